@@ -39,6 +39,17 @@ local options = {
 		section = 'performance',
 		def     = true,
 	},
+	{ -- number
+		key     = 'frame_budget',
+		name    = 'Frame time budget',
+		desc    = 'Microseconds per frame for staggered unit and task updates.\nEvery unit is still updated within bounded number of frames.\nkey: frame_budget',
+		type    = 'number',
+		section = 'performance',
+		def     = 1500,
+		min     = 250,
+		max     = 20000,
+		step    = 250,
+	},
 -- 	{ -- number (int->uint)
 -- 		key     = 'random_seed',
 -- 		name    = 'Random seed',
@@ -54,6 +65,14 @@ local options = {
 		type    = 'string',
 		def     = '',
 	},
+	{ -- string
+		key     = 'record',
+		name    = 'Event record',
+		desc    = 'Write engine events with handling time into binary file <record>-<skirmishAIId>.rec of writable AI dir.\nTimings summary is logged on release.\nkey: record',
+		type    = 'string',
+		section = 'performance',
+		def     = '',
+	},
 	{ -- string
 		key     = 'config_file',
 		name    = 'Config file parts',
@@ -0,0 +1,112 @@
+/*
+ * Replay.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+/*
+ * Offline replay of event record: CircuitAI runs against recorded callback results.
+ * Usage: circuit-replay <file.rec>
+ */
+
+#include "CircuitAI.h"
+#include "util/CallbackProxy.h"
+#include "util/EventReader.h"
+#include "util/EventRecorder.h"
+
+#include "OOAICallback.h"
+#include "WrappOOAICallback.h"
+
+#include <chrono>
+#include <cstdio>
+#include <map>
+
+using namespace circuit;
+
+struct STiming {
+	unsigned count;
+	float total;
+	float max;
+	void Add(float elapsed) {
+		++count;
+		total += elapsed;
+		max = std::max(max, elapsed);
+	}
+	float Avg() const { return (count > 0) ? total / count : .0f; }
+};
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2) {
+		printf("Usage: %s <file.rec>\n", argv[0]);
+		return 1;
+	}
+	CEventReader reader(argv[1]);
+	if (!reader.IsValid()) {
+		printf("Invalid event record: %s (version %i and hooks of the same engine expected)\n", argv[1], RECORD_VERSION);
+		return 1;
+	}
+
+	const int skirmishAIId = reader.GetSkirmishAIId();
+	CCallbackProxy proxy(skirmishAIId);
+	springai::OOAICallback* clb = nullptr;
+	CCircuitAI* ai = nullptr;
+
+	std::map<int, STiming> recTopics, repTopics;  // key: topic
+	STiming recFrames = {0, .0f, .0f}, repFrames = {0, .0f, .0f};
+	float recFrame = .0f, repFrame = .0f;
+	int lastFrame = -1;
+	unsigned errors = 0;
+
+	CEventReader::SRecord record;
+	std::string data;
+	while (reader.Next(record)) {
+		if (record.topic == RECORD_QUERY) {
+			const int hook = CEventReader::GetQueryHook(record, data);
+			proxy.PushQuery(hook, std::move(data));
+			continue;
+		}
+
+		if (ai == nullptr) {
+			// NOTE: Queries of constructor precede first event
+			clb = springai::WrappOOAICallback::GetInstance(proxy.GetCallback(), skirmishAIId);
+			ai = new CCircuitAI(clb);
+		}
+
+		if (lastFrame != record.frame) {
+			if (lastFrame >= 0) {
+				recFrames.Add(recFrame);
+				repFrames.Add(repFrame);
+			}
+			lastFrame = record.frame;
+			recFrame = repFrame = .0f;
+		}
+
+		const void* event = reader.MakeEvent(record, proxy.GetCallback());
+		const auto t0 = std::chrono::steady_clock::now();
+		if (ai->HandleEvent(record.topic, event) != 0) {
+			++errors;
+		}
+		const std::chrono::duration<float, std::micro> elapsed = std::chrono::steady_clock::now() - t0;
+
+		recTopics[record.topic].Add(record.elapsed);
+		repTopics[record.topic].Add(elapsed.count());
+		recFrame += record.elapsed;
+		repFrame += elapsed.count();
+	}
+
+	delete ai;
+	delete clb;
+
+	printf("Frames: count=%u record avg=%.1fus max=%.1fus, replay avg=%.1fus max=%.1fus\n",
+			repFrames.count, recFrames.Avg(), recFrames.max, repFrames.Avg(), repFrames.max);
+	for (auto& kv : repTopics) {
+		const STiming& rec = recTopics[kv.first];
+		const STiming& rep = kv.second;
+		printf("\ttopic %i: count=%u record avg=%.1fus max=%.1fus, replay avg=%.1fus max=%.1fus\n",
+				kv.first, rep.count, rec.Avg(), rec.max, rep.Avg(), rep.max);
+	}
+	printf("Errors: events=%u query misses=%u pending=%u\n", errors, proxy.GetMissCount(), proxy.GetPendingCount());
+	return 0;
+}
@@ -8,9 +8,11 @@
 #include "WrappOOAICallback.h"
 
 #include "circuit/CircuitAI.h"
+#include "circuit/util/EventRecorder.h"
 
 #include <stdexcept>
 #include <map>
+#include <memory>
 
 static std::map<int, circuit::CCircuitAI*> myAIs;
 static std::map<int, springai::OOAICallback*> myAICallbacks;
@@ -35,11 +37,17 @@ EXPORT(int) init(int skirmishAIId, const struct SSkirmishAICallback* innerCallba
 	int ret = ERROR_SHIFT + 1;
 
 	try {
-		springai::OOAICallback* clb = springai::WrappOOAICallback::GetInstance(innerCallback, skirmishAIId);
-		circuit::CCircuitAI* ai = new circuit::CCircuitAI(clb);
+		// NOTE: Recorder wraps callback to write query results from the very first call
+		std::unique_ptr<circuit::CEventRecorder> recorder(circuit::CEventRecorder::Create(skirmishAIId, innerCallback));
+		if (recorder != nullptr) {
+			innerCallback = recorder->GetCallback();
+		}
+		// NOTE: Both are freed if CCircuitAI constructor throws
+		std::unique_ptr<springai::OOAICallback> clb(springai::WrappOOAICallback::GetInstance(innerCallback, skirmishAIId));
+		circuit::CCircuitAI* ai = new circuit::CCircuitAI(clb.get(), std::move(recorder));
 
 		myAIs[skirmishAIId] = ai;
-		myAICallbacks[skirmishAIId] = clb;
+		myAICallbacks[skirmishAIId] = clb.release();
 
 		ret = 0;
 	} CATCH_CPP_AI_EXCEPTION(ret);
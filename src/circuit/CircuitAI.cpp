@@ -7,6 +7,7 @@
 
 #include "CircuitAI.h"
 #include "setup/SetupManager.h"
+#include "setup/DefenceMatrix.h"
 #include "module/BuilderManager.h"
 #include "module/FactoryManager.h"
 #include "module/EconomyManager.h"
@@ -18,6 +19,9 @@
 #include "task/PlayerTask.h"
 #include "unit/CircuitUnit.h"
 #include "unit/EnemyUnit.h"
+#include "util/Action.h"
+#include "util/EventRecorder.h"
+#include "util/FrameBudget.h"
 #include "util/GameAttribute.h"
 #include "util/Scheduler.h"
 #include "util/utils.h"
@@ -48,12 +52,17 @@
 
 #include <regex>
 #include <fstream>
+#include <sstream>
+#include <chrono>
 
 namespace circuit {
 
 using namespace springai;
 
 #define ACTION_UPDATE_RATE	128
+#define FRAME_BUDGET		1500  // microseconds
+#define SNAPSHOT_MAGIC		0x54435243  // "CRCT"
+#define SNAPSHOT_VERSION	3
 #define RELEASE_CONFIG		100
 #define RELEASE_COMMANDER	101
 #define RELEASE_CORRUPTED	102
@@ -67,7 +76,7 @@ using namespace springai;
 std::unique_ptr<CGameAttribute> CCircuitAI::gameAttribute(nullptr);
 unsigned int CCircuitAI::gaCounter = 0;
 
-CCircuitAI::CCircuitAI(OOAICallback* callback)
+CCircuitAI::CCircuitAI(OOAICallback* callback, std::unique_ptr<CEventRecorder> recorder)
 		: eventHandler(&CCircuitAI::HandleGameEvent)
 		, economy(nullptr)
 		, metalRes(nullptr)
@@ -80,6 +89,7 @@ CCircuitAI::CCircuitAI(OOAICallback* callback)
 		, isAllyAware(true)
 		, isCommMerge(true)
 		, isInitialized(false)
+		, isInitPending(false)
 		, isLoadSave(false)
 		, isResigned(false)
 		// NOTE: assert(lastFrame != -1): CCircuitUnit initialized with -1
@@ -95,6 +105,7 @@ CCircuitAI::CCircuitAI(OOAICallback* callback)
 		, pathing(std::unique_ptr<Pathing>(callback->GetPathing()))
 		, drawer(std::unique_ptr<Drawer>(map->GetDrawer()))
 		, skirmishAI(std::unique_ptr<SkirmishAI>(callback->GetSkirmishAI()))
+		, recorder(std::move(recorder))
 		, airCategory(0)
 		, landCategory(0)
 		, waterCategory(0)
@@ -119,7 +130,15 @@ CCircuitAI::~CCircuitAI()
 
 int CCircuitAI::HandleEvent(int topic, const void* data)
 {
-	return (this->*eventHandler)(topic, data);
+	if (recorder == nullptr) {
+		return (this->*eventHandler)(topic, data);
+	}
+
+	const auto t0 = std::chrono::steady_clock::now();
+	const int ret = (this->*eventHandler)(topic, data);
+	const std::chrono::duration<float, std::micro> elapsed = std::chrono::steady_clock::now() - t0;
+	recorder->Record(lastFrame, topic, data, elapsed.count());
+	return ret;
 }
 
 void CCircuitAI::NotifyGameEnd()
@@ -141,17 +160,28 @@ void CCircuitAI::Resign(int newTeamId)
 	isResigned = true;
 }
 
+void CCircuitAI::CountCommands(unsigned sent, unsigned dropped, unsigned merged)
+{
+	if (recorder != nullptr) {
+		recorder->CountCommands(lastFrame, sent, dropped, merged);
+	}
+}
+
 int CCircuitAI::HandleGameEvent(int topic, const void* data)
 {
 	int ret = ERROR_UNKNOWN;
 
+	if (topic != EVENT_UPDATE) {
+		CAllyUnit::ClearAllProps();
+	}
+
 	switch (topic) {
 		case EVENT_INIT: {
 			PRINT_TOPIC("EVENT_INIT", topic);
 			SCOPED_TIME(this, "EVENT_INIT");
 			struct SInitEvent* evt = (struct SInitEvent*)data;
 			try {
-				ret = this->Init(evt->skirmishAIId, evt->callback);
+				ret = this->Init(evt->skirmishAIId, evt->callback, evt->savedGame);
 			} catch (const CException& e) {
 				Release(RELEASE_CORRUPTED);
 				LOG("Exception: %s", e.what());
@@ -516,18 +546,19 @@ void CCircuitAI::CheatPreload()
 	}
 }
 
-int CCircuitAI::Init(int skirmishAIId, const struct SSkirmishAICallback* sAICallback)
+int CCircuitAI::Init(int skirmishAIId, const struct SSkirmishAICallback* sAICallback, bool savedGame)
 {
 	LOG(version);
 	this->skirmishAIId = skirmishAIId;
+	isLoadSave = savedGame;
 	// NOTE: Due to chewed API only SSkirmishAICallback have access to Engine
-	this->sAICallback = sAICallback;
+	this->sAICallback = (recorder != nullptr) ? recorder->GetCallback() : sAICallback;
 //	if (!IsModValid()) {
 //		return ERROR_INIT;
 //	}
 
 #ifdef DEBUG_VIS
-	debugDrawer = std::unique_ptr<CDebugDrawer>(new CDebugDrawer(this, sAICallback));
+	debugDrawer = std::unique_ptr<CDebugDrawer>(new CDebugDrawer(this, this->sAICallback));
 	if (debugDrawer->Init() != 0) {
 		return ERROR_INIT;
 	}
@@ -535,6 +566,10 @@ int CCircuitAI::Init(int skirmishAIId, const struct SSkirmishAICallback* sAICall
 
 	scheduler = std::make_shared<CScheduler>();
 	scheduler->Init(scheduler);
+	frameBudget = std::make_shared<CFrameBudget>(FRAME_BUDGET);
+	frameBudget->AddQueue("action", 3, ACTION_UPDATE_RATE / 4, ACTION_UPDATE_RATE,
+			[this]() { return actionUnits.size(); },
+			[this](unsigned int n) { return ActionUpdate(n); });
 
 	std::string cfgOption = InitOptions();  // Inits GameAttribute
 	float decloakRadius;
@@ -555,15 +590,15 @@ int CCircuitAI::Init(int skirmishAIId, const struct SSkirmishAICallback* sAICall
 
 	terrainManager = std::make_shared<CTerrainManager>(this, &gameAttribute->GetTerrainData());
 	economyManager = std::make_shared<CEconomyManager>(this);
-	threatMap = std::make_shared<CThreatMap>(this, decloakRadius);
 
 	allyTeam->Init(this);
 	metalManager = allyTeam->GetMetalManager();
 	pathfinder = allyTeam->GetPathfinder();
+	threatMap = std::make_shared<CThreatMap>(this, decloakRadius);
 
 	terrainManager->Init();
 
-	if (setupManager->HasStartBoxes() && setupManager->CanChooseStartPos()) {
+	if (!isLoadSave && setupManager->HasStartBoxes() && setupManager->CanChooseStartPos()) {
 		const CSetupManager::StartPosType spt = metalManager->HasMetalSpots() ?
 												CSetupManager::StartPosType::METAL_SPOT :
 												CSetupManager::StartPosType::MIDDLE;
@@ -581,6 +616,7 @@ int CCircuitAI::Init(int skirmishAIId, const struct SSkirmishAICallback* sAICall
 	modules.push_back(builderManager);
 	modules.push_back(factoryManager);
 	modules.push_back(economyManager);  // NOTE: Units use manager, but ain't assigned here
+	InitModuleMasks();
 
 	uEnemyMark = skirmishAIId % FRAMES_PER_SEC;
 	kEnemyMark = (skirmishAIId + FRAMES_PER_SEC / 2) % FRAMES_PER_SEC;
@@ -593,13 +629,28 @@ int CCircuitAI::Init(int skirmishAIId, const struct SSkirmishAICallback* sAICall
 		scheduler->RunTaskAt(std::make_shared<CGameTask>(&CCircuitAI::CheatPreload, this), skirmishAIId + 1);
 	}
 
+	// Saved game: metal clusters and closest sectors are expected in Load's snapshot
+	isInitPending = isLoadSave;
+	if (!isInitPending) {
+		FinishInit();
+	}
+	isInitialized = true;
+
+	return 0;  // signaling: OK
+}
+
+void CCircuitAI::FinishInit()
+{
+	isInitPending = false;
+	if (metalManager->HasMetalSpots() && !metalManager->HasMetalClusters() && !metalManager->IsClusterizing()) {
+		metalManager->ClusterizeMetal(setupManager->GetCommChoice());
+	}
+	gameAttribute->GetTerrainData().InitClosestSectors();
+
 	scheduler->ProcessInit();  // Init modules: allows to manipulate units on gadget:Initialize
 	setupManager->Welcome();
 
 	setupManager->CloseConfig();
-	isInitialized = true;
-
-	return 0;  // signaling: OK
 }
 
 int CCircuitAI::Release(int reason)
@@ -613,6 +664,14 @@ int CCircuitAI::Release(int reason)
 		return 0;
 	}
 
+	if (recorder != nullptr) {
+		recorder->Report(this);
+	}
+	LOG("AI: %i | Target fields: hits=%u misses=%u", skirmishAIId,
+		pathfinder->GetFieldHitNum(), pathfinder->GetFieldMissNum());
+	LOG("AI: %i | Build probes: hits=%u misses=%u", skirmishAIId,
+		terrainManager->GetBuildCacheHits(), terrainManager->GetBuildCacheMisses());
+
 	if (reason == RELEASE_RESIGN) {
 		factoryManager->Release();
 		builderManager->Release();
@@ -628,6 +687,7 @@ int CCircuitAI::Release(int reason)
 
 	scheduler->ProcessRelease();
 	scheduler = nullptr;
+	frameBudget = nullptr;
 
 	threatMap = nullptr;
 	modules.clear();
@@ -655,6 +715,11 @@ int CCircuitAI::Release(int reason)
 		delete kv.second;
 	}
 	enemyUnits.clear();
+#ifdef DEBUG_LOG
+	LOG("AI: %i | Pools high-water: units=%u enemies=%u tasks=%u actions=%u", skirmishAIId,
+		CCircuitUnit::GetPool().GetHighWater(), CEnemyUnit::GetPool().GetHighWater(),
+		IUnitTask::GetPool().GetHighWater(), IAction::GetPool().GetHighWater());
+#endif
 	if (allyTeam != nullptr) {
 		allyTeam->Release();
 	}
@@ -678,17 +743,24 @@ int CCircuitAI::Release(int reason)
 int CCircuitAI::Update(int frame)
 {
 	lastFrame = frame;
+	if (isInitPending) {  // saved game without load event
+		FinishInit();
+	}
 	if (isResigned) {
 		Release(RELEASE_RESIGN);
 		NotifyResign();
 		return 0;
 	}
 
-	if (!garbage.empty()) {
-		CCircuitUnit* unit = *garbage.begin();
-		UnitDestroyed(unit, nullptr);
-		UnregisterTeamUnit(unit);
-		garbage.erase(unit);  // NOTE: UnregisterTeamUnit may erase unit
+	while (!garbage.empty()) {
+		CCircuitUnit* unit = CCircuitUnit::GetPool().Get(garbage.front());
+		garbage.pop_front();
+		// NOTE: Handle is stale if unit was deleted, duplicate entry if unit was already unregistered
+		if ((unit != nullptr) && (GetTeamUnit(unit->GetId()) == unit)) {
+			UnitDestroyed(unit, nullptr);
+			UnregisterTeamUnit(unit);
+			break;
+		}
 	}
 
 	if (!enemyUnits.empty()) {
@@ -701,7 +773,7 @@ int CCircuitAI::Update(int frame)
 	}
 
 	scheduler->ProcessTasks(frame);
-	ActionUpdate();
+	frameBudget->Process();
 
 #ifdef DEBUG_VIS
 	if (frame % FRAMES_PER_SEC == 0) {
@@ -805,10 +877,33 @@ int CCircuitAI::Message(int playerId, const char* message)
 	return 0;  // signaling: OK
 }
 
+void CCircuitAI::InitModuleMasks()
+{
+	CCircuitDef::Id maxId = 0;
+	for (auto& kv : defsById) {
+		maxId = std::max(maxId, kv.first);
+	}
+	moduleMasks.assign(maxId + 1, 0);
+
+	for (auto& kv : defsById) {
+		uint32_t& mask = moduleMasks[kv.first];
+		for (unsigned i = 0; i < modules.size(); ++i) {
+			for (int event = 0; event < static_cast<int>(IModule::Event::_SIZE_); ++event) {
+				if (modules[i]->IsInterested(static_cast<IModule::Event>(event), kv.first)) {
+					mask |= 1 << (event * 8 + i);
+				}
+			}
+		}
+	}
+}
+
 int CCircuitAI::UnitCreated(CCircuitUnit* unit, CCircuitUnit* builder)
 {
-	for (auto& module : modules) {
-		module->UnitCreated(unit, builder);
+	const uint32_t mask = GetModuleMask(unit->GetCircuitDef()->GetId(), IModule::Event::CREATED);
+	for (unsigned i = 0; i < modules.size(); ++i) {
+		if (mask & (1 << i)) {
+			modules[i]->UnitCreated(unit, builder);
+		}
 	}
 
 	return 0;  // signaling: OK
@@ -816,19 +911,22 @@ int CCircuitAI::UnitCreated(CCircuitUnit* unit, CCircuitUnit* builder)
 
 int CCircuitAI::UnitFinished(CCircuitUnit* unit)
 {
-	if (unit->GetUnit()->IsBeingBuilt()) {
+	if (unit->IsBeingBuilt(lastFrame)) {
 		return 0;  // created by gadget
 	}
 	TRY_UNIT(this, unit,
-		unit->GetUnit()->ExecuteCustomCommand(CMD_DONT_FIRE_AT_RADAR, {0.0f});
+		unit->CmdCustom(CMD_DONT_FIRE_AT_RADAR, {0.0f});
 //		if (unit->GetCircuitDef()->GetUnitDef()->IsAbleToCloak()) {
 //			unit->GetUnit()->ExecuteCustomCommand(CMD_WANT_CLOAK, {1.0f});  // personal
 //			unit->GetUnit()->ExecuteCustomCommand(CMD_CLOAK_SHIELD, {1.0f});  // area
 //			unit->GetUnit()->Cloak(true);
 //		}
 	)
-	for (auto& module : modules) {
-		module->UnitFinished(unit);
+	const uint32_t mask = GetModuleMask(unit->GetCircuitDef()->GetId(), IModule::Event::FINISHED);
+	for (unsigned i = 0; i < modules.size(); ++i) {
+		if (mask & (1 << i)) {
+			modules[i]->UnitFinished(unit);
+		}
 	}
 
 	return 0;  // signaling: OK
@@ -836,6 +934,7 @@ int CCircuitAI::UnitFinished(CCircuitUnit* unit)
 
 int CCircuitAI::UnitIdle(CCircuitUnit* unit)
 {
+	unit->CmdClear();
 	for (auto& module : modules) {
 		module->UnitIdle(unit);
 	}
@@ -845,10 +944,11 @@ int CCircuitAI::UnitIdle(CCircuitUnit* unit)
 
 int CCircuitAI::UnitMoveFailed(CCircuitUnit* unit)
 {
+	unit->CmdClear();
 	if (unit->IsMoveFailed(lastFrame)) {
 		TRY_UNIT(this, unit,
-			unit->GetUnit()->Stop();
-			unit->GetUnit()->SetMoveState(2);
+			unit->CmdStop();
+			unit->CmdMoveState(2);
 		)
 		UnitDestroyed(unit, nullptr);
 		UnregisterTeamUnit(unit);
@@ -867,8 +967,11 @@ int CCircuitAI::UnitDamaged(CCircuitUnit* unit, CEnemyUnit* attacker/*, int weap
 //	}
 //	unit->SetDamagedFrame(lastFrame);
 
-	for (auto& module : modules) {
-		module->UnitDamaged(unit, attacker);
+	const uint32_t mask = GetModuleMask(unit->GetCircuitDef()->GetId(), IModule::Event::DAMAGED);
+	for (unsigned i = 0; i < modules.size(); ++i) {
+		if (mask & (1 << i)) {
+			modules[i]->UnitDamaged(unit, attacker);
+		}
 	}
 
 	return 0;  // signaling: OK
@@ -876,6 +979,7 @@ int CCircuitAI::UnitDamaged(CCircuitUnit* unit, CEnemyUnit* attacker/*, int weap
 
 int CCircuitAI::UnitDestroyed(CCircuitUnit* unit, CEnemyUnit* attacker)
 {
+	terrainManager->InvalidateBuildCache(unit->GetPos(lastFrame), SQUARE_SIZE * 8);  // wreck or freed site
 	for (auto& module : modules) {
 		module->UnitDestroyed(unit, attacker);
 	}
@@ -902,8 +1006,8 @@ int CCircuitAI::UnitGiven(ICoreUnit::Id unitId, int oldTeamId, int newTeamId)
 	}
 
 	TRY_UNIT(this, unit,
-		unit->GetUnit()->Stop();
-		unit->GetUnit()->ExecuteCustomCommand(CMD_DONT_FIRE_AT_RADAR, {0.0f});
+		unit->CmdStop();
+		unit->CmdCustom(CMD_DONT_FIRE_AT_RADAR, {0.0f});
 //		if (unit->GetCircuitDef()->GetUnitDef()->IsAbleToCloak()) {
 //			unit->GetUnit()->ExecuteCustomCommand(CMD_WANT_CLOAK, {1.0f});  // personal
 //			unit->GetUnit()->ExecuteCustomCommand(CMD_CLOAK_SHIELD, {1.0f});  // area
@@ -945,6 +1049,7 @@ int CCircuitAI::EnemyEnterLOS(CEnemyUnit* enemy)
 	if (threatMap->EnemyEnterLOS(enemy)) {
 		militaryManager->AddEnemyCost(enemy);
 	}
+	militaryManager->MarkEnemyDirty(enemy->GetId());
 
 	if (isKnownBefore) {
 		return 0;  // signaling: OK
@@ -971,6 +1076,7 @@ int CCircuitAI::EnemyEnterLOS(CEnemyUnit* enemy)
 int CCircuitAI::EnemyLeaveLOS(CEnemyUnit* enemy)
 {
 	threatMap->EnemyLeaveLOS(enemy);
+	militaryManager->MarkEnemyDirty(enemy->GetId());
 
 	return 0;  // signaling: OK
 }
@@ -978,6 +1084,7 @@ int CCircuitAI::EnemyLeaveLOS(CEnemyUnit* enemy)
 int CCircuitAI::EnemyEnterRadar(CEnemyUnit* enemy)
 {
 	threatMap->EnemyEnterRadar(enemy);
+	militaryManager->MarkEnemyDirty(enemy->GetId());
 	enemy->SetLastSeen(-1);
 
 	return 0;  // signaling: OK
@@ -986,6 +1093,7 @@ int CCircuitAI::EnemyEnterRadar(CEnemyUnit* enemy)
 int CCircuitAI::EnemyLeaveRadar(CEnemyUnit* enemy)
 {
 	threatMap->EnemyLeaveRadar(enemy);
+	militaryManager->MarkEnemyDirty(enemy->GetId());
 	enemy->SetLastSeen(lastFrame);
 
 	return 0;  // signaling: OK
@@ -994,15 +1102,18 @@ int CCircuitAI::EnemyLeaveRadar(CEnemyUnit* enemy)
 int CCircuitAI::EnemyDamaged(CEnemyUnit* enemy)
 {
 	threatMap->EnemyDamaged(enemy);
+	militaryManager->MarkEnemyDirty(enemy->GetId());
 
 	return 0;  // signaling: OK
 }
 
 int CCircuitAI::EnemyDestroyed(CEnemyUnit* enemy)
 {
+	terrainManager->InvalidateBuildCache(enemy->GetPos(), SQUARE_SIZE * 8);
 	if (threatMap->EnemyDestroyed(enemy)) {
 		militaryManager->DelEnemyCost(enemy);
 	}
+	militaryManager->MarkEnemyDirty(enemy->GetId());
 
 	return 0;  // signaling: OK
 }
@@ -1035,6 +1146,46 @@ int CCircuitAI::Load(std::istream& is)
 {
 	isLoadSave = true;
 
+	/*
+	 * Snapshot: header, then sections of {tag, size, data}
+	 */
+	uint32_t magic = 0, version = 0;
+	int frame = -1;
+	utils::binary_read(is, magic);
+	utils::binary_read(is, version);
+	utils::binary_read(is, frame);
+	const bool isValid = is && (magic == SNAPSHOT_MAGIC) && (version == SNAPSHOT_VERSION);
+
+	std::vector<std::pair<SnapshotTag, std::string>> sections;
+	SnapshotTag tag;
+	uint32_t size;
+	while (isValid && utils::binary_read(is, tag) && (tag != SnapshotTag::END) && utils::binary_read(is, size)) {
+		std::string data(size, '\0');
+		if (!is.read(&data[0], size)) {
+			break;
+		}
+		sections.push_back(std::make_pair(tag, std::move(data)));
+	}
+
+	// Expensive init data, applied once for all AIs
+	for (auto& kv : sections) {
+		std::istringstream section(kv.second);
+		switch (kv.first) {
+			case SnapshotTag::CLUSTERS: {
+				if (!metalManager->HasMetalClusters()) {
+					gameAttribute->GetMetalData().LoadClusters(section);
+				}
+			} break;
+			case SnapshotTag::AREAS: {
+				gameAttribute->GetTerrainData().LoadAreas(section);
+			} break;
+			default: break;
+		}
+	}
+	if (isInitPending) {
+		FinishInit();
+	}
+
 	auto units = std::move(callback->GetTeamUnits());
 	for (Unit* u : units) {
 		if (u == nullptr) {
@@ -1056,8 +1207,25 @@ int CCircuitAI::Load(std::istream& is)
 		}
 	}
 
-	for (auto& module : modules) {
-		is >> *module;
+	if (!isValid) {
+		LOG("AI: %i | Incompatible snapshot: %x v%u", skirmishAIId, magic, version);
+		return 0;  // signaling: OK
+	}
+
+	unsigned int moduleIdx = 0;
+	for (auto& kv : sections) {
+		std::istringstream section(kv.second);
+		switch (kv.first) {
+			case SnapshotTag::DEFENCE: {  // only owner of shared matrix saved it
+				allyTeam->GetDefenceMatrix()->Load(section);
+			} break;
+			case SnapshotTag::MODULE: {
+				if (moduleIdx < modules.size()) {
+					section >> *modules[moduleIdx++];
+				}
+			} break;
+			default: break;  // unknown section
+		}
 	}
 
 	return 0;  // signaling: OK
@@ -1065,13 +1233,41 @@ int CCircuitAI::Load(std::istream& is)
 
 int CCircuitAI::Save(std::ostream& os)
 {
+	utils::binary_write(os, SNAPSHOT_MAGIC);
+	utils::binary_write(os, SNAPSHOT_VERSION);
+	utils::binary_write(os, lastFrame);
+
+	// Init data goes into every snapshot: any AI may load first
+	std::ostringstream section;
+	gameAttribute->GetMetalData().SaveClusters(section);
+	SaveSection(os, SnapshotTag::CLUSTERS, section);
+	section.str("");
+	gameAttribute->GetTerrainData().SaveAreas(section);
+	SaveSection(os, SnapshotTag::AREAS, section);
+	if (allyTeam->GetDefenceMatrix()->IsAuthority(this)) {
+		section.str("");
+		allyTeam->GetDefenceMatrix()->Save(section);
+		SaveSection(os, SnapshotTag::DEFENCE, section);
+	}
 	for (auto& module : modules) {
-		os << *module;
+		section.str("");
+		section << *module;
+		SaveSection(os, SnapshotTag::MODULE, section);
 	}
+	utils::binary_write(os, SnapshotTag::END);
 
 	return 0;  // signaling: OK
 }
 
+void CCircuitAI::SaveSection(std::ostream& os, SnapshotTag tag, const std::ostringstream& section)
+{
+	const std::string data = section.str();
+	const uint32_t size = data.size();
+	utils::binary_write(os, tag);
+	utils::binary_write(os, size);
+	os.write(data.data(), size);
+}
+
 int CCircuitAI::LuaMessage(const char* inData)
 {
 	if (strncmp(inData, "DISABLE_CONTROL:", 16) == 0) {
@@ -1134,15 +1330,14 @@ void CCircuitAI::UnregisterTeamUnit(CCircuitUnit* unit)
 
 void CCircuitAI::DeleteTeamUnit(CCircuitUnit* unit)
 {
-	garbage.erase(unit);
-	delete unit;
+	delete unit;  // NOTE: invalidates handles in garbage
 }
 
 void CCircuitAI::Garbage(CCircuitUnit* unit, const char* reason)
 {
 	// NOTE: Happens because engine can send EVENT_UNIT_FINISHED after EVENT_UNIT_DESTROYED.
 	//       Engine should not send events with isDead units.
-	garbage.insert(unit);
+	garbage.push_back(unit->GetHandle());
 #ifdef DEBUG_LOG
 	LOG("AI: %i | Garbage unit: %i | reason: %s", skirmishAIId, unit->GetId(), reason);
 #endif
@@ -1154,6 +1349,19 @@ CCircuitUnit* CCircuitAI::GetTeamUnit(ICoreUnit::Id unitId) const
 	return (it != teamUnits.end()) ? it->second : nullptr;
 }
 
+void CCircuitAI::GetFriendlyUnitsIn(const AIFloat3& pos, float radius, std::vector<CAllyUnit*>& outUnits)
+{
+	UpdateFriendlyUnits();
+	const unsigned start = outUnits.size();
+	allyTeam->GetFriendlyUnitsIn(pos, radius, outUnits);
+	for (unsigned i = start; i < outUnits.size(); ++i) {
+		CCircuitUnit* unit = GetTeamUnit(outUnits[i]->GetId());
+		if (unit != nullptr) {
+			outUnits[i] = unit;
+		}
+	}
+}
+
 CAllyUnit* CCircuitAI::GetFriendlyUnit(Unit* u) const
 {
 	if (u == nullptr) {
@@ -1268,6 +1476,9 @@ void CCircuitAI::UpdateEnemyUnits()
 				continue;
 			}
 			enemy->SetNewPos(pos);
+			militaryManager->MarkEnemyMoved(enemy);
+		} else if (!enemy->IsHidden()) {
+			militaryManager->MarkEnemyDirty(enemy->GetId());  // may turn hidden on threat update
 		}
 
 		++it;
@@ -1320,15 +1531,13 @@ void CCircuitAI::EnableControl(const std::string data)
 	}
 }
 
-void CCircuitAI::ActionUpdate()
+unsigned int CCircuitAI::ActionUpdate(unsigned int n)
 {
 	if (actionIterator >= actionUnits.size()) {
 		actionIterator = 0;
 	}
 
-	// stagger the Update's
-	unsigned int n = (actionUnits.size() / ACTION_UPDATE_RATE) + 1;
-
+	const unsigned int total = n;
 	while ((actionIterator < actionUnits.size()) && (n != 0)) {
 		CCircuitUnit* unit = actionUnits[actionIterator];
 		if (unit->IsDead()) {
@@ -1343,6 +1552,7 @@ void CCircuitAI::ActionUpdate()
 			n--;
 		}
 	}
+	return total - n;
 }
 
 std::string CCircuitAI::InitOptions()
@@ -1365,6 +1575,11 @@ std::string CCircuitAI::InitOptions()
 		isCommMerge = StringToBool(value);
 	}
 
+	value = options->GetValueByKey("frame_budget");
+	if (value != nullptr) {
+		frameBudget->SetBudget(StringToInt(value));
+	}
+
 	value = options->GetValueByKey("config_file");
 	std::string cfgOption = ((value != nullptr) && strlen(value) > 0) ? value : "";
 
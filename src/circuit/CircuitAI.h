@@ -8,10 +8,14 @@
 #ifndef SRC_CIRCUIT_CIRCUIT_H_
 #define SRC_CIRCUIT_CIRCUIT_H_
 
+#include "module/Module.h"
 #include "unit/AllyTeam.h"
 #include "unit/CircuitDef.h"
 #include "util/Defines.h"
+#include "util/ObjectPool.h"
 
+#include <deque>
+#include <iosfwd>
 #include <memory>
 #include <unordered_map>
 #include <map>
@@ -55,7 +59,8 @@ class CFactoryManager;
 class CEconomyManager;
 class CMilitaryManager;
 class CScheduler;
-class IModule;
+class CFrameBudget;
+class CEventRecorder;
 class CCircuitUnit;
 class CEnemyUnit;
 #ifdef DEBUG_VIS
@@ -81,7 +86,7 @@ public:
 
 class CCircuitAI {
 public:
-	CCircuitAI(springai::OOAICallback* callback);
+	CCircuitAI(springai::OOAICallback* callback, std::unique_ptr<CEventRecorder> recorder = nullptr);
 	virtual ~CCircuitAI();
 
 // ---- AI Event handler ---- BEGIN
@@ -106,7 +111,8 @@ private:
 private:
 //	bool IsModValid();
 	void CheatPreload();
-	int Init(int skirmishAIId, const struct SSkirmishAICallback* sAICallback);
+	int Init(int skirmishAIId, const struct SSkirmishAICallback* sAICallback, bool savedGame);
+	void FinishInit();
 	int Release(int reason);
 	int Update(int frame);
 	int Message(int playerId, const char* message);
@@ -128,6 +134,8 @@ private:
 //	int CommandFinished(CCircuitUnit* unit, int commandTopicId, springai::Command* cmd);
 	int Load(std::istream& is);
 	int Save(std::ostream& os);
+	enum class SnapshotTag: uint32_t {END = 0, DEFENCE, MODULE, CLUSTERS, AREAS};  // binary snapshot sections
+	void SaveSection(std::ostream& os, SnapshotTag tag, const std::ostringstream& section);
 	int LuaMessage(const char* inData);
 
 // ---- Units ---- BEGIN
@@ -148,6 +156,8 @@ public:
 	CAllyUnit* GetFriendlyUnit(springai::Unit* u) const;
 	CAllyUnit* GetFriendlyUnit(ICoreUnit::Id unitId) const { return allyTeam->GetFriendlyUnit(unitId); }
 	const CAllyTeam::Units& GetFriendlyUnits() const { return allyTeam->GetFriendlyUnits(); }
+	// Own units are returned as CCircuitUnit
+	void GetFriendlyUnitsIn(const springai::AIFloat3& pos, float radius, std::vector<CAllyUnit*>& outUnits);
 
 	using EnemyUnits = std::map<ICoreUnit::Id, CEnemyUnit*>;
 private:
@@ -169,7 +179,7 @@ public:
 	void AddActionUnit(CCircuitUnit* unit) { actionUnits.push_back(unit); }
 
 private:
-	void ActionUpdate();
+	unsigned int ActionUpdate(unsigned int n);
 
 	Units teamUnits;  // owner
 	EnemyUnits enemyUnits;  // owner
@@ -180,7 +190,7 @@ private:
 	std::vector<CCircuitUnit*> actionUnits;
 	unsigned int actionIterator;
 
-	std::set<CCircuitUnit*> garbage;
+	std::deque<CMemPool::SHandle> garbage;  // handles of CCircuitUnit
 // ---- Units ---- END
 
 // ---- AIOptions.lua ---- BEGIN
@@ -217,11 +227,14 @@ public:
 	bool IsLoadSave() const { return isLoadSave; }
 	CGameAttribute* GetGameAttribute() const { return gameAttribute.get(); }
 	std::shared_ptr<CScheduler>& GetScheduler() { return scheduler; }
+	std::shared_ptr<CFrameBudget>& GetFrameBudget() { return frameBudget; }
+	void CountCommands(unsigned sent, unsigned dropped, unsigned merged);  // unit orders of current frame
 	int GetLastFrame()    const { return lastFrame; }
 	int GetSkirmishAIId() const { return skirmishAIId; }
 	int GetTeamId()       const { return teamId; }
 	int GetAllyTeamId()   const { return allyTeamId; }
 	springai::OOAICallback* GetCallback()   const { return callback; }
+	const struct SSkirmishAICallback* GetSkirmishAICallback() const { return sAICallback; }
 	springai::Log*          GetLog()        const { return log.get(); }
 	springai::Game*         GetGame()       const { return game.get(); }
 	springai::Map*          GetMap()        const { return map.get(); }
@@ -251,6 +264,7 @@ private:
 //	void DrawClusters();
 
 	bool isInitialized;
+	bool isInitPending;  // saved game waits for snapshot of init data
 	bool isLoadSave;
 	bool isResigned;
 	int lastFrame;
@@ -273,6 +287,8 @@ private:
 	void CreateGameAttribute(unsigned int seed);
 	void DestroyGameAttribute();
 	std::shared_ptr<CScheduler> scheduler;
+	std::shared_ptr<CFrameBudget> frameBudget;
+	std::unique_ptr<CEventRecorder> recorder;
 	std::shared_ptr<CSetupManager> setupManager;
 	std::shared_ptr<CMetalManager> metalManager;
 	std::shared_ptr<CThreatMap> threatMap;
@@ -283,6 +299,11 @@ private:
 	std::shared_ptr<CEconomyManager> economyManager;
 	std::shared_ptr<CMilitaryManager> militaryManager;
 	std::vector<std::shared_ptr<IModule>> modules;
+	std::vector<uint32_t> moduleMasks;  // per def: interested modules, 8 bits per IModule::Event
+	void InitModuleMasks();
+	uint32_t GetModuleMask(CCircuitDef::Id unitDefId, IModule::Event event) const {
+		return moduleMasks[unitDefId] >> (static_cast<int>(event) * 8);
+	}
 
 	// TODO: Move into GameAttribute? Or use locally
 	int airCategory;  // over surface
@@ -11,6 +11,7 @@
 #include "module/FactoryManager.h"
 #include "resource/MetalManager.h"
 #include "setup/SetupManager.h"
+#include "setup/ConfigData.h"
 #include "terrain/TerrainManager.h"
 #include "terrain/ThreatMap.h"
 #include "terrain/PathFinder.h"
@@ -36,13 +37,15 @@
 #include "task/builder/GuardTask.h"
 #include "task/builder/BuildChain.h"
 #include "CircuitAI.h"
+#include "util/FrameBudget.h"
 #include "util/Scheduler.h"
 #include "util/utils.h"
-#include "json/json.h"
 
 #include "Command.h"
 #include "Log.h"
 
+#include <sstream>
+
 namespace circuit {
 
 using namespace springai;
@@ -131,8 +134,7 @@ CBuilderManager::CBuilderManager(CCircuitAI* circuit)
 //		}
 //	};
 
-	const Json::Value& root = circuit->GetSetupManager()->GetConfig();
-	const float builderRet = root["retreat"].get("builder", 0.8f).asFloat();
+	const float builderRet = circuit->GetSetupManager()->GetConfigData()->GetMilitary().builderRet;
 
 	CTerrainManager* terrainManager = circuit->GetTerrainManager();
 	const CCircuitAI::CircuitDefs& allDefs = circuit->GetCircuitDefs();
@@ -218,127 +220,37 @@ CBuilderManager::~CBuilderManager()
 
 void CBuilderManager::ReadConfig()
 {
-	const Json::Value& root = circuit->GetSetupManager()->GetConfig();
-	const std::string& cfgName = circuit->GetSetupManager()->GetConfigName();
+	const CConfigData* configData = circuit->GetSetupManager()->GetConfigData();
 
-	terraDef = circuit->GetCircuitDef(root["economy"].get("terra", "").asCString());
+	const CCircuitDef::Id terraId = configData->GetEconomy().terraDef;
+	terraDef = (terraId >= 0) ? circuit->GetCircuitDef(terraId) : nullptr;
 	if (terraDef == nullptr) {
 		terraDef = circuit->GetEconomyManager()->GetDefaultDef();
 	}
 
-	const Json::Value& cond = root["porcupine"]["condition"];
-	super.minIncome = cond.get((unsigned)0, 50.f).asFloat();
-	super.maxTime = cond.get((unsigned)1, 300.f).asFloat();
-
-	IBuilderTask::BuildName& buildNames = IBuilderTask::GetBuildNames();
-	const Json::Value& build = root["build_chain"];
-	for (const std::string& catName : build.getMemberNames()) {
-		auto it = buildNames.find(catName);
-		if (it == buildNames.end()) {
-			circuit->LOG("CONFIG %s: has unknown category '%s'", cfgName.c_str(), catName.c_str());
-			continue;
-		}
-
-		std::unordered_map<CCircuitDef*, SBuildChain*>& defMap = buildChains[static_cast<IBuilderTask::BT>(it->second)];
-		const Json::Value& catChain = build[catName];
-		for (const std::string& defName : catChain.getMemberNames()) {
-			CCircuitDef* cdef = circuit->GetCircuitDef(defName.c_str());
-			if (cdef == nullptr) {
-				circuit->LOG("CONFIG %s: has unknown UnitDef '%s'", cfgName.c_str(), defName.c_str());
-				continue;
-			}
-
-			SBuildChain bc;
-			const Json::Value& buildQueue = catChain[defName];
-			bc.isPylon = buildQueue.get("pylon", false).asBool();
-			bc.isPorc = buildQueue.get("porc", false).asBool();
-			bc.isTerra = buildQueue.get("terra", false).asBool();
-
-			const Json::Value& engy = buildQueue["energy"];
-			bc.energy = engy.get(unsigned(0), -1.f).asFloat();
-			bc.isMexEngy = engy[1].isString();
-
-			const Json::Value& hub = buildQueue["hub"];
-			bc.hub.reserve(hub.size());
-			for (const Json::Value& que : hub) {
+	super.minIncome = configData->GetMilitary().superMinIncome;
+	super.maxTime = configData->GetMilitary().superMaxTime;
+
+	for (const auto& kv1 : configData->GetBuildChains()) {
+		std::unordered_map<CCircuitDef*, SBuildChain*>& defMap = buildChains[kv1.first];
+		for (const auto& kv2 : kv1.second) {
+			const CConfigData::SBuildChain& chain = kv2.second;
+			SBuildChain* bc = new SBuildChain;
+			bc->energy = chain.energy;
+			bc->isMexEngy = chain.isMexEngy;
+			bc->isPylon = chain.isPylon;
+			bc->isPorc = chain.isPorc;
+			bc->isTerra = chain.isTerra;
+			bc->hub.reserve(chain.hub.size());
+			for (const std::vector<CConfigData::SBuildPart>& que : chain.hub) {
 				std::vector<SBuildInfo> queue;
 				queue.reserve(que.size());
-				for (const Json::Value& part : que) {
-					SBuildInfo bi;
-
-					const std::string& partName = part.get("unit", "").asString();
-					bi.cdef = circuit->GetCircuitDef(partName.c_str());
-					if (bi.cdef == nullptr) {
-						circuit->LOG("CONFIG %s: has unknown UnitDef '%s'", cfgName.c_str(), partName.c_str());
-						continue;
-					}
-
-					const std::string& cat = part.get("category", "").asString();
-					auto it = buildNames.find(cat);
-					if (it == buildNames.end()) {
-						circuit->LOG("CONFIG %s: has unknown category '%s'", cfgName.c_str(), cat.c_str());
-						continue;
-					}
-					bi.buildType = it->second;
-
-					UnitDef* unitDef = cdef->GetUnitDef();
-					bi.offset = ZeroVector;
-					bi.direction = SBuildInfo::Direction::NONE;
-					const Json::Value& off = part["offset"];
-					if (off.isArray()) {
-						bi.offset = AIFloat3(off.get((unsigned)0, 0.f).asFloat(), 0.f, off.get((unsigned)1, 0.f).asFloat());
-						if (bi.offset.x < -1e-3f) {
-							bi.offset.x -= unitDef->GetXSize() * SQUARE_SIZE / 2;
-						} else if (bi.offset.x > 1e-3f) {
-							bi.offset.x += unitDef->GetXSize() * SQUARE_SIZE / 2;
-						}
-						if (bi.offset.z < -1e-3f) {
-							bi.offset.z -= unitDef->GetZSize() * SQUARE_SIZE / 2;
-						} else if (bi.offset.z > 1e-3f) {
-							bi.offset.z += unitDef->GetZSize() * SQUARE_SIZE / 2;
-						}
-					} else if (off.isObject() && !off.empty()) {
-						float delta = 0.f;
-						SBuildInfo::DirName& dirNames = SBuildInfo::GetDirNames();
-						std::string dir = off.getMemberNames().front();
-						auto it = dirNames.find(dir);
-						if (it != dirNames.end()) {
-							bi.direction = it->second;
-							delta = off[dir].asFloat();
-						}
-						switch (bi.direction) {
-							case DIRECTION(LEFT): {
-								bi.offset.x = delta + unitDef->GetXSize() * SQUARE_SIZE / 2;
-							} break;
-							case DIRECTION(RIGHT): {
-								bi.offset.x = -(delta + unitDef->GetXSize() * SQUARE_SIZE / 2);
-							} break;
-							case DIRECTION(FRONT): {
-								bi.offset.z = delta + unitDef->GetZSize() * SQUARE_SIZE / 2;
-							} break;
-							case DIRECTION(BACK): {
-								bi.offset.z = -(delta + unitDef->GetZSize() * SQUARE_SIZE / 2);
-							} break;
-							default: break;
-						}
-					}
-
-					bi.condition = SBuildInfo::Condition::ALWAYS;
-					const std::string& cond = part.get("condition", "").asString();
-					if (!cond.empty()) {
-						SBuildInfo::CondName& condNames = SBuildInfo::GetCondNames();
-						auto it = condNames.find(cond);
-						if (it != condNames.end()) {
-							bi.condition = it->second;
-						}
-					}
-
-					queue.push_back(bi);
+				for (const CConfigData::SBuildPart& part : que) {
+					queue.push_back({circuit->GetCircuitDef(part.id), part.buildType, part.offset, part.direction, part.condition});
 				}
-				bc.hub.push_back(queue);
+				bc->hub.push_back(queue);
 			}
-
-			defMap[cdef] = new SBuildChain(bc);
+			defMap[circuit->GetCircuitDef(kv2.first)] = bc;
 		}
 	}
 }
@@ -346,12 +258,15 @@ void CBuilderManager::ReadConfig()
 void CBuilderManager::Init()
 {
 	CSetupManager::StartFunc subinit = [this](const AIFloat3& pos) {
-		CScheduler* scheduler = circuit->GetScheduler().get();
-		const int interval = 8;
-		const int offset = circuit->GetSkirmishAIId() % interval;
-		scheduler->RunTaskEvery(std::make_shared<CGameTask>(&CBuilderManager::UpdateIdle, this), interval, offset + 0);
-		scheduler->RunTaskEvery(std::make_shared<CGameTask>(&CBuilderManager::UpdateBuild, this), interval, offset + 1);
+		CFrameBudget* frameBudget = circuit->GetFrameBudget().get();
+		frameBudget->AddQueue("builder:idle", 2, TEAM_SLOWUPDATE_RATE * 2, TEAM_SLOWUPDATE_RATE * 8,
+				[this]() { return idleTask->GetAssignees().size(); },
+				[this](unsigned int n) { return UpdateIdle(n); });
+		frameBudget->AddQueue("builder:build", 2, TEAM_SLOWUPDATE_RATE * 2, TEAM_SLOWUPDATE_RATE * 8,
+				[this]() { return buildUpdates.size(); },
+				[this](unsigned int n) { return UpdateBuild(n); });
 
+		CScheduler* scheduler = circuit->GetScheduler().get();
 		scheduler->RunTaskEvery(std::make_shared<CGameTask>(&CBuilderManager::Watchdog, this),
 								FRAMES_PER_SEC * 60,
 								circuit->GetSkirmishAIId() * WATCHDOG_COUNT + 10);
@@ -371,12 +286,15 @@ void CBuilderManager::Release()
 	buildUpdates.clear();
 }
 
+bool CBuilderManager::IsInterested(Event event, CCircuitDef::Id unitDefId) const
+{
+	// created, finished: tasks of any unit
+	return (event != Event::DAMAGED) || damagedHandler.Has(unitDefId);
+}
+
 int CBuilderManager::UnitCreated(CCircuitUnit* unit, CCircuitUnit* builder)
 {
-	auto search = createdHandler.find(unit->GetCircuitDef()->GetId());
-	if (search != createdHandler.end()) {
-		search->second(unit, builder);
-	}
+	createdHandler.Call(unit->GetCircuitDef()->GetId(), unit, builder);
 
 	if (builder == nullptr) {
 		CTerrainManager* terrainManager = circuit->GetTerrainManager();
@@ -428,30 +346,21 @@ int CBuilderManager::UnitFinished(CCircuitUnit* unit)
 		AbortTask(itcl->second);
 	}
 
-	auto search = finishedHandler.find(unit->GetCircuitDef()->GetId());
-	if (search != finishedHandler.end()) {
-		search->second(unit);
-	}
+	finishedHandler.Call(unit->GetCircuitDef()->GetId(), unit);
 
 	return 0; //signaling: OK
 }
 
 int CBuilderManager::UnitIdle(CCircuitUnit* unit)
 {
-	auto search = idleHandler.find(unit->GetCircuitDef()->GetId());
-	if (search != idleHandler.end()) {
-		search->second(unit);
-	}
+	idleHandler.Call(unit->GetCircuitDef()->GetId(), unit);
 
 	return 0; //signaling: OK
 }
 
 int CBuilderManager::UnitDamaged(CCircuitUnit* unit, CEnemyUnit* attacker)
 {
-	auto search = damagedHandler.find(unit->GetCircuitDef()->GetId());
-	if (search != damagedHandler.end()) {
-		search->second(unit, attacker);
-	}
+	damagedHandler.Call(unit->GetCircuitDef()->GetId(), unit, attacker);
 
 	return 0; //signaling: OK
 }
@@ -471,10 +380,7 @@ int CBuilderManager::UnitDestroyed(CCircuitUnit* unit, CEnemyUnit* attacker)
 		DoneTask(itcl->second);
 	}
 
-	auto search = destroyedHandler.find(unit->GetCircuitDef()->GetId());
-	if (search != destroyedHandler.end()) {
-		search->second(unit, attacker);
-	}
+	destroyedHandler.Call(unit->GetCircuitDef()->GetId(), unit, attacker);
 
 	return 0; //signaling: OK
 }
@@ -491,7 +397,7 @@ void CBuilderManager::DelBuildPower(CCircuitUnit* unit)
 	circuit->GetMilitaryManager()->DelResponse(unit);
 }
 
-const std::set<IBuilderTask*>& CBuilderManager::GetTasks(IBuilderTask::BuildType type) const
+const CSlotSet<IBuilderTask>& CBuilderManager::GetTasks(IBuilderTask::BuildType type) const
 {
 	assert(type < IBuilderTask::BuildType::_SIZE_);
 	return buildTasks[static_cast<IBuilderTask::BT>(type)];
@@ -616,6 +522,25 @@ IBuilderTask* CBuilderManager::EnqueueReclaim(IBuilderTask::Priority priority,
 	return task;
 }
 
+IBuilderTask* CBuilderManager::EnqueueReclaim(IBuilderTask::Priority priority,
+											  int featureId,
+											  const AIFloat3& position,
+											  float cost,
+											  int timeout,
+											  float radius)
+{
+	auto it = reclaimedFeatures.find(featureId);
+	if (it != reclaimedFeatures.end()) {
+		return it->second;
+	}
+	CBReclaimTask* task = new CBReclaimTask(this, priority, position, cost, timeout, radius, true, featureId);
+	buildTasks[static_cast<IBuilderTask::BT>(IBuilderTask::BuildType::RECLAIM)].insert(task);
+	buildTasksCount++;
+	buildUpdates.push_back(task);
+	reclaimedFeatures[featureId] = task;
+	return task;
+}
+
 IBuilderTask* CBuilderManager::EnqueuePatrol(IBuilderTask::Priority priority,
 											 const AIFloat3& position,
 											 float cost,
@@ -735,21 +660,21 @@ IBuilderTask* CBuilderManager::AddTask(IBuilderTask::Priority priority,
 void CBuilderManager::DequeueTask(IBuilderTask* task, bool done)
 {
 	if ((task->GetType() == IUnitTask::Type::BUILDER) && (task->GetBuildType() < IBuilderTask::BuildType::_SIZE_)) {
-		std::set<IBuilderTask*>& tasks = buildTasks[static_cast<IBuilderTask::BT>(task->GetBuildType())];
-		auto it = tasks.find(task);
-		if (it != tasks.end()) {
+		CSlotSet<IBuilderTask>& tasks = buildTasks[static_cast<IBuilderTask::BT>(task->GetBuildType())];
+		if (tasks.contains(task)) {
 			switch (task->GetBuildType()) {
 				case IBuilderTask::BuildType::REPAIR: {
 					repairedUnits.erase(static_cast<CBRepairTask*>(task)->GetTargetId());
 				} break;
 				case IBuilderTask::BuildType::RECLAIM: {
 					reclaimedUnits.erase(task->GetTarget());
+					reclaimedFeatures.erase(static_cast<CBReclaimTask*>(task)->GetFeatureId());
 				} break;
 				default: {
 					unfinishedUnits.erase(task->GetTarget());
 				} break;
 			}
-			tasks.erase(it);
+			tasks.erase(task);
 			buildTasksCount--;
 		}
 	}
@@ -851,7 +776,7 @@ IBuilderTask* CBuilderManager::MakeCommTask(CCircuitUnit* unit)
 	const int buildDistance = std::max<int>(cdef->GetBuildDistance(), pathfinder->GetSquareSize());
 	const AIFloat3& basePos = circuit->GetSetupManager()->GetBasePos();
 	float metric = std::numeric_limits<float>::max();
-	for (const std::set<IBuilderTask*>& tasks : buildTasks) {
+	for (const CSlotSet<IBuilderTask>& tasks : buildTasks) {
 		for (const IBuilderTask* candidate : tasks) {
 			if (!candidate->CanAssignTo(unit) ||
 				(isNotReady && (candidate->GetBuildDef() != nullptr) && (candidate->GetPriority() != IBuilderTask::Priority::NOW)))
@@ -894,9 +819,8 @@ IBuilderTask* CBuilderManager::MakeCommTask(CCircuitUnit* unit)
 
 			CCircuitUnit* target = candidate->GetTarget();
 			if ((target != nullptr) && (distCost * weight < metric)) {
-				Unit* tu = target->GetUnit();
-				const float maxHealth = tu->GetMaxHealth();
-				const float health = tu->GetHealth() - maxHealth * 0.005f;
+				const float maxHealth = target->GetMaxHealth(frame);
+				const float health = target->GetHealth(frame) - maxHealth * 0.005f;
 				const float healthSpeed = maxHealth * candidate->GetBuildPower() / candidate->GetCost();
 				valid = ((maxHealth - health) * 0.6f) * maxSpeed > healthSpeed * distCost;
 			} else {
@@ -954,7 +878,7 @@ IBuilderTask* CBuilderManager::MakeBuilderTask(CCircuitUnit* unit)
 	const float maxThreat = threatMap->GetUnitThreat(unit);
 	const int buildDistance = std::max<int>(cdef->GetBuildDistance(), pathfinder->GetSquareSize());
 	float metric = std::numeric_limits<float>::max();
-	for (const std::set<IBuilderTask*>& tasks : buildTasks) {
+	for (const CSlotSet<IBuilderTask>& tasks : buildTasks) {
 		for (const IBuilderTask* candidate : tasks) {
 			if (!candidate->CanAssignTo(unit) || (isNotReady &&
 												  (candidate->GetPriority() != IBuilderTask::Priority::NOW) &&
@@ -1004,9 +928,8 @@ IBuilderTask* CBuilderManager::MakeBuilderTask(CCircuitUnit* unit)
 			if (target != nullptr) {
 				if (distCost * weight < metric) {
 					// BA: float time_to_build = targetDef->GetBuildTime() / workerDef->GetBuildSpeed();
-					Unit* tu = target->GetUnit();
-					const float maxHealth = tu->GetMaxHealth();
-					const float health = tu->GetHealth() - maxHealth * 0.005f;
+					const float maxHealth = target->GetMaxHealth(frame);
+					const float health = target->GetHealth(frame) - maxHealth * 0.005f;
 					const float healthSpeed = maxHealth * candidate->GetBuildPower() / candidate->GetCost();
 					valid = (((maxHealth - health) * 0.6f) * maxSpeed > healthSpeed * distCost);
 				}
@@ -1059,7 +982,7 @@ IBuilderTask* CBuilderManager::CreateBuilderTask(const AIFloat3& position, CCirc
 		CMilitaryManager* militaryManager = circuit->GetMilitaryManager();
 		buildDef = militaryManager->GetBigGunDef();
 		if ((buildDef != nullptr) && (buildDef->GetCost() < super.maxTime * metalIncome)) {
-			const std::set<IBuilderTask*>& tasks = GetTasks(IBuilderTask::BuildType::BIG_GUN);
+			const CSlotSet<IBuilderTask>& tasks = GetTasks(IBuilderTask::BuildType::BIG_GUN);
 			if (tasks.empty()) {
 				if (buildDef->IsAvailable(circuit->GetLastFrame()) && militaryManager->IsNeedBigGun(buildDef)) {
 					AIFloat3 pos = militaryManager->GetBigGunPos(buildDef);
@@ -1129,6 +1052,7 @@ void CBuilderManager::Watchdog()
 	SCOPED_TIME(circuit, __PRETTY_FUNCTION__);
 	CEconomyManager* economyManager = circuit->GetEconomyManager();
 	Resource* metalRes = economyManager->GetMetalRes();
+	const int frame = circuit->GetLastFrame();
 	// somehow workers get stuck
 	for (CCircuitUnit* worker : workers) {
 		if (worker->GetTask()->GetType() == IUnitTask::Type::PLAYER) {
@@ -1137,7 +1061,7 @@ void CBuilderManager::Watchdog()
 		Unit* u = worker->GetUnit();
 		auto commands = std::move(u->GetCurrentCommands());
 		// TODO: Ignore workers with idle and wait task? (.. && worker->GetTask()->IsBusy())
-		if (commands.empty() && (u->GetResourceUse(metalRes) == .0f) && (u->GetVel() == ZeroVector)) {
+		if (commands.empty() && (u->GetResourceUse(metalRes) == .0f) && (worker->GetVel(frame) == ZeroVector)) {
 			worker->GetTask()->OnUnitMoveFailed(worker);
 		}
 		utils::free_clear(commands);
@@ -1153,10 +1077,9 @@ void CBuilderManager::Watchdog()
 			(repairedUnits.find(unit->GetId()) == repairedUnits.end()) &&
 			(reclaimedUnits.find(unit) == reclaimedUnits.end()))
 		{
-			Unit* u = unit->GetUnit();
-			if (u->IsBeingBuilt()) {
-				float maxHealth = u->GetMaxHealth();
-				float buildPercent = (maxHealth - u->GetHealth()) / maxHealth;
+			if (unit->IsBeingBuilt(frame)) {
+				float maxHealth = unit->GetMaxHealth(frame);
+				float buildPercent = (maxHealth - unit->GetHealth(frame)) / maxHealth;
 				CCircuitDef* cdef = unit->GetCircuitDef();
 				if ((cdef->GetBuildTime() * buildPercent < maxCost) || (*cdef == *terraDef)) {
 					EnqueueRepair(IBuilderTask::Priority::NORMAL, unit);
@@ -1170,13 +1093,13 @@ void CBuilderManager::Watchdog()
 	}
 }
 
-void CBuilderManager::UpdateIdle()
+unsigned int CBuilderManager::UpdateIdle(unsigned int n)
 {
 	SCOPED_TIME(circuit, __PRETTY_FUNCTION__);
-	idleTask->Update();
+	return idleTask->UpdateSlice(n);
 }
 
-void CBuilderManager::UpdateBuild()
+unsigned int CBuilderManager::UpdateBuild(unsigned int n)
 {
 	SCOPED_TIME(circuit, __PRETTY_FUNCTION__);
 	if (buildIterator >= buildUpdates.size()) {
@@ -1184,8 +1107,7 @@ void CBuilderManager::UpdateBuild()
 	}
 
 	int lastFrame = circuit->GetLastFrame();
-	// stagger the Update's
-	unsigned int n = (buildUpdates.size() / TEAM_SLOWUPDATE_RATE) + 1;
+	const unsigned int total = n;
 
 	while ((buildIterator < buildUpdates.size()) && (n != 0)) {
 		IUnitTask* task = buildUpdates[buildIterator];
@@ -1205,6 +1127,7 @@ void CBuilderManager::UpdateBuild()
 			n--;
 		}
 	}
+	return total - n;
 }
 
 void CBuilderManager::UpdateAreaUsers()
@@ -1241,47 +1164,115 @@ void CBuilderManager::UpdateAreaUsers()
 
 void CBuilderManager::Load(std::istream& is)
 {
-//	std::streamsize y;
-//	int yo, yoyo;
-//	is >> y;
-//	is.seekg(is.tellg() + std::streampos(sizeof('\n')));
-//	is.read(reinterpret_cast<char*>(&yo), sizeof(yo));
-//	is.read(reinterpret_cast<char*>(&yoyo), sizeof(yoyo));
-//	circuit->LOG("LOAD ID: %i | %i | %i", y, yo, yoyo);
-
 	/*
-	 * Restore data
+	 * Restore construction tasks and assignees, records are {size, data}
 	 */
-//	for (IUnitTask* task : buildUpdates) {
-//		if (task->GetType() != IUnitTask::Type::BUILDER) {
-//			continue;
-//		}
-//		IBuilderTask* bt = static_cast<IBuilderTask*>(task);
-//		if (bt->GetBuildType() < IBuilderTask::BuildType::_SIZE_) {
-//			buildTasks[static_cast<IBuilderTask::BT>(bt->GetBuildType())].insert(bt);
-//			buildTasksCount++;
-//		}
-//	}
+	uint32_t size = 0;
+	utils::binary_read(is, size);
+	std::vector<char> data;
+	for (uint32_t i = 0; i < size; ++i) {
+		if (!utils::binary_read(is, data)) {
+			return;
+		}
+		std::istringstream record(std::string(data.begin(), data.end()));
+		IBuilderTask::BuildType buildType;
+		CCircuitDef::Id bdefId;
+		AIFloat3 position;
+		float cost;
+		utils::binary_read(record, buildType);
+		utils::binary_read(record, bdefId);
+		utils::binary_read(record, position);
+		utils::binary_read(record, cost);
+		CCircuitDef* buildDef = circuit->GetCircuitDef(bdefId);
+		if (!record || (buildDef == nullptr) || !IsRestorable(buildType)) {
+			continue;  // skip unknown record
+		}
+
+		IBuilderTask* task = EnqueueTask(IBuilderTask::Priority::NORMAL, buildDef, position, buildType, cost, .0f);
+		record >> *task;
+
+		AIFloat3 buildPos;
+		int facing;
+		std::vector<ICoreUnit::Id> unitIds;
+		utils::binary_read(record, buildPos);
+		utils::binary_read(record, facing);
+		utils::binary_read(record, unitIds);
+		if (!record) {
+			AbortTask(task);
+			continue;
+		}
+		task->SetFacing(facing);
+		if (utils::is_valid(buildPos)) {
+			task->SetBuildPos(buildPos);
+			circuit->GetTerrainManager()->AddBlocker(buildDef, buildPos, facing);
+		}
+
+		for (ICoreUnit::Id unitId : unitIds) {
+			CCircuitUnit* unit = circuit->GetTeamUnit(unitId);
+			if ((unit != nullptr) && (unit->GetTask() != task) && task->CanAssignTo(unit)) {
+				AssignTask(unit, task);
+			}
+		}
+	}
 }
 
 void CBuilderManager::Save(std::ostream& os) const
 {
-//	std::stringstream tmp;
-//	int i = circuit->GetSkirmishAIId();
-//	tmp.write(reinterpret_cast<const char*>(&i), sizeof(i));
-//	i = 42;
-//	tmp.write(reinterpret_cast<const char*>(&i), sizeof(i));
-//	os << std::streamsize(1024) << '\n' << tmp.rdbuf();
-
 	/*
-	 * Save tasks
+	 * Save construction tasks, others are recreated by unit events on load
 	 */
-//	int size = buildUpdates.size();
-//	os.write(reinterpret_cast<const char*>(&size), sizeof(size));
-//	for (IUnitTask* task : buildUpdates) {
-//		os << *task;
-//	}
-//	os.write(reinterpret_cast<const char*>(&buildIterator), sizeof(buildIterator));
+	std::vector<IBuilderTask*> tasks;
+	for (const CSlotSet<IBuilderTask>& bucket : buildTasks) {
+		for (IBuilderTask* task : bucket) {
+			if (!task->IsDead() && IsRestorable(task->GetBuildType())) {
+				tasks.push_back(task);
+			}
+		}
+	}
+
+	const uint32_t size = tasks.size();
+	utils::binary_write(os, size);
+	std::ostringstream record;
+	for (IBuilderTask* task : tasks) {
+		record.str("");
+		const CCircuitDef::Id bdefId = task->GetBuildDef()->GetId();
+		utils::binary_write(record, task->GetBuildType());
+		utils::binary_write(record, bdefId);
+		utils::binary_write(record, task->GetTaskPos());
+		utils::binary_write(record, task->GetCost());
+		record << *task;
+
+		std::vector<ICoreUnit::Id> unitIds;
+		unitIds.reserve(task->GetAssignees().size());
+		for (CCircuitUnit* unit : task->GetAssignees()) {
+			unitIds.push_back(unit->GetId());
+		}
+		utils::binary_write(record, task->GetBuildPos());
+		utils::binary_write(record, task->GetFacing());
+		utils::binary_write(record, unitIds);
+
+		const std::string data = record.str();
+		utils::binary_write(os, std::vector<char>(data.begin(), data.end()));
+	}
+}
+
+bool CBuilderManager::IsRestorable(IBuilderTask::BuildType type)
+{
+	// NOTE: Types created by AddTask from definition and position only
+	switch (type) {
+		case IBuilderTask::BuildType::NANO:
+		case IBuilderTask::BuildType::STORE:
+		case IBuilderTask::BuildType::ENERGY:
+		case IBuilderTask::BuildType::DEFENCE:
+		case IBuilderTask::BuildType::BUNKER:
+		case IBuilderTask::BuildType::BIG_GUN:
+		case IBuilderTask::BuildType::RADAR:
+		case IBuilderTask::BuildType::SONAR:
+		case IBuilderTask::BuildType::MEX:
+			return true;
+		default:
+			return false;
+	}
 }
 
 } // namespace circuit
@@ -16,6 +16,7 @@
 #include <map>
 #include <set>
 #include <vector>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace springai {
@@ -42,6 +43,7 @@ private:
 public:
 	void Release();
 
+	virtual bool IsInterested(Event event, CCircuitDef::Id unitDefId) const override;
 	virtual int UnitCreated(CCircuitUnit* unit, CCircuitUnit* builder) override;
 	virtual int UnitFinished(CCircuitUnit* unit) override;
 	virtual int UnitIdle(CCircuitUnit* unit) override;
@@ -55,7 +57,7 @@ public:
 	void DelBuildPower(CCircuitUnit* unit);
 	float GetBuildPower() const { return buildPower; }
 	bool CanEnqueueTask(const unsigned mod = 8) const { return buildTasksCount < workers.size() * mod; }
-	const std::set<IBuilderTask*>& GetTasks(IBuilderTask::BuildType type) const;
+	const CSlotSet<IBuilderTask>& GetTasks(IBuilderTask::BuildType type) const;
 	void ActivateTask(IBuilderTask* task);
 
 	IBuilderTask* EnqueueTask(IBuilderTask::Priority priority,
@@ -99,6 +101,12 @@ public:
 	IBuilderTask* EnqueueReclaim(IBuilderTask::Priority priority,
 								 CCircuitUnit* target,
 								 int timeout = ASSIGN_TIMEOUT);
+	IBuilderTask* EnqueueReclaim(IBuilderTask::Priority priority,
+								 int featureId,
+								 const springai::AIFloat3& position,
+								 float cost,
+								 int timeout,
+								 float radius = .0f);
 	IBuilderTask* EnqueuePatrol(IBuilderTask::Priority priority,
 								const springai::AIFloat3& position,
 								float cost,
@@ -147,8 +155,8 @@ private:
 	void RemoveBuildList(CCircuitUnit* unit);
 
 	void Watchdog();
-	void UpdateIdle();
-	void UpdateBuild();
+	unsigned int UpdateIdle(unsigned int n);
+	unsigned int UpdateBuild(unsigned int n);
 
 	Handlers2 createdHandler;
 	Handlers1 finishedHandler;
@@ -159,7 +167,8 @@ private:
 	std::map<CAllyUnit*, IBuilderTask*> unfinishedUnits;
 	std::map<ICoreUnit::Id, CBRepairTask*> repairedUnits;
 	std::map<CAllyUnit*, CBReclaimTask*> reclaimedUnits;
-	std::vector<std::set<IBuilderTask*>> buildTasks;  // UnitDef based tasks
+	std::map<int, CBReclaimTask*> reclaimedFeatures;  // feature id
+	std::vector<CSlotSet<IBuilderTask>> buildTasks;  // UnitDef based tasks
 	unsigned int buildTasksCount;
 	float buildPower;
 	std::vector<IUnitTask*> buildUpdates;  // owner
@@ -183,6 +192,7 @@ private:
 
 	virtual void Load(std::istream& is) override;
 	virtual void Save(std::ostream& os) const override;
+	static bool IsRestorable(IBuilderTask::BuildType type);
 };
 
 } // namespace circuit
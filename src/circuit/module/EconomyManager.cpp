@@ -10,22 +10,21 @@
 #include "module/FactoryManager.h"
 #include "module/MilitaryManager.h"
 #include "setup/SetupManager.h"
+#include "setup/ConfigData.h"
 #include "resource/MetalManager.h"
 #include "resource/EnergyGrid.h"
+#include "resource/FeatureData.h"
 #include "terrain/TerrainManager.h"
 #include "CircuitAI.h"
 #include "util/math/LagrangeInterPol.h"
 #include "util/Scheduler.h"
 #include "util/utils.h"
-#include "json/json.h"
 
 #include "AISCommands.h"
 #include "OOAICallback.h"
 #include "Map.h"
 #include "Resource.h"
 #include "Economy.h"
-#include "Feature.h"
-#include "FeatureDef.h"
 #include "Team.h"
 #include "Log.h"
 
@@ -265,54 +264,38 @@ CEconomyManager::~CEconomyManager()
 
 void CEconomyManager::ReadConfig()
 {
-	const Json::Value& root = circuit->GetSetupManager()->GetConfig();
-	const std::string& cfgName = circuit->GetSetupManager()->GetConfigName();
-	const Json::Value& econ = root["economy"];
-	ecoStep = econ.get("eps_step", 0.25f).asFloat();
+	const CConfigData::SEconomy& econ = circuit->GetSetupManager()->GetConfigData()->GetEconomy();
+	ecoStep = econ.epsStep;
 	ecoFactor = (circuit->GetAllyTeam()->GetSize() - 1.0f) * ecoStep + 1.0f;
-	metalMod = (1.f - econ.get("excess", -1.f).asFloat());
-	switchTime = econ.get("switch", 900).asInt() * FRAMES_PER_SEC;
-	const float bd = econ.get("build_delay", -1.f).asFloat();
-	buildDelay = (bd > 0.f) ? (bd * FRAMES_PER_SEC) : 0;
-
-	const Json::Value& energy = econ["energy"];
-	const Json::Value& factor = energy["factor"];
-	efInfo.startFactor = factor[0].get((unsigned)0, 0.5f).asFloat();
-	efInfo.startFrame = factor[0].get((unsigned)1, 300 ).asInt() * FRAMES_PER_SEC;
-	efInfo.endFactor = factor[1].get((unsigned)0, 2.0f).asFloat();
-	efInfo.endFrame = factor[1].get((unsigned)1, 3600).asInt() * FRAMES_PER_SEC;
+	metalMod = (1.f - econ.excess);
+	switchTime = econ.switchTime;
+	buildDelay = econ.buildDelay;
+
+	efInfo.startFactor = econ.startFactor;
+	efInfo.startFrame = econ.startFrame;
+	efInfo.endFactor = econ.endFactor;
+	efInfo.endFrame = econ.endFrame;
 	efInfo.fraction = (efInfo.endFactor - efInfo.startFactor) / (efInfo.endFrame - efInfo.startFrame);
 	energyFactor = efInfo.startFactor;
 
 	// Using cafus, armfus, armsolar as control points
 	// FIXME: Дабы ветка параболы заработала надо использовать [x <= 0; y < min limit) для точки перегиба
-	constexpr unsigned MAX_CTRL_POINTS = 3;
-	std::vector<std::pair<std::string, int>> engies;
-	std::string type = circuit->GetTerrainManager()->IsWaterMap() ? "water" : "land";
-	const Json::Value& surf = energy[type];
-	unsigned si = 0;
-	for (const std::string& engy : surf.getMemberNames()) {
-		const int min = surf[engy][0].asInt();
-		const int max = surf[engy].get(1, min).asInt();
-		const int limit = min + rand() % (max - min + 1);
-		engies.push_back(std::make_pair(engy, limit));
-		if (++si >= MAX_CTRL_POINTS) {
-			break;
-		}
-	}
+	const std::vector<CConfigData::SEconomy::SEnergy>& engies = circuit->GetTerrainManager()->IsWaterMap()
+			? econ.waterEnergies
+			: econ.landEnergies;
 
 	CLagrangeInterPol::Vector x(engies.size()), y(engies.size());
 	for (unsigned i = 0; i < engies.size(); ++i) {
-		CCircuitDef* cdef = circuit->GetCircuitDef(engies[i].first.c_str());
-		if (cdef == nullptr) {
-			circuit->LOG("CONFIG %s: has unknown UnitDef '%s'", cfgName.c_str(), engies[i].first.c_str());
+		const int limit = engies[i].min + rand() % (engies[i].max - engies[i].min + 1);
+		if (engies[i].id < 0) {
 			continue;
 		}
+		CCircuitDef* cdef = circuit->GetCircuitDef(engies[i].id);
 		const std::map<std::string, std::string>& customParams = cdef->GetUnitDef()->GetCustomParams();
 		auto it = customParams.find("income_energy");
 		float make = (it != customParams.end()) ? utils::string_to_float(it->second) : 1.f;
 		x[i] = cdef->GetCost() / make;
-		y[i] = engies[i].second + 0.5;  // +0.5 to be sure precision errors will not decrease integer part
+		y[i] = limit + 0.5;  // +0.5 to be sure precision errors will not decrease integer part
 	}
 	engyPol = new CLagrangeInterPol(x, y);  // Alternatively use CGaussSolver to compute polynomial - faster on reuse
 
@@ -327,7 +310,7 @@ void CEconomyManager::ReadConfig()
 //	circuit->LOG("y = %f*x^0 + %f*x^1 + %f*x^2", r[0], r[1], r[2]);
 
 	// NOTE: Must have
-	defaultDef = circuit->GetCircuitDef(econ["default"].asCString());
+	defaultDef = (econ.defaultDef >= 0) ? circuit->GetCircuitDef(econ.defaultDef) : nullptr;
 	if (defaultDef == nullptr) {
 		throw CException("economy.default");
 	}
@@ -340,23 +323,23 @@ void CEconomyManager::Init()
 	const size_t clSize = circuit->GetMetalManager()->GetClusters().size();
 	clusterInfos.resize(clSize, {nullptr, -FRAMES_PER_SEC});
 	const size_t spSize = circuit->GetMetalManager()->GetSpots().size();
-	openSpots.resize(spSize, true);
+	openSpots.Resize(spSize, true);
 
-	const Json::Value& econ = circuit->GetSetupManager()->GetConfig()["economy"];
-	const float mm = econ.get("mex_max", 2.f).asFloat();
+	const CConfigData::SEconomy& econ = circuit->GetSetupManager()->GetConfigData()->GetEconomy();
+	const float mm = econ.mexMax;
 	mexMax = (mm < 1.f) ? (mm * spSize) : std::numeric_limits<decltype(mexMax)>::max();
 
-	const Json::Value& pull = econ["ms_pull"];
+	const std::vector<std::pair<float, float>>& pull = econ.msPull;
 	mspInfos.resize(pull.size());
 	mspInfos.push_back(SPullMtoS {
-		.pull = pull[0].get((unsigned)0, 1.0f).asFloat(),
-		.mex = (int)(pull[0].get((unsigned)1, 0.0f).asFloat() * spSize),
+		.pull = pull.empty() ? 1.0f : pull[0].first,
+		.mex = (int)((pull.empty() ? 0.0f : pull[0].second) * spSize),
 		.fraction = 0.f
 	});
 	for (unsigned i = 1; i < pull.size(); ++i) {
 		SPullMtoS mspInfoEnd;
-		mspInfoEnd.pull = pull[i].get((unsigned)0, 0.25f).asFloat();
-		mspInfoEnd.mex = pull[i].get((unsigned)1, 0.75f).asFloat() * spSize;
+		mspInfoEnd.pull = pull[i].first;
+		mspInfoEnd.mex = pull[i].second * spSize;
 		mspInfoEnd.fraction = 0.f;
 		mspInfos.push_back(mspInfoEnd);
 		SPullMtoS& mspInfoBegin = mspInfos[i - 1];
@@ -406,22 +389,25 @@ void CEconomyManager::Init()
 	circuit->GetSetupManager()->ExecOnFindStart(subinit);
 }
 
-int CEconomyManager::UnitCreated(CCircuitUnit* unit, CCircuitUnit* builder)
+bool CEconomyManager::IsInterested(Event event, CCircuitDef::Id unitDefId) const
 {
-	auto search = createdHandler.find(unit->GetCircuitDef()->GetId());
-	if (search != createdHandler.end()) {
-		search->second(unit, builder);
+	switch (event) {
+		case Event::CREATED:  return createdHandler.Has(unitDefId);
+		case Event::FINISHED: return finishedHandler.Has(unitDefId);
+		default: return true;  // damaged: morph of any unit
 	}
+}
+
+int CEconomyManager::UnitCreated(CCircuitUnit* unit, CCircuitUnit* builder)
+{
+	createdHandler.Call(unit->GetCircuitDef()->GetId(), unit, builder);
 
 	return 0; //signaling: OK
 }
 
 int CEconomyManager::UnitFinished(CCircuitUnit* unit)
 {
-	auto search = finishedHandler.find(unit->GetCircuitDef()->GetId());
-	if (search != finishedHandler.end()) {
-		search->second(unit);
-	}
+	finishedHandler.Call(unit->GetCircuitDef()->GetId(), unit);
 
 	return 0; //signaling: OK
 }
@@ -429,7 +415,8 @@ int CEconomyManager::UnitFinished(CCircuitUnit* unit)
 int CEconomyManager::UnitDamaged(CCircuitUnit* unit, CEnemyUnit* attacker)
 {
 	// NOTE: If more actions should be done then consider moving into damagedHandler
-	if (unit->IsMorphing() && (unit->GetUnit()->GetHealth() < unit->GetUnit()->GetMaxHealth() * 0.5f)) {
+	const int frame = circuit->GetLastFrame();
+	if (unit->IsMorphing() && (unit->GetHealth(frame) < unit->GetMaxHealth(frame) * 0.5f)) {
 		unit->StopUpgrade();  // StopMorph();
 		AddMorphee(unit);
 	}
@@ -439,10 +426,7 @@ int CEconomyManager::UnitDamaged(CCircuitUnit* unit, CEnemyUnit* attacker)
 
 int CEconomyManager::UnitDestroyed(CCircuitUnit* unit, CEnemyUnit* attacker)
 {
-	auto search = destroyedHandler.find(unit->GetCircuitDef()->GetId());
-	if (search != destroyedHandler.end()) {
-		search->second(unit, attacker);
-	}
+	destroyedHandler.Call(unit->GetCircuitDef()->GetId(), unit, attacker);
 
 	return 0; //signaling: OK
 }
@@ -628,13 +612,30 @@ bool CEconomyManager::IsAllyOpenSpot(int spotId) const
 
 void CEconomyManager::SetOpenSpot(int spotId, bool value)
 {
-	if (openSpots[spotId] == value) {
+	if (openSpots.Test(spotId) == value) {
 		return;
 	}
-	openSpots[spotId] = value;
+	openSpots.Set(spotId, value);
 	value ? --mexCount : ++mexCount;
 }
 
+void CEconomyManager::GetAllyOpenSpots(CMetalData::SMask& outMask) const
+{
+	outMask = circuit->GetMetalManager()->GetOpenSpots();
+	if (mexCount < mexMax) {
+		outMask.And(openSpots);
+	} else {
+		outMask.Clear();
+	}
+}
+
+void CEconomyManager::FilterClosedSpots(CMetalData::SMask& mask) const
+{
+	if (mexCount < mexMax) {
+		mask.AndNot(openSpots);
+	}
+}
+
 bool CEconomyManager::IsIgnorePull(const IBuilderTask* task) const
 {
 	if (mexMax != std::numeric_limits<decltype(mexMax)>::max()) {
@@ -698,25 +699,25 @@ IBuilderTask* CEconomyManager::UpdateMetalTasks(const AIFloat3& position, CCircu
 			CTerrainManager* terrainManager = circuit->GetTerrainManager();
 			const CMetalData::Metals& spots = metalManager->GetSpots();
 			Map* map = circuit->GetMap();
+			static CMetalData::SMask openMask;  // NOTE: micro-opt
+			GetAllyOpenSpots(openMask);
 			CMetalData::PointPredicate predicate;
 			if (unit != nullptr) {
 				CCircuitDef* mexDef = this->mexDef;
-				predicate = [this, &spots, map, mexDef, terrainManager, unit](int index) {
-					return (IsAllyOpenSpot(index) &&
-							terrainManager->CanBeBuiltAtSafe(mexDef, spots[index].position) &&  // hostile environment
+				predicate = [&spots, map, mexDef, terrainManager, unit](int index) {
+					return (terrainManager->CanBeBuiltAtSafe(mexDef, spots[index].position) &&  // hostile environment
 							terrainManager->CanBuildAtSafe(unit, spots[index].position) &&
 							map->IsPossibleToBuildAt(mexDef->GetUnitDef(), spots[index].position, UNIT_COMMAND_BUILD_NO_FACING));
 				};
 			} else {
 				CCircuitDef* mexDef = this->mexDef;
-				predicate = [this, &spots, map, mexDef, terrainManager, builderManager](int index) {
-					return (IsAllyOpenSpot(index) &&
-							terrainManager->CanBeBuiltAtSafe(mexDef, spots[index].position) &&  // hostile environment
+				predicate = [&spots, map, mexDef, terrainManager, builderManager](int index) {
+					return (terrainManager->CanBeBuiltAtSafe(mexDef, spots[index].position) &&  // hostile environment
 							builderManager->IsBuilderInArea(mexDef, spots[index].position) &&
 							map->IsPossibleToBuildAt(mexDef->GetUnitDef(), spots[index].position, UNIT_COMMAND_BUILD_NO_FACING));
 				};
 			}
-			int index = metalManager->GetMexToBuild(position, predicate);
+			int index = metalManager->GetMexToBuild(position, openMask, predicate);
 			if (index != -1) {
 				int cluster = metalManager->GetCluster(index);
 				if (!circuit->GetMilitaryManager()->HasDefence(cluster)) {
@@ -748,60 +749,20 @@ IBuilderTask* CEconomyManager::UpdateReclaimTasks(const AIFloat3& position, CCir
 		return nullptr;
 	}
 
-	std::vector<Feature*> features;
-	if (isNear) {
-		const float distance = unit->GetCircuitDef()->GetSpeed() * ((GetMetalPull() * 0.8f > GetAvgMetalIncome()) ? 300 : 30);
-		features = std::move(circuit->GetCallback()->GetFeaturesIn(position, distance));
-	} else {
-		features = std::move(circuit->GetCallback()->GetFeatures());
-	}
-	if (features.empty()) {
-		return nullptr;
-	}
-
+	const float distance = isNear
+			? unit->GetCircuitDef()->GetSpeed() * ((GetMetalPull() * 0.8f > GetAvgMetalIncome()) ? 300 : 30)
+			: std::numeric_limits<float>::max();
 	CTerrainManager* terrainManager = circuit->GetTerrainManager();
-	AIFloat3 pos;
-	float cost = .0f;
-	float minSqDist = std::numeric_limits<float>::max();
-	for (Feature* feature : features) {
-		AIFloat3 featPos = feature->GetPosition();
-		CTerrainManager::CorrectPosition(featPos);  // Impulsed flying feature
-		if (!terrainManager->CanBuildAtSafe(unit, featPos)) {
-			continue;
-		}
-		FeatureDef* featDef = feature->GetDef();
-		if (!featDef->IsReclaimable()) {
-			delete featDef;
-			continue;
-		}
-		float reclaimValue = featDef->GetContainedResource(metalRes)/* * feature->GetReclaimLeft()*/;
-		delete featDef;
-		if (reclaimValue < 1.0f) {
-			continue;
-		}
-		float sqDist = position.SqDistance2D(featPos);
-		if (sqDist < minSqDist) {
-			pos = featPos;
-			cost = reclaimValue;
-			minSqDist = sqDist;
-		}
-	}
-	IBuilderTask* task = nullptr;
-	if (minSqDist < std::numeric_limits<float>::max()) {
-		for (IBuilderTask* t : builderManager->GetTasks(IBuilderTask::BuildType::RECLAIM)) {
-			if (utils::is_equal_pos(pos, t->GetTaskPos())) {
-				task = t;
-				break;
-			}
-		}
-		if (task == nullptr) {
-			task = builderManager->EnqueueReclaim(IBuilderTask::Priority::HIGH, pos, cost, FRAMES_PER_SEC * 300,
-												  8.0f/*unit->GetCircuitDef()->GetBuildDistance()*/);
-		}
+	const CFeatureData::SFeature* feature = circuit->GetAllyTeam()->GetFeatureData()->FindNearest(position, distance, 1.0f,
+		[terrainManager, unit](const CFeatureData::SFeature& f) {
+			return terrainManager->CanBuildAtSafe(unit, f.pos);
+		});
+	if (feature == nullptr) {
+		return nullptr;
 	}
-	utils::free_clear(features);
 
-	return task;
+	return builderManager->EnqueueReclaim(IBuilderTask::Priority::HIGH, feature->id, feature->pos, feature->value,
+										  FRAMES_PER_SEC * 300, 8.0f/*unit->GetCircuitDef()->GetBuildDistance()*/);
 }
 
 IBuilderTask* CEconomyManager::UpdateEnergyTasks(const AIFloat3& position, CCircuitUnit* unit)
@@ -915,7 +876,7 @@ IBuilderTask* CEconomyManager::UpdateFactoryTasks(const AIFloat3& position, CCir
 	CFactoryManager* factoryManager = circuit->GetFactoryManager();
 	CMilitaryManager* militaryManager = circuit->GetMilitaryManager();
 	CCircuitDef* airpadDef = factoryManager->GetAirpadDef();
-	const std::set<IBuilderTask*> &factoryTasks = builderManager->GetTasks(IBuilderTask::BuildType::FACTORY);
+	const CSlotSet<IBuilderTask>& factoryTasks = builderManager->GetTasks(IBuilderTask::BuildType::FACTORY);
 	const unsigned airpadFactor = SQUARE((airpadDef->GetCount() + factoryTasks.size()) * 4);
 	const int frame = circuit->GetLastFrame();
 	if (airpadDef->IsAvailable(frame) &&
@@ -1189,11 +1150,12 @@ void CEconomyManager::UpdateMorph()
 		return;
 	}
 
+	const int frame = circuit->GetLastFrame();
 	auto it = morphees.begin();
 	while (it != morphees.end()) {
 		CCircuitUnit* unit = *it;
 		if ((unit->GetTask()->GetType() == IUnitTask::Type::PLAYER) ||
-			(unit->GetUnit()->GetHealth() < unit->GetUnit()->GetMaxHealth() * 0.8f))
+			(unit->GetHealth(frame) < unit->GetMaxHealth(frame) * 0.8f))
 		{
 			++it;
 		} else {
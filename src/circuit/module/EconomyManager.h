@@ -9,6 +9,7 @@
 #define SRC_CIRCUIT_MODULE_ECONOMYMANAGER_H_
 
 #include "module/Module.h"
+#include "resource/MetalData.h"
 
 #include "AIFloat3.h"
 
@@ -40,6 +41,7 @@ private:
 	void Init();
 
 public:
+	virtual bool IsInterested(Event event, CCircuitDef::Id unitDefId) const override;
 	virtual int UnitCreated(CCircuitUnit* unit, CCircuitUnit* builder) override;
 	virtual int UnitFinished(CCircuitUnit* unit) override;
 	virtual int UnitDamaged(CCircuitUnit* unit, CEnemyUnit* attacker) override;
@@ -72,8 +74,10 @@ public:
 	int GetBuildDelay() const { return buildDelay; }
 
 	bool IsAllyOpenSpot(int spotId) const;
-	bool IsOpenSpot(int spotId) const { return openSpots[spotId] && (mexCount < mexMax); }
+	bool IsOpenSpot(int spotId) const { return openSpots.Test(spotId) && (mexCount < mexMax); }
 	void SetOpenSpot(int spotId, bool value);
+	void GetAllyOpenSpots(CMetalData::SMask& outMask) const;  // IsAllyOpenSpot
+	void FilterClosedSpots(CMetalData::SMask& mask) const;  // mask & !IsOpenSpot
 	bool IsIgnorePull(const IBuilderTask* task) const;
 	bool IsIgnoreStallingPull(const IBuilderTask* task) const;
 
@@ -119,7 +123,7 @@ private:
 
 	// NOTE: MetalManager::SetOpenSpot used by whole allyTeam. Therefore
 	//       local spot's state descriptor needed for better expansion
-	std::vector<bool> openSpots;  // AI-local metal info
+	CMetalData::SMask openSpots;  // AI-local metal info
 	int mexCount;
 
 	std::set<CCircuitDef*> allEnergyDefs;
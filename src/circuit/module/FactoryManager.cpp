@@ -10,7 +10,10 @@
 #include "module/BuilderManager.h"
 #include "module/MilitaryManager.h"
 #include "setup/SetupManager.h"
+#include "setup/ConfigData.h"
+#include "resource/FeatureData.h"
 #include "terrain/TerrainManager.h"
+#include "terrain/HavenField.h"
 #include "task/NilTask.h"
 #include "task/IdleTask.h"
 #include "task/static/WaitTask.h"
@@ -18,15 +21,14 @@
 #include "task/static/ReclaimTask.h"
 #include "unit/FactoryData.h"
 #include "CircuitAI.h"
+#include "util/FrameBudget.h"
 #include "util/Scheduler.h"
 #include "util/utils.h"
-#include "json/json.h"
 
 #include "AIFloat3.h"
 #include "OOAICallback.h"
 #include "AISCommands.h"
 #include "Command.h"
-#include "Feature.h"
 #include "Log.h"
 
 namespace circuit {
@@ -42,6 +44,7 @@ CFactoryManager::CFactoryManager(CCircuitAI* circuit)
 		, reWeight(.5f)
 {
 	circuit->GetScheduler()->RunOnInit(std::make_shared<CGameTask>(&CFactoryManager::Init, this));
+	havenField = new CHavenField(circuit->GetTerrainManager(), havens);
 
 	/*
 	 * factory handlers
@@ -100,7 +103,7 @@ CFactoryManager::CFactoryManager(CCircuitAI* circuit)
 		int frame = this->circuit->GetLastFrame();
 		const AIFloat3& assPos = unit->GetPos(frame);
 		TRY_UNIT(this->circuit, unit,
-			unit->GetUnit()->ExecuteCustomCommand(CMD_PRIORITY, {0.0f});
+			unit->CmdPriority(0.0f);
 		)
 
 		// check factory nano belongs to
@@ -126,6 +129,7 @@ CFactoryManager::CFactoryManager(CCircuitAI* circuit)
 			}
 			if (!isInHaven) {
 				havens.push_back(assPos);
+				havenField->AddHaven();
 				// TODO: Send HavenFinished message?
 			}
 		}
@@ -154,6 +158,7 @@ CFactoryManager::CFactoryManager(CCircuitAI* circuit)
 //					it = havens.erase(it);  // NOTE: micro-opt
 					*it = havens.back();
 					havens.pop_back();
+					havenField->DelHaven();
 					// TODO: Send HavenDestroyed message?
 				} else {
 					++it;
@@ -227,14 +232,15 @@ CFactoryManager::~CFactoryManager()
 {
 	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
 	utils::free_clear(updateTasks);
+	delete havenField;
 }
 
 void CFactoryManager::ReadConfig()
 {
-	const Json::Value& root = circuit->GetSetupManager()->GetConfig();
-	const std::string& cfgName = circuit->GetSetupManager()->GetConfigName();
+	const CConfigData* configData = circuit->GetSetupManager()->GetConfigData();
 
-	airpadDef = circuit->GetCircuitDef(root["economy"].get("airpad", "").asCString());
+	const CCircuitDef::Id airpadId = configData->GetEconomy().airpadDef;
+	airpadDef = (airpadId >= 0) ? circuit->GetCircuitDef(airpadId) : nullptr;
 	if (airpadDef == nullptr) {
 		airpadDef = circuit->GetEconomyManager()->GetDefaultDef();
 	}
@@ -243,120 +249,49 @@ void CFactoryManager::ReadConfig()
 	 * Roles, attributes and retreat
 	 */
 	std::map<CCircuitDef::RoleType, std::set<CCircuitDef::Id>> roleDefs;
-	CCircuitDef::RoleName& roleNames = CCircuitDef::GetRoleNames();
-	CCircuitDef::AttrName& attrNames = CCircuitDef::GetAttrNames();
-	CCircuitDef::FireName& fireNames = CCircuitDef::GetFireNames();
-	const Json::Value& behaviours = root["behaviour"];
-	for (const std::string& defName : behaviours.getMemberNames()) {
-		CCircuitDef* cdef = circuit->GetCircuitDef(defName.c_str());
-		if (cdef == nullptr) {
-			circuit->LOG("CONFIG %s: has unknown UnitDef '%s'", cfgName.c_str(), defName.c_str());
+	const CConfigData::Behaviours& behaviours = configData->GetBehaviours();
+	for (auto& kv : circuit->GetCircuitDefs()) {
+		const CConfigData::SBehaviour& bhv = behaviours[kv.first];
+		if (!bhv.IsValid()) {
 			continue;
 		}
+		CCircuitDef* cdef = kv.second;
 
-		// Read roles from config
-		const Json::Value& behaviour = behaviours[defName];
-		const Json::Value& role = behaviour["role"];
-		if (role.empty()) {
-			circuit->LOG("CONFIG %s: '%s' has no role", cfgName.c_str(), defName.c_str());
-			continue;
-		}
-
-		const std::string& mainName = role[0].asString();
-		auto it = roleNames.find(mainName);
-		if (it == roleNames.end()) {
-			circuit->LOG("CONFIG %s: %s has unknown main role '%s'", cfgName.c_str(), defName.c_str(), mainName.c_str());
-			continue;
-		}
-		cdef->SetMainRole(it->second);
-		cdef->AddRole(it->second);
-		roleDefs[it->second].insert(cdef->GetId());
-
-//		if (role.size() < 2) {
-			cdef->AddEnemyRole(it->second);
-//		} else {
-			for (unsigned i = 1; i < role.size(); ++i) {
-				const std::string& enemyName = role[i].asString();
-				it = roleNames.find(enemyName);
-				if (it == roleNames.end()) {
-					circuit->LOG("CONFIG %s: %s has unknown enemy role '%s'", cfgName.c_str(), defName.c_str(), enemyName.c_str());
-					continue;
-				}
-				cdef->AddEnemyRole(it->second);
-//				cdef->AddRole(it->second);
-			}
-//		}
-
-		// Read optional roles and attributes
-		const Json::Value& attributes = behaviour["attribute"];
-		for (const Json::Value& attr : attributes) {
-			const std::string& attrName = attr.asString();
-			it = roleNames.find(attrName);
-			if (it == roleNames.end()) {
-				auto it = attrNames.find(attrName);
-				if (it == attrNames.end()) {
-					circuit->LOG("CONFIG %s: %s has unknown attribute '%s'", cfgName.c_str(), defName.c_str(), attrName.c_str());
-					continue;
-				} else {
-					cdef->AddAttribute(it->second);
-				}
-			} else {
-				cdef->AddRole(it->second);
-				roleDefs[it->second].insert(cdef->GetId());
-			}
-		}
-
-		const Json::Value& fire = behaviour["fire_state"];
-		if (!fire.isNull()) {
-			const std::string& fireName = fire.asString();
-			auto itf = fireNames.find(fireName);
-			if (itf == fireNames.end()) {
-				circuit->LOG("CONFIG %s: %s has unknown fire state '%s'", cfgName.c_str(), defName.c_str(), fireName.c_str());
-			} else {
-				cdef->SetFireState(itf->second);
+		cdef->SetMainRole(static_cast<CCircuitDef::RoleType>(bhv.mainRole));
+		cdef->AddRoles(bhv.roles);
+		cdef->AddEnemyRoles(bhv.enemyRoles);
+		for (CCircuitDef::RoleT i = 0; i < static_cast<CCircuitDef::RoleT>(CCircuitDef::RoleType::_SIZE_); ++i) {
+			if (bhv.roles & CCircuitDef::GetMask(i)) {
+				roleDefs[static_cast<CCircuitDef::RoleType>(i)].insert(cdef->GetId());
 			}
 		}
 
-		const Json::Value& reload = behaviour["reload"];
-		if (!reload.isNull()) {
-			cdef->SetReloadTime(reload.asFloat() * FRAMES_PER_SEC);
+		if (bhv.fireState >= 0) {
+			cdef->SetFireState(static_cast<CCircuitDef::FireType>(bhv.fireState));
 		}
-
-		const Json::Value& limit = behaviour["limit"];
-		if (!limit.isNull()) {
-			cdef->SetMaxThisUnit(std::min(limit.asInt(), cdef->GetMaxThisUnit()));
+		if (bhv.reloadTime >= 0) {
+			cdef->SetReloadTime(bhv.reloadTime);
 		}
-
-		const Json::Value& since = behaviour["since"];
-		if (!since.isNull()) {
-			cdef->SetSinceFrame(since.asInt() * FRAMES_PER_SEC);
+		if (bhv.limit >= 0) {
+			cdef->SetMaxThisUnit(std::min(bhv.limit, cdef->GetMaxThisUnit()));
 		}
-
-		cdef->SetRetreat(behaviour.get("retreat", cdef->GetRetreat()).asFloat());
-
-		const Json::Value& pwrMod = behaviour["pwr_mod"];
-		if (!pwrMod.isNull()) {
-			cdef->ModPower(pwrMod.asFloat());
+		if (bhv.sinceFrame >= 0) {
+			cdef->SetSinceFrame(bhv.sinceFrame);
 		}
-		const Json::Value& thrMod = behaviour["thr_mod"];
-		if (!thrMod.isNull()) {
-			cdef->ModThreat(thrMod.asFloat());
+		if (bhv.retreat >= 0.f) {
+			cdef->SetRetreat(bhv.retreat);
 		}
+		cdef->ModPower(bhv.pwrMod);
+		cdef->ModThreat(bhv.thrMod);
 	}
 
 	/*
 	 * Factories
 	 */
 	CTerrainManager* terrainManager = circuit->GetTerrainManager();
-	const Json::Value& factories = root["factory"];
-	for (const std::string& fac : factories.getMemberNames()) {
-		CCircuitDef* cdef = circuit->GetCircuitDef(fac.c_str());
-		if (cdef == nullptr) {
-			circuit->LOG("CONFIG %s: has unknown UnitDef '%s'", cfgName.c_str(), fac.c_str());
-			continue;
-		}
-
-		const Json::Value& factory = factories[fac];
+	for (const auto& kv : configData->GetFactories()) {
+		CCircuitDef* cdef = circuit->GetCircuitDef(kv.first);
+		const CConfigData::SFactory& factory = kv.second;
 		SFactoryDef facDef;
 
 		// NOTE: used to create tasks on Event (like DefendTask), fix/improve
@@ -380,25 +315,16 @@ void CFactoryManager::ReadConfig()
 			facDef.roleDefs[static_cast<CCircuitDef::RoleT>(type)] = rdef;
 		}
 
-		facDef.isRequireEnergy = factory.get("require_energy", false).asBool();
-
-		const Json::Value& items = factory["unit"];
-		const Json::Value& tiers = factory["income_tier"];
-		facDef.buildDefs.reserve(items.size());
-		const unsigned tierSize = tiers.size();
-		facDef.incomes.reserve(tierSize + 1);
+		facDef.isRequireEnergy = factory.isRequireEnergy;
+		facDef.buildDefs.reserve(factory.buildDefs.size());
 
 		CCircuitDef* landDef = nullptr;
 		CCircuitDef* waterDef = nullptr;
 		float landSize = std::numeric_limits<float>::max();
 		float waterSize = std::numeric_limits<float>::max();
 
-		for (unsigned i = 0; i < items.size(); ++i) {
-			CCircuitDef* udef = circuit->GetCircuitDef(items[i].asCString());
-			if (udef == nullptr) {
-				circuit->LOG("CONFIG %s: has unknown UnitDef '%s'", cfgName.c_str(), items[i].asCString());
-				continue;
-			}
+		for (const CCircuitDef::Id id : factory.buildDefs) {
+			CCircuitDef* udef = circuit->GetCircuitDef(id);
 			facDef.buildDefs.push_back(udef);
 
 			// identify surface representatives
@@ -424,82 +350,37 @@ void CFactoryManager::ReadConfig()
 				waterDef = udef;
 			}
 		}
-		if (facDef.buildDefs.empty()) {
-			continue;  // ignore empty factory
-		}
 		facDef.landDef = landDef;
 		facDef.waterDef = waterDef;
 
-		auto fillProbs = [this, &cfgName, &facDef, &fac, &factory](unsigned i, const char* type, SFactoryDef::Tiers& tiers) {
-			const Json::Value& tierType = factory[type];
-			if (tierType.isNull()) {
-				return false;
-			}
-			const Json::Value& tier = tierType[utils::int_to_string(i, "tier%i")];
-			if (tier.isNull()) {
-				return false;
-			}
-			std::vector<float>& probs = tiers[i];
-			probs.reserve(facDef.buildDefs.size());
-			float sum = .0f;
-			for (unsigned j = 0; j < facDef.buildDefs.size(); ++j) {
-				const float p = tier[j].asFloat();
-				sum += p;
-				probs.push_back(p);
-			}
-			if (fabs(sum - 1.0f) > 0.0001f) {
-				circuit->LOG("CONFIG %s: %s's %s_tier%i total probability = %f", cfgName.c_str(), fac.c_str(), type, i, sum);
-			}
-			return true;
-		};
-		unsigned i = 0;
-		for (; i < tierSize; ++i) {
-			facDef.incomes.push_back(tiers[i].asFloat());
-			fillProbs(i, "air", facDef.airTiers);
-			fillProbs(i, "land", facDef.landTiers);
-			fillProbs(i, "water", facDef.waterTiers);
-		}
-		fillProbs(i, "air", facDef.airTiers);
-		fillProbs(i, "land", facDef.landTiers);
-		fillProbs(i, "water", facDef.waterTiers);
-
-//		if (facDef.incomes.empty()) {
-			facDef.incomes.push_back(std::numeric_limits<float>::max());
-//		}
-		if (facDef.landTiers.empty()) {
-			if (!facDef.airTiers.empty()) {
-				facDef.landTiers = facDef.airTiers;
-			} else if (!facDef.waterTiers.empty()) {
-				facDef.landTiers = facDef.waterTiers;
-			} else {
-				facDef.landTiers[0];  // create empty tier
-			}
-		}
-		if (facDef.waterTiers.empty()) {
-			facDef.waterTiers = facDef.landTiers;
-		}
-		if (facDef.airTiers.empty()) {
-			facDef.airTiers = terrainManager->IsWaterMap() ? facDef.waterTiers : facDef.landTiers;
-		}
+		facDef.incomes = factory.incomes;
+		facDef.landTiers = factory.landTiers;
+		facDef.waterTiers = factory.waterTiers;
+		facDef.airTiers = factory.airTiers.empty()
+				? (terrainManager->IsWaterMap() ? facDef.waterTiers : facDef.landTiers)
+				: factory.airTiers;
 
-		facDef.nanoCount = factory.get("caretaker", 1).asUInt();
+		facDef.nanoCount = factory.nanoCount;
 
 		factoryDefs[cdef->GetId()] = facDef;
 	}
 
-	bpRatio = root["economy"].get("buildpower", 1.f).asFloat();
-	reWeight = root["response"].get("_weight_", .5f).asFloat();
+	bpRatio = configData->GetEconomy().buildPower;
+	reWeight = configData->GetResponseWeight();
 }
 
 void CFactoryManager::Init()
 {
 	CSetupManager::StartFunc subinit = [this](const AIFloat3& pos) {
-		CScheduler* scheduler = circuit->GetScheduler().get();
-		const int interval = 4;
-		const int offset = circuit->GetSkirmishAIId() % interval;
-		scheduler->RunTaskEvery(std::make_shared<CGameTask>(&CFactoryManager::UpdateIdle, this), interval, offset + 0);
-		scheduler->RunTaskEvery(std::make_shared<CGameTask>(&CFactoryManager::UpdateFactory, this), interval, offset + 2);
+		CFrameBudget* frameBudget = circuit->GetFrameBudget().get();
+		frameBudget->AddQueue("factory:idle", 1, TEAM_SLOWUPDATE_RATE, TEAM_SLOWUPDATE_RATE * 4,
+				[this]() { return idleTask->GetAssignees().size(); },
+				[this](unsigned int n) { return UpdateIdle(n); });
+		frameBudget->AddQueue("factory:update", 1, TEAM_SLOWUPDATE_RATE, TEAM_SLOWUPDATE_RATE * 4,
+				[this]() { return updateTasks.size(); },
+				[this](unsigned int n) { return UpdateFactory(n); });
 
+		CScheduler* scheduler = circuit->GetScheduler().get();
 		scheduler->RunTaskEvery(std::make_shared<CGameTask>(&CFactoryManager::Watchdog, this),
 								FRAMES_PER_SEC * 60,
 								circuit->GetSkirmishAIId() * WATCHDOG_COUNT + 11);
@@ -519,17 +400,20 @@ void CFactoryManager::Release()
 	updateTasks.clear();
 }
 
+bool CFactoryManager::IsInterested(Event event, CCircuitDef::Id unitDefId) const
+{
+	// created: fire state of any unit; finished: tasks of any unit
+	return event != Event::DAMAGED;
+}
+
 int CFactoryManager::UnitCreated(CCircuitUnit* unit, CCircuitUnit* builder)
 {
 	CCircuitDef* cdef = unit->GetCircuitDef();
 	TRY_UNIT(circuit, unit,
-		unit->GetUnit()->SetFireState(cdef->GetFireState());
+		unit->CmdFireState(cdef->GetFireState());
 	)
 
-	auto search = createdHandler.find(cdef->GetId());
-	if (search != createdHandler.end()) {
-		search->second(unit, builder);
-	}
+	createdHandler.Call(cdef->GetId(), unit, builder);
 
 	if (builder == nullptr) {
 		return 0; //signaling: OK
@@ -562,20 +446,14 @@ int CFactoryManager::UnitFinished(CCircuitUnit* unit)
 		DoneTask(itre->second);
 	}
 
-	auto search = finishedHandler.find(unit->GetCircuitDef()->GetId());
-	if (search != finishedHandler.end()) {
-		search->second(unit);
-	}
+	finishedHandler.Call(unit->GetCircuitDef()->GetId(), unit);
 
 	return 0; //signaling: OK
 }
 
 int CFactoryManager::UnitIdle(CCircuitUnit* unit)
 {
-	auto search = idleHandler.find(unit->GetCircuitDef()->GetId());
-	if (search != idleHandler.end()) {
-		search->second(unit);
-	}
+	idleHandler.Call(unit->GetCircuitDef()->GetId(), unit);
 
 	return 0; //signaling: OK
 }
@@ -591,10 +469,7 @@ int CFactoryManager::UnitDestroyed(CCircuitUnit* unit, CEnemyUnit* attacker)
 		AbortTask(itre->second);
 	}
 
-	auto search = destroyedHandler.find(unit->GetCircuitDef()->GetId());
-	if (search != destroyedHandler.end()) {
-		search->second(unit, attacker);
-	}
+	destroyedHandler.Call(unit->GetCircuitDef()->GetId(), unit, attacker);
 
 	return 0; //signaling: OK
 }
@@ -735,7 +610,7 @@ CCircuitUnit* CFactoryManager::GetClosestFactory(AIFloat3 position)
 	const int frame = circuit->GetLastFrame();
 	for (SFactory& fac : factories) {
 		STerrainMapArea* area = fac.unit->GetArea();
-		if ((area != nullptr) && (area->sector.find(iS) == area->sector.end())) {
+		if ((area != nullptr) && !area->HasSector(iS)) {
 			continue;
 		}
 		const AIFloat3& facPos = fac.unit->GetPos(frame);
@@ -782,8 +657,14 @@ AIFloat3 CFactoryManager::GetClosestHaven(CCircuitUnit* unit) const
 	if (havens.empty()) {
 		return -RgtVector;
 	}
-	float metric = std::numeric_limits<float>::max();
 	const AIFloat3& position = unit->GetPos(circuit->GetLastFrame());
+	const int havenIdx = havenField->GetClosest(unit->GetArea(), position);
+	if (havenIdx >= 0) {
+		return havens[havenIdx];
+	}
+
+	// flying unit or outside of field
+	float metric = std::numeric_limits<float>::max();
 	CTerrainManager* terrainManager = circuit->GetTerrainManager();
 	auto it = havens.begin(), havIt = havens.end();
 	for (; it != havens.end(); ++it) {
@@ -1002,32 +883,28 @@ void CFactoryManager::EnableFactory(CCircuitUnit* unit)
 	// check nanos around
 	std::set<CCircuitUnit*> nanos;
 	float radius = assistDef->GetBuildDistance();
-	const AIFloat3& pos = unit->GetPos(this->circuit->GetLastFrame());
-	auto units = std::move(this->circuit->GetCallback()->GetFriendlyUnitsIn(pos, radius));
-	int nanoId = assistDef->GetId();
-	int teamId = this->circuit->GetTeamId();
-	for (Unit* nano : units) {
-		if (nano == nullptr) {
+	const int frame = this->circuit->GetLastFrame();
+	const AIFloat3& pos = unit->GetPos(frame);
+	static std::vector<CAllyUnit*> units;  // NOTE: micro-opt
+	units.clear();
+	this->circuit->GetFriendlyUnitsIn(pos, radius, units);
+	for (CAllyUnit* nano : units) {
+		if ((*nano->GetCircuitDef() != *assistDef) || nano->IsBeingBuilt(frame)) {
 			continue;
 		}
-		UnitDef* ndef = nano->GetDef();
-		if (ndef->GetUnitDefId() == nanoId && (nano->GetTeam() == teamId) && !nano->IsBeingBuilt()) {
-			CCircuitUnit* ass = this->circuit->GetTeamUnit(nano->GetUnitId());
-			// NOTE: OOAICallback::GetFriendlyUnits may return yet unregistered units created in GamePreload
-			if (ass != nullptr) {
-				nanos.insert(ass);
-
-				std::set<CCircuitUnit*>& facs = assists[ass];
-				if (facs.empty()) {
-					factoryPower += ass->GetBuildSpeed();
-				}
-				facs.insert(unit);
-			}
+		// NOTE: Ally's nano or yet unregistered unit created in GamePreload
+		CCircuitUnit* ass = this->circuit->GetTeamUnit(nano->GetId());
+		if (ass == nullptr) {
+			continue;
 		}
-		delete ndef;
-		delete nano;
+		nanos.insert(ass);
+
+		std::set<CCircuitUnit*>& facs = assists[ass];
+		if (facs.empty()) {
+			factoryPower += ass->GetBuildSpeed();
+		}
+		facs.insert(unit);
 	}
-//	utils::free_clear(units);
 
 	if (factories.empty()) {
 		this->circuit->GetSetupManager()->SetBasePos(pos);
@@ -1071,7 +948,8 @@ void CFactoryManager::DisableFactory(CCircuitUnit* unit)
 		}
 		if (!hasBuilder) {
 			// check queued factories
-			std::set<IBuilderTask*> tasks = builderManager->GetTasks(IBuilderTask::BuildType::FACTORY);
+			const CSlotSet<IBuilderTask>& factoryTasks = builderManager->GetTasks(IBuilderTask::BuildType::FACTORY);
+			std::vector<IBuilderTask*> tasks(factoryTasks.begin(), factoryTasks.end());  // AbortTask modifies set
 			for (IBuilderTask* task : tasks) {
 				auto it = factoryDefs.find(task->GetBuildDef()->GetId());
 				if (it != factoryDefs.end()) {
@@ -1172,25 +1050,25 @@ IUnitTask* CFactoryManager::CreateAssistTask(CCircuitUnit* unit)
 	bool isMetalEmpty = economyManager->IsMetalEmpty();
 	CAllyUnit* repairTarget = nullptr;
 	CAllyUnit* buildTarget = nullptr;
-	const AIFloat3& pos = unit->GetPos(circuit->GetLastFrame());
+	const int frame = circuit->GetLastFrame();
+	const AIFloat3& pos = unit->GetPos(frame);
 	float radius = unit->GetCircuitDef()->GetBuildDistance();
 
 	CBuilderManager* builderManager = circuit->GetBuilderManager();
 	CCircuitDef* terraDef = builderManager->GetTerraDef();
 	const float maxCost = MAX_BUILD_SEC * economyManager->GetAvgMetalIncome() * economyManager->GetEcoFactor();
 	float curCost = std::numeric_limits<float>::max();
-	circuit->UpdateFriendlyUnits();
-	// NOTE: OOAICallback::GetFriendlyUnitsIn depends on unit's radius
-	auto units = std::move(circuit->GetCallback()->GetFriendlyUnitsIn(pos, radius * 0.9f));
-	for (Unit* u : units) {
-		CAllyUnit* candUnit = circuit->GetFriendlyUnit(u);
-		if ((candUnit == nullptr) || builderManager->IsReclaimed(candUnit)) {
+	static std::vector<CAllyUnit*> units;  // NOTE: micro-opt
+	units.clear();
+	circuit->GetFriendlyUnitsIn(pos, radius * 0.9f, units);
+	for (CAllyUnit* candUnit : units) {
+		if (builderManager->IsReclaimed(candUnit)) {
 			continue;
 		}
-		if (u->IsBeingBuilt()) {
+		if (candUnit->IsBeingBuilt(frame)) {
 			CCircuitDef* cdef = candUnit->GetCircuitDef();
-			const float maxHealth = u->GetMaxHealth();
-			const float buildTime = cdef->GetBuildTime() * (maxHealth - u->GetHealth()) / maxHealth;
+			const float maxHealth = candUnit->GetMaxHealth(frame);
+			const float buildTime = cdef->GetBuildTime() * (maxHealth - candUnit->GetHealth(frame)) / maxHealth;
 			if (buildTime >= curCost) {
 				continue;
 			}
@@ -1202,14 +1080,13 @@ IUnitTask* CFactoryManager::CreateAssistTask(CCircuitUnit* unit)
 				curCost = buildTime;
 				buildTarget = candUnit;
 			}
-		} else if ((repairTarget == nullptr) && (u->GetHealth() < u->GetMaxHealth())) {
+		} else if ((repairTarget == nullptr) && (candUnit->GetHealth(frame) < candUnit->GetMaxHealth(frame))) {
 			repairTarget = candUnit;
 			if (isMetalEmpty) {
 				break;
 			}
 		}
 	}
-	utils::free_clear(units);
 	if (/*!isMetalEmpty && */(buildTarget != nullptr)) {
 		// Construction task
 		IBuilderTask::Priority priority = buildTarget->GetCircuitDef()->IsMobile() ?
@@ -1223,9 +1100,7 @@ IUnitTask* CFactoryManager::CreateAssistTask(CCircuitUnit* unit)
 	}
 	if (isMetalEmpty) {
 		// Reclaim task
-		auto features = std::move(circuit->GetCallback()->GetFeaturesIn(pos, radius));
-		if (!features.empty()) {
-			utils::free_clear(features);
+		if (circuit->GetAllyTeam()->GetFeatureData()->HasFeaturesIn(pos, radius)) {
 			return EnqueueReclaim(IBuilderTask::Priority::NORMAL, pos, radius);
 		}
 	}
@@ -1257,13 +1132,13 @@ void CFactoryManager::Watchdog()
 	}
 }
 
-void CFactoryManager::UpdateIdle()
+unsigned int CFactoryManager::UpdateIdle(unsigned int n)
 {
 	SCOPED_TIME(circuit, __PRETTY_FUNCTION__);
-	idleTask->Update();
+	return idleTask->UpdateSlice(n);
 }
 
-void CFactoryManager::UpdateFactory()
+unsigned int CFactoryManager::UpdateFactory(unsigned int n)
 {
 	SCOPED_TIME(circuit, __PRETTY_FUNCTION__);
 	if (updateIterator >= updateTasks.size()) {
@@ -1271,8 +1146,7 @@ void CFactoryManager::UpdateFactory()
 	}
 
 	int lastFrame = circuit->GetLastFrame();
-	// stagger the Update's
-	unsigned int n = (updateTasks.size() / TEAM_SLOWUPDATE_RATE) + 1;
+	const unsigned int total = n;
 
 	while ((updateIterator < updateTasks.size()) && (n != 0)) {
 		IUnitTask* task = updateTasks[updateIterator];
@@ -1292,6 +1166,7 @@ void CFactoryManager::UpdateFactory()
 			n--;
 		}
 	}
+	return total - n;
 }
 
 } // namespace circuit
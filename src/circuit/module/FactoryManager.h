@@ -13,11 +13,13 @@
 #include "unit/CircuitUnit.h"
 
 #include <map>
+#include <unordered_map>
 
 namespace circuit {
 
 class CEconomyManager;
 class CFactoryData;
+class CHavenField;
 
 class CFactoryManager: public IUnitModule {
 public:
@@ -30,6 +32,7 @@ private:
 public:
 	void Release();
 
+	virtual bool IsInterested(Event event, CCircuitDef::Id unitDefId) const override;
 	virtual int UnitCreated(CCircuitUnit* unit, CCircuitUnit* builder) override;
 	virtual int UnitFinished(CCircuitUnit* unit) override;
 	virtual int UnitIdle(CCircuitUnit* unit) override;
@@ -68,6 +71,7 @@ public:
 	CCircuitDef* GetAssistDef() const { return assistDef; }
 	springai::AIFloat3 GetClosestHaven(CCircuitUnit* unit) const;
 	springai::AIFloat3 GetClosestHaven(const springai::AIFloat3& position) const;
+	CHavenField* GetHavenField() const { return havenField; }
 
 	CRecruitTask* UpdateBuildPower(CCircuitUnit* unit);
 	CRecruitTask* UpdateFirePower(CCircuitUnit* unit);
@@ -88,8 +92,8 @@ private:
 	IUnitTask* CreateAssistTask(CCircuitUnit* unit);
 
 	void Watchdog();
-	void UpdateIdle();
-	void UpdateFactory();
+	unsigned int UpdateIdle(unsigned int n);
+	unsigned int UpdateFactory(unsigned int n);
 
 	Handlers2 createdHandler;
 	Handlers1 finishedHandler;
@@ -106,6 +110,7 @@ private:
 	CCircuitDef* assistDef;
 	std::map<CCircuitUnit*, std::set<CCircuitUnit*>> assists;  // nano 1:n factory
 	std::vector<springai::AIFloat3> havens;  // position behind factory
+	CHavenField* havenField;  // owner
 	std::map<ICoreUnit::Id, IBuilderTask*> repairedUnits;
 
 	CFactoryData* factoryData;
@@ -10,6 +10,7 @@
 #include "module/EconomyManager.h"
 #include "resource/MetalManager.h"
 #include "setup/SetupManager.h"
+#include "setup/ConfigData.h"
 #include "setup/DefenceMatrix.h"
 #include "task/NilTask.h"
 #include "task/IdleTask.h"
@@ -32,9 +33,9 @@
 #include "terrain/PathFinder.h"
 #include "unit/EnemyUnit.h"
 #include "CircuitAI.h"
+#include "util/FrameBudget.h"
 #include "util/Scheduler.h"
 #include "util/utils.h"
-#include "json/json.h"
 
 #include "OOAICallback.h"
 #include "AISCommands.h"
@@ -46,10 +47,12 @@ namespace circuit {
 
 using namespace springai;
 
+#define DEFENCE_INTERVAL	(FRAMES_PER_SEC * 60)
+
 CMilitaryManager::CMilitaryManager(CCircuitAI* circuit)
 		: IUnitModule(circuit)
 		, fightIterator(0)
-		, defenceIdx(0)
+		, defenceCursor(0)
 		, scoutIdx(0)
 		, armyCost(0.f)
 		, enemyMobileCost(0.f)
@@ -58,6 +61,7 @@ CMilitaryManager::CMilitaryManager(CCircuitAI* circuit)
 		, radarDef(nullptr)
 		, sonarDef(nullptr)
 		, bigGunDef(nullptr)
+		, kmeansStamp(0)
 {
 	circuit->GetScheduler()->RunOnInit(std::make_shared<CGameTask>(&CMilitaryManager::Init, this));
 
@@ -72,9 +76,11 @@ CMilitaryManager::CMilitaryManager(CCircuitAI* circuit)
 	auto defenceDestroyedHandler = [this](CCircuitUnit* unit, CEnemyUnit* attacker) {
 		int frame = this->circuit->GetLastFrame();
 		float defCost = unit->GetCircuitDef()->GetCost();
-		CDefenceMatrix::SDefPoint* point = defence->GetDefPoint(unit->GetPos(frame), defCost);
+		int index;
+		CDefenceMatrix::SDefPoint* point = defence->GetDefPoint(unit->GetPos(frame), defCost, index);
 		if (point != nullptr) {
 			point->cost -= defCost;
+			defence->Rescore(index);
 		}
 	};
 
@@ -101,7 +107,7 @@ CMilitaryManager::CMilitaryManager(CCircuitAI* circuit)
 		TRY_UNIT(this->circuit, unit,
 			if (unit->GetCircuitDef()->IsAbleToFly()) {
 				if (unit->GetCircuitDef()->IsAttrNoStrafe()) {
-					unit->GetUnit()->ExecuteCustomCommand(CMD_AIR_STRAFE, {0.0f});
+					unit->CmdCustom(CMD_AIR_STRAFE, {0.0f});
 				}
 				if (unit->GetCircuitDef()->IsRoleMine()) {
 					unit->GetUnit()->SetIdleMode(1);
@@ -109,7 +115,7 @@ CMilitaryManager::CMilitaryManager(CCircuitAI* circuit)
 			}
 			if (unit->GetCircuitDef()->IsAttrStock()) {
 				unit->GetUnit()->Stockpile(UNIT_COMMAND_OPTION_SHIFT_KEY | UNIT_COMMAND_OPTION_CONTROL_KEY);
-				unit->GetUnit()->ExecuteCustomCommand(CMD_MISC_PRIORITY, {2.0f});
+				unit->CmdMiscPriority(2.0f);
 			}
 		)
 	};
@@ -156,7 +162,7 @@ CMilitaryManager::CMilitaryManager(CCircuitAI* circuit)
 			unit->GetUnit()->SetTrajectory(1);
 			if (unit->GetCircuitDef()->IsAttrStock()) {
 				unit->GetUnit()->Stockpile(UNIT_COMMAND_OPTION_SHIFT_KEY | UNIT_COMMAND_OPTION_CONTROL_KEY);
-				unit->GetUnit()->ExecuteCustomCommand(CMD_MISC_PRIORITY, {2.0f});
+				unit->CmdMiscPriority(2.0f);
 			}
 		)
 	};
@@ -205,9 +211,9 @@ CMilitaryManager::CMilitaryManager(CCircuitAI* circuit)
 		destroyedHandler[cdef->GetId()] = defenceDestroyedHandler;
 	}
 
-	const Json::Value& root = circuit->GetSetupManager()->GetConfig();
-	const float fighterRet = root["retreat"].get("fighter", 0.5f).asFloat();
-	const float commMod = root["quota"]["thr_mod"].get("comm", 1.f).asFloat();
+	const CConfigData::SMilitary& military = circuit->GetSetupManager()->GetConfigData()->GetMilitary();
+	const float fighterRet = military.fighterRet;
+	const float commMod = military.commThrMod;
 	float maxRadarDivCost = 0.f;
 	float maxSonarDivCost = 0.f;
 	CCircuitDef* commDef = circuit->GetSetupManager()->GetCommChoice();
@@ -282,140 +288,83 @@ CMilitaryManager::~CMilitaryManager()
 
 void CMilitaryManager::ReadConfig()
 {
-	const Json::Value& root = circuit->GetSetupManager()->GetConfig();
-	const std::string& cfgName = circuit->GetSetupManager()->GetConfigName();
-	CCircuitDef::RoleName& roleNames = CCircuitDef::GetRoleNames();
+	const CConfigData* configData = circuit->GetSetupManager()->GetConfigData();
 
-	const Json::Value& responses = root["response"];
+	const CConfigData::Responses& responses = configData->GetResponses();
 	const float teamSize = circuit->GetAllyTeam()->GetSize();
 	roleInfos.resize(static_cast<CCircuitDef::RoleT>(CCircuitDef::RoleType::_SIZE_), {.0f});
-	for (const auto& pair : roleNames) {
-		SRoleInfo& info = roleInfos[static_cast<CCircuitDef::RoleT>(pair.second)];
-		const Json::Value& response = responses[pair.first];
+	for (CCircuitDef::RoleT i = 0; i < static_cast<CCircuitDef::RoleT>(CCircuitDef::RoleType::_SIZE_); ++i) {
+		SRoleInfo& info = roleInfos[i];
+		const CConfigData::SResponse& response = responses[i];
 
-		if (response.isNull()) {
+		if (!response.isSet) {
 			info.maxPerc = 1.0f;
 			info.factor  = teamSize;
 			continue;
 		}
 
-		info.maxPerc = response.get("max_percent", 1.0f).asFloat();
-		const float step = response.get("eps_step", 1.0f).asFloat();
-		info.factor  = (teamSize - 1.0f) * step + 1.0f;
+		info.maxPerc = response.maxPercent;
+		info.factor  = (teamSize - 1.0f) * response.epsStep + 1.0f;
+		for (const CConfigData::SResponse::SVs& vs : response.vs) {
+			info.vs.push_back(SRoleInfo::SVsInfo(vs.role, vs.ratio, vs.importance));
+		}
+	}
 
-		const Json::Value& vs = response["vs"];
-		const Json::Value& ratio = response["ratio"];
-		const Json::Value& importance = response["importance"];
-		for (unsigned i = 0; i < vs.size(); ++i) {
-			const std::string& roleName = vs[i].asString();
-			auto it = roleNames.find(roleName);
-			if (it == roleNames.end()) {
-				circuit->LOG("CONFIG %s: response %s vs unknown role '%s'", cfgName.c_str(), pair.first.c_str(), roleName.c_str());
-				continue;
-			}
-			float rat = ratio.get(i, 1.0f).asFloat();
-			float imp = importance.get(i, 1.0f).asFloat();
-			info.vs.push_back(SRoleInfo::SVsInfo(roleNames[roleName], rat, imp));
-		}
-	}
-
-	const Json::Value& quotas = root["quota"];
-	maxScouts = quotas.get("scout", 3).asUInt();
-	const Json::Value& qraid = quotas["raid"];
-	raid.min = qraid.get((unsigned)0, 3.f).asFloat();
-	raid.avg = qraid.get((unsigned)1, 5.f).asFloat();
-	minAttackers = quotas.get("attack", 8.f).asFloat();
-	defRadius = quotas.get("def_rad", 2000.f).asFloat();
-	const Json::Value& qthrMod = quotas["thr_mod"];
-	const Json::Value& qthrAtk = qthrMod["attack"];
-	attackMod.min = qthrAtk.get((unsigned)0, 1.f).asFloat();
-	attackMod.len = qthrAtk.get((unsigned)1, 1.f).asFloat() - attackMod.min;
-	const Json::Value& qthrDef = qthrMod["defence"];
-	defenceMod.min = qthrDef.get((unsigned)0, 1.f).asFloat();
-	defenceMod.len = qthrDef.get((unsigned)1, 1.f).asFloat() - defenceMod.min;
-	initThrMod.inMobile = qthrMod.get("mobile", 1.f).asFloat();
-	initThrMod.inStatic = qthrMod.get("static", 0.f).asFloat();
-	maxAAThreat = quotas.get("aa_threat", 42.f).asFloat();
-
-	const Json::Value& porc = root["porcupine"];
-	const Json::Value& defs = porc["unit"];
-	defenderDefs.reserve(defs.size());
-	for (const Json::Value& def : defs) {
-		CCircuitDef* cdef = circuit->GetCircuitDef(def.asCString());
-		if (cdef == nullptr) {
-			circuit->LOG("CONFIG %s: has unknown UnitDef '%s'", cfgName.c_str(), def.asCString());
-		} else {
-			defenderDefs.push_back(cdef);
-		}
-	}
-	const Json::Value& land = porc["land"];
-	landDefenders.reserve(land.size());
-	for (const Json::Value& idx : land) {
-		unsigned index = idx.asUInt();
-		if (index < defenderDefs.size()) {
-			landDefenders.push_back(defenderDefs[index]);
-		}
-	}
-	const Json::Value& watr = porc["water"];
-	waterDefenders.reserve(watr.size());
-	for (const Json::Value& idx : watr) {
-		unsigned index = idx.asUInt();
-		if (index < defenderDefs.size()) {
-			waterDefenders.push_back(defenderDefs[index]);
-		}
-	}
-
-	preventCount = porc.get("prevent", 1).asUInt();
-	const Json::Value& amount = porc["amount"];
-	const Json::Value& amOff = amount["offset"];
-	const Json::Value& amFac = amount["factor"];
-	const Json::Value& amMap = amount["map"];
-	const float minOffset = amOff.get((unsigned)0, -0.2f).asFloat();
-	const float maxOffset = amOff.get((unsigned)1, 0.2f).asFloat();
-	const float offset = (float)rand() / RAND_MAX * (maxOffset - minOffset) + minOffset;
-	const float minFactor = amFac.get((unsigned)0, 2.0f).asFloat();
-	const float maxFactor = amFac.get((unsigned)1, 1.0f).asFloat();
-	const float minMap = amMap.get((unsigned)0, 8.0f).asFloat();
-	const float maxMap = amMap.get((unsigned)1, 24.0f).asFloat();
+	const CConfigData::SMilitary& military = configData->GetMilitary();
+	maxScouts = military.maxScouts;
+	raid.min = military.raidMin;
+	raid.avg = military.raidAvg;
+	minAttackers = military.minAttackers;
+	defRadius = military.defRadius;
+	attackMod.min = military.attackMin;
+	attackMod.len = military.attackMax - attackMod.min;
+	defenceMod.min = military.defenceMin;
+	defenceMod.len = military.defenceMax - defenceMod.min;
+	initThrMod.inMobile = military.thrMobile;
+	initThrMod.inStatic = military.thrStatic;
+	maxAAThreat = military.aaThreat;
+
+	defenderDefs.reserve(military.defenderDefs.size());
+	for (const CCircuitDef::Id id : military.defenderDefs) {
+		defenderDefs.push_back(circuit->GetCircuitDef(id));
+	}
+	landDefenders.reserve(military.landDefenders.size());
+	for (const unsigned index : military.landDefenders) {
+		landDefenders.push_back(defenderDefs[index]);
+	}
+	waterDefenders.reserve(military.waterDefenders.size());
+	for (const unsigned index : military.waterDefenders) {
+		waterDefenders.push_back(defenderDefs[index]);
+	}
+
+	preventCount = military.preventCount;
+	const float offset = (float)rand() / RAND_MAX * (military.offsetMax - military.offsetMin) + military.offsetMin;
+	const float minFactor = military.factorMin;
+	const float maxFactor = military.factorMax;
+	const float minMap = military.mapMin;
+	const float maxMap = military.mapMax;
 	const float mapSize = (circuit->GetMap()->GetWidth() / 64) * (circuit->GetMap()->GetHeight() / 64);
 	amountFactor = (maxFactor - minFactor) / (SQUARE(maxMap) - SQUARE(minMap)) * (mapSize - SQUARE(minMap)) + minFactor + offset;
 //	amountFactor = std::max(amountFactor, 0.f);
 
-	const Json::Value& base = porc["base"];
-	baseDefence.reserve(base.size());
-	for (const Json::Value& pair : base) {
-		unsigned index = pair.get((unsigned)0, -1).asUInt();
-		if (index >= defenderDefs.size()) {
-			continue;
-		}
-		int frame = pair.get((unsigned)1, 0).asInt() * FRAMES_PER_SEC;
-		baseDefence.push_back(std::make_pair(defenderDefs[index], frame));
+	baseDefence.reserve(military.baseDefence.size());
+	for (const std::pair<unsigned, int>& pair : military.baseDefence) {  // sorted by frame
+		baseDefence.push_back(std::make_pair(defenderDefs[pair.first], pair.second));
 	}
-	auto compare = [](const std::pair<CCircuitDef*, int>& d1, const std::pair<CCircuitDef*, int>& d2) {
-		return d1.second > d2.second;
-	};
-	std::sort(baseDefence.begin(), baseDefence.end(), compare);
 
-	const Json::Value& super = porc["superweapon"];
-	const Json::Value& items = super["unit"];
-	const Json::Value& probs = super["weight"];
-	superInfos.reserve(items.size());
-	for (unsigned i = 0; i < items.size(); ++i) {
+	superInfos.reserve(military.superWeights.size());
+	for (const std::pair<CCircuitDef::Id, float>& pair : military.superWeights) {
 		SSuperInfo si;
-		si.cdef = circuit->GetCircuitDef(items[i].asCString());
-		if (si.cdef == nullptr) {
-			circuit->LOG("CONFIG %s: has unknown UnitDef '%s'", cfgName.c_str(), items[i].asCString());
-			continue;
-		}
+		si.cdef = circuit->GetCircuitDef(pair.first);
 		si.cdef->SetMainRole(CCircuitDef::RoleType::SUPER);  // override mainRole
 		si.cdef->AddEnemyRole(CCircuitDef::RoleType::SUPER);
 		si.cdef->AddRole(CCircuitDef::RoleType::SUPER);
-		si.weight = probs.get(i, 1.f).asFloat();
+		si.weight = pair.second;
 		superInfos.push_back(si);
 	}
 	DiceBigGun();
 
-	defaultPorc = circuit->GetCircuitDef(porc.get("default", "").asCString());
+	defaultPorc = (military.defaultPorc >= 0) ? circuit->GetCircuitDef(military.defaultPorc) : nullptr;
 	if (defaultPorc == nullptr) {
 		defaultPorc = circuit->GetEconomyManager()->GetDefaultDef();
 	}
@@ -426,7 +375,8 @@ void CMilitaryManager::Init()
 	CMetalManager* metalManager = circuit->GetMetalManager();
 	const CMetalData::Metals& spots = metalManager->GetSpots();
 
-	clusterInfos.resize(metalManager->GetClusters().size(), {nullptr});
+	clusterInfos.resize(metalManager->GetClusters().size(), {nullptr, 0, -1});
+	defenceMask.Resize(metalManager->GetClusters().size(), false);
 
 	scoutPath.reserve(spots.size());
 	for (unsigned i = 0; i < spots.size(); ++i) {
@@ -439,11 +389,17 @@ void CMilitaryManager::Init()
 		};
 		std::sort(scoutPath.begin(), scoutPath.end(), compare);
 
+		CFrameBudget* frameBudget = circuit->GetFrameBudget().get();
+		frameBudget->AddQueue("military:idle", 3, TEAM_SLOWUPDATE_RATE, TEAM_SLOWUPDATE_RATE * 4,
+				[this]() { return idleTask->GetAssignees().size(); },
+				[this](unsigned int n) { return UpdateIdle(n); });
+		frameBudget->AddQueue("military:fight", 3, TEAM_SLOWUPDATE_RATE / 2, TEAM_SLOWUPDATE_RATE * 2,
+				[this]() { return fightUpdates.size(); },
+				[this](unsigned int n) { return UpdateFight(n); });
+
 		CScheduler* scheduler = circuit->GetScheduler().get();
 		const int interval = 4;
 		const int offset = circuit->GetSkirmishAIId() % interval;
-		scheduler->RunTaskEvery(std::make_shared<CGameTask>(&CMilitaryManager::UpdateIdle, this), interval, offset + 0);
-		scheduler->RunTaskEvery(std::make_shared<CGameTask>(&CMilitaryManager::UpdateFight, this), interval / 2, offset + 1);
 		scheduler->RunTaskEvery(std::make_shared<CGameTask>(&CMilitaryManager::UpdateDefenceTasks, this), FRAMES_PER_SEC * 5, offset + 2);
 
 		scheduler->RunTaskEvery(std::make_shared<CGameTask>(&CMilitaryManager::Watchdog, this),
@@ -465,52 +421,47 @@ void CMilitaryManager::Release()
 	fightUpdates.clear();
 }
 
-int CMilitaryManager::UnitCreated(CCircuitUnit* unit, CCircuitUnit* builder)
+bool CMilitaryManager::IsInterested(Event event, CCircuitDef::Id unitDefId) const
 {
-	auto search = createdHandler.find(unit->GetCircuitDef()->GetId());
-	if (search != createdHandler.end()) {
-		search->second(unit, builder);
+	switch (event) {
+		case Event::CREATED:  return createdHandler.Has(unitDefId);
+		case Event::FINISHED: return finishedHandler.Has(unitDefId);
+		case Event::DAMAGED:  return damagedHandler.Has(unitDefId);
+		default: return true;
 	}
+}
+
+int CMilitaryManager::UnitCreated(CCircuitUnit* unit, CCircuitUnit* builder)
+{
+	createdHandler.Call(unit->GetCircuitDef()->GetId(), unit, builder);
 
 	return 0; //signaling: OK
 }
 
 int CMilitaryManager::UnitFinished(CCircuitUnit* unit)
 {
-	auto search = finishedHandler.find(unit->GetCircuitDef()->GetId());
-	if (search != finishedHandler.end()) {
-		search->second(unit);
-	}
+	finishedHandler.Call(unit->GetCircuitDef()->GetId(), unit);
 
 	return 0; //signaling: OK
 }
 
 int CMilitaryManager::UnitIdle(CCircuitUnit* unit)
 {
-	auto search = idleHandler.find(unit->GetCircuitDef()->GetId());
-	if (search != idleHandler.end()) {
-		search->second(unit);
-	}
+	idleHandler.Call(unit->GetCircuitDef()->GetId(), unit);
 
 	return 0; //signaling: OK
 }
 
 int CMilitaryManager::UnitDamaged(CCircuitUnit* unit, CEnemyUnit* attacker)
 {
-	auto search = damagedHandler.find(unit->GetCircuitDef()->GetId());
-	if (search != damagedHandler.end()) {
-		search->second(unit, attacker);
-	}
+	damagedHandler.Call(unit->GetCircuitDef()->GetId(), unit, attacker);
 
 	return 0; //signaling: OK
 }
 
 int CMilitaryManager::UnitDestroyed(CCircuitUnit* unit, CEnemyUnit* attacker)
 {
-	auto search = destroyedHandler.find(unit->GetCircuitDef()->GetId());
-	if (search != destroyedHandler.end()) {
-		search->second(unit, attacker);
-	}
+	destroyedHandler.Call(unit->GetCircuitDef()->GetId(), unit, attacker);
 
 	return 0; //signaling: OK
 }
@@ -738,30 +689,7 @@ void CMilitaryManager::MakeDefence(int cluster, const AIFloat3& pos)
 		isPorc = mm->GetSpots()[spotId].income > income;
 	}
 	if (!isPorc) {
-		unsigned threatCount = 0;
-		CThreatMap* threatMap = circuit->GetThreatMap();
-		const CMetalData::Clusters& clusters = mm->GetClusters();
-		const CMetalData::Metals& spots = mm->GetSpots();
-		const CMetalData::Graph& clusterGraph = mm->GetGraph();
-		CMetalData::Graph::Node node = clusterGraph.nodeFromId(cluster);
-		CMetalData::Graph::IncEdgeIt edgeIt(clusterGraph, node);
-		for (; edgeIt != lemon::INVALID; ++edgeIt) {
-			int idx0 = clusterGraph.id(clusterGraph.oppositeNode(node, edgeIt));
-			if (mm->IsClusterFinished(idx0)) {
-				continue;
-			}
-			// check if there is enemy neighbor
-			for (int idx : clusters[idx0].idxSpots) {
-				if (threatMap->GetAllThreatAt(spots[idx].position) > THREAT_MIN * 2) {
-					threatCount++;
-					break;
-				}
-			}
-			if (threatCount >= 2) {  // if 2 nearby clusters are a threat
-				isPorc = true;
-				break;
-			}
-		}
+		isPorc = defence->CountThreatNeighbours(cluster, 2) >= 2;  // if 2 nearby clusters are a threat
 	}
 	if (!isPorc) {
 		for (IBuilderTask* t : builderManager->GetTasks(IBuilderTask::BuildType::DEFENCE)) {
@@ -805,6 +733,9 @@ void CMilitaryManager::MakeDefence(int cluster, const AIFloat3& pos)
 			break;
 		}
 	}
+	if (parentTask != nullptr) {
+		defence->Rescore(cluster);
+	}
 
 	// Build sensors
 	auto checkSensor = [this, &backPos, builderManager](IBuilderTask::BuildType type, CCircuitDef* cdef, float range) {
@@ -851,7 +782,8 @@ void CMilitaryManager::MakeDefence(int cluster, const AIFloat3& pos)
 void CMilitaryManager::AbortDefence(const CBDefenceTask* task)
 {
 	float defCost = task->GetBuildDef()->GetCost();
-	CDefenceMatrix::SDefPoint* point = defence->GetDefPoint(task->GetPosition(), defCost);
+	int index;
+	CDefenceMatrix::SDefPoint* point = defence->GetDefPoint(task->GetPosition(), defCost, index);
 	if (point != nullptr) {
 		if ((task->GetTarget() == nullptr) && (point->cost >= defCost)) {
 			point->cost -= defCost;
@@ -868,6 +800,7 @@ void CMilitaryManager::AbortDefence(const CBDefenceTask* task)
 			}
 			next = next->GetNextTask();
 		}
+		defence->Rescore(index);
 	}
 }
 
@@ -918,29 +851,26 @@ AIFloat3 CMilitaryManager::GetScoutPosition(CCircuitUnit* unit)
 	return -RgtVector;
 }
 
-void CMilitaryManager::FindBestPos(F3Vec& posPath, AIFloat3& startPos, STerrainMapArea* area)
+void CMilitaryManager::FindBestPos(F3Vec& posPath, AIFloat3& startPos, STerrainMapArea* area, bool safe)
 {
 	static F3Vec ourPositions;  // NOTE: micro-opt
 
-	CTerrainManager* terrainManager = circuit->GetTerrainManager();
 	CPathFinder* pathfinder = circuit->GetPathfinder();
 	const int frame = circuit->GetLastFrame();
 
 	/*
 	 * Check mobile groups
+	 * NOTE: Leaders are shared by all units, field skips those out of area
 	 */
 	const std::array<IFighterTask::FightType, 2> types = {IFighterTask::FightType::ATTACK, IFighterTask::FightType::DEFEND};
 	for (IFighterTask::FightType type : types) {
 		const std::set<IFighterTask*>& atkTasks = GetTasks(type);
 		for (IFighterTask* task : atkTasks) {
-			const AIFloat3& ourPos = static_cast<ISquadTask*>(task)->GetLeaderPos(frame);
-			if (terrainManager->CanMoveToPos(area, ourPos)) {
-				ourPositions.push_back(ourPos);
-			}
+			ourPositions.push_back(static_cast<ISquadTask*>(task)->GetLeaderPos(frame));
 		}
 
 		if (!ourPositions.empty()) {
-			pathfinder->FindBestPath(posPath, startPos, pathfinder->GetSquareSize(), ourPositions, false);
+			pathfinder->FindBestPathByField(posPath, startPos, pathfinder->GetSquareSize(), ourPositions, safe);
 			ourPositions.clear();
 			if (!posPath.empty()) {
 				return;
@@ -981,25 +911,14 @@ void CMilitaryManager::FindBestPos(F3Vec& posPath, AIFloat3& startPos, STerrainM
 //		}
 //	}
 
-	CDefenceMatrix* defMat = defence;
-	CMetalData::PointPredicate predicate = [defMat, terrainManager, area](const int index) {
-		const std::vector<CDefenceMatrix::SDefPoint>& points = defMat->GetDefPoints(index);
-		for (const CDefenceMatrix::SDefPoint& defPoint : points) {
-			if ((defPoint.cost > 100.0f) && terrainManager->CanMoveToPos(area, defPoint.position)) {
-				return true;
-			}
-		}
-		return false;
-	};
-	CMetalManager* metalManager = circuit->GetMetalManager();
-	int index = metalManager->FindNearestCluster(startPos, predicate);
+	int index = FindNearestDefCluster(startPos, area);
 	if (index >= 0) {
 		const std::vector<CDefenceMatrix::SDefPoint>& points = defence->GetDefPoints(index);
 		for (const CDefenceMatrix::SDefPoint& defPoint : points) {
 			ourPositions.push_back(defPoint.position);
 		}
 
-		pathfinder->FindBestPath(posPath, startPos, pathfinder->GetSquareSize(), ourPositions, false);
+		pathfinder->FindBestPath(posPath, startPos, pathfinder->GetSquareSize(), ourPositions, safe);
 		ourPositions.clear();
 		if (!posPath.empty()) {
 			return;
@@ -1010,51 +929,27 @@ void CMilitaryManager::FindBestPos(F3Vec& posPath, AIFloat3& startPos, STerrainM
 	 * Use base
 	 */
 	ourPositions.push_back(circuit->GetSetupManager()->GetBasePos());
-	pathfinder->FindBestPath(posPath, startPos, pathfinder->GetSquareSize(), ourPositions, false);
+	pathfinder->FindBestPathByField(posPath, startPos, pathfinder->GetSquareSize(), ourPositions, safe);
 	ourPositions.clear();
 }
 
-void CMilitaryManager::FillSafePos(const AIFloat3& pos, STerrainMapArea* area, F3Vec& outPositions)
+int CMilitaryManager::FindNearestDefCluster(const AIFloat3& pos, STerrainMapArea* area)
 {
+	CMetalManager* metalManager = circuit->GetMetalManager();
 	CTerrainManager* terrainManager = circuit->GetTerrainManager();
-	const int frame = circuit->GetLastFrame();
-
-	const std::array<IFighterTask::FightType, 2> types = {IFighterTask::FightType::ATTACK, IFighterTask::FightType::DEFEND};
-	for (IFighterTask::FightType type : types) {
-		const std::set<IFighterTask*>& atkTasks = GetTasks(type);
-		for (IFighterTask* task : atkTasks) {
-			const AIFloat3& ourPos = static_cast<ISquadTask*>(task)->GetLeaderPos(frame);
-			if (terrainManager->CanMoveToPos(area, ourPos)) {
-				outPositions.push_back(ourPos);
-			}
-		}
-		if (!outPositions.empty()) {
-			return;
-		}
-	}
-
-	CDefenceMatrix* defMat = defence;
-	CMetalData::PointPredicate predicate = [defMat, terrainManager, area](const int index) {
-		const std::vector<CDefenceMatrix::SDefPoint>& points = defMat->GetDefPoints(index);
+	static CMetalData::SMask clusterMask;  // NOTE: micro-opt
+	clusterMask = metalManager->GetReachableClusters(area);
+	int index;
+	while ((index = metalManager->FindNearestCluster(pos, clusterMask)) >= 0) {
+		const std::vector<CDefenceMatrix::SDefPoint>& points = defence->GetDefPoints(index);
 		for (const CDefenceMatrix::SDefPoint& defPoint : points) {
 			if ((defPoint.cost > 100.0f) && terrainManager->CanMoveToPos(area, defPoint.position)) {
-				return true;
+				return index;
 			}
 		}
-		return false;
-	};
-	CMetalManager* metalManager = circuit->GetMetalManager();
-	int index = metalManager->FindNearestCluster(pos, predicate);
-	if (index >= 0) {
-		const std::vector<CDefenceMatrix::SDefPoint>& points = defence->GetDefPoints(index);
-		for (const CDefenceMatrix::SDefPoint& defPoint : points) {
-			outPositions.push_back(defPoint.position);
-		}
-	}
-
-	if (outPositions.empty()) {
-		outPositions.push_back(circuit->GetSetupManager()->GetBasePos());
+		clusterMask.Set(index, false);
 	}
+	return -1;
 }
 
 IFighterTask* CMilitaryManager::AddDefendTask(int cluster)
@@ -1256,25 +1151,27 @@ void CMilitaryManager::UpdateDefenceTasks()
 	CMetalManager* mm = circuit->GetMetalManager();
 	CEconomyManager* em = circuit->GetEconomyManager();
 	CTerrainManager* tm = circuit->GetTerrainManager();
-	const CMetalData::Metals& spots = mm->GetSpots();
 	const CMetalData::Clusters& clusters = mm->GetClusters();
+	// Clusters with reachable spot that is not open, per leader's area
+	static CMetalData::SMask spotMask;  // NOTE: micro-opt
+	static CMetalData::SMask clusterMask;  // NOTE: micro-opt
+	STerrainMapArea* maskArea = nullptr;
+	bool isMaskValid = false;
 	for (IFighterTask* task : tasks) {
 		CDefendTask* dt = static_cast<CDefendTask*>(task);
 		if (dt->GetTarget() != nullptr) {
 			continue;
 		}
 		STerrainMapArea* area = dt->GetLeader()->GetArea();
-		CMetalData::PointPredicate predicate = [em, tm, area, &spots, &clusters](const int index) {
-			const CMetalData::MetalIndices& idcs = clusters[index].idxSpots;
-			for (int idx : idcs) {
-				if (!em->IsOpenSpot(idx) && tm->CanMoveToPos(area, spots[idx].position)) {
-					return true;
-				}
-			}
-			return false;
-		};
+		if (!isMaskValid || (maskArea != area)) {
+			spotMask = mm->GetReachableSpots(area);
+			em->FilterClosedSpots(spotMask);
+			mm->SpotsToClusters(spotMask, clusterMask);
+			maskArea = area;
+			isMaskValid = true;
+		}
 		AIFloat3 center(tm->GetTerrainWidth() / 2, 0, tm->GetTerrainHeight() / 2);
-		int index = mm->FindNearestCluster(center, predicate);
+		int index = mm->FindNearestCluster(center, clusterMask);
 		if (index >= 0) {
 			dt->SetPosition(clusters[index].position);
 		}
@@ -1301,21 +1198,82 @@ void CMilitaryManager::UpdateDefenceTasks()
 	/*
 	 * Porc update
 	 */
-	decltype(defenceIdx) prevIdx = defenceIdx;
-	while (defenceIdx < clusters.size()) {
-		int index = defenceIdx++;
-		if (mm->IsClusterQueued(index) || mm->IsClusterFinished(index)) {
-			MakeDefence(index);
-			return;
+	UpdateDefenceQueue();
+	const int frame = circuit->GetLastFrame();
+	while (!defenceQueue.empty()) {
+		const std::pair<int, int> top = defenceQueue.top();
+		SClusterInfo& info = clusterInfos[top.second];
+		if (info.dueFrame != top.first) {
+			defenceQueue.pop();  // stale
+			continue;
 		}
+		if (top.first > frame) {
+			break;
+		}
+		defenceQueue.pop();
+		info.checkFrame = frame;
+		info.dueFrame = -1;
+		MakeDefence(top.second);
+		ScheduleDefence(top.second);
+		return;
 	}
-	defenceIdx = 0;
-	while (defenceIdx < prevIdx) {
-		int index = defenceIdx++;
-		if (mm->IsClusterQueued(index) || mm->IsClusterFinished(index)) {
-			MakeDefence(index);
-			return;
+}
+
+void CMilitaryManager::UpdateDefenceQueue()
+{
+	CMetalManager* mm = circuit->GetMetalManager();
+	static CMetalData::SMask prevMask;  // NOTE: micro-opt
+	static std::vector<int> changed;  // NOTE: micro-opt
+	prevMask = defenceMask;
+	defenceMask = mm->GetQueuedClusters();
+	defenceMask.Or(mm->GetFinishedClusters());
+
+	// Clusters that lost ownership drop their queue entries
+	for (int i = prevMask.FindNext(0); i >= 0; i = prevMask.FindNext(i + 1)) {
+		if (!defenceMask.Test(i)) {
+			clusterInfos[i].dueFrame = -1;
+		}
+	}
+
+	// Only clusters re-scored by the matrix and new owned clusters are rescheduled
+	defence->Refresh(circuit->GetThreatMap());
+	if (defence->GetChanges(defenceCursor, changed)) {
+		for (int i : changed) {
+			ScheduleDefence(i);
+		}
+		for (int i = defenceMask.FindNext(0); i >= 0; i = defenceMask.FindNext(i + 1)) {
+			if (!prevMask.Test(i)) {
+				ScheduleDefence(i);
+			}
+		}
+	} else {
+		for (int i = defenceMask.FindNext(0); i >= 0; i = defenceMask.FindNext(i + 1)) {
+			ScheduleDefence(i);
+		}
+	}
+	changed.clear();
+
+	if (defenceQueue.size() > clusterInfos.size() * 4) {
+		DefenceQueue queue;
+		for (int i = defenceMask.FindNext(0); i >= 0; i = defenceMask.FindNext(i + 1)) {
+			if (clusterInfos[i].dueFrame >= 0) {
+				queue.push(std::make_pair(clusterInfos[i].dueFrame, i));
+			}
 		}
+		std::swap(defenceQueue, queue);
+	}
+}
+
+void CMilitaryManager::ScheduleDefence(int cluster)
+{
+	if (!defenceMask.Test(cluster)) {
+		return;
+	}
+	SClusterInfo& info = clusterInfos[cluster];
+	const int dueFrame = info.checkFrame + DEFENCE_INTERVAL / std::max(defence->GetNeed(cluster), 1e-3f);
+	if (dueFrame != info.dueFrame) {
+		info.dueFrame = dueFrame;
+		defenceQueue.push(std::make_pair(dueFrame, cluster));
 	}
 }
 
@@ -1374,21 +1332,20 @@ void CMilitaryManager::Watchdog()
 	}
 }
 
-void CMilitaryManager::UpdateIdle()
+unsigned int CMilitaryManager::UpdateIdle(unsigned int n)
 {
 	SCOPED_TIME(circuit, __PRETTY_FUNCTION__);
-	idleTask->Update();
+	return idleTask->UpdateSlice(n);
 }
 
-void CMilitaryManager::UpdateFight()
+unsigned int CMilitaryManager::UpdateFight(unsigned int n)
 {
 	SCOPED_TIME(circuit, __PRETTY_FUNCTION__);
 	if (fightIterator >= fightUpdates.size()) {
 		fightIterator = 0;
 	}
 
-	// stagger the Update's
-	unsigned int n = (fightUpdates.size() / TEAM_SLOWUPDATE_RATE) + 1;
+	const unsigned int total = n;
 
 	while ((fightIterator < fightUpdates.size()) && (n != 0)) {
 		IUnitTask* task = fightUpdates[fightIterator];
@@ -1402,6 +1359,7 @@ void CMilitaryManager::UpdateFight()
 			n--;
 		}
 	}
+	return total - n;
 }
 
 void CMilitaryManager::AddArmyCost(CCircuitUnit* unit)
@@ -1416,15 +1374,37 @@ void CMilitaryManager::DelArmyCost(CCircuitUnit* unit)
 	armyCost = std::max(armyCost - unit->GetCircuitDef()->GetCost(), .0f);
 }
 
+#define KMEANS_BASE_MAX_K	32
+// Full rebuild interval in iterations, compensates floating-point drift of incremental sums
+#define KMEANS_REBUILD		64
+
+void CMilitaryManager::MarkEnemyDirty(ICoreUnit::Id unitId)
+{
+	SEnemyAssign& ea = enemyAssigns[unitId];
+	if (!ea.isDirty) {
+		ea.isDirty = true;
+		kmeansDirty.push_back(unitId);
+	}
+}
+
+void CMilitaryManager::MarkEnemyMoved(const CEnemyUnit* enemy)
+{
+	auto it = enemyAssigns.find(enemy->GetId());
+	if ((it == enemyAssigns.end()) || (it->second.pos.SqDistance2D(enemy->GetNewPos()) > SQUARE(DEFAULT_SLACK))) {
+		MarkEnemyDirty(enemy->GetId());
+	}
+}
+
 /*
  * 2d only, ignores y component.
  * @see KAIK/AttackHandler::KMeansIteration for general reference
+ * Incremental variant: assignments persist between iterations, only dirty enemies
+ * and members of one group (round-robin, against drifted means) are reassigned.
  */
 void CMilitaryManager::KMeansIteration()
 {
 	const CCircuitAI::EnemyUnits& units = circuit->GetEnemyUnits();
 	// calculate a new K. change the formula to adjust max K, needs to be 1 minimum.
-	constexpr int KMEANS_BASE_MAX_K = 32;
 	int newK = std::min(KMEANS_BASE_MAX_K, 1 + (int)sqrtf(units.size()));
 
 	// change the number of means according to newK
@@ -1432,98 +1412,152 @@ void CMilitaryManager::KMeansIteration()
 	// add a new means, just use one of the positions
 	AIFloat3 newMeansPosition = units.begin()->second->GetPos();
 //	newMeansPosition.y = circuit->GetMap()->GetElevationAt(newMeansPosition.x, newMeansPosition.z) + K_MEANS_ELEVATION;
-	enemyGroups.resize(newK, SEnemyGroup(newMeansPosition));
-
-	// check all positions and assign them to means, complexity n*k for one iteration
-	std::vector<int> unitsClosestMeanID(units.size(), -1);
-	std::vector<int> numUnitsAssignedToMean(newK, 0);
-
-	{
-		int i = 0;
+	if ((newK != (int)enemyGroups.size()) || (kmeansStamp % KMEANS_REBUILD == 0)) {
+		ClearEnemyGroups(newK, newMeansPosition);
 		for (const auto& kv : units) {
-			CEnemyUnit* enemy = kv.second;
-			if (enemy->IsHidden()) {
-				continue;
-			}
-			AIFloat3 unitPos = enemy->GetPos();
-			float closestDistance = std::numeric_limits<float>::max();
-			int closestIndex = -1;
-
-			for (int m = 0; m < newK; m++) {
-				const AIFloat3& mean = enemyGroups[m].pos;
-				float distance = unitPos.SqDistance2D(mean);
-
-				if (distance < closestDistance) {
-					closestDistance = distance;
-					closestIndex = m;
-				}
-			}
-
-			// position i is closest to the mean at closestIndex
-			unitsClosestMeanID[i++] = closestIndex;
-			numUnitsAssignedToMean[closestIndex]++;
+			MarkEnemyDirty(kv.first);
 		}
 	}
+	++kmeansStamp;
+
+	// snapshot of means in SoA layout, distance loop over them is vectorizable
+	alignas(16) float meanX[KMEANS_BASE_MAX_K];
+	alignas(16) float meanZ[KMEANS_BASE_MAX_K];
+	for (int m = 0; m < newK; ++m) {
+		meanX[m] = enemyGroups[m].pos.x;
+		meanZ[m] = enemyGroups[m].pos.z;
+	}
 
-	// change the means according to which positions are assigned to them
-	// use meanAverage for indexes with 0 pos'es assigned
-	// make a new means list
-//	std::vector<AIFloat3> newMeans(newK, ZeroVector);
-	std::vector<SEnemyGroup>& newMeans = enemyGroups;
-	for (unsigned i = 0; i < newMeans.size(); i++) {
-		SEnemyGroup& eg = newMeans[i];
-		eg.units.clear();
-		eg.units.reserve(numUnitsAssignedToMean[i]);
-		eg.pos = ZeroVector;
-		std::fill(eg.roleCosts.begin(), eg.roleCosts.end(), 0.f);
-		eg.cost = 0.f;
-		eg.threat = 0.f;
+	for (ICoreUnit::Id unitId : enemyGroups[kmeansStamp % newK].units) {
+		MarkEnemyDirty(unitId);
 	}
 
-	{
-		int i = 0;
-		for (const auto& kv : units) {
-			CEnemyUnit* enemy = kv.second;
-			if (enemy->IsHidden()) {
-				continue;
+	for (ICoreUnit::Id unitId : kmeansDirty) {
+		auto it = enemyAssigns.find(unitId);
+		SEnemyAssign& ea = it->second;
+		ea.isDirty = false;
+		CEnemyUnit* enemy = circuit->GetEnemyUnit(unitId);
+		if ((enemy == nullptr) || enemy->IsHidden()) {
+			if (ea.group >= 0) {
+				UnassignEnemy(ea);
 			}
-			int meanIndex = unitsClosestMeanID[i++];
-			SEnemyGroup& eg = newMeans[meanIndex];
-
-			// don't divide by 0
-			float num = std::max(1, numUnitsAssignedToMean[meanIndex]);
-			eg.pos += enemy->GetPos() / num;
+			enemyAssigns.erase(it);
+			continue;
+		}
 
-			eg.units.push_back(kv.first);
+		const AIFloat3& pos = enemy->GetPos();
+		const CCircuitDef* cdef = enemy->GetCircuitDef();
+		float cost = 0.f;
+		float threat;
+		if (cdef != nullptr) {
+			if (!cdef->IsMobile() || enemy->IsInRadarOrLOS()) {
+				cost = cdef->GetCost();
+			}
+			threat = enemy->GetThreat() * (cdef->IsMobile() ? initThrMod.inMobile : initThrMod.inStatic);
+		} else {
+			threat = enemy->GetThreat();
+		}
 
-			const CCircuitDef* cdef = enemy->GetCircuitDef();
-			if (cdef != nullptr) {
-				eg.roleCosts[cdef->GetMainRole()] += cdef->GetCost();
-				if (!cdef->IsMobile() || enemy->IsInRadarOrLOS()) {
-					eg.cost += cdef->GetCost();
-				}
-				eg.threat += enemy->GetThreat() * (cdef->IsMobile() ? initThrMod.inMobile : initThrMod.inStatic);
-			} else {
-				eg.threat += enemy->GetThreat();
+		const int group = FindClosestMean(pos, meanX, meanZ, newK);
+		if (ea.group >= 0) {
+			if ((group == ea.group) && (pos == ea.pos) && (cdef == ea.cdef) && (cost == ea.cost) && (threat == ea.threat)) {
+				continue;
 			}
+			UnassignEnemy(ea);
 		}
+		ea.cdef = cdef;
+		ea.pos = pos;
+		ea.cost = cost;
+		ea.threat = threat;
+		AssignEnemy(unitId, ea, group);
 	}
+	kmeansDirty.clear();
 
 	// do a check and see if there are any empty means and set the height
 	enemyPos = ZeroVector;
-	for (int i = 0; i < newK; i++) {
-		// if a newmean is unchanged, set it to the new means pos instead of (0, 0, 0)
-		if (newMeans[i].pos == ZeroVector) {
-			newMeans[i] = newMeansPosition;
+	for (SEnemyGroup& eg : enemyGroups) {
+		// if a mean is empty, set it to the new means pos instead of (0, 0, 0)
+		if (eg.units.empty()) {
+			eg.pos = newMeansPosition;
 		} else {
+			eg.pos = eg.sumPos / eg.units.size();
 			// get the proper elevation for the y-coord
-//			newMeans[i].pos.y = circuit->GetMap()->GetElevationAt(newMeans[i].pos.x, newMeans[i].pos.z) + K_MEANS_ELEVATION;
+//			eg.pos.y = circuit->GetMap()->GetElevationAt(eg.pos.x, eg.pos.z) + K_MEANS_ELEVATION;
 		}
-		enemyPos += newMeans[i].pos;
+		enemyPos += eg.pos;
 	}
 	enemyPos /= newK;
+}
+
+int CMilitaryManager::FindClosestMean(const AIFloat3& pos, const float* meanX, const float* meanZ, int k) const
+{
+	alignas(16) float distance[KMEANS_BASE_MAX_K];
+	for (int m = 0; m < k; ++m) {
+		const float dx = meanX[m] - pos.x;
+		const float dz = meanZ[m] - pos.z;
+		distance[m] = dx * dx + dz * dz;
+	}
+	int closestIndex = 0;
+	for (int m = 1; m < k; ++m) {
+		if (distance[m] < distance[closestIndex]) {
+			closestIndex = m;
+		}
+	}
+	return closestIndex;
+}
+
+void CMilitaryManager::AssignEnemy(ICoreUnit::Id unitId, SEnemyAssign& ea, int group)
+{
+	SEnemyGroup& eg = enemyGroups[group];
+	ea.group = group;
+	ea.index = eg.units.size();
+	eg.units.push_back(unitId);
+	eg.sumPos += ea.pos;
+	if (ea.cdef != nullptr) {
+		eg.roleCosts[ea.cdef->GetMainRole()] += ea.cdef->GetCost();
+	}
+	eg.cost += ea.cost;
+	eg.threat += ea.threat;
+}
+
+void CMilitaryManager::UnassignEnemy(SEnemyAssign& ea)
+{
+	SEnemyGroup& eg = enemyGroups[ea.group];
+	// swap-remove, keep index of moved unit valid
+	const ICoreUnit::Id lastId = eg.units.back();
+	eg.units[ea.index] = lastId;
+	eg.units.pop_back();
+	if (ea.index < eg.units.size()) {
+		enemyAssigns[lastId].index = ea.index;
+	}
+	if (eg.units.empty()) {
+		eg.sumPos = ZeroVector;
+		std::fill(eg.roleCosts.begin(), eg.roleCosts.end(), 0.f);
+		eg.cost = 0.f;
+		eg.threat = 0.f;
+		return;
+	}
+	eg.sumPos -= ea.pos;
+	if (ea.cdef != nullptr) {
+		float& roleCost = eg.roleCosts[ea.cdef->GetMainRole()];
+		roleCost = std::max(roleCost - ea.cdef->GetCost(), 0.f);
+	}
+	eg.cost = std::max(eg.cost - ea.cost, 0.f);
+	eg.threat = std::max(eg.threat - ea.threat, 0.f);
+}
 
-//	return newMeans;
+void CMilitaryManager::ClearEnemyGroups(int newK, const AIFloat3& newMeansPosition)
+{
+	enemyAssigns.clear();
+	kmeansDirty.clear();
+	enemyGroups.resize(newK, SEnemyGroup(newMeansPosition));
+	for (SEnemyGroup& eg : enemyGroups) {
+		eg.units.clear();
+		eg.sumPos = ZeroVector;
+		std::fill(eg.roleCosts.begin(), eg.roleCosts.end(), 0.f);
+		eg.cost = 0.f;
+		eg.threat = 0.f;
+	}
 }
 
 } // namespace circuit
@@ -9,12 +9,15 @@
 #define SRC_CIRCUIT_MODULE_MILITARYMANAGER_H_
 
 #include "module/UnitModule.h"
+#include "resource/MetalData.h"
 #include "task/fighter/FighterTask.h"
 #include "unit/CircuitUnit.h"
 #include "unit/CircuitDef.h"
 
 #include <vector>
+#include <queue>
 #include <set>
+#include <unordered_map>
 
 namespace circuit {
 
@@ -26,9 +29,10 @@ class CRetreatTask;
 class CMilitaryManager: public IUnitModule {
 public:
 	struct SEnemyGroup {
-		SEnemyGroup(const springai::AIFloat3& p) : pos(p), cost(0.f), threat(0.f) {}
+		SEnemyGroup(const springai::AIFloat3& p) : pos(p), sumPos(ZeroVector), cost(0.f), threat(0.f) {}
 		std::vector<ICoreUnit::Id> units;
 		springai::AIFloat3 pos;
+		springai::AIFloat3 sumPos;  // sum of units' positions
 		std::array<float, static_cast<CCircuitDef::RoleT>(CCircuitDef::RoleType::_SIZE_)> roleCosts{{0.f}};
 		float cost;
 		float threat;  // thr_mod applied
@@ -43,6 +47,7 @@ private:
 public:
 	void Release();
 
+	virtual bool IsInterested(Event event, CCircuitDef::Id unitDefId) const override;
 	virtual int UnitCreated(CCircuitUnit* unit, CCircuitUnit* builder) override;
 	virtual int UnitFinished(CCircuitUnit* unit) override;
 	virtual int UnitIdle(CCircuitUnit* unit) override;
@@ -73,8 +78,7 @@ public:
 	void AbortDefence(const CBDefenceTask* task);
 	bool HasDefence(int cluster);
 	springai::AIFloat3 GetScoutPosition(CCircuitUnit* unit);
-	void FindBestPos(F3Vec& posPath, springai::AIFloat3& startPos, STerrainMapArea* area);
-	void FillSafePos(const springai::AIFloat3& pos, STerrainMapArea* area, F3Vec& outPositions);
+	void FindBestPos(F3Vec& posPath, springai::AIFloat3& startPos, STerrainMapArea* area, bool safe = false);
 
 	IFighterTask* AddDefendTask(int cluster);
 	IFighterTask* DelDefendTask(const springai::AIFloat3& pos);
@@ -95,6 +99,9 @@ public:
 	const std::vector<SEnemyGroup>& GetEnemyGroups() const { return enemyGroups; }
 	const springai::AIFloat3& GetEnemyPos() const { return enemyPos; }
 	void UpdateEnemyGroups() { KMeansIteration(); }
+	// Feed of K-means: enemy changed (los, radar, threat, death) or moved since its assignment
+	void MarkEnemyDirty(ICoreUnit::Id unitId);
+	void MarkEnemyMoved(const CEnemyUnit* enemy);
 	bool IsAirValid() const { return GetEnemyThreat(CCircuitDef::RoleType::AA) <= maxAAThreat; }
 
 	const std::set<CCircuitUnit*>& GetRoleUnits(CCircuitDef::RoleType type) const {
@@ -122,13 +129,30 @@ public:
 
 private:
 	void Watchdog();
-	void UpdateIdle();
-	void UpdateFight();
+	int FindNearestDefCluster(const springai::AIFloat3& pos, STerrainMapArea* area);
+	void UpdateDefenceQueue();
+	void ScheduleDefence(int cluster);
+	unsigned int UpdateIdle(unsigned int n);
+	unsigned int UpdateFight(unsigned int n);
 
 	void AddArmyCost(CCircuitUnit* unit);
 	void DelArmyCost(CCircuitUnit* unit);
 
+	struct SEnemyAssign {
+		SEnemyAssign() : group(-1), index(0), isDirty(false), cdef(nullptr), cost(0.f), threat(0.f) {}
+		int group;  // -1 if unassigned
+		unsigned int index;  // in SEnemyGroup::units
+		bool isDirty;  // in kmeansDirty
+		const CCircuitDef* cdef;
+		springai::AIFloat3 pos;
+		float cost;
+		float threat;
+	};
 	void KMeansIteration();
+	int FindClosestMean(const springai::AIFloat3& pos, const float* meanX, const float* meanZ, int k) const;
+	void AssignEnemy(ICoreUnit::Id unitId, SEnemyAssign& ea, int group);
+	void UnassignEnemy(SEnemyAssign& ea);
+	void ClearEnemyGroups(int newK, const springai::AIFloat3& newMeansPosition);
 
 	Handlers2 createdHandler;
 	Handlers1 finishedHandler;
@@ -141,7 +165,11 @@ private:
 	unsigned int fightIterator;
 
 	CDefenceMatrix* defence;
-	unsigned int defenceIdx;
+	// Porc schedule: eligible (queued or finished) cluster with the earliest due frame is checked next
+	using DefenceQueue = std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<std::pair<int, int>>>;
+	DefenceQueue defenceQueue;  // dueFrame: cluster, stale entries are skipped
+	CMetalData::SMask defenceMask;  // eligible clusters on last update
+	unsigned defenceCursor;  // position in CDefenceMatrix change log
 
 	std::vector<unsigned int> scoutPath;  // list of cluster ids
 	unsigned int scoutIdx;
@@ -178,9 +206,15 @@ private:
 	std::array<SEnemyInfo, static_cast<CCircuitDef::RoleT>(CCircuitDef::RoleType::_SIZE_)> enemyInfos{{{0.f}, {0.f}}};
 	std::vector<SEnemyGroup> enemyGroups;
 	springai::AIFloat3 enemyPos;
+	// Persistent K-means state: enemy's group and its contribution to group sums
+	std::unordered_map<ICoreUnit::Id, SEnemyAssign> enemyAssigns;
+	std::vector<ICoreUnit::Id> kmeansDirty;
+	int kmeansStamp;
 
 	struct SClusterInfo {
 		IFighterTask* defence;
+		int checkFrame;
+		int dueFrame;  // checkFrame + DEFENCE_INTERVAL / CDefenceMatrix::GetNeed
 	};
 	std::vector<SClusterInfo> clusterInfos;
 
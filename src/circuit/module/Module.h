@@ -10,8 +10,9 @@
 
 #include "unit/CircuitDef.h"
 
-#include <unordered_map>
-#include <functional>
+#include <vector>
+#include <new>
+#include <type_traits>
 
 namespace circuit {
 
@@ -19,12 +20,68 @@ class CCircuitAI;
 class CCircuitUnit;
 class CEnemyUnit;
 
+/*
+ * Trivially-copyable delegate for captureless or [this] lambdas
+ */
+template<typename... Args>
+class CDelegate {
+public:
+	CDelegate() : invoke(nullptr) {}
+	template<typename F>
+	CDelegate(F func) {
+		static_assert((sizeof(F) <= sizeof(Storage)) && std::is_trivially_copyable<F>::value,
+				"Delegate accepts only small trivially-copyable functors");
+		new (&storage) F(func);
+		invoke = [](const Storage& s, Args... args) {
+			(*reinterpret_cast<const F*>(&s))(args...);
+		};
+	}
+
+	explicit operator bool() const { return invoke != nullptr; }
+	void operator()(Args... args) const { invoke(storage, args...); }
+
+private:
+	using Storage = typename std::aligned_storage<sizeof(void*), alignof(void*)>::type;
+	Storage storage;
+	void (*invoke)(const Storage&, Args...);
+};
+
+/*
+ * Handlers indexed by CCircuitDef::Id
+ */
+template<typename... Args>
+class CHandlers {
+public:
+	CDelegate<Args...>& operator[](CCircuitDef::Id unitDefId) {
+		if ((unsigned)unitDefId >= handlers.size()) {
+			handlers.resize(unitDefId + 1);
+		}
+		return handlers[unitDefId];
+	}
+	bool Has(CCircuitDef::Id unitDefId) const {
+		return ((unsigned)unitDefId < handlers.size()) && handlers[unitDefId];
+	}
+	void Call(CCircuitDef::Id unitDefId, Args... args) const {
+		if (Has(unitDefId)) {
+			handlers[unitDefId](args...);
+		}
+	}
+
+private:
+	std::vector<CDelegate<Args...>> handlers;
+};
+
 class IModule {
 protected:
 	IModule(CCircuitAI* circuit);
 public:
+	enum class Event: char {CREATED = 0, FINISHED, DAMAGED, _SIZE_};
+
 	virtual ~IModule();
 
+	// Does module need the event for units of the def; @see CCircuitAI::InitModuleMasks
+	virtual bool IsInterested(Event event, CCircuitDef::Id unitDefId) const { return true; }
+
 	virtual int UnitCreated(CCircuitUnit* unit, CCircuitUnit* builder);
 	virtual int UnitFinished(CCircuitUnit* unit);
 	virtual int UnitIdle(CCircuitUnit* unit);
@@ -39,9 +96,9 @@ protected:
 	virtual void Load(std::istream& is) {}
 	virtual void Save(std::ostream& os) const {}
 
-	using Handlers1 = std::unordered_map<CCircuitDef::Id, std::function<void (CCircuitUnit* unit)>>;
-	using Handlers2 = std::unordered_map<CCircuitDef::Id, std::function<void (CCircuitUnit* unit, CCircuitUnit* other)>>;
-	using EHandlers = std::unordered_map<CCircuitDef::Id, std::function<void (CCircuitUnit* unit, CEnemyUnit* other)>>;
+	using Handlers1 = CHandlers<CCircuitUnit*>;
+	using Handlers2 = CHandlers<CCircuitUnit*, CCircuitUnit*>;
+	using EHandlers = CHandlers<CCircuitUnit*, CEnemyUnit*>;
 
 	CCircuitAI* circuit;
 };
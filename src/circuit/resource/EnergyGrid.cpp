@@ -10,12 +10,12 @@
 #include "module/BuilderManager.h"
 #include "module/EconomyManager.h"
 #include "setup/SetupManager.h"
+#include "setup/ConfigData.h"
 #include "terrain/TerrainManager.h"
 #include "CircuitAI.h"
 #include "util/Scheduler.h"
 #include "util/utils.h"
-#include "json/json.h"
-#include "lemon/kruskal.h"
+#include "lemon/unionfind.h"
 
 #include "AISCommands.h"
 #include "Log.h"
@@ -35,8 +35,8 @@ public:
 	{}
 	Value operator[](Key k) const {
 		// NOTE: check for link.IsBeingBuilt solves vertex's pylon duplicates, but slows down grid construction
-		return (spanningTree.find(k) != spanningTree.end())
-				&& !links[CMetalData::Graph::id(k)].IsBeingBuilt();
+		const int edgeIdx = CMetalData::Graph::id(k);
+		return spanningTree[edgeIdx] && !links[edgeIdx].IsBeingBuilt();
 	}
 private:
 	const CEnergyGrid::SpanningTree& spanningTree;
@@ -103,16 +103,8 @@ CEnergyGrid::~CEnergyGrid()
 
 void CEnergyGrid::ReadConfig()
 {
-	const Json::Value& root = circuit->GetSetupManager()->GetConfig();
-	const std::string& cfgName = circuit->GetSetupManager()->GetConfigName();
-	const Json::Value& pylon = root["economy"]["energy"]["pylon"];
-	for (const Json::Value& pyl : pylon) {
-		CCircuitDef* cdef = circuit->GetCircuitDef(pyl.asCString());
-		if (cdef == nullptr) {
-			circuit->LOG("CONFIG %s: has unknown UnitDef '%s'", cfgName.c_str(), pyl.asCString());
-		} else {
-			rangePylons[pylonRanges[cdef->GetId()]] = cdef->GetId();
-		}
+	for (const CCircuitDef::Id id : circuit->GetSetupManager()->GetConfigData()->GetEconomy().pylonDefs) {
+		rangePylons[pylonRanges[id]] = id;
 	}
 }
 
@@ -131,6 +123,9 @@ void CEnergyGrid::Init()
 	spanningBfs = new SpanningBFS(*spanningGraph);
 
 	linkedClusters.resize(clusters.size(), false);
+	spanningTree.resize(clusterGraph.edgeNum(), false);
+	treeEdges.reserve(clusterGraph.edgeNum());
+	mstEdges.reserve(clusters.size());
 
 	links.reserve(clusterGraph.edgeNum());
 	for (int i = 0; i < clusterGraph.edgeNum(); ++i) {
@@ -259,6 +254,12 @@ CEnergyLink* CEnergyGrid::GetLinkToBuild(CCircuitDef*& outDef, AIFloat3& outPos)
 	return link;
 }
 
+void CEnergyGrid::SetBeingBuilt(CEnergyLink* link, bool value)
+{
+	link->SetBeingBuilt(value);
+	costEdges.push_back(link - links.data());
+}
+
 float CEnergyGrid::GetPylonRange(CCircuitDef::Id defId)
 {
 	auto it = pylonRanges.find(defId);
@@ -365,6 +366,9 @@ void CEnergyGrid::CheckGrid()
 			continue;
 		}
 		link.CheckConnection();
+		if (link.IsFinished()) {
+			costEdges.push_back(edgeIdx);
+		}
 	}
 	linkPylons.clear();
 
@@ -374,6 +378,9 @@ void CEnergyGrid::CheckGrid()
 			continue;
 		}
 		link.CheckConnection();
+		if (!link.IsFinished()) {
+			costEdges.push_back(edgeIdx);
+		}
 	}
 	unlinkPylons.clear();
 }
@@ -391,26 +398,86 @@ void CEnergyGrid::MarkClusters()
 	}
 }
 
+float CEnergyGrid::EdgeCost(const CMetalData::Graph::Edge& edge) const
+{
+	const CMetalData::WeightMap& weights = circuit->GetMetalManager()->GetWeights();
+	const CMetalData::CenterMap& centers = circuit->GetMetalManager()->GetCenters();
+	float width = circuit->GetTerrainManager()->GetTerrainWidth();
+	float height = circuit->GetTerrainManager()->GetTerrainHeight();
+	float baseWeight = width * width + height * height;
+	float invBaseWeight = 1.0f / baseWeight;  // FIXME: only valid for 1 of the ally team
+
+	const CEnergyLink& link = links[CMetalData::Graph::id(edge)];
+	if (link.IsFinished() || link.IsBeingBuilt()) {
+		// Mark used edges as const
+		return weights[edge] * invBaseWeight;
+	} else if (!link.IsValid()) {
+		return weights[edge] * baseWeight;
+	}
+	// Adjust weight by distance to base
+	const AIFloat3& basePos = circuit->GetSetupManager()->GetBasePos();
+	return weights[edge] * basePos.SqDistance2D(centers[edge]) * invBaseWeight;
+}
+
+/*
+ * Incremental Kruskal:
+ *   - new clusters: MST(G + v) = MST(T + E(v)), only tree and incident edges are sorted;
+ *   - removed clusters or more expensive tree edges: remaining tree edges stay in MST,
+ *     union-find is seeded with them and only non-tree edges reconnect the pieces;
+ *   - cheaper non-tree edge, both cases at once or forced: full rebuild.
+ * Costs are re-evaluated only for links reported by CheckGrid and SetBeingBuilt.
+ */
 void CEnergyGrid::RebuildTree()
 {
-	if (linkClusters.empty() && unlinkClusters.empty() && !isForceRebuild) {
+	if (linkClusters.empty() && unlinkClusters.empty() && costEdges.empty() && !isForceRebuild) {
 		return;
 	}
+	bool isFullRebuild = isForceRebuild;
 	isForceRebuild = false;
 	CMetalManager* metalManager = circuit->GetMetalManager();
 	const CMetalData::Graph& clusterGraph = metalManager->GetGraph();
+	bool isCut = !unlinkClusters.empty();
+	const bool isGrow = !linkClusters.empty();
 
 	// Remove destroyed edges
 	for (int index : unlinkClusters) {
-		OwnedGraph::Node node = ownedClusters->nodeFromId(index);
+		CMetalData::Graph::Node node = clusterGraph.nodeFromId(index);
 		ownedClusters->disable(node);
-		OwnedGraph::IncEdgeIt edgeIt(*ownedClusters, node);
+		CMetalData::Graph::IncEdgeIt edgeIt(clusterGraph, node);
 		for (; edgeIt != lemon::INVALID; ++edgeIt) {
-			spanningTree.erase(edgeIt);
+			spanningTree[clusterGraph.id(edgeIt)] = false;
 		}
 	}
 	unlinkClusters.clear();
 
+	// Update costs of changed links: more expensive tree edge cuts the tree,
+	// cheaper non-tree edge may replace tree edge of its cycle
+	for (int edgeIdx : costEdges) {
+		CMetalData::Graph::Edge edge = clusterGraph.edgeFromId(edgeIdx);
+		if (!(*ownedFilter)[clusterGraph.u(edge)] || !(*ownedFilter)[clusterGraph.v(edge)]) {
+			continue;
+		}
+		const float cost = EdgeCost(edge);
+		if (spanningTree[edgeIdx]) {
+			if (cost > (*edgeCosts)[edge]) {
+				spanningTree[edgeIdx] = false;
+				isCut = true;
+			}
+		} else if (cost < (*edgeCosts)[edge]) {
+			isFullRebuild = true;
+		}
+		(*edgeCosts)[edge] = cost;
+	}
+	costEdges.clear();
+
+	treeEdges.clear();
+	for (int edgeIdx : mstEdges) {
+		if (spanningTree[edgeIdx]) {
+			treeEdges.push_back(edgeIdx);
+		}
+	}
+	mstEdges.clear();
+
 	// Add new edges to Kruskal graph
 	for (int index : linkClusters) {
 		CMetalData::Graph::Node node = clusterGraph.nodeFromId(index);
@@ -419,37 +486,67 @@ void CEnergyGrid::RebuildTree()
 		for (; edgeIt != lemon::INVALID; ++edgeIt) {
 			int idx0 = clusterGraph.id(clusterGraph.oppositeNode(node, edgeIt));
 			if (linkedClusters[idx0]) {
-				CEnergyLink& link = links[clusterGraph.id(edgeIt)];
+				int edgeIdx = clusterGraph.id(edgeIt);
+				CEnergyLink& link = links[edgeIdx];
 				link.SetStartVertex(idx0);
+				if (!spanningTree[edgeIdx]) {
+					treeEdges.push_back(edgeIdx);
+				}
 			}
 		}
 	}
 	linkClusters.clear();
 
-	const CMetalData::WeightMap& weights = metalManager->GetWeights();
-	const CMetalData::CenterMap& centers = metalManager->GetCenters();
-	float width = circuit->GetTerrainManager()->GetTerrainWidth();
-	float height = circuit->GetTerrainManager()->GetTerrainHeight();
-	float baseWeight = width * width + height * height;
-	float invBaseWeight = 1.0f / baseWeight;  // FIXME: only valid for 1 of the ally team
-	const AIFloat3& basePos = circuit->GetSetupManager()->GetBasePos();
+	using IndexMap = CMetalData::Graph::NodeMap<int>;
+	IndexMap ufIndex(clusterGraph);
+	lemon::UnionFind<IndexMap> components(ufIndex);
+	for (OwnedGraph::NodeIt nodeIt(*ownedClusters); nodeIt != lemon::INVALID; ++nodeIt) {
+		components.insert(nodeIt);
+	}
 
-	for (const CMetalData::Graph::Edge edge : spanningTree) {
-		CEnergyLink& link = links[clusterGraph.id(edge)];
-		if (link.IsFinished() || link.IsBeingBuilt()) {
-			// Mark used edges as const
-			(*edgeCosts)[edge] = weights[edge] * invBaseWeight;
-		} else if (!link.IsValid()) {
-			(*edgeCosts)[edge] = weights[edge] * baseWeight;
-		} else {
-			// Adjust weight by distance to base
-			(*edgeCosts)[edge] = weights[edge] * basePos.SqDistance2D(centers[edge]) * invBaseWeight;
+	if (isFullRebuild || (isCut && isGrow)) {
+		std::fill(spanningTree.begin(), spanningTree.end(), false);
+		treeEdges.clear();
+		for (OwnedGraph::EdgeIt edgeIt(*ownedClusters); edgeIt != lemon::INVALID; ++edgeIt) {
+			treeEdges.push_back(clusterGraph.id(edgeIt));
+		}
+	} else if (isCut) {
+		// Remaining tree edges belong to new tree, reconnect components with the rest
+		for (int edgeIdx : treeEdges) {
+			CMetalData::Graph::Edge edge = clusterGraph.edgeFromId(edgeIdx);
+			components.join(clusterGraph.u(edge), clusterGraph.v(edge));
+		}
+		mstEdges.swap(treeEdges);
+		treeEdges.clear();
+		for (OwnedGraph::EdgeIt edgeIt(*ownedClusters); edgeIt != lemon::INVALID; ++edgeIt) {
+			const int edgeIdx = clusterGraph.id(edgeIt);
+			if (!spanningTree[edgeIdx]) {
+				treeEdges.push_back(edgeIdx);
+			}
+		}
+	} else {
+		// Only tree edges and edges of new clusters
+		for (int edgeIdx : treeEdges) {
+			spanningTree[edgeIdx] = false;
 		}
 	}
 
-	// Build Kruskal's minimum spanning tree
-	spanningTree.clear();
-	lemon::kruskal(*ownedClusters, *edgeCosts, std::inserter(spanningTree, spanningTree.end()));
+	for (int edgeIdx : treeEdges) {
+		CMetalData::Graph::Edge edge = clusterGraph.edgeFromId(edgeIdx);
+		(*edgeCosts)[edge] = EdgeCost(edge);
+	}
+	std::sort(treeEdges.begin(), treeEdges.end(), [this, &clusterGraph](int a, int b) {
+		return (*edgeCosts)[clusterGraph.edgeFromId(a)] < (*edgeCosts)[clusterGraph.edgeFromId(b)];
+	});
+
+	// Kruskal's minimum spanning tree over candidates
+	for (int edgeIdx : treeEdges) {
+		CMetalData::Graph::Edge edge = clusterGraph.edgeFromId(edgeIdx);
+		if (components.join(clusterGraph.u(edge), clusterGraph.v(edge))) {
+			spanningTree[edgeIdx] = true;
+			mstEdges.push_back(edgeIdx);
+		}
+	}
 }
 
 #ifdef DEBUG_VIS
@@ -505,7 +602,11 @@ void CEnergyGrid::UpdateVis()
 	figureKruskalId = fig->DrawLine(ZeroVector, ZeroVector, 0.0f, false, FRAMES_PER_SEC * 300, 0);
 	const CMetalData::Clusters& clusters = circuit->GetMetalManager()->GetClusters();
 	const CMetalData::Graph& clusterGraph = circuit->GetMetalManager()->GetGraph();
-	for (const CMetalData::Graph::Edge edge : spanningTree) {
+	for (unsigned edgeIdx = 0; edgeIdx < spanningTree.size(); ++edgeIdx) {
+		if (!spanningTree[edgeIdx]) {
+			continue;
+		}
+		CMetalData::Graph::Edge edge = clusterGraph.edgeFromId(edgeIdx);
 		const AIFloat3& posFrom = clusters[clusterGraph.id(clusterGraph.u(edge))].position;
 		const AIFloat3& posTo = clusters[clusterGraph.id(clusterGraph.v(edge))].position;
 		AIFloat3 pos0 = posFrom;
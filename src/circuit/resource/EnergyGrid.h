@@ -35,6 +35,7 @@ private:
 public:
 	void Update();
 	void SetForceRebuild(bool value) { isForceRebuild = value; }
+	void SetBeingBuilt(CEnergyLink* link, bool value);
 	CEnergyLink* GetLinkToBuild(CCircuitDef*& outDef, springai::AIFloat3& outPos);
 
 	float GetPylonRange(CCircuitDef::Id defId);
@@ -66,7 +67,7 @@ private:
 	class DetectLink;
 	using OwnedFilter = CMetalData::Graph::NodeMap<bool>;
 	using OwnedGraph = lemon::FilterNodes<const CMetalData::Graph, OwnedFilter>;
-	using SpanningTree = std::set<CMetalData::Graph::Edge>;
+	using SpanningTree = std::vector<bool>;  // edge id: is in tree
 	using SpanningGraph = lemon::FilterEdges<const CMetalData::Graph, SpanningLink>;
 	using SpanningBFS = lemon::Bfs<SpanningGraph>;
 
@@ -79,7 +80,12 @@ private:
 	SpanningGraph* spanningGraph;
 	SpanningBFS* spanningBfs;  // breadth-first search
 
+	std::vector<int> treeEdges;  // NOTE: micro-opt, candidate edges for Kruskal
+	std::vector<int> mstEdges;  // edges of last Kruskal, filter by spanningTree
+	std::vector<int> costEdges;  // links with changed cost since last Kruskal
+
 	void MarkClusters();
+	float EdgeCost(const CMetalData::Graph::Edge& edge) const;
 	void RebuildTree();
 
 #ifdef DEBUG_VIS
@@ -9,15 +9,20 @@
 #include "resource/EnergyLink.h"
 #include "util/utils.h"
 
-#include <queue>
+#include <algorithm>
+#include <limits>
 
 namespace circuit {
 
 using namespace springai;
 
+#define PYLON_CELL_SIZE	256.f
+
 CEnergyLink::CEnergyLink(int idx0, const AIFloat3& P0, int idx1, const AIFloat3& P1)
 		: v0(new SVertex(idx0, P0))
 		, v1(new SVertex(idx1, P1))
+		, maxRange(.0f)
+		, isDirty(false)
 		, isBeingBuilt(false)
 		, isFinished(false)
 		, isValid(true)
@@ -27,87 +32,109 @@ CEnergyLink::CEnergyLink(int idx0, const AIFloat3& P0, int idx1, const AIFloat3&
 CEnergyLink::~CEnergyLink()
 {
 	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
-	for (auto& kv : pylons) {
-		delete kv.second;
-	}
 	delete v0;
 	delete v1;
 }
 
 void CEnergyLink::AddPylon(ICoreUnit::Id unitId, const AIFloat3& pos, float range)
 {
-	if (pylons.find(unitId) != pylons.end()) {
+	if (pylonIds.find(unitId) != pylonIds.end()) {
 		return;
 	}
 
-	SPylon* pylon0 = new SPylon(pos, range);
-
-	for (auto& kv : pylons) {
-		SPylon* pylon1 = kv.second;
-		float dist = range + pylon1->range;
-		if (pos.SqDistance2D(pylon1->pos) < dist * dist) {
-			pylon0->neighbors.insert(pylon1);
-			pylon1->neighbors.insert(pylon0);
+	int index0;
+	if (freePylons.empty()) {
+		index0 = pylons.size();
+		pylons.emplace_back(pos, range);
+	} else {
+		index0 = freePylons.back();
+		freePylons.pop_back();
+		pylons[index0] = SPylon(pos, range);
+	}
+	pylons[index0].parent = index0;
+	pylonIds[unitId] = index0;
+	maxRange = std::max(maxRange, range);
+
+	// Neighbours from nearby cells only
+	const int cx = int(pos.x / PYLON_CELL_SIZE);
+	const int cz = int(pos.z / PYLON_CELL_SIZE);
+	const int cr = int((range + maxRange) / PYLON_CELL_SIZE) + 1;
+	for (int z = std::max(cz - cr, 0); z <= cz + cr; ++z) {
+		for (int x = std::max(cx - cr, 0); x <= cx + cr; ++x) {
+			auto it = cells.find(CellKey(x, z));
+			if (it == cells.end()) {
+				continue;
+			}
+			for (int index1 : it->second) {
+				SPylon& pylon1 = pylons[index1];
+				float dist = range + pylon1.range;
+				if (pos.SqDistance2D(pylon1.pos) < dist * dist) {
+					pylons[index0].neighbors.push_back(index1);
+					pylon1.neighbors.push_back(index0);
+					if (!isDirty) {
+						Union(index0, index1);
+					}
+				}
+			}
 		}
 	}
-
-	pylons[unitId] = pylon0;
+	cells[CellKey(cx, cz)].push_back(index0);
 
 	float sqRange = range * range;
 	if (v0->pos.SqDistance2D(pos) < sqRange) {
-		v0->pylons.insert(pylon0);
+		v0->pylons.push_back(index0);
 	}
 	if (v1->pos.SqDistance2D(pos) < sqRange) {
-		v1->pylons.insert(pylon0);
+		v1->pylons.push_back(index0);
 	}
 }
 
 bool CEnergyLink::RemovePylon(ICoreUnit::Id unitId)
 {
-	auto it = pylons.find(unitId);
-	if (it == pylons.end()) {
+	auto it = pylonIds.find(unitId);
+	if (it == pylonIds.end()) {
 		return false;
 	}
-	SPylon* pylon0 = it->second;
-
-	for (SPylon* pylon1 : pylon0->neighbors) {
-		pylon1->neighbors.erase(pylon0);
+	const int index0 = it->second;
+	pylonIds.erase(it);
+	SPylon& pylon0 = pylons[index0];
+
+	auto eraseIndex = [index0](std::vector<int>& indices) {
+		auto it = std::find(indices.begin(), indices.end(), index0);
+		if (it != indices.end()) {
+			*it = indices.back();
+			indices.pop_back();
+		}
+	};
+	for (int index1 : pylon0.neighbors) {
+		eraseIndex(pylons[index1].neighbors);
 	}
-	v0->pylons.erase(pylon0);
-	v1->pylons.erase(pylon0);
-	delete pylon0;
+	eraseIndex(cells[CellKey(int(pylon0.pos.x / PYLON_CELL_SIZE), int(pylon0.pos.z / PYLON_CELL_SIZE))]);
+	eraseIndex(v0->pylons);
+	eraseIndex(v1->pylons);
 
-	return it != pylons.erase(it);
+	pylon0.neighbors.clear();
+	pylon0.parent = -1;
+	freePylons.push_back(index0);
+	// NOTE: union-find can't split, rebuild on demand
+	isDirty = true;
+
+	return true;
 }
 
 void CEnergyLink::CheckConnection()
 {
-	int i = 0;
-	std::set<SPylon*> visited;
-	std::queue<SPylon*> queue;
-
-	for (SPylon* p : v0->pylons) {
-		queue.push(p);
+	if (isDirty) {
+		RebuildComponents();
 	}
 
-	while (!queue.empty()) {
-		SPylon* q = queue.front();
-		queue.pop();
-		float dist = q->range;
-		if (v1->pos.SqDistance2D(q->pos) < dist * dist) {
-			isFinished = true;
-			return;
-		}
-
-		if (i++ > 1000) {
-			isValid = false;
-			break;
-		}
-
-		visited.insert(q);
-		for (SPylon* child : q->neighbors) {
-			if (visited.find(child) == visited.end()) {
-				queue.push(child);
+	// Link is finished when some pylon at v0 shares component with some pylon at v1
+	for (int index0 : v0->pylons) {
+		const int root0 = FindRoot(index0);
+		for (int index1 : v1->pylons) {
+			if (FindRoot(index1) == root0) {
+				isFinished = true;
+				return;
 			}
 		}
 	}
@@ -124,40 +151,69 @@ void CEnergyLink::SetStartVertex(int index)
 
 CEnergyLink::SPylon* CEnergyLink::GetConnectionHead(SVertex* v0, const AIFloat3& P1)
 {
-	SPylon* winner = nullptr;
-	float minDist = std::numeric_limits<float>::max();
-
-	int i = 0;
-	std::set<SPylon*> visited;
-	std::queue<SPylon*> queue;
+	if (v0->pylons.empty()) {
+		return nullptr;
+	}
+	if (isDirty) {
+		RebuildComponents();
+	}
 
-	for (SPylon* p : v0->pylons) {
-		queue.push(p);
+	std::vector<int> roots;
+	roots.reserve(v0->pylons.size());
+	for (int index : v0->pylons) {
+		roots.push_back(FindRoot(index));
 	}
 
-	while (!queue.empty()) {
-		SPylon* q = queue.front();
-		queue.pop();
-		float dist = P1.distance2D(q->pos) - q->range;
+	// Closest to P1 pylon among those connected to v0
+	SPylon* winner = nullptr;
+	float minDist = std::numeric_limits<float>::max();
+	for (unsigned index = 0; index < pylons.size(); ++index) {
+		SPylon& q = pylons[index];
+		if ((q.parent < 0) || (std::find(roots.begin(), roots.end(), FindRoot(index)) == roots.end())) {
+			continue;
+		}
+		float dist = P1.distance2D(q.pos) - q.range;
 		if (dist < minDist) {
 			minDist = dist;
-			winner = q;
+			winner = &q;
 		}
+	}
 
-		if (i++ > 1000) {
-			isValid = false;
-			return winner;
-		}
+	return winner;
+}
 
-		visited.insert(q);
-		for (SPylon* child : q->neighbors) {
-			if (visited.find(child) == visited.end()) {
-				queue.push(child);
-			}
-		}
+int CEnergyLink::FindRoot(int index)
+{
+	while (pylons[index].parent != index) {
+		int& parent = pylons[index].parent;
+		parent = pylons[parent].parent;  // path halving
+		index = parent;
+	}
+	return index;
+}
+
+void CEnergyLink::Union(int index0, int index1)
+{
+	const int root0 = FindRoot(index0);
+	const int root1 = FindRoot(index1);
+	if (root0 != root1) {
+		pylons[root1].parent = root0;
 	}
+}
 
-	return winner;
+void CEnergyLink::RebuildComponents()
+{
+	isDirty = false;
+	for (unsigned index = 0; index < pylons.size(); ++index) {
+		if (pylons[index].parent >= 0) {
+			pylons[index].parent = index;
+		}
+	}
+	for (unsigned index0 = 0; index0 < pylons.size(); ++index0) {
+		for (int index1 : pylons[index0].neighbors) {
+			Union(index0, index1);
+		}
+	}
 }
 
 } // namespace circuit
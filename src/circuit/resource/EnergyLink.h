@@ -10,23 +10,24 @@
 
 #include "unit/CircuitUnit.h"
 
-#include <map>
-#include <set>
+#include <unordered_map>
+#include <vector>
 
 namespace circuit {
 
 class CEnergyLink {
 public:
 	struct SPylon {
-		SPylon() : pos(-RgtVector), range(.0f) {}
-		SPylon(const springai::AIFloat3& p, float r) : pos(p), range(r) {}
+		SPylon() : pos(-RgtVector), range(.0f), parent(-1) {}
+		SPylon(const springai::AIFloat3& p, float r) : pos(p), range(r), parent(-1) {}
 		springai::AIFloat3 pos;
 		float range;
-		std::set<SPylon*> neighbors;
+		int parent;  // union-find, -1 for free slot
+		std::vector<int> neighbors;  // indices in pylons pool
 	};
 	struct SVertex {
 		SVertex(int index, const springai::AIFloat3& pos) : index(index), pos(pos) {}
-		std::set<SPylon*> pylons;
+		std::vector<int> pylons;  // indices in pylons pool
 		int index;
 		springai::AIFloat3 pos;
 	};
@@ -51,7 +52,20 @@ public:
 private:
 	SVertex *v0, *v1;
 
-	std::map<ICoreUnit::Id, SPylon*> pylons;  // owner
+	std::unordered_map<ICoreUnit::Id, int> pylonIds;  // unitId: index in pylons
+	std::vector<SPylon> pylons;  // pool
+	std::vector<int> freePylons;
+	float maxRange;
+	bool isDirty;  // pylon was removed, components must be rebuilt
+
+	// Spatial hash of pylons, cell: indices in pylons
+	std::unordered_map<int, std::vector<int>> cells;
+	static int CellKey(int x, int z) { return (z << 16) | x; }
+
+	int FindRoot(int index);
+	void Union(int index0, int index1);
+	void RebuildComponents();
+
 	bool isBeingBuilt;
 	bool isFinished;
 	bool isValid;
@@ -0,0 +1,233 @@
+/*
+ * FeatureData.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#include "resource/FeatureData.h"
+#include "module/EconomyManager.h"
+#include "terrain/TerrainManager.h"
+#include "CircuitAI.h"
+#include "util/utils.h"
+
+#include "SSkirmishAICallback.h"
+#include "Resource.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace circuit {
+
+using namespace springai;
+
+#define FEATURE_UPDATE_RATE	FRAMES_PER_SEC
+#define FEATURE_CELL_SIZE	512
+#define FEATURE_CONFIRM_RADIUS	(SQUARE_SIZE * 4.f)
+#define FEATURE_CONFIRM_MAX		32
+
+CFeatureData::CFeatureData(CCircuitAI* circuit)
+		: circuit(circuit)
+		, updateFrame(-FEATURE_UPDATE_RATE)
+		, cellSize(FEATURE_CELL_SIZE)
+		, maxValue(-1.f)
+{
+	width = (CTerrainManager::GetTerrainWidth() + cellSize - 1) / cellSize;
+	height = (CTerrainManager::GetTerrainHeight() + cellSize - 1) / cellSize;
+	cells.resize(width * height);
+}
+
+CFeatureData::~CFeatureData()
+{
+	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
+}
+
+void CFeatureData::Update()
+{
+	const int frame = circuit->GetLastFrame();
+	if (updateFrame + FEATURE_UPDATE_RATE > frame) {
+		return;
+	}
+	updateFrame = frame;
+
+	// NOTE: OOAICallback::GetFeatures allocates Feature per id, C API fills existing buffer
+	const SSkirmishAICallback* clb = circuit->GetSkirmishAICallback();
+	const int skirmishAIId = circuit->GetSkirmishAIId();
+	engineIds.resize(clb->getFeatures(skirmishAIId, nullptr, 0));
+	engineIds.resize(clb->getFeatures(skirmishAIId, engineIds.data(), engineIds.size()));
+
+	const int metalId = circuit->GetEconomyManager()->GetMetalRes()->GetResourceId();
+	for (Id featureId : engineIds) {
+		auto it = indices.find(featureId);
+		if (it != indices.end()) {
+			features[it->second].mark = frame;
+			continue;
+		}
+
+		const int defId = clb->Feature_getDef(skirmishAIId, featureId);
+		auto vit = defValues.find(defId);
+		if (vit == defValues.end()) {
+			const float value = clb->FeatureDef_isReclaimable(skirmishAIId, defId)
+					? clb->FeatureDef_getContainedResource(skirmishAIId, defId, metalId)
+					: -1.f;
+			vit = defValues.insert(std::make_pair(defId, value)).first;
+		}
+
+		float pos_posF3[3];
+		clb->Feature_getPosition(skirmishAIId, featureId, pos_posF3);
+		AIFloat3 pos(pos_posF3[0], pos_posF3[1], pos_posF3[2]);
+		CTerrainManager::CorrectPosition(pos);  // Impulsed flying feature
+		AddFeature(featureId, pos, vit->second);
+		features.back().mark = frame;
+	}
+
+	maxValue = -1.f;
+	for (int i = features.size() - 1; i >= 0; --i) {
+		if (features[i].mark != frame) {
+			DelFeature(i);
+		} else {
+			maxValue = std::max(maxValue, features[i].value);
+		}
+	}
+}
+
+bool CFeatureData::HasFeaturesIn(const AIFloat3& pos, float radius)
+{
+	Update();
+	int index;
+	while ((index = FindAnyIn(pos, radius)) >= 0) {
+		if (IsAlive(features[index])) {
+			return true;
+		}
+		DelFeature(index);
+	}
+	return false;
+}
+
+const CFeatureData::SFeature* CFeatureData::FindNearest(const AIFloat3& pos, float maxDist, float minValue,
+		FeaturePredicate&& predicate)
+{
+	Update();
+	if ((maxValue <= 0.f) || (maxValue < minValue)) {
+		return nullptr;
+	}
+
+	int index;
+	while ((index = FindBest(pos, maxDist, minValue, predicate)) >= 0) {
+		if (IsAlive(features[index])) {
+			return &features[index];
+		}
+		DelFeature(index);
+	}
+	return nullptr;
+}
+
+int CFeatureData::FindAnyIn(const AIFloat3& pos, float radius) const
+{
+	const float sqRadius = SQUARE(radius);
+	const int x0 = utils::clamp(int(pos.x - radius) / cellSize, 0, width - 1);
+	const int x1 = utils::clamp(int(pos.x + radius) / cellSize, 0, width - 1);
+	const int z0 = utils::clamp(int(pos.z - radius) / cellSize, 0, height - 1);
+	const int z1 = utils::clamp(int(pos.z + radius) / cellSize, 0, height - 1);
+	for (int z = z0; z <= z1; ++z) {
+		for (int x = x0; x <= x1; ++x) {
+			for (int index : cells[z * width + x]) {
+				const SFeature& feature = features[index];
+				if ((feature.value >= 0.f) && (pos.SqDistance2D(feature.pos) <= sqRadius)) {
+					return index;
+				}
+			}
+		}
+	}
+	return -1;
+}
+
+int CFeatureData::FindBest(const AIFloat3& pos, float maxDist, float minValue, FeaturePredicate& predicate) const
+{
+	const int cx = utils::clamp(int(pos.x) / cellSize, 0, width - 1);
+	const int cz = utils::clamp(int(pos.z) / cellSize, 0, height - 1);
+	const int maxRing = std::min(maxDist / cellSize + 1.f, (float)std::max(width, height));
+	const float sqMaxDist = SQUARE(maxDist);
+	int best = -1;
+	float bestMetric = std::numeric_limits<float>::max();
+
+	// Rings of cells around pos, ring can't contain better feature than (ring distance)^2 / maxValue
+	for (int r = 0; r <= maxRing; ++r) {
+		if (SQUARE(std::max(r - 1, 0) * cellSize) / maxValue >= bestMetric) {
+			break;
+		}
+		for (int z = cz - r; z <= cz + r; ++z) {
+			if ((z < 0) || (z >= height)) {
+				continue;
+			}
+			const int step = ((z == cz - r) || (z == cz + r)) ? 1 : 2 * r;
+			for (int x = cx - r; x <= cx + r; x += step) {
+				if ((x < 0) || (x >= width)) {
+					continue;
+				}
+				for (int index : cells[z * width + x]) {
+					const SFeature& feature = features[index];
+					if ((feature.value < minValue) || (feature.value <= 0.f)) {
+						continue;
+					}
+					const float sqDist = pos.SqDistance2D(feature.pos);
+					if (sqDist > sqMaxDist) {
+						continue;
+					}
+					const float metric = sqDist / feature.value;
+					if ((metric < bestMetric) && predicate(feature)) {
+						best = index;
+						bestMetric = metric;
+					}
+				}
+			}
+		}
+	}
+	return best;
+}
+
+bool CFeatureData::IsAlive(const SFeature& feature) const
+{
+	float pos_posF3[3] = {feature.pos.x, feature.pos.y, feature.pos.z};
+	int featureIds[FEATURE_CONFIRM_MAX];
+	const int count = circuit->GetSkirmishAICallback()->getFeaturesIn(circuit->GetSkirmishAIId(), pos_posF3,
+			FEATURE_CONFIRM_RADIUS, featureIds, FEATURE_CONFIRM_MAX);
+	const int* begin = featureIds;
+	const int* end = begin + std::min(count, FEATURE_CONFIRM_MAX);
+	return std::find(begin, end, feature.id) != end;
+}
+
+void CFeatureData::AddFeature(Id id, const AIFloat3& pos, float value)
+{
+	const int index = features.size();
+	const int cell = GetCell(pos);
+	features.push_back({id, pos, value, cell, -1});
+	indices[id] = index;
+	cells[cell].push_back(index);
+}
+
+void CFeatureData::DelFeature(int index)
+{
+	std::vector<int>& cell = cells[features[index].cell];
+	*std::find(cell.begin(), cell.end(), index) = cell.back();
+	cell.pop_back();
+	indices.erase(features[index].id);
+
+	const int last = features.size() - 1;
+	if (index != last) {
+		features[index] = features[last];
+		std::vector<int>& lastCell = cells[features[index].cell];
+		*std::find(lastCell.begin(), lastCell.end(), last) = index;
+		indices[features[index].id] = index;
+	}
+	features.pop_back();
+}
+
+int CFeatureData::GetCell(const AIFloat3& pos) const
+{
+	const int x = utils::clamp(int(pos.x) / cellSize, 0, width - 1);
+	const int z = utils::clamp(int(pos.z) / cellSize, 0, height - 1);
+	return z * width + x;
+}
+
+} // namespace circuit
@@ -0,0 +1,73 @@
+/*
+ * FeatureData.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#ifndef SRC_CIRCUIT_RESOURCE_FEATUREDATA_H_
+#define SRC_CIRCUIT_RESOURCE_FEATUREDATA_H_
+
+#include "AIFloat3.h"
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace circuit {
+
+class CCircuitAI;
+
+/*
+ * Features (wrecks) of ally team in uniform grid with cached reclaim value per FeatureDef.
+ * AI interface has no feature events: registry syncs ids with engine at most once per FEATURE_UPDATE_RATE, on query.
+ * Registry may be stale between syncs, feature picked by query is confirmed by engine around its position.
+ */
+class CFeatureData {
+public:
+	using Id = int;
+	struct SFeature {
+		Id id;
+		springai::AIFloat3 pos;
+		float value;  // contained metal, < 0 if not reclaimable
+		int cell;
+		int mark;
+	};
+	using FeaturePredicate = std::function<bool (const SFeature& feature)>;
+
+	CFeatureData(CCircuitAI* circuit);
+	virtual ~CFeatureData();
+
+	void SetAuthority(CCircuitAI* authority) { circuit = authority; }
+
+	void Update();
+	bool HasFeaturesIn(const springai::AIFloat3& pos, float radius);  // reclaimable
+	// Feature with the lowest sqDist/value, nullptr if none. Pointer is valid until next query
+	const SFeature* FindNearest(const springai::AIFloat3& pos, float maxDist, float minValue, FeaturePredicate&& predicate);
+
+private:
+	int FindAnyIn(const springai::AIFloat3& pos, float radius) const;
+	int FindBest(const springai::AIFloat3& pos, float maxDist, float minValue, FeaturePredicate& predicate) const;
+	bool IsAlive(const SFeature& feature) const;
+	void AddFeature(Id id, const springai::AIFloat3& pos, float value);
+	void DelFeature(int index);
+	int GetCell(const springai::AIFloat3& pos) const;
+
+	CCircuitAI* circuit;
+	int updateFrame;
+
+	int cellSize;
+	int width;
+	int height;
+	std::vector<std::vector<int>> cells;  // indices of features
+
+	std::vector<SFeature> features;
+	std::unordered_map<Id, int> indices;  // feature id: index in features
+	std::unordered_map<int, float> defValues;  // FeatureDef id: value
+	float maxValue;
+	std::vector<int> engineIds;  // persistent buffer of sync
+};
+
+} // namespace circuit
+
+#endif // SRC_CIRCUIT_RESOURCE_FEATUREDATA_H_
@@ -18,6 +18,69 @@ namespace circuit {
 using namespace springai;
 using namespace nanoflann;
 
+class CMaskResultSet: public KNNResultSet<float, int> {
+public:
+	CMaskResultSet(const CMetalData::SMask& mask) : KNNResultSet<float, int>(1), mask(mask) {}
+	inline bool condition(const int index) const { return mask.Test(index); }
+private:
+	const CMetalData::SMask& mask;
+};
+
+void CMetalData::SMask::Resize(unsigned size, bool value)
+{
+	words.assign((size + 63) / 64, value ? ~(uint64_t)0 : 0);
+	if (value && (size % 64 != 0)) {
+		words.back() = ((uint64_t)1 << (size % 64)) - 1;  // Any() relies on clear tail
+	}
+}
+
+bool CMetalData::SMask::Any() const
+{
+	for (uint64_t word : words) {
+		if (word != 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void CMetalData::SMask::And(const SMask& other)
+{
+	for (unsigned i = 0; i < words.size(); ++i) {
+		words[i] &= other.words[i];
+	}
+}
+
+void CMetalData::SMask::AndNot(const SMask& other)
+{
+	for (unsigned i = 0; i < words.size(); ++i) {
+		words[i] &= ~other.words[i];
+	}
+}
+
+void CMetalData::SMask::Or(const SMask& other)
+{
+	for (unsigned i = 0; i < words.size(); ++i) {
+		words[i] |= other.words[i];
+	}
+}
+
+int CMetalData::SMask::FindNext(int index) const
+{
+	unsigned i = index >> 6;
+	if (i >= words.size()) {
+		return -1;
+	}
+	uint64_t word = words[i] & (~(uint64_t)0 << (index & 63));
+	while (word == 0) {
+		if (++i >= words.size()) {
+			return -1;
+		}
+		word = words[i];
+	}
+	return (i << 6) + __builtin_ctzll(word);
+}
+
 CMetalData::CMetalData()
 		: isInitialized(false)
 		, spotsAdaptor(spots)
@@ -78,6 +141,21 @@ const int CMetalData::FindNearestSpot(const AIFloat3& pos, PointPredicate& predi
 	return -1;
 }
 
+const int CMetalData::FindNearestSpot(const AIFloat3& pos, const SMask& mask) const
+{
+	if (!mask.Any()) {
+		return -1;
+	}
+	float query_pt[2] = {pos.x, pos.z};
+	int ret_index;
+	float out_dist_sqr;
+
+	CMaskResultSet resultSet(mask);
+	resultSet.init(&ret_index, &out_dist_sqr);
+	metalTree.findNeighbors(resultSet, &query_pt[0], SearchParams());
+	return (resultSet.size() > 0) ? ret_index : -1;
+}
+
 const int CMetalData::FindNearestCluster(const AIFloat3& pos) const
 {
 	float query_pt[2] = {pos.x, pos.z};
@@ -102,6 +180,21 @@ const int CMetalData::FindNearestCluster(const AIFloat3& pos, PointPredicate& pr
 	return -1;
 }
 
+const int CMetalData::FindNearestCluster(const AIFloat3& pos, const SMask& mask) const
+{
+	if (!mask.Any()) {
+		return -1;
+	}
+	float query_pt[2] = {pos.x, pos.z};
+	int ret_index;
+	float out_dist_sqr;
+
+	CMaskResultSet resultSet(mask);
+	resultSet.init(&ret_index, &out_dist_sqr);
+	clusterTree.findNeighbors(resultSet, &query_pt[0], SearchParams());
+	return (resultSet.size() > 0) ? ret_index : -1;
+}
+
 void CMetalData::Clusterize(float maxDistance, std::shared_ptr<CRagMatrix> distMatrix)
 {
 	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
@@ -146,6 +239,58 @@ void CMetalData::Clusterize(float maxDistance, std::shared_ptr<CRagMatrix> distM
 	isClusterizing = false;
 }
 
+void CMetalData::SaveClusters(std::ostream& os) const
+{
+	const uint32_t spotCount = spots.size();
+	const uint32_t size = clusters.size();
+	utils::binary_write(os, spotCount);
+	utils::binary_write(os, size);
+	for (const SCluster& c : clusters) {
+		utils::binary_write(os, c.idxSpots);
+		utils::binary_write(os, c.position);
+		utils::binary_write(os, c.weightCentr);
+		utils::binary_write(os, c.income);
+	}
+}
+
+bool CMetalData::LoadClusters(std::istream& is)
+{
+	uint32_t spotCount = 0, size = 0;
+	utils::binary_read(is, spotCount);
+	utils::binary_read(is, size);
+	if (!is || (spotCount != spots.size()) || (size == 0)) {  // different map or metal config
+		return false;
+	}
+	Clusters newClusters(size);
+	for (SCluster& c : newClusters) {
+		utils::binary_read(is, c.idxSpots);
+		utils::binary_read(is, c.position);
+		utils::binary_read(is, c.weightCentr);
+		utils::binary_read(is, c.income);
+		if (!is) {
+			return false;
+		}
+		for (int idx : c.idxSpots) {
+			if ((idx < 0) || ((unsigned)idx >= spots.size())) {
+				return false;
+			}
+		}
+	}
+
+	clusters = std::move(newClusters);
+	clusterGraph.clear();
+	clusterGraph.reserveNode(clusters.size());
+	for (unsigned i = 0; i < clusters.size(); ++i) {
+		clusterGraph.addNode();
+	}
+	clusterTree.buildIndex();
+
+	BuildClusterGraph();
+
+	isClusterizing = false;
+	return true;
+}
+
 void CMetalData::TriangulateGraph(const std::vector<double>& coords,
 		std::function<float (std::size_t A, std::size_t B)> distance,
 		std::function<void (std::size_t A, std::size_t B)> addEdge)
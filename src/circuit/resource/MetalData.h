@@ -14,7 +14,10 @@
 #include "lemon/smart_graph.h"
 
 #include <vector>
+#include <algorithm>
 #include <atomic>
+#include <cstdint>
+#include <iosfwd>
 #include <memory>
 #include <set>
 
@@ -55,6 +58,29 @@ public:
 		bool kdtree_get_bbox(BBOX& /* bb */) const { return false; }
 	};
 	using PointPredicate = nanoflann::KNNCondResultSet<float, int>::Predicate;
+	/*
+	 * Bit per spot or per cluster, masks are combined by words.
+	 * Nearest search tests mask inline and skips tree walk when mask is empty.
+	 */
+	struct SMask {
+		void Resize(unsigned size, bool value);
+		void Clear() { std::fill(words.begin(), words.end(), 0); }
+		void Set(int index, bool value) {
+			if (value) {
+				words[index >> 6] |= (uint64_t)1 << (index & 63);
+			} else {
+				words[index >> 6] &= ~((uint64_t)1 << (index & 63));
+			}
+		}
+		bool Test(int index) const { return (words[index >> 6] >> (index & 63)) & 1; }
+		bool Any() const;
+		void And(const SMask& other);
+		void AndNot(const SMask& other);
+		void Or(const SMask& other);
+		int FindNext(int index) const;  // first set bit >= index, -1 if none
+	private:
+		std::vector<uint64_t> words;
+	};
 	using MetalIndices = std::vector<int>;
 	struct SCluster {
 		MetalIndices idxSpots;
@@ -82,9 +108,11 @@ public:
 	const Metals& GetSpots() const { return spots; }
 	const int FindNearestSpot(const springai::AIFloat3& pos) const;
 	const int FindNearestSpot(const springai::AIFloat3& pos, PointPredicate& predicate) const;
+	const int FindNearestSpot(const springai::AIFloat3& pos, const SMask& mask) const;
 
 	const int FindNearestCluster(const springai::AIFloat3& pos) const;
 	const int FindNearestCluster(const springai::AIFloat3& pos, PointPredicate& predicate) const;
+	const int FindNearestCluster(const springai::AIFloat3& pos, const SMask& mask) const;
 
 	const Clusters& GetClusters() const { return clusters; }
 	const Graph& GetGraph() const { return clusterGraph; }
@@ -96,6 +124,10 @@ public:
 	 */
 	void Clusterize(float maxDistance, std::shared_ptr<CRagMatrix> distmatrix);
 
+	// Snapshot of clusterization result, graph and tree are rebuilt on load
+	void SaveClusters(std::ostream& os) const;
+	bool LoadClusters(std::istream& is);
+
 	// debug, could be used for defence perimeter calculation
 //	void DrawConvexHulls(springai::Drawer* drawer);
 //	void DrawCentroids(springai::Drawer* drawer);
@@ -7,8 +7,10 @@
 
 #include "resource/MetalManager.h"
 #include "module/EconomyManager.h"
+#include "setup/DefenceMatrix.h"
 #include "terrain/TerrainManager.h"
 #include "terrain/ThreatMap.h"
+#include "unit/AllyTeam.h"
 #include "CircuitAI.h"
 #include "util/math/RagMatrix.h"
 #include "util/Scheduler.h"
@@ -42,8 +44,9 @@ private:
 
 class CMetalManager::DetectCluster : public lemon::MapBase<ClusterGraph::Node, bool> {
 public:
-	DetectCluster(CMetalManager* mgr, CMetalData::PointPredicate& pred, std::vector<int>& outIdxs)
+	DetectCluster(CMetalManager* mgr, const CMetalData::SMask& msk, CMetalData::PointPredicate& pred, std::vector<int>& outIdxs)
 		: manager(mgr)
+		, mask(msk)
 		, predicate(pred)
 		, indices(outIdxs)
 	{}
@@ -53,7 +56,7 @@ public:
 			return false;
 		}
 		for (int index : manager->GetClusters()[u].idxSpots) {
-			if (predicate(index)) {
+			if (mask.Test(index) && predicate(index)) {
 				indices.push_back(index);
 			}
 		}
@@ -61,6 +64,7 @@ public:
 	}
 private:
 	CMetalManager* manager;
+	const CMetalData::SMask& mask;
 	CMetalData::PointPredicate predicate;
 	std::vector<int>& indices;
 };
@@ -69,6 +73,7 @@ CMetalManager::CMetalManager(CCircuitAI* circuit, CMetalData* metalData)
 		: circuit(circuit)
 		, metalData(metalData)
 		, markFrame(-1)
+		, reachUpdateNum(-1)
 		, threatFilter(nullptr)
 		, filteredGraph(nullptr)
 		, shortPath(nullptr)
@@ -79,7 +84,9 @@ CMetalManager::CMetalManager(CCircuitAI* circuit, CMetalData* metalData)
 		// TODO: Add metal zone and no-metal-spots maps support
 		ParseMetalSpots();
 	}
-	metalInfos.resize(metalData->GetSpots().size(), {true, -1});
+	metalInfos.resize(metalData->GetSpots().size(), {-1, 0});
+	openSpots.Resize(metalData->GetSpots().size(), true);
+	mexSpots.Resize(metalData->GetSpots().size(), false);
 }
 
 CMetalManager::~CMetalManager()
@@ -99,6 +106,8 @@ void CMetalManager::Init()
 			metalInfos[idx].clusterId = i;
 		}
 	}
+	queuedClusters.Resize(clusterInfos.size(), false);
+	finishedClusters.Resize(clusterInfos.size(), false);
 
 	threatFilter = new SafeCluster(circuit->GetThreatMap(), GetClusters());
 	filteredGraph = new ClusterGraph(GetGraph(), *threatFilter);
@@ -209,9 +218,10 @@ void CMetalManager::ClusterizeMetal(CCircuitDef* commDef)
 
 void CMetalManager::SetOpenSpot(int index, bool value)
 {
-	if (metalInfos[index].isOpen != value) {
-		metalInfos[index].isOpen = value;
+	if (openSpots.Test(index) != value) {
+		openSpots.Set(index, value);
 		clusterInfos[metalInfos[index].clusterId].queuedCount += value ? -1 : 1;
+		UpdateClusterMasks(metalInfos[index].clusterId);
 	}
 }
 
@@ -276,10 +286,14 @@ void CMetalManager::MarkAllyMexes(const std::vector<CAllyUnit*>& mexes)
 			mex.unitId = unit->GetId();
 			*d_first++ = mex;
 			clusterInfos[metalInfos[mex.index].clusterId].finishedCount++;
+			mexSpots.Set(mex.index, ++metalInfos[mex.index].mexCount > 0);
+			UpdateClusterMasks(metalInfos[mex.index].clusterId);
 		}
 	};
 	auto delMex = [this](const SMex& mex) {
 		clusterInfos[metalInfos[mex.index].clusterId].finishedCount--;
+		mexSpots.Set(mex.index, --metalInfos[mex.index].mexCount > 0);
+		UpdateClusterMasks(metalInfos[mex.index].clusterId);
 	};
 
 	// @see std::set_symmetric_difference + std::set_intersection
@@ -313,14 +327,37 @@ void CMetalManager::MarkAllyMexes(const std::vector<CAllyUnit*>& mexes)
 bool CMetalManager::IsMexInFinished(int index) const
 {
 	// NOTE: finishedCount updated on lazy MarkAllyMexes call, thus can be invalid
-	int idx = metalInfos[index].clusterId;
-	return clusterInfos[idx].finishedCount >= GetClusters()[idx].idxSpots.size();
+	return IsClusterFinished(metalInfos[index].clusterId);
 }
 
-int CMetalManager::GetMexToBuild(const AIFloat3& pos, CMetalData::PointPredicate& predicate)
+const CMetalData::SMask& CMetalManager::GetReachableSpots(STerrainMapArea* area)
+{
+	return GetReachMask(area).spots;
+}
+
+const CMetalData::SMask& CMetalManager::GetReachableClusters(STerrainMapArea* area)
+{
+	return GetReachMask(area).clusters;
+}
+
+void CMetalManager::SpotsToClusters(const CMetalData::SMask& spotMask, CMetalData::SMask& outClusters) const
+{
+	const CMetalData::Clusters& clusters = GetClusters();
+	outClusters.Resize(clusters.size(), false);
+	for (unsigned i = 0; i < clusters.size(); ++i) {
+		for (int index : clusters[i].idxSpots) {
+			if (spotMask.Test(index)) {
+				outClusters.Set(i, true);
+				break;
+			}
+		}
+	}
+}
+
+int CMetalManager::GetMexToBuild(const AIFloat3& pos, const CMetalData::SMask& mask, CMetalData::PointPredicate& predicate)
 {
 	int index = FindNearestCluster(pos);
-	if (index < 0 || !(*threatFilter)[index]) {
+	if ((index < 0) || !mask.Any() || !(*threatFilter)[index]) {
 		return -1;
 	}
 	MarkAllyMexes();
@@ -328,7 +365,7 @@ int CMetalManager::GetMexToBuild(const AIFloat3& pos, CMetalData::PointPredicate
 	static std::vector<int> indices;  // NOTE: micro-opt
 	int result = -1;
 
-	DetectCluster goal(this, predicate, indices);
+	DetectCluster goal(this, mask, predicate, indices);
 	shortPath->init();
 	shortPath->addSource(filteredGraph->nodeFromId(index));
 	CMetalData::Graph::Node target = shortPath->start(goal);
@@ -348,4 +385,39 @@ int CMetalManager::GetMexToBuild(const AIFloat3& pos, CMetalData::PointPredicate
 	return result;
 }
 
+void CMetalManager::UpdateClusterMasks(int index)
+{
+	const unsigned size = GetClusters()[index].idxSpots.size();
+	queuedClusters.Set(index, clusterInfos[index].queuedCount >= size);
+	const bool isFinished = clusterInfos[index].finishedCount >= size;
+	if (finishedClusters.Test(index) != isFinished) {
+		finishedClusters.Set(index, isFinished);
+		circuit->GetAllyTeam()->GetDefenceMatrix()->SetFinished(index, isFinished);
+	}
+}
+
+CMetalManager::SReachMask& CMetalManager::GetReachMask(STerrainMapArea* area)
+{
+	CTerrainManager* terrainManager = circuit->GetTerrainManager();
+	if (reachUpdateNum != terrainManager->GetAreaUpdateNum()) {
+		reachUpdateNum = terrainManager->GetAreaUpdateNum();
+		reachMasks.clear();
+	}
+	auto it = reachMasks.find(area);
+	if (it != reachMasks.end()) {
+		return it->second;
+	}
+
+	SReachMask& reach = reachMasks[area];
+	const CMetalData::Metals& spots = GetSpots();
+	reach.spots.Resize(spots.size(), false);
+	for (unsigned i = 0; i < spots.size(); ++i) {
+		if (terrainManager->CanMoveToPos(area, spots[i].position)) {
+			reach.spots.Set(i, true);
+		}
+	}
+	SpotsToClusters(reach.spots, reach.clusters);
+	return reach;
+}
+
 } // namespace circuit
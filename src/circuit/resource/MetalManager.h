@@ -13,10 +13,13 @@
 #include "lemon/adaptors.h"
 #include "lemon/dijkstra.h"
 
+#include <unordered_map>
+
 namespace circuit {
 
 class CCircuitAI;
 class CMetalData;
+struct STerrainMapArea;
 class CScheduler;
 class CGameTask;
 class CRagMatrix;
@@ -47,6 +50,9 @@ public:
 	const int FindNearestSpot(const springai::AIFloat3& pos, CMetalData::PointPredicate& predicate) const {
 		return metalData->FindNearestSpot(pos, predicate);
 	}
+	const int FindNearestSpot(const springai::AIFloat3& pos, const CMetalData::SMask& mask) const {
+		return metalData->FindNearestSpot(pos, mask);
+	}
 
 	const int FindNearestCluster(const springai::AIFloat3& pos) const {
 		return metalData->FindNearestCluster(pos);
@@ -54,6 +60,9 @@ public:
 	const int FindNearestCluster(const springai::AIFloat3& pos, CMetalData::PointPredicate& predicate) const {
 		return metalData->FindNearestCluster(pos, predicate);
 	}
+	const int FindNearestCluster(const springai::AIFloat3& pos, const CMetalData::SMask& mask) const {
+		return metalData->FindNearestCluster(pos, mask);
+	}
 
 	const CMetalData::Clusters& GetClusters() const { return metalData->GetClusters(); }
 	const CMetalData::Graph& GetGraph() const { return metalData->GetGraph(); }
@@ -63,20 +72,26 @@ public:
 public:
 	void SetOpenSpot(int index, bool value);
 	void SetOpenSpot(const springai::AIFloat3& pos, bool value);
-	bool IsOpenSpot(int index) const { return metalInfos[index].isOpen; }
+	bool IsOpenSpot(int index) const { return openSpots.Test(index); }
 	bool IsOpenSpot(const springai::AIFloat3& pos) const;
 	void MarkAllyMexes();
 	void MarkAllyMexes(const std::vector<CAllyUnit*>& mexes);
-	bool IsClusterFinished(int index) const {
-		return clusterInfos[index].finishedCount >= GetClusters()[index].idxSpots.size();
-	}
-	bool IsClusterQueued(int index) const {
-		return clusterInfos[index].queuedCount >= GetClusters()[index].idxSpots.size();
-	}
+	bool IsClusterFinished(int index) const { return finishedClusters.Test(index); }
+	bool IsClusterQueued(int index) const { return queuedClusters.Test(index); }
 	bool IsMexInFinished(int index) const;
 	int GetCluster(int index) const { return metalInfos[index].clusterId; }
 
-	int GetMexToBuild(const springai::AIFloat3& pos, CMetalData::PointPredicate& predicate);
+	// Masks of spot and cluster states, maintained by setters above
+	const CMetalData::SMask& GetOpenSpots() const { return openSpots; }
+	const CMetalData::SMask& GetMexSpots() const { return mexSpots; }  // with ally mex, lazy as MarkAllyMexes
+	const CMetalData::SMask& GetQueuedClusters() const { return queuedClusters; }
+	const CMetalData::SMask& GetFinishedClusters() const { return finishedClusters; }
+	// Cached per area until area update, cluster is reachable if any of its spots is
+	const CMetalData::SMask& GetReachableSpots(STerrainMapArea* area);
+	const CMetalData::SMask& GetReachableClusters(STerrainMapArea* area);
+	void SpotsToClusters(const CMetalData::SMask& spotMask, CMetalData::SMask& outClusters) const;
+
+	int GetMexToBuild(const springai::AIFloat3& pos, const CMetalData::SMask& mask, CMetalData::PointPredicate& predicate);
 
 	float GetMinIncome() const { return metalData->GetMinIncome(); }
 	float GetAvgIncome() const { return metalData->GetAvgIncome(); }
@@ -87,8 +102,8 @@ private:
 	CMetalData* metalData;
 
 	struct SMetalInfo {
-		bool isOpen;
 		int clusterId;
+		int mexCount;
 	};
 	struct SClusterInfo {
 		unsigned int queuedCount;
@@ -96,6 +111,20 @@ private:
 	};
 	std::vector<SMetalInfo> metalInfos;
 	std::vector<SClusterInfo> clusterInfos;
+	void UpdateClusterMasks(int index);
+
+	CMetalData::SMask openSpots;
+	CMetalData::SMask mexSpots;
+	CMetalData::SMask queuedClusters;
+	CMetalData::SMask finishedClusters;
+
+	struct SReachMask {
+		CMetalData::SMask spots;
+		CMetalData::SMask clusters;
+	};
+	SReachMask& GetReachMask(STerrainMapArea* area);
+	std::unordered_map<STerrainMapArea*, SReachMask> reachMasks;
+	unsigned reachUpdateNum;  // area update reachMasks were built for
 
 	int markFrame;
 	struct SMex {
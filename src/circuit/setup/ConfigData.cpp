@@ -0,0 +1,547 @@
+/*
+ * ConfigData.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#include "setup/ConfigData.h"
+#include "CircuitAI.h"
+#include "util/utils.h"
+#include "json/json.h"
+
+#include "UnitDef.h"
+
+namespace circuit {
+
+using namespace springai;
+
+CConfigData::SBehaviour::SBehaviour()
+		: mainRole(static_cast<CCircuitDef::RoleT>(CCircuitDef::RoleType::_SIZE_))
+		, roles(CCircuitDef::RoleMask::NONE)
+		, enemyRoles(CCircuitDef::RoleMask::NONE)
+		, fireState(-1)
+		, reloadTime(-1)
+		, limit(-1)
+		, sinceFrame(-1)
+		, retreat(-1.f)
+		, pwrMod(1.f)
+		, thrMod(1.f)
+{
+}
+
+CConfigData::CConfigData(Json::Value* root)
+		: root(root)
+		, isCompiled(false)
+		, responseWeight(.5f)
+{
+}
+
+CConfigData::~CConfigData()
+{
+	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
+}
+
+void CConfigData::Compile(CCircuitAI* circuit, const std::string& cfgName)
+{
+	if (isCompiled) {
+		return;
+	}
+	isCompiled = true;
+
+	CompileBehaviours(circuit, cfgName);
+	CompileResponses(circuit, cfgName);
+	CompileFactories(circuit, cfgName);
+	CompileEconomy(circuit, cfgName);
+	CompileBuildChains(circuit, cfgName);
+	CompileMilitary(circuit, cfgName);
+}
+
+void CConfigData::CompileBehaviours(CCircuitAI* circuit, const std::string& cfgName)
+{
+	CCircuitDef::Id maxId = 0;
+	for (auto& kv : circuit->GetCircuitDefs()) {
+		maxId = std::max(maxId, kv.first);
+	}
+	behaviours.resize(maxId + 1);
+
+	/*
+	 * Roles, attributes and retreat
+	 */
+	CCircuitDef::RoleName& roleNames = CCircuitDef::GetRoleNames();
+	CCircuitDef::AttrName& attrNames = CCircuitDef::GetAttrNames();
+	CCircuitDef::FireName& fireNames = CCircuitDef::GetFireNames();
+	const Json::Value& behaves = (*root)["behaviour"];
+	for (const std::string& defName : behaves.getMemberNames()) {
+		CCircuitDef* cdef = circuit->GetCircuitDef(defName.c_str());
+		if (cdef == nullptr) {
+			circuit->LOG("CONFIG %s: has unknown UnitDef '%s'", cfgName.c_str(), defName.c_str());
+			continue;
+		}
+		SBehaviour& bhv = behaviours[cdef->GetId()];
+
+		// Read roles from config
+		const Json::Value& behaviour = behaves[defName];
+		const Json::Value& role = behaviour["role"];
+		if (role.empty()) {
+			circuit->LOG("CONFIG %s: '%s' has no role", cfgName.c_str(), defName.c_str());
+			continue;
+		}
+
+		const std::string& mainName = role[0].asString();
+		auto it = roleNames.find(mainName);
+		if (it == roleNames.end()) {
+			circuit->LOG("CONFIG %s: %s has unknown main role '%s'", cfgName.c_str(), defName.c_str(), mainName.c_str());
+			continue;
+		}
+		bhv.mainRole = static_cast<CCircuitDef::RoleT>(it->second);
+		bhv.roles |= CCircuitDef::GetMask(bhv.mainRole);
+		bhv.enemyRoles |= CCircuitDef::GetMask(bhv.mainRole);
+
+		for (unsigned i = 1; i < role.size(); ++i) {
+			const std::string& enemyName = role[i].asString();
+			it = roleNames.find(enemyName);
+			if (it == roleNames.end()) {
+				circuit->LOG("CONFIG %s: %s has unknown enemy role '%s'", cfgName.c_str(), defName.c_str(), enemyName.c_str());
+				continue;
+			}
+			bhv.enemyRoles |= CCircuitDef::GetMask(static_cast<CCircuitDef::RoleT>(it->second));
+		}
+
+		// Read optional roles and attributes
+		const Json::Value& attributes = behaviour["attribute"];
+		for (const Json::Value& attr : attributes) {
+			const std::string& attrName = attr.asString();
+			it = roleNames.find(attrName);
+			if (it == roleNames.end()) {
+				auto it = attrNames.find(attrName);
+				if (it == attrNames.end()) {
+					circuit->LOG("CONFIG %s: %s has unknown attribute '%s'", cfgName.c_str(), defName.c_str(), attrName.c_str());
+					continue;
+				} else {
+					bhv.roles |= CCircuitDef::GetMask(static_cast<CCircuitDef::RoleT>(it->second));
+				}
+			} else {
+				bhv.roles |= CCircuitDef::GetMask(static_cast<CCircuitDef::RoleT>(it->second));
+			}
+		}
+
+		const Json::Value& fire = behaviour["fire_state"];
+		if (!fire.isNull()) {
+			const std::string& fireName = fire.asString();
+			auto itf = fireNames.find(fireName);
+			if (itf == fireNames.end()) {
+				circuit->LOG("CONFIG %s: %s has unknown fire state '%s'", cfgName.c_str(), defName.c_str(), fireName.c_str());
+			} else {
+				bhv.fireState = itf->second;
+			}
+		}
+
+		const Json::Value& reload = behaviour["reload"];
+		if (!reload.isNull()) {
+			bhv.reloadTime = reload.asFloat() * FRAMES_PER_SEC;
+		}
+
+		const Json::Value& limit = behaviour["limit"];
+		if (!limit.isNull()) {
+			bhv.limit = std::max(limit.asInt(), 0);
+		}
+
+		const Json::Value& since = behaviour["since"];
+		if (!since.isNull()) {
+			bhv.sinceFrame = since.asInt() * FRAMES_PER_SEC;
+		}
+
+		const Json::Value& retreat = behaviour["retreat"];
+		if (!retreat.isNull()) {
+			bhv.retreat = retreat.asFloat();
+		}
+
+		bhv.pwrMod = behaviour.get("pwr_mod", 1.f).asFloat();
+		bhv.thrMod = behaviour.get("thr_mod", 1.f).asFloat();
+	}
+}
+
+void CConfigData::CompileResponses(CCircuitAI* circuit, const std::string& cfgName)
+{
+	CCircuitDef::RoleName& roleNames = CCircuitDef::GetRoleNames();
+	const Json::Value& resps = (*root)["response"];
+	responses.resize(static_cast<CCircuitDef::RoleT>(CCircuitDef::RoleType::_SIZE_));
+	for (const auto& pair : roleNames) {
+		const Json::Value& response = resps[pair.first];
+		if (response.isNull()) {
+			continue;
+		}
+		SResponse& resp = responses[static_cast<CCircuitDef::RoleT>(pair.second)];
+		resp.isSet = true;
+		resp.maxPercent = response.get("max_percent", 1.0f).asFloat();
+		resp.epsStep = response.get("eps_step", 1.0f).asFloat();
+
+		const Json::Value& vs = response["vs"];
+		const Json::Value& ratio = response["ratio"];
+		const Json::Value& importance = response["importance"];
+		for (unsigned i = 0; i < vs.size(); ++i) {
+			const std::string& roleName = vs[i].asString();
+			auto it = roleNames.find(roleName);
+			if (it == roleNames.end()) {
+				circuit->LOG("CONFIG %s: response %s vs unknown role '%s'", cfgName.c_str(), pair.first.c_str(), roleName.c_str());
+				continue;
+			}
+			resp.vs.push_back({it->second, ratio.get(i, 1.0f).asFloat(), importance.get(i, 1.0f).asFloat()});
+		}
+	}
+	responseWeight = resps.get("_weight_", .5f).asFloat();
+}
+
+void CConfigData::CompileFactories(CCircuitAI* circuit, const std::string& cfgName)
+{
+	const Json::Value& facs = (*root)["factory"];
+	for (const std::string& fac : facs.getMemberNames()) {
+		const CCircuitDef::Id facId = GetDefId(circuit, cfgName, fac.c_str());
+		if (facId < 0) {
+			continue;
+		}
+
+		const Json::Value& factory = facs[fac];
+		SFactory facDef;
+		facDef.isRequireEnergy = factory.get("require_energy", false).asBool();
+		facDef.nanoCount = factory.get("caretaker", 1).asUInt();
+
+		const Json::Value& items = factory["unit"];
+		facDef.buildDefs.reserve(items.size());
+		for (const Json::Value& item : items) {
+			const CCircuitDef::Id id = GetDefId(circuit, cfgName, item.asCString());
+			if (id >= 0) {
+				facDef.buildDefs.push_back(id);
+			}
+		}
+		if (facDef.buildDefs.empty()) {
+			continue;  // ignore empty factory
+		}
+
+		auto fillProbs = [circuit, &cfgName, &facDef, &fac, &factory](unsigned i, const char* type, SFactory::Tiers& tiers) {
+			const Json::Value& tierType = factory[type];
+			if (tierType.isNull()) {
+				return false;
+			}
+			const Json::Value& tier = tierType[utils::int_to_string(i, "tier%i")];
+			if (tier.isNull()) {
+				return false;
+			}
+			std::vector<float>& probs = tiers[i];
+			probs.reserve(facDef.buildDefs.size());
+			float sum = .0f;
+			for (unsigned j = 0; j < facDef.buildDefs.size(); ++j) {
+				const float p = tier[j].asFloat();
+				sum += p;
+				probs.push_back(p);
+			}
+			if (fabs(sum - 1.0f) > 0.0001f) {
+				circuit->LOG("CONFIG %s: %s's %s_tier%i total probability = %f", cfgName.c_str(), fac.c_str(), type, i, sum);
+			}
+			return true;
+		};
+		const Json::Value& tiers = factory["income_tier"];
+		const unsigned tierSize = tiers.size();
+		facDef.incomes.reserve(tierSize + 1);
+		unsigned i = 0;
+		for (; i < tierSize; ++i) {
+			facDef.incomes.push_back(tiers[i].asFloat());
+			fillProbs(i, "air", facDef.airTiers);
+			fillProbs(i, "land", facDef.landTiers);
+			fillProbs(i, "water", facDef.waterTiers);
+		}
+		fillProbs(i, "air", facDef.airTiers);
+		fillProbs(i, "land", facDef.landTiers);
+		fillProbs(i, "water", facDef.waterTiers);
+		facDef.incomes.push_back(std::numeric_limits<float>::max());
+
+		if (facDef.landTiers.empty()) {
+			if (!facDef.airTiers.empty()) {
+				facDef.landTiers = facDef.airTiers;
+			} else if (!facDef.waterTiers.empty()) {
+				facDef.landTiers = facDef.waterTiers;
+			} else {
+				facDef.landTiers[0];  // create empty tier
+			}
+		}
+		if (facDef.waterTiers.empty()) {
+			facDef.waterTiers = facDef.landTiers;
+		}
+		// NOTE: empty airTiers are resolved by module, depends on map
+
+		factories[facId] = std::move(facDef);
+	}
+}
+
+void CConfigData::CompileEconomy(CCircuitAI* circuit, const std::string& cfgName)
+{
+	const Json::Value& econ = (*root)["economy"];
+	economy.epsStep = econ.get("eps_step", 0.25f).asFloat();
+	economy.excess = econ.get("excess", -1.f).asFloat();
+	economy.switchTime = econ.get("switch", 900).asInt() * FRAMES_PER_SEC;
+	const float bd = econ.get("build_delay", -1.f).asFloat();
+	economy.buildDelay = (bd > 0.f) ? (bd * FRAMES_PER_SEC) : 0;
+
+	const Json::Value& energy = econ["energy"];
+	const Json::Value& factor = energy["factor"];
+	economy.startFactor = factor[0].get((unsigned)0, 0.5f).asFloat();
+	economy.startFrame = factor[0].get((unsigned)1, 300 ).asInt() * FRAMES_PER_SEC;
+	economy.endFactor = factor[1].get((unsigned)0, 2.0f).asFloat();
+	economy.endFrame = factor[1].get((unsigned)1, 3600).asInt() * FRAMES_PER_SEC;
+
+	// Using cafus, armfus, armsolar as control points
+	constexpr unsigned MAX_CTRL_POINTS = 3;
+	auto fillEnergies = [this, circuit, &cfgName, &energy](const char* type, std::vector<SEconomy::SEnergy>& engies) {
+		const Json::Value& surf = energy[type];
+		for (const std::string& engy : surf.getMemberNames()) {
+			const int min = surf[engy][0].asInt();
+			const int max = surf[engy].get(1, min).asInt();
+			engies.push_back({GetDefId(circuit, cfgName, engy.c_str()), min, max});
+			if (engies.size() >= MAX_CTRL_POINTS) {
+				break;
+			}
+		}
+	};
+	fillEnergies("land", economy.landEnergies);
+	fillEnergies("water", economy.waterEnergies);
+
+	const Json::Value& pylon = energy["pylon"];
+	for (const Json::Value& pyl : pylon) {
+		const CCircuitDef::Id id = GetDefId(circuit, cfgName, pyl.asCString());
+		if (id >= 0) {
+			economy.pylonDefs.push_back(id);
+		}
+	}
+
+	economy.defaultDef = GetDefId(circuit, cfgName, econ.get("default", "").asCString(), false);
+	economy.airpadDef = GetDefId(circuit, cfgName, econ.get("airpad", "").asCString(), false);
+	economy.terraDef = GetDefId(circuit, cfgName, econ.get("terra", "").asCString(), false);
+	economy.buildPower = econ.get("buildpower", 1.f).asFloat();
+	economy.mexMax = econ.get("mex_max", 2.f).asFloat();
+
+	const Json::Value& pull = econ["ms_pull"];
+	economy.msPull.reserve(pull.size());
+	if (!pull.empty()) {
+		economy.msPull.push_back(std::make_pair(pull[0].get((unsigned)0, 1.0f).asFloat(), pull[0].get((unsigned)1, 0.0f).asFloat()));
+	}
+	for (unsigned i = 1; i < pull.size(); ++i) {
+		economy.msPull.push_back(std::make_pair(pull[i].get((unsigned)0, 0.25f).asFloat(), pull[i].get((unsigned)1, 0.75f).asFloat()));
+	}
+}
+
+void CConfigData::CompileBuildChains(CCircuitAI* circuit, const std::string& cfgName)
+{
+	IBuilderTask::BuildName& buildNames = IBuilderTask::GetBuildNames();
+	const Json::Value& build = (*root)["build_chain"];
+	for (const std::string& catName : build.getMemberNames()) {
+		auto it = buildNames.find(catName);
+		if (it == buildNames.end()) {
+			circuit->LOG("CONFIG %s: has unknown category '%s'", cfgName.c_str(), catName.c_str());
+			continue;
+		}
+
+		std::map<CCircuitDef::Id, SBuildChain>& defMap = buildChains[static_cast<IBuilderTask::BT>(it->second)];
+		const Json::Value& catChain = build[catName];
+		for (const std::string& defName : catChain.getMemberNames()) {
+			CCircuitDef* cdef = circuit->GetCircuitDef(defName.c_str());
+			if (cdef == nullptr) {
+				circuit->LOG("CONFIG %s: has unknown UnitDef '%s'", cfgName.c_str(), defName.c_str());
+				continue;
+			}
+
+			SBuildChain& bc = defMap[cdef->GetId()];
+			const Json::Value& buildQueue = catChain[defName];
+			bc.isPylon = buildQueue.get("pylon", false).asBool();
+			bc.isPorc = buildQueue.get("porc", false).asBool();
+			bc.isTerra = buildQueue.get("terra", false).asBool();
+
+			const Json::Value& engy = buildQueue["energy"];
+			bc.energy = engy.get(unsigned(0), -1.f).asFloat();
+			bc.isMexEngy = engy[1].isString();
+
+			const Json::Value& hub = buildQueue["hub"];
+			bc.hub.reserve(hub.size());
+			for (const Json::Value& que : hub) {
+				std::vector<SBuildPart> queue;
+				queue.reserve(que.size());
+				for (const Json::Value& part : que) {
+					SBuildPart bi;
+
+					const std::string& partName = part.get("unit", "").asString();
+					bi.id = GetDefId(circuit, cfgName, partName.c_str());
+					if (bi.id < 0) {
+						continue;
+					}
+
+					const std::string& cat = part.get("category", "").asString();
+					auto it = buildNames.find(cat);
+					if (it == buildNames.end()) {
+						circuit->LOG("CONFIG %s: has unknown category '%s'", cfgName.c_str(), cat.c_str());
+						continue;
+					}
+					bi.buildType = it->second;
+
+					UnitDef* unitDef = cdef->GetUnitDef();
+					bi.offset = ZeroVector;
+					bi.direction = SBuildInfo::Direction::NONE;
+					const Json::Value& off = part["offset"];
+					if (off.isArray()) {
+						bi.offset = AIFloat3(off.get((unsigned)0, 0.f).asFloat(), 0.f, off.get((unsigned)1, 0.f).asFloat());
+						if (bi.offset.x < -1e-3f) {
+							bi.offset.x -= unitDef->GetXSize() * SQUARE_SIZE / 2;
+						} else if (bi.offset.x > 1e-3f) {
+							bi.offset.x += unitDef->GetXSize() * SQUARE_SIZE / 2;
+						}
+						if (bi.offset.z < -1e-3f) {
+							bi.offset.z -= unitDef->GetZSize() * SQUARE_SIZE / 2;
+						} else if (bi.offset.z > 1e-3f) {
+							bi.offset.z += unitDef->GetZSize() * SQUARE_SIZE / 2;
+						}
+					} else if (off.isObject() && !off.empty()) {
+						float delta = 0.f;
+						SBuildInfo::DirName& dirNames = SBuildInfo::GetDirNames();
+						std::string dir = off.getMemberNames().front();
+						auto it = dirNames.find(dir);
+						if (it != dirNames.end()) {
+							bi.direction = it->second;
+							delta = off[dir].asFloat();
+						}
+						switch (bi.direction) {
+							case DIRECTION(LEFT): {
+								bi.offset.x = delta + unitDef->GetXSize() * SQUARE_SIZE / 2;
+							} break;
+							case DIRECTION(RIGHT): {
+								bi.offset.x = -(delta + unitDef->GetXSize() * SQUARE_SIZE / 2);
+							} break;
+							case DIRECTION(FRONT): {
+								bi.offset.z = delta + unitDef->GetZSize() * SQUARE_SIZE / 2;
+							} break;
+							case DIRECTION(BACK): {
+								bi.offset.z = -(delta + unitDef->GetZSize() * SQUARE_SIZE / 2);
+							} break;
+							default: break;
+						}
+					}
+
+					bi.condition = SBuildInfo::Condition::ALWAYS;
+					const std::string& cond = part.get("condition", "").asString();
+					if (!cond.empty()) {
+						SBuildInfo::CondName& condNames = SBuildInfo::GetCondNames();
+						auto it = condNames.find(cond);
+						if (it != condNames.end()) {
+							bi.condition = it->second;
+						}
+					}
+
+					queue.push_back(bi);
+				}
+				bc.hub.push_back(queue);
+			}
+		}
+	}
+}
+
+void CConfigData::CompileMilitary(CCircuitAI* circuit, const std::string& cfgName)
+{
+	const Json::Value& quotas = (*root)["quota"];
+	military.maxScouts = quotas.get("scout", 3).asUInt();
+	const Json::Value& qraid = quotas["raid"];
+	military.raidMin = qraid.get((unsigned)0, 3.f).asFloat();
+	military.raidAvg = qraid.get((unsigned)1, 5.f).asFloat();
+	military.minAttackers = quotas.get("attack", 8.f).asFloat();
+	military.defRadius = quotas.get("def_rad", 2000.f).asFloat();
+	const Json::Value& qthrMod = quotas["thr_mod"];
+	const Json::Value& qthrAtk = qthrMod["attack"];
+	military.attackMin = qthrAtk.get((unsigned)0, 1.f).asFloat();
+	military.attackMax = qthrAtk.get((unsigned)1, 1.f).asFloat();
+	const Json::Value& qthrDef = qthrMod["defence"];
+	military.defenceMin = qthrDef.get((unsigned)0, 1.f).asFloat();
+	military.defenceMax = qthrDef.get((unsigned)1, 1.f).asFloat();
+	military.thrMobile = qthrMod.get("mobile", 1.f).asFloat();
+	military.thrStatic = qthrMod.get("static", 0.f).asFloat();
+	military.aaThreat = quotas.get("aa_threat", 42.f).asFloat();
+	military.commThrMod = qthrMod.get("comm", 1.f).asFloat();
+
+	const Json::Value& retreat = (*root)["retreat"];
+	military.fighterRet = retreat.get("fighter", 0.5f).asFloat();
+	military.builderRet = retreat.get("builder", 0.8f).asFloat();
+
+	const Json::Value& porc = (*root)["porcupine"];
+	const Json::Value& defs = porc["unit"];
+	military.defenderDefs.reserve(defs.size());
+	for (const Json::Value& def : defs) {
+		const CCircuitDef::Id id = GetDefId(circuit, cfgName, def.asCString());
+		if (id >= 0) {
+			military.defenderDefs.push_back(id);
+		}
+	}
+	const unsigned defSize = military.defenderDefs.size();
+	auto fillIndices = [defSize, &porc](const char* type, std::vector<unsigned>& indices) {
+		const Json::Value& surf = porc[type];
+		indices.reserve(surf.size());
+		for (const Json::Value& idx : surf) {
+			const unsigned index = idx.asUInt();
+			if (index < defSize) {
+				indices.push_back(index);
+			}
+		}
+	};
+	fillIndices("land", military.landDefenders);
+	fillIndices("water", military.waterDefenders);
+
+	military.preventCount = porc.get("prevent", 1).asUInt();
+	const Json::Value& amount = porc["amount"];
+	const Json::Value& amOff = amount["offset"];
+	const Json::Value& amFac = amount["factor"];
+	const Json::Value& amMap = amount["map"];
+	military.offsetMin = amOff.get((unsigned)0, -0.2f).asFloat();
+	military.offsetMax = amOff.get((unsigned)1, 0.2f).asFloat();
+	military.factorMin = amFac.get((unsigned)0, 2.0f).asFloat();
+	military.factorMax = amFac.get((unsigned)1, 1.0f).asFloat();
+	military.mapMin = amMap.get((unsigned)0, 8.0f).asFloat();
+	military.mapMax = amMap.get((unsigned)1, 24.0f).asFloat();
+
+	const Json::Value& base = porc["base"];
+	military.baseDefence.reserve(base.size());
+	for (const Json::Value& pair : base) {
+		const unsigned index = pair.get((unsigned)0, -1).asUInt();
+		if (index < defSize) {
+			military.baseDefence.push_back(std::make_pair(index, pair.get((unsigned)1, 0).asInt() * FRAMES_PER_SEC));
+		}
+	}
+	auto compare = [](const std::pair<unsigned, int>& d1, const std::pair<unsigned, int>& d2) {
+		return d1.second > d2.second;
+	};
+	std::sort(military.baseDefence.begin(), military.baseDefence.end(), compare);
+
+	const Json::Value& super = porc["superweapon"];
+	const Json::Value& items = super["unit"];
+	const Json::Value& probs = super["weight"];
+	military.superWeights.reserve(items.size());
+	for (unsigned i = 0; i < items.size(); ++i) {
+		const CCircuitDef::Id id = GetDefId(circuit, cfgName, items[i].asCString());
+		if (id >= 0) {
+			military.superWeights.push_back(std::make_pair(id, probs.get(i, 1.f).asFloat()));
+		}
+	}
+	military.defaultPorc = GetDefId(circuit, cfgName, porc.get("default", "").asCString(), false);
+
+	const Json::Value& cond = porc["condition"];
+	military.superMinIncome = cond.get((unsigned)0, 50.f).asFloat();
+	military.superMaxTime = cond.get((unsigned)1, 300.f).asFloat();
+}
+
+CCircuitDef::Id CConfigData::GetDefId(CCircuitAI* circuit, const std::string& cfgName, const char* name, bool isLogged) const
+{
+	CCircuitDef* cdef = circuit->GetCircuitDef(name);
+	if (cdef == nullptr) {
+		if (isLogged) {
+			circuit->LOG("CONFIG %s: has unknown UnitDef '%s'", cfgName.c_str(), name);
+		}
+		return -1;
+	}
+	return cdef->GetId();
+}
+
+} // namespace circuit
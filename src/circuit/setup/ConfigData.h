@@ -0,0 +1,184 @@
+/*
+ * ConfigData.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#ifndef SRC_CIRCUIT_SETUP_CONFIGDATA_H_
+#define SRC_CIRCUIT_SETUP_CONFIGDATA_H_
+
+#include "task/builder/BuildChain.h"
+#include "unit/CircuitDef.h"
+#include "json/json-forwards.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace circuit {
+
+class CCircuitAI;
+
+/*
+ * Merged config parsed once per source and shared by all AI instances of a process.
+ * Per-AI overrides create private copy (copy-on-write).
+ * Compiled sections hold def ids, modules apply per-AI parts (rand, team size, terrain).
+ */
+class CConfigData {
+public:
+	struct SBehaviour {
+		SBehaviour();
+		bool IsValid() const { return mainRole != static_cast<CCircuitDef::RoleT>(CCircuitDef::RoleType::_SIZE_); }
+
+		CCircuitDef::RoleT mainRole;
+		CCircuitDef::RoleM roles;  // roles and attributes
+		CCircuitDef::RoleM enemyRoles;
+		int fireState;  // -1 if not set
+		int reloadTime;  // frames, -1 if not set
+		int limit;  // -1 if not set
+		int sinceFrame;  // -1 if not set
+		float retreat;  // < 0 if not set
+		float pwrMod;
+		float thrMod;
+	};
+	using Behaviours = std::vector<SBehaviour>;  // index: CCircuitDef::Id
+
+	struct SResponse {
+		SResponse() : isSet(false), maxPercent(1.f), epsStep(1.f) {}
+		struct SVs {
+			CCircuitDef::RoleType role;
+			float ratio;
+			float importance;
+		};
+		bool isSet;
+		float maxPercent;
+		float epsStep;
+		std::vector<SVs> vs;
+	};
+	using Responses = std::vector<SResponse>;  // index: CCircuitDef::RoleT
+
+	struct SFactory {
+		using Tiers = std::map<unsigned, std::vector<float>>;
+		std::vector<CCircuitDef::Id> buildDefs;
+		Tiers airTiers;
+		Tiers landTiers;
+		Tiers waterTiers;
+		std::vector<float> incomes;  // last one is max float
+		bool isRequireEnergy;
+		unsigned int nanoCount;
+	};
+	using Factories = std::map<CCircuitDef::Id, SFactory>;
+
+	struct SEconomy {
+		struct SEnergy {
+			CCircuitDef::Id id;  // -1 if unknown
+			int min;
+			int max;
+		};
+		float epsStep;
+		float excess;
+		int switchTime;  // frames
+		int buildDelay;  // frames
+		float startFactor;
+		int startFrame;
+		float endFactor;
+		int endFrame;
+		std::vector<SEnergy> landEnergies;  // control points
+		std::vector<SEnergy> waterEnergies;
+		std::vector<CCircuitDef::Id> pylonDefs;
+		CCircuitDef::Id defaultDef;  // -1 if not set
+		CCircuitDef::Id airpadDef;
+		CCircuitDef::Id terraDef;
+		float buildPower;
+		float mexMax;
+		std::vector<std::pair<float, float>> msPull;  // pull, mex fraction
+	};
+
+	struct SBuildPart {
+		CCircuitDef::Id id;
+		IBuilderTask::BuildType buildType;
+		springai::AIFloat3 offset;
+		SBuildInfo::Direction direction;
+		SBuildInfo::Condition condition;
+	};
+	struct SBuildChain {
+		float energy;
+		bool isMexEngy;
+		bool isPylon;
+		bool isPorc;
+		bool isTerra;
+		std::vector<std::vector<SBuildPart>> hub;
+	};
+	using BuildChains = std::map<IBuilderTask::BT, std::map<CCircuitDef::Id, SBuildChain>>;
+
+	struct SMilitary {
+		unsigned maxScouts;
+		float raidMin;
+		float raidAvg;
+		float minAttackers;
+		float defRadius;
+		float attackMin;
+		float attackMax;
+		float defenceMin;
+		float defenceMax;
+		float thrMobile;
+		float thrStatic;
+		float aaThreat;
+
+		std::vector<CCircuitDef::Id> defenderDefs;
+		std::vector<unsigned> landDefenders;  // index in defenderDefs
+		std::vector<unsigned> waterDefenders;
+		unsigned preventCount;
+		float offsetMin, offsetMax;
+		float factorMin, factorMax;
+		float mapMin, mapMax;
+		std::vector<std::pair<unsigned, int>> baseDefence;  // index in defenderDefs, frame
+		std::vector<std::pair<CCircuitDef::Id, float>> superWeights;
+		CCircuitDef::Id defaultPorc;  // -1 if not set
+		float superMinIncome;
+		float superMaxTime;
+		float fighterRet;
+		float builderRet;
+		float commThrMod;
+	};
+
+	CConfigData(Json::Value* root);
+	virtual ~CConfigData();
+
+	const Json::Value& GetRoot() const { return *root; }
+
+	void Compile(CCircuitAI* circuit, const std::string& cfgName);
+	bool IsCompiled() const { return isCompiled; }
+	const Behaviours& GetBehaviours() const { return behaviours; }
+	const Responses& GetResponses() const { return responses; }
+	float GetResponseWeight() const { return responseWeight; }
+	const Factories& GetFactories() const { return factories; }
+	const SEconomy& GetEconomy() const { return economy; }
+	const BuildChains& GetBuildChains() const { return buildChains; }
+	const SMilitary& GetMilitary() const { return military; }
+
+private:
+	void CompileBehaviours(CCircuitAI* circuit, const std::string& cfgName);
+	void CompileResponses(CCircuitAI* circuit, const std::string& cfgName);
+	void CompileFactories(CCircuitAI* circuit, const std::string& cfgName);
+	void CompileEconomy(CCircuitAI* circuit, const std::string& cfgName);
+	void CompileBuildChains(CCircuitAI* circuit, const std::string& cfgName);
+	void CompileMilitary(CCircuitAI* circuit, const std::string& cfgName);
+	CCircuitDef::Id GetDefId(CCircuitAI* circuit, const std::string& cfgName, const char* name, bool isLogged = true) const;
+
+	std::unique_ptr<Json::Value> root;
+
+	bool isCompiled;
+	Behaviours behaviours;
+	Responses responses;
+	float responseWeight;
+	Factories factories;
+	SEconomy economy;
+	BuildChains buildChains;
+	SMilitary military;
+};
+
+} // namespace circuit
+
+#endif // SRC_CIRCUIT_SETUP_CONFIGDATA_H_
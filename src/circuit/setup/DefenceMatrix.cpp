@@ -9,6 +9,7 @@
 #include "module/MilitaryManager.h"
 #include "resource/MetalManager.h"
 #include "terrain/TerrainManager.h"
+#include "terrain/ThreatMap.h"
 #include "CircuitAI.h"
 #include "util/math/HierarchCluster.h"
 #include "util/math/RagMatrix.h"
@@ -23,7 +24,11 @@ namespace circuit {
 using namespace springai;
 
 CDefenceMatrix::CDefenceMatrix(CCircuitAI* circuit)
-		: metalManager(nullptr)
+		: circuit(circuit)
+		, metalManager(nullptr)
+		, porcCost(1.f)
+		, refreshEpoch(-1)
+		, logStart(0)
 {
 	circuit->GetScheduler()->RunOnInit(std::make_shared<CGameTask>(&CDefenceMatrix::Init, this, circuit));
 }
@@ -44,6 +49,7 @@ void CDefenceMatrix::Init(CCircuitAI* circuit)
 	CMilitaryManager* militaryManager = circuit->GetMilitaryManager();
 	const std::vector<CCircuitDef*>& defenders = isWaterMap ? militaryManager->GetWaterDefenders() : militaryManager->GetLandDefenders();
 	CCircuitDef* rangeDef = defenders.empty() ? militaryManager->GetDefaultPorc() : defenders.front();
+	porcCost = std::max(militaryManager->GetDefaultPorc()->GetCost(), 1.f);
 
 	Map* map = circuit->GetMap();
 	float maxDistance = rangeDef->GetMaxRange() * 0.75f * 2;
@@ -62,26 +68,37 @@ void CDefenceMatrix::Init(CCircuitAI* circuit)
 
 		const CHierarchCluster::Clusters& iclusters = clust.Clusterize(distmatrix, maxDistance);
 
-		DefPoints& defPoints = clusterInfos[k].defPoints;
+		SClusterInfo& info = clusterInfos[k];
+		DefPoints& defPoints = info.defPoints;
 		unsigned nclusters = iclusters.size();
 		defPoints.reserve(nclusters);
+		info.pointIncomes.reserve(nclusters);
 		for (unsigned i = 0; i < nclusters; ++i) {
 			std::vector<AIFloat3> points;
 			points.reserve(iclusters[i].size());
+			float income = 0.f;
 			for (unsigned j = 0; j < iclusters[i].size(); ++j) {
-				points.push_back(spots[idxSpots[iclusters[i][j]]].position);
+				const CMetalData::SMetal& spot = spots[idxSpots[iclusters[i][j]]];
+				points.push_back(spot.position);
+				income += spot.income;
 			}
 			enclose.MakeCircle(points);
 			AIFloat3 pos = enclose.GetCenter();
 			pos.y = map->GetElevationAt(pos.x, pos.z);
 			defPoints.push_back({pos, .0f});
+			info.pointIncomes.push_back(income);
 		}
+		info.pointNeeds.resize(nclusters, 0.f);
+		info.need = 0.f;
+		info.isThreatened = false;
+		info.isFinished = metalManager->GetFinishedClusters().Test(k);  // flips before init
 	}
+	RescoreAll();
 }
 
-CDefenceMatrix::SDefPoint* CDefenceMatrix::GetDefPoint(const AIFloat3& pos, float defCost)
+CDefenceMatrix::SDefPoint* CDefenceMatrix::GetDefPoint(const AIFloat3& pos, float defCost, int& outIndex)
 {
-	int index = metalManager->FindNearestCluster(pos);
+	int index = outIndex = metalManager->FindNearestCluster(pos);
 	if (index < 0) {
 		return nullptr;
 	}
@@ -101,4 +118,137 @@ CDefenceMatrix::SDefPoint* CDefenceMatrix::GetDefPoint(const AIFloat3& pos, floa
 	return &defPoints[idx];
 }
 
+unsigned CDefenceMatrix::CountThreatNeighbours(int index, unsigned maxCount) const
+{
+	unsigned threatCount = 0;
+	const CMetalData::Graph& clusterGraph = metalManager->GetGraph();
+	CMetalData::Graph::Node node = clusterGraph.nodeFromId(index);
+	CMetalData::Graph::IncEdgeIt edgeIt(clusterGraph, node);
+	for (; edgeIt != lemon::INVALID; ++edgeIt) {
+		const SClusterInfo& info = clusterInfos[clusterGraph.id(clusterGraph.oppositeNode(node, edgeIt))];
+		if (!info.isFinished && info.isThreatened && (++threatCount >= maxCount)) {
+			break;
+		}
+	}
+	return threatCount;
+}
+
+void CDefenceMatrix::SetFinished(int index, bool value)
+{
+	if ((unsigned)index >= clusterInfos.size()) {  // not initialized yet
+		return;
+	}
+	clusterInfos[index].isFinished = value;
+	MarkNeighbours(index);
+}
+
+void CDefenceMatrix::Refresh(CThreatMap* threatMap)
+{
+	const int epoch = threatMap->GetEpoch();
+	if (refreshEpoch != epoch) {
+		refreshEpoch = epoch;
+
+		const CMetalData::Metals& spots = metalManager->GetSpots();
+		const CMetalData::Clusters& clusters = metalManager->GetClusters();
+		for (unsigned i = 0; i < clusterInfos.size(); ++i) {
+			bool isThreatened = false;
+			for (int idx : clusters[i].idxSpots) {
+				if (threatMap->GetAllThreatAt(spots[idx].position) > THREAT_MIN * 2) {
+					isThreatened = true;
+					break;
+				}
+			}
+			if (clusterInfos[i].isThreatened != isThreatened) {
+				clusterInfos[i].isThreatened = isThreatened;
+				MarkNeighbours(i);
+			}
+		}
+	}
+
+	for (int index : dirty) {
+		Rescore(index);
+	}
+	dirty.clear();
+}
+
+void CDefenceMatrix::MarkNeighbours(int index)
+{
+	const CMetalData::Graph& clusterGraph = metalManager->GetGraph();
+	CMetalData::Graph::Node node = clusterGraph.nodeFromId(index);
+	CMetalData::Graph::IncEdgeIt edgeIt(clusterGraph, node);
+	for (; edgeIt != lemon::INVALID; ++edgeIt) {
+		dirty.push_back(clusterGraph.id(clusterGraph.oppositeNode(node, edgeIt)));
+	}
+}
+
+void CDefenceMatrix::Rescore(int index)
+{
+	SClusterInfo& info = clusterInfos[index];
+	const float factor = 1 + CountThreatNeighbours(index, 2);
+	float need = 0.f;
+	for (unsigned i = 0; i < info.defPoints.size(); ++i) {
+		info.pointNeeds[i] = info.pointIncomes[i] * factor / (1.f + info.defPoints[i].cost / porcCost);
+		need = std::max(need, info.pointNeeds[i]);
+	}
+	if (need == info.need) {
+		return;
+	}
+	info.need = need;
+
+	if (changeLog.size() >= clusterInfos.size() * 4) {
+		logStart += changeLog.size();
+		changeLog.clear();
+	}
+	changeLog.push_back(index);
+}
+
+void CDefenceMatrix::RescoreAll()
+{
+	for (unsigned i = 0; i < clusterInfos.size(); ++i) {
+		Rescore(i);
+	}
+	logStart += changeLog.size() + 1;  // force readers to rescan
+	changeLog.clear();
+}
+
+bool CDefenceMatrix::GetChanges(unsigned& cursor, std::vector<int>& outIndices) const
+{
+	const unsigned logEnd = logStart + changeLog.size();
+	if (cursor < logStart) {
+		cursor = logEnd;
+		return false;
+	}
+	outIndices.insert(outIndices.end(), changeLog.begin() + (cursor - logStart), changeLog.end());
+	cursor = logEnd;
+	return true;
+}
+
+void CDefenceMatrix::Load(std::istream& is)
+{
+	uint32_t size = 0;
+	utils::binary_read(is, size);
+	if (size != clusterInfos.size()) {  // different map or metal config
+		return;
+	}
+	for (SClusterInfo& info : clusterInfos) {
+		DefPoints defPoints;
+		if (!utils::binary_read(is, defPoints)) {
+			break;
+		}
+		if (defPoints.size() == info.defPoints.size()) {
+			info.defPoints = std::move(defPoints);
+		}
+	}
+	RescoreAll();
+}
+
+void CDefenceMatrix::Save(std::ostream& os) const
+{
+	const uint32_t size = clusterInfos.size();
+	utils::binary_write(os, size);
+	for (const SClusterInfo& info : clusterInfos) {
+		utils::binary_write(os, info.defPoints);
+	}
+}
+
 } // namespace circuit
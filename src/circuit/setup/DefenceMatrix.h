@@ -10,12 +10,14 @@
 
 #include "AIFloat3.h"
 
+#include <iosfwd>
 #include <vector>
 
 namespace circuit {
 
 class CCircuitAI;
 class CMetalManager;
+class CThreatMap;
 
 class CDefenceMatrix {
 public:
@@ -26,6 +28,11 @@ public:
 	using DefPoints = std::vector<SDefPoint>;
 	struct SClusterInfo {
 		DefPoints defPoints;
+		std::vector<float> pointIncomes;  // income of spots covered by point
+		std::vector<float> pointNeeds;  // income * threatened neighbours / existing defence
+		float need;  // max of pointNeeds
+		bool isThreatened;
+		bool isFinished;
 	};
 
 public:
@@ -36,12 +43,41 @@ private:
 	void Init(CCircuitAI* circuit);
 
 public:
+	void SetAuthority(CCircuitAI* authority) { circuit = authority; }
+	bool IsAuthority(const CCircuitAI* ai) const { return circuit == ai; }
+
 	std::vector<SDefPoint>& GetDefPoints(int index) { return clusterInfos[index].defPoints; }
-	SDefPoint* GetDefPoint(const springai::AIFloat3& pos, float cost);
+	SDefPoint* GetDefPoint(const springai::AIFloat3& pos, float cost, int& outIndex);
+
+	const std::vector<float>& GetPointNeeds(int index) const { return clusterInfos[index].pointNeeds; }
+	float GetNeed(int index) const { return clusterInfos[index].need; }
+	unsigned CountThreatNeighbours(int index, unsigned maxCount) const;
+
+	void SetFinished(int index, bool value);  // by CMetalManager on finished mask flip
+	/*
+	 * Re-scores only neighbours of clusters that changed threat or finished state.
+	 * Cheap to call from every AI, threat is scanned once per epoch.
+	 */
+	void Refresh(CThreatMap* threatMap);
+	void Rescore(int index);  // after defPoints cost change
+	bool GetChanges(unsigned& cursor, std::vector<int>& outIndices) const;  // false if cursor is too old
+
+	void Load(std::istream& is);
+	void Save(std::ostream& os) const;
 
 private:
+	void MarkNeighbours(int index);
+	void RescoreAll();
+
+	CCircuitAI* circuit;  // authority, saves shared matrix
 	CMetalManager* metalManager;
 	std::vector<SClusterInfo> clusterInfos;
+	float porcCost;
+	int refreshEpoch;  // threat epoch of last refresh
+	std::vector<int> dirty;  // neighbours of changed clusters, re-scored on refresh
+
+	std::vector<int> changeLog;  // re-scored clusters
+	unsigned logStart;  // absolute position of changeLog.front()
 };
 
 } // namespace circuit
@@ -7,9 +7,11 @@
 
 #include "setup/SetupManager.h"
 #include "setup/SetupData.h"
+#include "setup/ConfigData.h"
 #include "resource/MetalManager.h"
 #include "terrain/TerrainManager.h"
 #include "CircuitAI.h"
+#include "util/GameAttribute.h"
 #include "util/Scheduler.h"
 #include "util/utils.h"
 #include "json/json.h"
@@ -54,7 +56,6 @@ CSetupManager::CSetupManager(CCircuitAI* circuit, CSetupData* setupData)
 CSetupManager::~CSetupManager()
 {
 	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
-	delete config;
 }
 
 void CSetupManager::DisabledUnits(const char* setupScript)
@@ -111,10 +112,14 @@ bool CSetupManager::OpenConfig(const std::string& cfgOption)
 
 void CSetupManager::CloseConfig()
 {
-	delete config;
 	config = nullptr;
 }
 
+const Json::Value& CSetupManager::GetConfig() const
+{
+	return config->GetRoot();
+}
+
 bool CSetupManager::HasStartBoxes() const
 {
 	return setupData->IsInitialized();
@@ -296,6 +301,8 @@ void CSetupManager::ReadConfig()
 {
 	const Json::Value& root = GetConfig();
 	const std::string& cfgName = GetConfigName();
+	config->Compile(circuit, cfgName);
+
 	const Json::Value& shield = root["retreat"]["shield"];
 	emptyShield = shield.get((unsigned)0, 0.1f).asFloat();
 	fullShield = shield.get((unsigned)1, 0.6f).asFloat();
@@ -566,8 +573,7 @@ bool CSetupManager::LoadConfig(const std::string& cfgOption)
 	std::string cfgStr = ((value != nullptr) && strlen(value) > 0) ? value : "";
 	delete options;
 	if (!cfgStr.empty()) {
-		config = ParseConfig(cfgStr, configName);
-		if (config != nullptr) {
+		if (FetchConfig(configName + ":" + cfgStr, [this, &cfgStr]() { return ParseConfig(cfgStr, configName); })) {
 			return true;
 		}
 	}
@@ -579,8 +585,7 @@ bool CSetupManager::LoadConfig(const std::string& cfgOption)
 	dirname = std::string("LuaRules/Configs/") + name + "/" + version + "/";
 	configName = utils::MakeFileSystemCompatible(map->GetName()) + ".json";
 
-	config = ReadConfig(dirname, {configName});
-	if (config != nullptr) {
+	if (FetchConfig(dirname + configName, [this, &dirname]() { return ReadConfig(dirname, {configName}); })) {
 		return true;
 	}
 
@@ -588,12 +593,14 @@ bool CSetupManager::LoadConfig(const std::string& cfgOption)
 	 * Prepare config parts
 	 */
 	std::vector<std::string> cfgNames;
+	std::string cfgKey;
 	std::string::const_iterator start = cfgOption.begin();
 	std::string::const_iterator end = cfgOption.end();
 	std::regex patternCfg("\\w+");
 	std::smatch section;
 	while (std::regex_search(start, end, section, patternCfg)) {
 		cfgNames.push_back(std::string(section[0]) + ".json");
+		cfgKey += ":" + cfgNames.back();
 		start = section[0].second;
 	}
 
@@ -603,8 +610,7 @@ bool CSetupManager::LoadConfig(const std::string& cfgOption)
 	configName = "config";
 	dirname = configName + SLASH;
 	if (LocatePath(dirname)) {
-		config = ReadConfig(dirname, cfgNames);
-		if (config != nullptr) {
+		if (FetchConfig(dirname + cfgKey, [this, &dirname, &cfgNames]() { return ReadConfig(dirname, cfgNames); })) {
 			return true;
 		}
 	} else {
@@ -615,8 +621,19 @@ bool CSetupManager::LoadConfig(const std::string& cfgOption)
 	 * Locate develop config: to run ./spring from source dir
 	 */
 	dirname = std::string("AI/Skirmish/") + name + "/data/" + configName + "/";
-	config = ReadConfig(dirname, cfgNames);
-	return (config != nullptr);
+	return FetchConfig(dirname + cfgKey, [this, &dirname, &cfgNames]() { return ReadConfig(dirname, cfgNames); });
+}
+
+bool CSetupManager::FetchConfig(const std::string& key, std::function<Json::Value* ()> parse)
+{
+	CGameAttribute::Configs& configs = circuit->GetGameAttribute()->GetConfigs();
+	auto it = configs.find(key);
+	if (it == configs.end()) {
+		Json::Value* cfg = parse();
+		it = configs.emplace(key, (cfg == nullptr) ? nullptr : std::make_shared<CConfigData>(cfg)).first;
+	}
+	config = it->second;
+	return config != nullptr;
 }
 
 Json::Value* CSetupManager::ReadConfig(const std::string& dirname, const std::vector<std::string>& cfgNames)
@@ -687,19 +704,28 @@ void CSetupManager::OverrideConfig()
 	Json::CharReader* reader = Json::CharReaderBuilder().newCharReader();
 	Json::Value json;
 	OptionValues* options = circuit->GetSkirmishAI()->GetOptionValues();
+	Json::Value* cfg = nullptr;  // private copy of shared config
 
 	const char* value = options->GetValueByKey("factory");
 	if ((value != nullptr) && reader->parse(value, value + strlen(value), &json, nullptr)) {
-		(*config)["factory"] = json;
+		cfg = new Json::Value(config->GetRoot());
+		(*cfg)["factory"] = json;
 	}
 
 	value = options->GetValueByKey("behaviour");
 	if ((value != nullptr) && reader->parse(value, value + strlen(value), &json, nullptr)) {
-		(*config)["behaviour"] = json;
+		if (cfg == nullptr) {
+			cfg = new Json::Value(config->GetRoot());
+		}
+		(*cfg)["behaviour"] = json;
 	}
 
 	delete reader;
 	delete options;
+
+	if (cfg != nullptr) {
+		config = std::make_shared<CConfigData>(cfg);
+	}
 }
 
 } // namespace circuit
@@ -19,6 +19,7 @@ namespace circuit {
 
 class CCircuitAI;
 class CSetupData;
+class CConfigData;
 class CAllyTeam;
 class CGameTask;
 class CCircuitUnit;
@@ -46,7 +47,8 @@ public:
 
 	bool OpenConfig(const std::string& cfgOption);
 	void CloseConfig();
-	const Json::Value& GetConfig() const { return *config; }
+	const Json::Value& GetConfig() const;
+	CConfigData* GetConfigData() const { return config.get(); }
 	const std::string& GetConfigName() const { return configName; }
 
 	bool HasStartBoxes() const;
@@ -82,6 +84,7 @@ private:
 	void FindStart();
 	bool LocatePath(std::string& filename);
 	bool LoadConfig(const std::string& cfgOption);
+	bool FetchConfig(const std::string& key, std::function<Json::Value* ()> parse);
 	Json::Value* ReadConfig(const std::string& dirName, const std::vector<std::string>& cfgNames);
 	Json::Value* ParseConfig(const std::string& cfgStr, const std::string& cfgName, Json::Value* cfg = nullptr);
 	void UpdateJson(Json::Value& a, Json::Value& b);
@@ -89,7 +92,7 @@ private:
 
 	CCircuitAI* circuit;
 	CSetupData* setupData;
-	Json::Value* config;  // owner;
+	std::shared_ptr<CConfigData> config;  // shared between AIs unless overridden
 	std::string configName;
 
 	CCircuitUnit* commander;
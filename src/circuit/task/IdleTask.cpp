@@ -11,11 +11,12 @@
 #include "CircuitAI.h"
 #include "util/utils.h"
 
+#include <algorithm>
+
 namespace circuit {
 
 CIdleTask::CIdleTask(ITaskManager* mgr)
 		: IUnitTask(mgr, Priority::NORMAL, Type::IDLE, -1)
-		, updateSlice(0)
 {
 }
 
@@ -32,8 +33,12 @@ void CIdleTask::AssignTo(CCircuitUnit* unit)
 
 void CIdleTask::RemoveAssignee(CCircuitUnit* unit)
 {
-	if (units.erase(unit) > 0) {
-		updateUnits.erase(unit);
+	units.erase(unit);
+	// NOTE: Destroyed unit goes through RemoveAssignee, snapshot must not keep it
+	auto it = std::find(updateUnits.begin(), updateUnits.end(), unit);
+	if (it != updateUnits.end()) {
+		*it = updateUnits.back();
+		updateUnits.pop_back();
 	}
 
 	unit->Clear();
@@ -44,25 +49,29 @@ void CIdleTask::Execute(CCircuitUnit* unit)
 }
 
 void CIdleTask::Update()
+{
+	UpdateSlice(units.size() / TEAM_SLOWUPDATE_RATE + 1);
+}
+
+unsigned int CIdleTask::UpdateSlice(unsigned int n)
 {
 	if (updateUnits.empty()) {
-		updateUnits = units;  // copy units
-		updateSlice = updateUnits.size() / TEAM_SLOWUPDATE_RATE;
+		updateUnits.assign(units.begin(), units.end());
 	}
 
-	auto it = updateUnits.begin();
+	// NOTE: AssignTask may remove other idle units, swap-erase reorders units,
+	//       snapshot of the round keeps each unit processed once.
+	//       RemoveAssignee erases units from snapshot.
 	unsigned int i = 0;
-	while (it != updateUnits.end()) {
-		CCircuitUnit* ass = *it;
-		it = updateUnits.erase(it);
+	while (!updateUnits.empty() && (i < n)) {
+		CCircuitUnit* ass = updateUnits.back();
+		updateUnits.pop_back();
 
 		manager->AssignTask(ass);  // should RemoveAssignee() on AssignTo()
 		ass->GetTask()->Execute(ass);
-
-		if (++i >= updateSlice) {
-			break;
-		}
+		++i;
 	}
+	return i;
 }
 
 void CIdleTask::Close(bool done)
@@ -22,6 +22,7 @@ public:
 
 	virtual void Execute(CCircuitUnit* unit) override;
 	virtual void Update() override;
+	unsigned int UpdateSlice(unsigned int n);
 	virtual void Close(bool done) override;
 
 	virtual void OnUnitIdle(CCircuitUnit* unit) override;
@@ -29,8 +30,7 @@ public:
 	virtual void OnUnitDestroyed(CCircuitUnit* unit, CEnemyUnit* attacker) override;
 
 private:
-	std::set<CCircuitUnit*> updateUnits;
-	unsigned int updateSlice;
+	std::vector<CCircuitUnit*> updateUnits;  // snapshot of units for current round
 };
 
 } // namespace circuit
@@ -10,6 +10,7 @@
 #include "module/BuilderManager.h"
 #include "module/FactoryManager.h"
 #include "setup/SetupManager.h"
+#include "terrain/HavenField.h"
 #include "terrain/PathFinder.h"
 #include "terrain/TerrainManager.h"
 #include "terrain/ThreatMap.h"
@@ -22,6 +23,8 @@
 
 #include "AISCommands.h"
 
+#include <limits>
+
 namespace circuit {
 
 using namespace springai;
@@ -49,15 +52,15 @@ void CRetreatTask::AssignTo(CCircuitUnit* unit)
 	CCircuitAI* circuit = manager->GetCircuit();
 	CCircuitDef* cdef = unit->GetCircuitDef();
 	TRY_UNIT(circuit, unit,
-		unit->GetUnit()->SetFireState(cdef->IsAttrRetHold() ? CCircuitDef::FireType::HOLD : CCircuitDef::FireType::OPEN);
+		unit->CmdFireState(cdef->IsAttrRetHold() ? CCircuitDef::FireType::HOLD : CCircuitDef::FireType::OPEN);
 	)
 	if (cdef->IsAttrBoost()) {
 		int frame = circuit->GetLastFrame() + FRAMES_PER_SEC * 60;
 		TRY_UNIT(circuit, unit,
 			if (cdef->IsPlane()) {
-				unit->GetUnit()->ExecuteCustomCommand(CMD_FIND_PAD, {}, UNIT_COMMAND_OPTION_INTERNAL_ORDER, frame);
+				unit->CmdCustom(CMD_FIND_PAD, {}, UNIT_COMMAND_OPTION_INTERNAL_ORDER, frame);
 			}
-			unit->GetUnit()->ExecuteCustomCommand(CMD_ONECLICK_WEAPON, {}, UNIT_COMMAND_OPTION_ALT_KEY | UNIT_COMMAND_OPTION_INTERNAL_ORDER, frame);
+			unit->CmdCustom(CMD_ONECLICK_WEAPON, {}, UNIT_COMMAND_OPTION_ALT_KEY | UNIT_COMMAND_OPTION_INTERNAL_ORDER, frame);
 		)
 		return;
 	}
@@ -88,7 +91,7 @@ void CRetreatTask::RemoveAssignee(CCircuitUnit* unit)
 	}
 
 	TRY_UNIT(manager->GetCircuit(), unit,
-		unit->GetUnit()->SetFireState(unit->GetCircuitDef()->GetFireState());
+		unit->CmdFireState(unit->GetCircuitDef()->GetFireState());
 	)
 }
 
@@ -107,20 +110,29 @@ void CRetreatTask::Execute(CCircuitUnit* unit)
 	AIFloat3 endPos;
 	float range;
 
+	std::shared_ptr<F3Vec> pPath = std::make_shared<F3Vec>();
+	const float minThreat = circuit->GetThreatMap()->GetUnitThreat(unit) * 0.125f;
+
 	if (repairer != nullptr) {
 		endPos = repairer->GetPos(frame);
 		range = pathfinder->GetSquareSize();
 	} else {
 		CFactoryManager* factoryManager = circuit->GetFactoryManager();
+		range = factoryManager->GetAssistDef()->GetBuildDistance() * 0.6f + pathfinder->GetSquareSize();
+		// Descend haven distance field instead of A*, field knows no threat
+		if (factoryManager->GetHavenField()->GetPath(unit->GetArea(), startPos, range, *pPath)) {
+			if (IsSafePath(unit, startPos, *pPath, minThreat)) {
+				travelAction->SetPath(pPath);
+				return;
+			}
+			pPath->clear();
+		}
 		endPos = factoryManager->GetClosestHaven(unit);
 		if (!utils::is_valid(endPos)) {
 			endPos = circuit->GetSetupManager()->GetBasePos();
 		}
-		range = factoryManager->GetAssistDef()->GetBuildDistance() * 0.6f + pathfinder->GetSquareSize();
 	}
-	std::shared_ptr<F3Vec> pPath = std::make_shared<F3Vec>();
 
-	const float minThreat = circuit->GetThreatMap()->GetUnitThreat(unit) * 0.125f;
 	pathfinder->SetMapData(unit, circuit->GetThreatMap(), frame);
 	pathfinder->MakePath(*pPath, startPos, endPos, range, minThreat);
 
@@ -130,12 +142,29 @@ void CRetreatTask::Execute(CCircuitUnit* unit)
 	travelAction->SetPath(pPath);
 }
 
+/*
+ * Path may move out of threat, but never into higher threat above minThreat.
+ */
+bool CRetreatTask::IsSafePath(CCircuitUnit* unit, const AIFloat3& startPos, const F3Vec& path, float minThreat) const
+{
+	CThreatMap* threatMap = manager->GetCircuit()->GetThreatMap();
+	float prevThreat = threatMap->GetThreatAt(unit, startPos);
+	for (const AIFloat3& pos : path) {
+		const float threat = threatMap->GetThreatAt(unit, pos);
+		if ((threat > minThreat) && (threat > prevThreat)) {
+			return false;
+		}
+		prevThreat = threat;
+	}
+	return true;
+}
+
 void CRetreatTask::Update()
 {
 	CCircuitAI* circuit = manager->GetCircuit();
 	const int frame = circuit->GetLastFrame();
 	bool isExecute = (++updCount % 2 == 0);
-	auto assignees = units;
+	std::vector<CCircuitUnit*> assignees(units.begin(), units.end());
 	for (CCircuitUnit* unit : assignees) {
 		const float healthPerc = unit->GetHealthPercent();
 		bool isRepaired;
@@ -184,7 +213,7 @@ void CRetreatTask::OnUnitIdle(CCircuitUnit* unit)
 		}
 
 		TRY_UNIT(circuit, unit,
-			unit->GetUnit()->ExecuteCustomCommand(CMD_FIND_PAD, {}, UNIT_COMMAND_OPTION_INTERNAL_ORDER, frame + FRAMES_PER_SEC * 60);
+			unit->CmdCustom(CMD_FIND_PAD, {}, UNIT_COMMAND_OPTION_INTERNAL_ORDER, frame + FRAMES_PER_SEC * 60);
 		)
 		state = State::REGROUP;
 		return;
@@ -201,7 +230,7 @@ void CRetreatTask::OnUnitIdle(CCircuitUnit* unit)
 	if (unitPos.SqDistance2D(haven) > maxDist * maxDist) {
 		// TODO: push MoveAction into unit? to avoid enemy fire
 		TRY_UNIT(circuit, unit,
-			unit->GetUnit()->MoveTo(haven, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 1);
+			unit->CmdMoveTo(haven, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 1);
 		)
 		// TODO: Add fail counter?
 	} else {
@@ -226,7 +255,7 @@ void CRetreatTask::OnUnitIdle(CCircuitUnit* unit)
 		pos = terrainManager->FindBuildSite(cdef, pos, maxDist, UNIT_COMMAND_BUILD_NO_FACING, predicate);
 		TRY_UNIT(circuit, unit,
 //			unit->GetUnit()->ExecuteCustomCommand(CMD_PRIORITY, {0.0f});
-			unit->GetUnit()->PatrolTo(pos);
+			unit->CmdPatrolTo(pos, UNIT_CMD_OPTION, std::numeric_limits<int>::max());
 		)
 
 		IUnitAction* act = static_cast<IUnitAction*>(unit->End());
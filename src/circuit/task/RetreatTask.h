@@ -37,6 +37,8 @@ public:
 	CCircuitUnit* GetRepairer() const { return repairer; }
 
 private:
+	bool IsSafePath(CCircuitUnit* unit, const springai::AIFloat3& startPos, const F3Vec& path, float minThreat) const;
+
 	CCircuitUnit* repairer;
 };
 
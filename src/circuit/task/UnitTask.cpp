@@ -32,6 +32,12 @@ IUnitTask::~IUnitTask()
 {
 }
 
+CSizedPool& IUnitTask::GetPool()
+{
+	static CSizedPool pool("IUnitTask");
+	return pool;
+}
+
 bool IUnitTask::CanAssignTo(CCircuitUnit* unit) const
 {
 	return true;
@@ -88,7 +94,7 @@ void IUnitTask::OnUnitMoveFailed(CCircuitUnit* unit)
 	const int frame = circuit->GetLastFrame();
 	const AIFloat3& pos = utils::get_radial_pos(unit->GetPos(frame), SQUARE_SIZE * 32);
 	TRY_UNIT(circuit, unit,
-		unit->GetUnit()->MoveTo(pos, 0, frame + FRAMES_PER_SEC);
+		unit->CmdMoveTo(pos, 0, frame + FRAMES_PER_SEC);
 	)
 }
 
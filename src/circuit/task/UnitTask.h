@@ -8,6 +8,9 @@
 #ifndef SRC_CIRCUIT_TASK_UNITTASK_H_
 #define SRC_CIRCUIT_TASK_UNITTASK_H_
 
+#include "util/ObjectPool.h"
+#include "util/SlotSet.h"
+
 #include "AIFloat3.h"
 
 #include <set>
@@ -22,7 +25,7 @@ class CCircuitUnit;
 class CEnemyUnit;
 class ITaskManager;
 
-class IUnitTask {  // CSquad, IAction
+class IUnitTask: public ISlotItem {  // CSquad, IAction
 public:
 	enum class Priority: char {LOW = 0, NORMAL = 1, HIGH = 2, NOW = 99};
 	enum class Type: char {NIL, PLAYER, IDLE, WAIT, RETREAT, BUILDER, FACTORY, FIGHTER};
@@ -33,6 +36,10 @@ protected:
 public:
 	virtual ~IUnitTask();
 
+	static void* operator new(std::size_t size) { return GetPool().Alloc(size); }
+	static void operator delete(void* ptr, std::size_t size) { GetPool().Free(ptr, size); }
+	static CSizedPool& GetPool();
+
 	virtual bool CanAssignTo(CCircuitUnit* unit) const;
 	virtual void AssignTo(CCircuitUnit* unit);
 	virtual void RemoveAssignee(CCircuitUnit* unit);
@@ -51,7 +58,7 @@ public:
 	virtual void OnUnitDestroyed(CCircuitUnit* unit, CEnemyUnit* attacker) = 0;
 	void OnUnitMoveFailed(CCircuitUnit* unit);
 
-	const std::set<CCircuitUnit*>& GetAssignees() const { return units; }
+	const CSlotSet<CCircuitUnit>& GetAssignees() const { return units; }
 	Priority GetPriority() const { return priority; }
 	Type GetType() const { return type; }
 	ITaskManager* GetManager() const { return manager; }
@@ -69,7 +76,7 @@ protected:
 	virtual void Save(std::ostream& os) const;
 
 	ITaskManager* manager;
-	std::set<CCircuitUnit*> units;
+	CSlotSet<CCircuitUnit> units;
 	Priority priority;
 	Type type;
 	State state;
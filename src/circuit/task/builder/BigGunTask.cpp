@@ -33,18 +33,14 @@ void CBBigGunTask::Finish()
 	IBuilderTask::Finish();
 }
 
-CAllyUnit* CBBigGunTask::FindSameAlly(CCircuitUnit* builder, const std::vector<Unit*>& friendlies)
+CAllyUnit* CBBigGunTask::FindSameAlly(CCircuitUnit* builder, const std::vector<CAllyUnit*>& friendlies)
 {
 	CCircuitAI* circuit = manager->GetCircuit();
 	CTerrainManager* terrainManager = circuit->GetTerrainManager();
 	const int frame = circuit->GetLastFrame();
 
-	for (Unit* au : friendlies) {
-		CAllyUnit* alu = circuit->GetFriendlyUnit(au);
-		if (alu == nullptr) {
-			continue;
-		}
-		if (alu->GetCircuitDef()->IsRoleSuper() && au->IsBeingBuilt()) {
+	for (CAllyUnit* alu : friendlies) {
+		if (alu->GetCircuitDef()->IsRoleSuper() && alu->IsBeingBuilt(frame)) {
 			const AIFloat3& pos = alu->GetPos(frame);
 			if (terrainManager->CanBuildAtSafe(builder, pos)) {
 				return alu;
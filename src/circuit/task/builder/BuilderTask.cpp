@@ -58,7 +58,7 @@ IBuilderTask::IBuilderTask(ITaskManager* mgr, Priority priority,
 		, facing(UNIT_COMMAND_BUILD_NO_FACING)
 		, nextTask(nullptr)
 		, buildFails(0)
-		, unitIt(units.end())
+		, unitIdx(0)
 {
 	savedIncome = manager->GetCircuit()->GetEconomyManager()->GetAvgMetalIncome();
 }
@@ -90,9 +90,6 @@ void IBuilderTask::AssignTo(CCircuitUnit* unit)
 
 void IBuilderTask::RemoveAssignee(CCircuitUnit* unit)
 {
-	if ((units.find(unit) == unitIt) && (unitIt != units.end())) {
-		++unitIt;
-	}
 	IUnitTask::RemoveAssignee(unit);
 
 	HideAssignee(unit);
@@ -101,15 +98,14 @@ void IBuilderTask::RemoveAssignee(CCircuitUnit* unit)
 void IBuilderTask::Execute(CCircuitUnit* unit)
 {
 	CCircuitAI* circuit = manager->GetCircuit();
-	Unit* u = unit->GetUnit();
 	TRY_UNIT(circuit, unit,
-		u->ExecuteCustomCommand(CMD_PRIORITY, {ClampPriority()});
+		unit->CmdPriority(ClampPriority());
 	)
 
 	const int frame = circuit->GetLastFrame();
 	if (target != nullptr) {
 		TRY_UNIT(circuit, unit,
-			u->Repair(target->GetUnit(), UNIT_CMD_OPTION, frame + FRAMES_PER_SEC * 60);
+			unit->CmdRepair(target, UNIT_CMD_OPTION, frame + FRAMES_PER_SEC * 60);
 		)
 		return;
 	}
@@ -118,7 +114,7 @@ void IBuilderTask::Execute(CCircuitUnit* unit)
 	if (utils::is_valid(buildPos)) {
 		if (circuit->GetMap()->IsPossibleToBuildAt(buildUDef, buildPos, facing)) {
 			TRY_UNIT(circuit, unit,
-				u->Build(buildUDef, buildPos, facing, 0, frame + FRAMES_PER_SEC * 60);
+				unit->CmdBuild(buildDef, buildPos, facing, 0, frame + FRAMES_PER_SEC * 60);
 			)
 			return;
 		} else {
@@ -131,13 +127,13 @@ void IBuilderTask::Execute(CCircuitUnit* unit)
 	circuit->GetThreatMap()->SetThreatType(unit);
 	// FIXME: Replace const 999.0f with build time?
 	if (circuit->IsAllyAware() && (cost > 999.0f)) {
-		circuit->UpdateFriendlyUnits();
-		auto friendlies = std::move(circuit->GetCallback()->GetFriendlyUnitsIn(position, cost));
+		static std::vector<CAllyUnit*> friendlies;  // NOTE: micro-opt
+		friendlies.clear();
+		circuit->GetFriendlyUnitsIn(position, cost, friendlies);
 		CAllyUnit* alu = FindSameAlly(unit, friendlies);
-		utils::free_clear(friendlies);
 		if (alu != nullptr) {
 			TRY_UNIT(circuit, unit,
-				u->Repair(alu->GetUnit(), UNIT_CMD_OPTION, frame + FRAMES_PER_SEC * 60);
+				unit->CmdRepair(alu, UNIT_CMD_OPTION, frame + FRAMES_PER_SEC * 60);
 			)
 			return;
 		}
@@ -152,7 +148,7 @@ void IBuilderTask::Execute(CCircuitUnit* unit)
 	if (utils::is_valid(buildPos)) {
 		terrainManager->AddBlocker(buildDef, buildPos, facing);
 		TRY_UNIT(circuit, unit,
-			u->Build(buildUDef, buildPos, facing, 0, frame + FRAMES_PER_SEC * 60);
+			unit->CmdBuild(buildDef, buildPos, facing, 0, frame + FRAMES_PER_SEC * 60);
 		)
 	} else {
 		// TODO: Select new proper BasePos, like near metal cluster.
@@ -198,11 +194,10 @@ void IBuilderTask::Update()
 	if (units.empty()) {
 		return;
 	}
-	if (unitIt == units.end()) {
-		unitIt = units.begin();
+	if (unitIdx >= units.size()) {
+		unitIdx = 0;
 	}
-	CCircuitUnit* unit = *unitIt;
-	++unitIt;
+	CCircuitUnit* unit = units[unitIdx++];
 
 	const float sqDist = unit->GetPos(circuit->GetLastFrame()).SqDistance2D(GetPosition());
 	if (sqDist <= SQUARE(unit->GetCircuitDef()->GetBuildDistance())) {
@@ -238,7 +233,7 @@ void IBuilderTask::Finish()
 		const int buildDelay = circuit->GetEconomyManager()->GetBuildDelay();
 		if (buildDelay > 0) {
 			IUnitTask* task = builderManager->EnqueueWait(buildDelay);
-			decltype(units) tmpUnits = units;
+			std::vector<CCircuitUnit*> tmpUnits(units.begin(), units.end());
 			for (CCircuitUnit* unit : tmpUnits) {
 				manager->AssignTask(unit, task);
 			}
@@ -325,7 +320,7 @@ void IBuilderTask::UpdateTarget(CCircuitUnit* unit)
 	int frame = circuit->GetLastFrame() + FRAMES_PER_SEC * 60;
 	for (CCircuitUnit* ass : units) {
 		TRY_UNIT(circuit, ass,
-			ass->GetUnit()->Repair(unit->GetUnit(), UNIT_CMD_OPTION, frame);
+			ass->CmdRepair(unit, UNIT_CMD_OPTION, frame);
 		)
 	}
 }
@@ -375,18 +370,14 @@ void IBuilderTask::ShowAssignee(CCircuitUnit* unit)
 	}
 }
 
-CAllyUnit* IBuilderTask::FindSameAlly(CCircuitUnit* builder, const std::vector<Unit*>& friendlies)
+CAllyUnit* IBuilderTask::FindSameAlly(CCircuitUnit* builder, const std::vector<CAllyUnit*>& friendlies)
 {
 	CCircuitAI* circuit = manager->GetCircuit();
 	CTerrainManager* terrainManager = circuit->GetTerrainManager();
 	const int frame = circuit->GetLastFrame();
 
-	for (Unit* au : friendlies) {
-		CAllyUnit* alu = circuit->GetFriendlyUnit(au);
-		if (alu == nullptr) {
-			continue;
-		}
-		if ((*alu->GetCircuitDef() == *buildDef) && au->IsBeingBuilt()) {
+	for (CAllyUnit* alu : friendlies) {
+		if ((*alu->GetCircuitDef() == *buildDef) && alu->IsBeingBuilt(frame)) {
 			const AIFloat3& pos = alu->GetPos(frame);
 			if (terrainManager->CanBuildAtSafe(builder, pos)) {
 				return alu;
@@ -444,24 +435,15 @@ void IBuilderTask::ExecuteChain(SBuildChain* chain)
 			float ourRange = economyManager->GetEnergyGrid()->GetPylonRange(buildDef->GetId());
 			float pylonRange = economyManager->GetPylonRange();
 			float radius = pylonRange + ourRange;
-			const int frame = circuit->GetLastFrame();
-			circuit->UpdateFriendlyUnits();
-			auto units = std::move(circuit->GetCallback()->GetFriendlyUnitsIn(buildPos, radius));
-			for (Unit* u : units) {
-				CAllyUnit* p = circuit->GetFriendlyUnit(u);
-				if (p == nullptr) {
-					continue;
-				}
-				// NOTE: Is SqDistance2D necessary? Or must subtract model radius of pylon from "radius" variable
-				//        @see rts/Sim/Misc/QaudField.cpp
-				//        ...CQuadField::GetUnitsExact(const float3& pos, float radius, bool spherical)
-				//        const float totRad = radius + u->radius; -- suspicious
-				if ((*p->GetCircuitDef() == *pylonDef) && (buildPos.SqDistance2D(p->GetPos(frame)) < SQUARE(radius))) {
+			static std::vector<CAllyUnit*> units;  // NOTE: micro-opt
+			units.clear();
+			circuit->GetFriendlyUnitsIn(buildPos, radius, units);
+			for (CAllyUnit* p : units) {
+				if (*p->GetCircuitDef() == *pylonDef) {
 					foundPylon = true;
 					break;
 				}
 			}
-			utils::free_clear(units);
 			if (!foundPylon) {
 				AIFloat3 pos = buildPos;
 				CMetalManager* metalManager = circuit->GetMetalManager();
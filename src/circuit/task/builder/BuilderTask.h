@@ -103,7 +103,7 @@ public:
 protected:
 	void HideAssignee(CCircuitUnit* unit);
 	void ShowAssignee(CCircuitUnit* unit);
-	virtual CAllyUnit* FindSameAlly(CCircuitUnit* builder, const std::vector<springai::Unit*>& friendlies);
+	virtual CAllyUnit* FindSameAlly(CCircuitUnit* builder, const std::vector<CAllyUnit*>& friendlies);
 	virtual void FindBuildSite(CCircuitUnit* builder, const springai::AIFloat3& pos, float searchRadius);
 
 	void ExecuteChain(SBuildChain* chain);
@@ -126,7 +126,7 @@ protected:
 	float savedIncome;
 	int buildFails;
 
-	decltype(units)::const_iterator unitIt;  // update iterator
+	unsigned int unitIdx;  // update index
 };
 
 } // namespace circuit
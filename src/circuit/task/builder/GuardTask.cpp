@@ -53,8 +53,8 @@ void CBGuardTask::Execute(CCircuitUnit* unit)
 	CCircuitUnit* vip = circuit->GetTeamUnit(vipId);
 	if (vip != nullptr) {
 		TRY_UNIT(circuit, unit,
-			unit->GetUnit()->ExecuteCustomCommand(CMD_PRIORITY, {ClampPriority()});
-			unit->GetUnit()->Guard(vip->GetUnit());
+			unit->CmdPriority(ClampPriority());
+			unit->CmdGuard(vip);
 		)
 	} else {
 		manager->AbortTask(this);
@@ -67,7 +67,7 @@ void CBGuardTask::OnUnitIdle(CCircuitUnit* unit)
 	CCircuitUnit* vip = circuit->GetTeamUnit(vipId);
 	if (vip != nullptr) {
 		TRY_UNIT(circuit, unit,
-			unit->GetUnit()->Guard(vip->GetUnit());
+			unit->CmdGuard(vip);
 		)
 	} else {
 		manager->AbortTask(this);
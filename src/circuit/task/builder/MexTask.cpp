@@ -62,15 +62,14 @@ bool CBMexTask::CanAssignTo(CCircuitUnit* unit) const
 void CBMexTask::Execute(CCircuitUnit* unit)
 {
 	CCircuitAI* circuit = manager->GetCircuit();
-	Unit* u = unit->GetUnit();
 	TRY_UNIT(circuit, unit,
-		u->ExecuteCustomCommand(CMD_PRIORITY, {ClampPriority()});
+		unit->CmdPriority(ClampPriority());
 	)
 
 	const int frame = circuit->GetLastFrame();
 	if (target != nullptr) {
 		TRY_UNIT(circuit, unit,
-			u->Repair(target->GetUnit(), UNIT_CMD_OPTION, frame + FRAMES_PER_SEC * 60);
+			unit->CmdRepair(target, UNIT_CMD_OPTION, frame + FRAMES_PER_SEC * 60);
 		)
 		return;
 	}
@@ -85,7 +84,7 @@ void CBMexTask::Execute(CCircuitUnit* unit)
 					state = State::ENGAGE;  // isFirstTry = false
 					metalManager->SetOpenSpot(index, false);
 					TRY_UNIT(circuit, unit,
-						u->Build(buildUDef, buildPos, facing, 0, frame + FRAMES_PER_SEC * 60);
+						unit->CmdBuild(buildDef, buildPos, facing, 0, frame + FRAMES_PER_SEC * 60);
 					)
 					return;
 				} else {
@@ -104,19 +103,24 @@ void CBMexTask::Execute(CCircuitUnit* unit)
 	CTerrainManager* terrainManager = circuit->GetTerrainManager();
 	CCircuitDef* mexDef = buildDef;
 	circuit->GetThreatMap()->SetThreatType(unit);
-	CMetalData::PointPredicate predicate = [&spots, economyManager, map, mexDef, terrainManager, unit](const int index) {
-		return (economyManager->IsAllyOpenSpot(index) &&
-				terrainManager->CanBeBuiltAtSafe(mexDef, spots[index].position) &&  // hostile environment
-				terrainManager->CanBuildAtSafe(unit, spots[index].position) &&
-				map->IsPossibleToBuildAt(mexDef->GetUnitDef(), spots[index].position, UNIT_COMMAND_BUILD_NO_FACING));
-	};
-	int index = metalManager->FindNearestSpot(position, predicate);
+	static CMetalData::SMask openMask;  // NOTE: micro-opt
+	economyManager->GetAllyOpenSpots(openMask);
+	int index;
+	while ((index = metalManager->FindNearestSpot(position, openMask)) >= 0) {
+		if (terrainManager->CanBeBuiltAtSafe(mexDef, spots[index].position) &&  // hostile environment
+			terrainManager->CanBuildAtSafe(unit, spots[index].position) &&
+			map->IsPossibleToBuildAt(mexDef->GetUnitDef(), spots[index].position, UNIT_COMMAND_BUILD_NO_FACING))
+		{
+			break;
+		}
+		openMask.Set(index, false);
+	}
 
 	if (index >= 0) {
 		buildPos = spots[index].position;
 		economyManager->SetOpenSpot(index, false);
 		TRY_UNIT(circuit, unit,
-			u->Build(buildUDef, buildPos, facing, 0, frame + FRAMES_PER_SEC * 60);
+			unit->CmdBuild(buildDef, buildPos, facing, 0, frame + FRAMES_PER_SEC * 60);
 		)
 	} else {
 //		buildPos = -RgtVector;
@@ -47,16 +47,15 @@ void CBPatrolTask::RemoveAssignee(CCircuitUnit* unit)
 void CBPatrolTask::Execute(CCircuitUnit* unit)
 {
 	CCircuitAI* circuit = manager->GetCircuit();
-	Unit* u = unit->GetUnit();
 	TRY_UNIT(circuit, unit,
-		u->ExecuteCustomCommand(CMD_PRIORITY, {0.0f});
+		unit->CmdPriority(0.0f);
 
 		const float size = SQUARE_SIZE * 100;
 		CTerrainManager* terrainManager = circuit->GetTerrainManager();
 		AIFloat3 pos = position;
 		pos.x += (pos.x > terrainManager->GetTerrainWidth() / 2) ? -size : size;
 		pos.z += (pos.z > terrainManager->GetTerrainHeight() / 2) ? -size : size;
-		u->PatrolTo(pos);
+		unit->CmdPatrolTo(pos, UNIT_CMD_OPTION, INT_MAX);
 	)
 }
 
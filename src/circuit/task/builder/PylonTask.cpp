@@ -8,6 +8,7 @@
 #include "task/builder/PylonTask.h"
 #include "task/TaskManager.h"
 #include "module/EconomyManager.h"
+#include "resource/EnergyGrid.h"
 #include "resource/EnergyLink.h"
 #include "terrain/TerrainManager.h"
 #include "terrain/ThreatMap.h"
@@ -28,7 +29,7 @@ CBPylonTask::CBPylonTask(ITaskManager* mgr, Priority priority,
 		, link(link)
 {
 	if (link != nullptr) {
-		link->SetBeingBuilt(true);
+		manager->GetCircuit()->GetEconomyManager()->GetEnergyGrid()->SetBeingBuilt(link, true);
 	}
 }
 
@@ -40,15 +41,14 @@ CBPylonTask::~CBPylonTask()
 void CBPylonTask::Execute(CCircuitUnit* unit)
 {
 	CCircuitAI* circuit = manager->GetCircuit();
-	Unit* u = unit->GetUnit();
 	TRY_UNIT(circuit, unit,
-		u->ExecuteCustomCommand(CMD_PRIORITY, {ClampPriority()});
+		unit->CmdPriority(ClampPriority());
 	)
 
 	const int frame = circuit->GetLastFrame();
 	if (target != nullptr) {
 		TRY_UNIT(circuit, unit,
-			u->Repair(target->GetUnit(), UNIT_CMD_OPTION, frame + FRAMES_PER_SEC * 60);
+			unit->CmdRepair(target, UNIT_CMD_OPTION, frame + FRAMES_PER_SEC * 60);
 		)
 		return;
 	}
@@ -57,7 +57,7 @@ void CBPylonTask::Execute(CCircuitUnit* unit)
 	if (utils::is_valid(buildPos)) {
 		if (circuit->GetMap()->IsPossibleToBuildAt(buildUDef, buildPos, facing)) {
 			TRY_UNIT(circuit, unit,
-				u->Build(buildUDef, buildPos, facing, 0, frame + FRAMES_PER_SEC * 60);
+				unit->CmdBuild(buildDef, buildPos, facing, 0, frame + FRAMES_PER_SEC * 60);
 			)
 			return;
 		} else {
@@ -72,7 +72,7 @@ void CBPylonTask::Execute(CCircuitUnit* unit)
 	if (utils::is_valid(buildPos)) {
 		terrainManager->AddBlocker(buildDef, buildPos, facing);
 		TRY_UNIT(circuit, unit,
-			u->Build(buildUDef, buildPos, facing, 0, frame + FRAMES_PER_SEC * 60);
+			unit->CmdBuild(buildDef, buildPos, facing, 0, frame + FRAMES_PER_SEC * 60);
 		)
 	} else {
 		// Fallback to Guard/Assist/Patrol
@@ -83,7 +83,7 @@ void CBPylonTask::Execute(CCircuitUnit* unit)
 void CBPylonTask::Finish()
 {
 	if (link != nullptr) {
-		link->SetBeingBuilt(false);
+		manager->GetCircuit()->GetEconomyManager()->GetEnergyGrid()->SetBeingBuilt(link, false);
 	}
 	manager->GetCircuit()->GetEconomyManager()->UpdatePylonTasks();
 
@@ -93,7 +93,7 @@ void CBPylonTask::Finish()
 void CBPylonTask::Cancel()
 {
 	if (link != nullptr) {
-		link->SetBeingBuilt(false);
+		manager->GetCircuit()->GetEconomyManager()->GetEnergyGrid()->SetBeingBuilt(link, false);
 	}
 
 	IBuilderTask::Cancel();
@@ -8,6 +8,7 @@
 #include "task/builder/ReclaimTask.h"
 #include "task/TaskManager.h"
 #include "module/EconomyManager.h"
+#include "resource/FeatureData.h"
 #include "terrain/TerrainManager.h"
 #include "terrain/ThreatMap.h"
 #include "CircuitAI.h"
@@ -15,8 +16,6 @@
 
 #include "OOAICallback.h"
 #include "AISCommands.h"
-#include "Feature.h"
-#include "FeatureDef.h"
 
 namespace circuit {
 
@@ -24,8 +23,9 @@ using namespace springai;
 
 CBReclaimTask::CBReclaimTask(ITaskManager* mgr, Priority priority,
 							 const AIFloat3& position,
-							 float cost, int timeout, float radius, bool isMetal)
+							 float cost, int timeout, float radius, bool isMetal, int featureId)
 		: IReclaimTask(mgr, priority, Type::BUILDER, position, cost, timeout, radius, isMetal)
+		, featureId(featureId)
 {
 }
 
@@ -33,6 +33,7 @@ CBReclaimTask::CBReclaimTask(ITaskManager* mgr, Priority priority,
 							 CCircuitUnit* target,
 							 int timeout)
 		: IReclaimTask(mgr, priority, Type::BUILDER, target, timeout)
+		, featureId(-1)
 {
 }
 
@@ -63,7 +64,7 @@ void CBReclaimTask::Update()
 			for (Unit* enemy : enemies) {
 				if ((enemy != nullptr) && enemy->IsBeingBuilt()) {
 					TRY_UNIT(circuit, unit,
-						unit->GetUnit()->ReclaimUnit(enemy, UNIT_COMMAND_OPTION_INTERNAL_ORDER, frame + FRAMES_PER_SEC * 60);
+						unit->CmdReclaimUnit(enemy, UNIT_COMMAND_OPTION_INTERNAL_ORDER, frame + FRAMES_PER_SEC * 60);
 					)
 					utils::free_clear(enemies);
 					return;
@@ -72,41 +73,18 @@ void CBReclaimTask::Update()
 			utils::free_clear(enemies);
 		}
 
-		auto features = std::move(circuit->GetCallback()->GetFeaturesIn(pos, 500.0f));
-		if (!features.empty()) {
-			CTerrainManager* terrainManager = circuit->GetTerrainManager();
-			circuit->GetThreatMap()->SetThreatType(unit);
-			float minSqDist = std::numeric_limits<float>::max();
-			Resource* metalRes = circuit->GetEconomyManager()->GetMetalRes();
-			for (Feature* feature : features) {
-				AIFloat3 featPos = feature->GetPosition();
-				CTerrainManager::CorrectPosition(featPos);  // Impulsed flying feature
-				if (!terrainManager->CanBuildAtSafe(unit, featPos)) {
-					continue;
-				}
-				FeatureDef* featDef = feature->GetDef();
-				if (!featDef->IsReclaimable()) {
-					delete featDef;
-					continue;
-				}
-				float reclaimValue = featDef->GetContainedResource(metalRes)/* * feature->GetReclaimLeft()*/;
-				delete featDef;
-				if (reclaimValue < 1.0f) {
-					continue;
-				}
-				float sqDist = pos.SqDistance2D(featPos);
-				if (sqDist < minSqDist) {
-					position = featPos;
-					minSqDist = sqDist;
-				}
-			}
-			if (minSqDist < std::numeric_limits<float>::max()) {
-				const float radius = 8.0f;  // unit->GetCircuitDef()->GetBuildDistance();
-				TRY_UNIT(circuit, unit,
-					unit->GetUnit()->ReclaimInArea(position, radius, UNIT_COMMAND_OPTION_INTERNAL_ORDER, frame + FRAMES_PER_SEC * 60);
-				)
-			}
-			utils::free_clear(features);
+		CTerrainManager* terrainManager = circuit->GetTerrainManager();
+		circuit->GetThreatMap()->SetThreatType(unit);
+		const CFeatureData::SFeature* feature = circuit->GetAllyTeam()->GetFeatureData()->FindNearest(pos, 500.0f, 1.0f,
+			[terrainManager, unit](const CFeatureData::SFeature& f) {
+				return terrainManager->CanBuildAtSafe(unit, f.pos);
+			});
+		if (feature != nullptr) {
+			position = feature->pos;
+			const float radius = 8.0f;  // unit->GetCircuitDef()->GetBuildDistance();
+			TRY_UNIT(circuit, unit,
+				unit->CmdReclaimInArea(position, radius, UNIT_COMMAND_OPTION_INTERNAL_ORDER, frame + FRAMES_PER_SEC * 60);
+			)
 		}
 	}
 }
@@ -16,13 +16,18 @@ class CBReclaimTask: public IReclaimTask {
 public:
 	CBReclaimTask(ITaskManager* mgr, Priority priority,
 				  const springai::AIFloat3& position,
-				  float cost, int timeout, float radius = .0f, bool isMetal = true);
+				  float cost, int timeout, float radius = .0f, bool isMetal = true, int featureId = -1);
 	CBReclaimTask(ITaskManager* mgr, Priority priority,
 				  CCircuitUnit* target,
 				  int timeout);
 	virtual ~CBReclaimTask();
 
 	virtual void Update() override;
+
+	int GetFeatureId() const { return featureId; }
+
+private:
+	int featureId;  // -1 if not a feature
 };
 
 } // namespace circuit
@@ -37,8 +37,8 @@ void CBRepairTask::Update()
 
 void CBRepairTask::OnUnitIdle(CCircuitUnit* unit)
 {
-	Unit* u = target->GetUnit();
-	if (u->GetHealth() < u->GetMaxHealth()) {
+	const int frame = manager->GetCircuit()->GetLastFrame();
+	if (target->GetHealth(frame) < target->GetMaxHealth(frame)) {
 		// unit stuck or event order fail
 		RemoveAssignee(unit);
 	} else {
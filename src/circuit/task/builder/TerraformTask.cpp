@@ -57,8 +57,6 @@ void CBTerraformTask::Execute(CCircuitUnit* unit)
 	 * Terraform blank position
 	 */
 	if (targetId == -1) {
-		Unit* u = unit->GetUnit();
-
 		if (!utils::is_valid(buildPos)) {
 			CTerrainManager* terrainManager = circuit->GetTerrainManager();
 			CTerrainManager::TerrainPredicate predicate = [terrainManager, unit](const AIFloat3& p) {
@@ -94,8 +92,8 @@ void CBTerraformTask::Execute(CCircuitUnit* unit)
 		params.push_back(buildPos.z - offsetZ);  //  9: i + 9 control point z
 		params.push_back(unit->GetId());  // 10: i + 10 unitId
 		TRY_UNIT(circuit, unit,
-			u->ExecuteCustomCommand(CMD_PRIORITY, {ClampPriority()});
-			u->ExecuteCustomCommand(CMD_TERRAFORM_INTERNAL, params);
+			unit->CmdPriority(ClampPriority());
+			unit->CmdCustom(CMD_TERRAFORM_INTERNAL, params);
 		)
 		return;
 	}
@@ -108,8 +106,6 @@ void CBTerraformTask::Execute(CCircuitUnit* unit)
 		return;
 	}
 
-	Unit* u = unit->GetUnit();
-
 	UnitDef* unitDef = buildDef->GetUnitDef();
 	const float offsetX = (((facing & 1) == 0) ? unitDef->GetXSize() : unitDef->GetZSize()) / 2 * SQUARE_SIZE + 1 * SQUARE_SIZE + 1;
 	const float offsetZ = (((facing & 1) == 1) ? unitDef->GetXSize() : unitDef->GetZSize()) / 2 * SQUARE_SIZE + 1 * SQUARE_SIZE + 1;
@@ -133,8 +129,8 @@ void CBTerraformTask::Execute(CCircuitUnit* unit)
 	params.push_back(position.z - offsetZ);  //  9: i + 9 control point z
 	params.push_back(unit->GetId());  // 10: i + 10 unitId
 	TRY_UNIT(circuit, unit,
-		u->ExecuteCustomCommand(CMD_PRIORITY, {ClampPriority()});
-		u->ExecuteCustomCommand(CMD_TERRAFORM_INTERNAL, params);
+		unit->CmdPriority(ClampPriority());
+		unit->CmdCustom(CMD_TERRAFORM_INTERNAL, params);
 	)
 
 	// TODO: Enqueue "move out" action for nearby units
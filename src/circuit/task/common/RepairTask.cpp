@@ -70,11 +70,11 @@ void IRepairTask::Execute(CCircuitUnit* unit)
 		repTarget = (target != nullptr) ? target : circuit->GetFriendlyUnit(targetId);
 	}
 
-	if ((repTarget != nullptr) && (repTarget->GetUnit()->GetHealth() < repTarget->GetUnit()->GetMaxHealth())) {
-		Unit* u = unit->GetUnit();
+	const int frame = circuit->GetLastFrame();
+	if ((repTarget != nullptr) && (repTarget->GetHealth(frame) < repTarget->GetMaxHealth(frame))) {
 		TRY_UNIT(circuit, unit,
-			u->ExecuteCustomCommand(CMD_PRIORITY, {ClampPriority()});
-			u->Repair(repTarget->GetUnit(), UNIT_COMMAND_OPTION_INTERNAL_ORDER, circuit->GetLastFrame() + FRAMES_PER_SEC * 60);
+			unit->CmdPriority(ClampPriority());
+			unit->CmdRepair(repTarget, UNIT_COMMAND_OPTION_INTERNAL_ORDER, circuit->GetLastFrame() + FRAMES_PER_SEC * 60);
 		)
 
 		IUnitTask* task = repTarget->GetTask();
@@ -131,7 +131,7 @@ void IRepairTask::SetTarget(CAllyUnit* unit)
 		position = buildPos = unit->GetPos(circuit->GetLastFrame());
 //		CTerrainManager::CorrectPosition(buildPos);  // position will contain non-corrected value
 		targetId = unit->GetId();
-		if (unit->GetUnit()->IsBeingBuilt()) {
+		if (unit->IsBeingBuilt(circuit->GetLastFrame())) {
 			buildDef = unit->GetCircuitDef();
 		} else {
 			savedIncome = .0f;
@@ -149,22 +149,21 @@ CAllyUnit* IRepairTask::FindUnitToAssist(CCircuitUnit* unit)
 {
 	CCircuitAI* circuit = manager->GetCircuit();
 	CAllyUnit* target = nullptr;
-	const AIFloat3& pos = unit->GetPos(circuit->GetLastFrame());
+	const int frame = circuit->GetLastFrame();
+	const AIFloat3& pos = unit->GetPos(frame);
 	float maxSpeed = unit->GetCircuitDef()->GetSpeed();
 	float radius = unit->GetCircuitDef()->GetBuildDistance() + maxSpeed * 30;
 	maxSpeed = SQUARE(maxSpeed * 1.5f / FRAMES_PER_SEC);
 
-	circuit->UpdateFriendlyUnits();
-	auto units = std::move(circuit->GetCallback()->GetFriendlyUnitsIn(pos, radius));
-	for (Unit* u : units) {
-		if ((u != nullptr) && (u->GetHealth() < u->GetMaxHealth()) && (u->GetVel().SqLength2D() <= maxSpeed)) {
-			target = circuit->GetFriendlyUnit(u);
-			if (target != nullptr) {
-				break;
-			}
+	static std::vector<CAllyUnit*> units;  // NOTE: micro-opt
+	units.clear();
+	circuit->GetFriendlyUnitsIn(pos, radius, units);
+	for (CAllyUnit* candUnit : units) {
+		if ((candUnit->GetHealth(frame) < candUnit->GetMaxHealth(frame)) && (candUnit->GetVel(frame).SqLength2D() <= maxSpeed)) {
+			target = candUnit;
+			break;
 		}
 	}
-	utils::free_clear(units);
 	return target;
 }
 
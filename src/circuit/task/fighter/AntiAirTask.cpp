@@ -137,7 +137,7 @@ void CAntiAirTask::Update()
 			int frame = circuit->GetLastFrame() + FRAMES_PER_SEC * 60;
 			for (CCircuitUnit* unit : units) {
 				TRY_UNIT(circuit, unit,
-					unit->GetUnit()->Fight(groupPos, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame);
+					unit->CmdFightTo(groupPos, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame);
 				)
 
 				ITravelAction* travelAction = static_cast<ITravelAction*>(unit->End());
@@ -184,15 +184,10 @@ void CAntiAirTask::Update()
 			return;
 		}
 	} else {
-		static F3Vec ourPositions;  // NOTE: micro-opt
 		AIFloat3 startPos = leader->GetPos(frame);
-		circuit->GetMilitaryManager()->FillSafePos(startPos, leader->GetArea(), ourPositions);
-
 		pPath->clear();
-		CPathFinder* pathfinder = circuit->GetPathfinder();
-		pathfinder->SetMapData(leader, circuit->GetThreatMap(), circuit->GetLastFrame());
-		pathfinder->FindBestPath(*pPath, startPos, pathfinder->GetSquareSize(), ourPositions, false);
-		ourPositions.clear();
+		circuit->GetPathfinder()->SetMapData(leader, circuit->GetThreatMap(), circuit->GetLastFrame());
+		circuit->GetMilitaryManager()->FindBestPos(*pPath, startPos, leader->GetArea());
 
 		if (!pPath->empty()) {
 			position = pPath->back();
@@ -216,7 +211,7 @@ void CAntiAirTask::Update()
 	if (pPath->empty()) {  // should never happen
 		for (CCircuitUnit* unit : units) {
 			TRY_UNIT(circuit, unit,
-				unit->GetUnit()->Fight(position, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
+				unit->CmdFightTo(position, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
 			)
 
 			ITravelAction* travelAction = static_cast<ITravelAction*>(unit->End());
@@ -260,15 +255,10 @@ void CAntiAirTask::OnUnitDamaged(CCircuitUnit* unit, CEnemyUnit* attacker)
 	}
 	CCircuitAI* circuit = manager->GetCircuit();
 	const int frame = circuit->GetLastFrame();
-	static F3Vec ourPositions;  // NOTE: micro-opt
 	AIFloat3 startPos = leader->GetPos(frame);
-	circuit->GetMilitaryManager()->FillSafePos(startPos, leader->GetArea(), ourPositions);
-
 	pPath->clear();
-	CPathFinder* pathfinder = circuit->GetPathfinder();
-	pathfinder->SetMapData(leader, circuit->GetThreatMap(), circuit->GetLastFrame());
-	pathfinder->FindBestPath(*pPath, startPos, pathfinder->GetSquareSize(), ourPositions);
-	ourPositions.clear();
+	circuit->GetPathfinder()->SetMapData(leader, circuit->GetThreatMap(), circuit->GetLastFrame());
+	circuit->GetMilitaryManager()->FindBestPos(*pPath, startPos, leader->GetArea(), true);
 
 	if (!pPath->empty()) {
 		position = pPath->back();
@@ -278,7 +268,7 @@ void CAntiAirTask::OnUnitDamaged(CCircuitUnit* unit, CEnemyUnit* attacker)
 		position = circuit->GetSetupManager()->GetBasePos();
 		for (CCircuitUnit* unit : units) {
 			TRY_UNIT(circuit, unit,
-				unit->GetUnit()->Fight(position, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
+				unit->CmdFightTo(position, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
 			)
 
 			ITravelAction* travelAction = static_cast<ITravelAction*>(unit->End());
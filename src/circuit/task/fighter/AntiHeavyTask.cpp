@@ -63,7 +63,7 @@ void CAntiHeavyTask::AssignTo(CCircuitUnit* unit)
 	CCircuitAI* circuit = manager->GetCircuit();
 	if (cdef->IsAbleToCloak() && !cdef->IsOpenFire()) {
 		TRY_UNIT(circuit, unit,
-			unit->GetUnit()->SetFireState(CCircuitDef::FireType::RETURN);
+			unit->CmdFireState(CCircuitDef::FireType::RETURN);
 		)
 	}
 
@@ -96,7 +96,7 @@ void CAntiHeavyTask::RemoveAssignee(CCircuitUnit* unit)
 	CCircuitDef* cdef = unit->GetCircuitDef();
 	if (cdef->IsAbleToCloak()) {
 		TRY_UNIT(manager->GetCircuit(), unit,
-			unit->GetUnit()->SetFireState(cdef->GetFireState());
+			unit->CmdFireState(cdef->GetFireState());
 		)
 	}
 }
@@ -145,7 +145,7 @@ void CAntiHeavyTask::Update()
 			int frame = circuit->GetLastFrame() + FRAMES_PER_SEC * 60;
 			for (CCircuitUnit* unit : units) {
 				TRY_UNIT(circuit, unit,
-					unit->GetUnit()->Fight(groupPos, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame);
+					unit->CmdFightTo(groupPos, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame);
 				)
 
 				ITravelAction* travelAction = static_cast<ITravelAction*>(unit->End());
@@ -260,7 +260,7 @@ void CAntiHeavyTask::Update()
 
 		for (CCircuitUnit* unit : units) {
 			TRY_UNIT(circuit, unit,
-				unit->GetUnit()->Fight(position, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
+				unit->CmdFightTo(position, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
 			)
 
 			ITravelAction* travelAction = static_cast<ITravelAction*>(unit->End());
@@ -298,7 +298,7 @@ void CAntiHeavyTask::OnUnitDamaged(CCircuitUnit* unit, CEnemyUnit* attacker)
 	if (attacker != nullptr) {
 		if (unit->GetCircuitDef()->IsAbleToCloak()) {
 			TRY_UNIT(manager->GetCircuit(), unit,
-				unit->GetUnit()->SetFireState(CCircuitDef::FireType::OPEN);
+				unit->CmdFireState(CCircuitDef::FireType::OPEN);
 			)
 		}
 		IUnitAction* act = static_cast<IUnitAction*>(unit->Begin());
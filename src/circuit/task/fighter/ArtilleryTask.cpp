@@ -44,7 +44,7 @@ void CArtilleryTask::AssignTo(CCircuitUnit* unit)
 {
 	IFighterTask::AssignTo(unit);
 
-	unit->GetUnit()->SetMoveState(0);
+	unit->CmdMoveState(0);
 
 	int squareSize = manager->GetCircuit()->GetPathfinder()->GetSquareSize();
 	CMoveAction* travelAction = new CMoveAction(unit, squareSize);
@@ -59,7 +59,7 @@ void CArtilleryTask::RemoveAssignee(CCircuitUnit* unit)
 		manager->AbortTask(this);
 	}
 
-	unit->GetUnit()->SetMoveState(1);
+	unit->CmdMoveState(1);
 }
 
 void CArtilleryTask::Execute(CCircuitUnit* unit)
@@ -98,7 +98,7 @@ void CArtilleryTask::Execute(CCircuitUnit* unit, bool isUpdating)
 
 	if (bestTarget != nullptr) {
 		TRY_UNIT(circuit, unit,
-			unit->GetUnit()->Attack(bestTarget->GetUnit(), UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
+			unit->CmdAttack(bestTarget, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
 //			unit->GetUnit()->ExecuteCustomCommand(CMD_UNIT_SET_TARGET, {(float)bestTarget->GetId()});
 		)
 		travelAction->SetActive(false);
@@ -142,7 +142,7 @@ void CArtilleryTask::Execute(CCircuitUnit* unit, bool isUpdating)
 	position = AIFloat3(x, circuit->GetMap()->GetElevationAt(x, z), z);
 	position = terrainManager->GetMovePosition(unit->GetArea(), position);
 	TRY_UNIT(circuit, unit,
-		unit->GetUnit()->Fight(position, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
+		unit->CmdFightTo(position, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
 	)
 	travelAction->SetActive(false);
 }
@@ -157,8 +157,15 @@ void CArtilleryTask::OnUnitIdle(CCircuitUnit* unit)
 
 CEnemyUnit* CArtilleryTask::FindTarget(CCircuitUnit* unit, const AIFloat3& pos, F3Vec& path)
 {
-	auto fallback = [this](CCircuitAI* circuit, const AIFloat3& pos, F3Vec& path, CPathFinder* pathfinder) {
-		position = circuit->GetSetupManager()->GetBasePos();
+	auto fallback = [this, unit](CCircuitAI* circuit, const AIFloat3& pos, F3Vec& path, CPathFinder* pathfinder) {
+		// Safe spot nearby (with its neighbour cells), otherwise base
+		CThreatMap* threatMap = circuit->GetThreatMap();
+		position = threatMap->GetSafestPos(pos, unit->GetCircuitDef()->GetMaxRange());
+		if ((threatMap->GetMaxThreatIn(position, threatMap->GetSquareSize() * 2) > THREAT_MIN) ||
+			!circuit->GetTerrainManager()->CanMoveToPos(unit->GetArea(), position))
+		{
+			position = circuit->GetSetupManager()->GetBasePos();
+		}
 		AIFloat3 startPos = pos;
 		AIFloat3 endPos = position;
 		pathfinder->MakePath(path, startPos, endPos, pathfinder->GetSquareSize());
@@ -90,7 +90,7 @@ void CBombTask::Execute(CCircuitUnit* unit, bool isUpdating)
 	if (!unit->IsWeaponReady(frame)) {  // reload empty unit
 		if (updCount % 32 == 0) {
 			TRY_UNIT(circuit, unit,
-				unit->GetUnit()->ExecuteCustomCommand(CMD_FIND_PAD, {}, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
+				unit->CmdCustom(CMD_FIND_PAD, {}, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
 			)
 		}
 		SetTarget(nullptr);
@@ -107,10 +107,10 @@ void CBombTask::Execute(CCircuitUnit* unit, bool isUpdating)
 		position = target->GetPos();
 		TRY_UNIT(circuit, unit,
 			if (target->GetUnit()->IsCloaked()) {
-				unit->GetUnit()->ExecuteCustomCommand(CMD_ATTACK_GROUND, {position.x, position.y, position.z},
-													  UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
+				unit->CmdCustom(CMD_ATTACK_GROUND, {position.x, position.y, position.z},
+								UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
 			} else if (lastTarget != target) {
-				unit->GetUnit()->Attack(target->GetUnit(), UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
+				unit->CmdAttack(target, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
 			}
 		)
 		travelAction->SetActive(false);
@@ -155,7 +155,7 @@ void CBombTask::Execute(CCircuitUnit* unit, bool isUpdating)
 	float z = rand() % terrainManager->GetTerrainHeight();
 	position = AIFloat3(x, circuit->GetMap()->GetElevationAt(x, z), z);
 	TRY_UNIT(circuit, unit,
-		unit->GetUnit()->Fight(position, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
+		unit->CmdFightTo(position, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
 	)
 	travelAction->SetActive(false);
 }
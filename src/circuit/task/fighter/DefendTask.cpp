@@ -59,8 +59,8 @@ void CDefendTask::Execute(CCircuitUnit* unit)
 	pos = terrainManager->FindBuildSite(unit->GetCircuitDef(), pos, 300.0f, UNIT_COMMAND_BUILD_NO_FACING);
 
 	TRY_UNIT(circuit, unit,
-		unit->GetUnit()->Fight(pos, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, circuit->GetLastFrame() + FRAMES_PER_SEC * 60);
-		unit->GetUnit()->ExecuteCustomCommand(CMD_WANTED_SPEED, {NO_SPEED_LIMIT});
+		unit->CmdFightTo(pos, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, circuit->GetLastFrame() + FRAMES_PER_SEC * 60);
+		unit->CmdWantedSpeed(NO_SPEED_LIMIT);
 	)
 }
 
@@ -75,7 +75,7 @@ void CDefendTask::Update()
 		CMilitaryManager* militaryManager = static_cast<CMilitaryManager*>(manager);
 		if ((attackPower >= maxPower) || !militaryManager->GetTasks(check).empty()) {
 			IFighterTask* task = militaryManager->EnqueueTask(promote);
-			decltype(units) tmpUnits = units;
+			std::vector<CCircuitUnit*> tmpUnits(units.begin(), units.end());
 			for (CCircuitUnit* unit : tmpUnits) {
 				manager->AssignTask(unit, task);
 			}
@@ -127,8 +127,8 @@ void CDefendTask::Update()
 		for (CCircuitUnit* unit : units) {
 			AIFloat3 pos = utils::get_radial_pos(position, SQUARE_SIZE * 32);
 			TRY_UNIT(circuit, unit,
-				unit->GetUnit()->Fight(pos, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame);
-				unit->GetUnit()->ExecuteCustomCommand(CMD_WANTED_SPEED, {NO_SPEED_LIMIT});
+				unit->CmdFightTo(pos, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame);
+				unit->CmdWantedSpeed(NO_SPEED_LIMIT);
 			)
 		}
 	}
@@ -136,7 +136,7 @@ void CDefendTask::Update()
 
 void CDefendTask::Merge(ISquadTask* task)
 {
-	const std::set<CCircuitUnit*>& rookies = task->GetAssignees();
+	const CSlotSet<CCircuitUnit>& rookies = task->GetAssignees();
 	for (CCircuitUnit* unit : rookies) {
 		unit->SetTask(this);
 	}
@@ -69,7 +69,7 @@ void IFighterTask::Update()
 	CCircuitAI* circuit = manager->GetCircuit();
 	CMilitaryManager* militaryManager = circuit->GetMilitaryManager();
 	const float minShield = circuit->GetSetupManager()->GetEmptyShield();
-	decltype(units) tmpUnits = shields;
+	decltype(shields) tmpUnits = shields;
 	for (CCircuitUnit* unit : tmpUnits) {
 		if (!unit->IsShieldCharged(minShield)) {
 			CRetreatTask* task = militaryManager->EnqueueRetreat();
@@ -37,8 +37,8 @@ void CFGuardTask::Execute(CCircuitUnit* unit)
 	CCircuitUnit* vip = circuit->GetTeamUnit(vipId);
 	if (vip != nullptr) {
 		TRY_UNIT(circuit, unit,
-			unit->GetUnit()->Guard(vip->GetUnit());
-			unit->GetUnit()->ExecuteCustomCommand(CMD_WANTED_SPEED, {NO_SPEED_LIMIT});
+			unit->CmdGuard(vip);
+			unit->CmdWantedSpeed(NO_SPEED_LIMIT);
 		)
 	} else {
 		manager->AbortTask(this);
@@ -51,7 +51,7 @@ void CFGuardTask::OnUnitIdle(CCircuitUnit* unit)
 	CCircuitUnit* vip = circuit->GetTeamUnit(vipId);
 	if (vip != nullptr) {
 		TRY_UNIT(circuit, unit,
-			unit->GetUnit()->Guard(vip->GetUnit());
+			unit->CmdGuard(vip);
 		)
 	} else {
 		manager->AbortTask(this);
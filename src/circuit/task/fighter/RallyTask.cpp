@@ -58,14 +58,14 @@ void CRallyTask::Execute(CCircuitUnit* unit)
 		AIFloat3 pos = terrainManager->FindBuildSite(unit->GetCircuitDef(), position, 300.0f, UNIT_COMMAND_BUILD_NO_FACING);
 
 		TRY_UNIT(circuit, unit,
-			unit->GetUnit()->MoveTo(pos, UNIT_COMMAND_OPTION_INTERNAL_ORDER, circuit->GetLastFrame() + FRAMES_PER_SEC * 60);
-			unit->GetUnit()->ExecuteCustomCommand(CMD_WANTED_SPEED, {NO_SPEED_LIMIT});
+			unit->CmdMoveTo(pos, UNIT_COMMAND_OPTION_INTERNAL_ORDER, circuit->GetLastFrame() + FRAMES_PER_SEC * 60);
+			unit->CmdWantedSpeed(NO_SPEED_LIMIT);
 		)
 		return;
 	}
 
 	IFighterTask* task = static_cast<CMilitaryManager*>(manager)->EnqueueTask(IFighterTask::FightType::ATTACK);
-	decltype(units) tmpUnits = units;
+	std::vector<CCircuitUnit*> tmpUnits(units.begin(), units.end());
 	for (CCircuitUnit* ass : tmpUnits) {
 		manager->AssignTask(ass, task);
 	}
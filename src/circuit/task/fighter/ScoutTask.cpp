@@ -106,8 +106,8 @@ void CScoutTask::Execute(CCircuitUnit* unit, bool isUpdating)
 		position = target->GetPos();
 		if (target->GetUnit()->IsCloaked()) {
 			TRY_UNIT(circuit, unit,
-				unit->GetUnit()->ExecuteCustomCommand(CMD_ATTACK_GROUND, {position.x, position.y, position.z},
-													  UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
+				unit->CmdCustom(CMD_ATTACK_GROUND, {position.x, position.y, position.z},
+								UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
 			)
 		} else {
 			unit->Attack(target, frame + FRAMES_PER_SEC * 60);
@@ -152,7 +152,7 @@ void CScoutTask::Execute(CCircuitUnit* unit, bool isUpdating)
 	}
 
 	TRY_UNIT(circuit, unit,
-		unit->GetUnit()->MoveTo(position, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
+		unit->CmdMoveTo(position, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
 	)
 	travelAction->SetActive(false);
 }
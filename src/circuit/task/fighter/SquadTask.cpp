@@ -78,7 +78,7 @@ void ISquadTask::RemoveAssignee(CCircuitUnit* unit)
 
 void ISquadTask::Merge(ISquadTask* task)
 {
-	const std::set<CCircuitUnit*>& rookies = task->GetAssignees();
+	const CSlotSet<CCircuitUnit>& rookies = task->GetAssignees();
 	bool isActive = static_cast<ITravelAction*>(leader->End())->IsActive();
 	for (CCircuitUnit* unit : rookies) {
 		unit->SetTask(this);
@@ -223,8 +223,8 @@ bool ISquadTask::IsMustRegroup()
 				((unit->GetTaskFrame() < groupFrame) || !terrainManager->CanMoveToPos(unit->GetArea(), pos)))
 			{
 				TRY_UNIT(circuit, unit,
-					unit->GetUnit()->Stop();
-					unit->GetUnit()->SetMoveState(2);
+					unit->CmdStop();
+					unit->CmdMoveState(2);
 				)
 				circuit->Garbage(unit, "stuck");
 			}
@@ -249,8 +249,8 @@ bool ISquadTask::IsMustRegroup()
 	if (!wasRegroup && (State::REGROUP == state)) {
 		if (utils::is_equal_pos(prevGroupPos, groupPos)) {
 			TRY_UNIT(circuit, leader,
-				leader->GetUnit()->Stop();
-				leader->GetUnit()->SetMoveState(2);
+				leader->CmdStop();
+				leader->CmdMoveState(2);
 			)
 			circuit->Garbage(leader, "stuck");
 		}
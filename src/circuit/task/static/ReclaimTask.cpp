@@ -40,23 +40,23 @@ void CSReclaimTask::Update()
 		// Check for damaged units
 		CBuilderManager* builderManager = circuit->GetBuilderManager();
 		CAllyUnit* repairTarget = nullptr;
-		circuit->UpdateFriendlyUnits();
-		auto us = std::move(circuit->GetCallback()->GetFriendlyUnitsIn(position, radius * 0.9f));
-		for (Unit* u : us) {
-			CAllyUnit* candUnit = circuit->GetFriendlyUnit(u);
-			if ((candUnit == nullptr) || builderManager->IsReclaimed(candUnit)) {
+		const int frame = circuit->GetLastFrame();
+		static std::vector<CAllyUnit*> us;  // NOTE: micro-opt
+		us.clear();
+		circuit->GetFriendlyUnitsIn(position, radius * 0.9f, us);
+		for (CAllyUnit* candUnit : us) {
+			if (builderManager->IsReclaimed(candUnit)) {
 				continue;
 			}
-			if (!u->IsBeingBuilt() && (u->GetHealth() < u->GetMaxHealth())) {
+			if (!candUnit->IsBeingBuilt(frame) && (candUnit->GetHealth(frame) < candUnit->GetMaxHealth(frame))) {
 				repairTarget = candUnit;
 				break;
 			}
 		}
-		utils::free_clear(us);
 		if (repairTarget != nullptr) {
 			// Repair task
 			IBuilderTask* task = circuit->GetFactoryManager()->EnqueueRepair(IBuilderTask::Priority::NORMAL, repairTarget);
-			decltype(units) tmpUnits = units;
+			std::vector<CCircuitUnit*> tmpUnits(units.begin(), units.end());
 			for (CCircuitUnit* unit : tmpUnits) {
 				manager->AssignTask(unit, task);
 			}
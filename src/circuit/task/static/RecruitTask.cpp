@@ -47,7 +47,7 @@ void CRecruitTask::Execute(CCircuitUnit* unit)
 {
 	CCircuitAI* circuit = manager->GetCircuit();
 	TRY_UNIT(circuit, unit,
-		unit->GetUnit()->ExecuteCustomCommand(CMD_PRIORITY, {ClampPriority()});
+		unit->CmdPriority(ClampPriority());
 	)
 	const int frame = circuit->GetLastFrame();
 
@@ -79,7 +79,7 @@ void CRecruitTask::Execute(CCircuitUnit* unit)
 
 	if (utils::is_valid(buildPos)) {
 		TRY_UNIT(circuit, unit,
-			unit->GetUnit()->Build(buildDef->GetUnitDef(), buildPos, UNIT_COMMAND_BUILD_NO_FACING, 0, frame + FRAMES_PER_SEC * 10);
+			unit->CmdBuild(buildDef, buildPos, UNIT_COMMAND_BUILD_NO_FACING, 0, frame + FRAMES_PER_SEC * 10);
 		)
 	} else {
 		manager->AbortTask(this);
@@ -100,7 +100,7 @@ void CRecruitTask::Update()
 			state = State::ROAM;  // Not wait
 			for (CCircuitUnit* unit : units) {
 				TRY_UNIT(circuit, unit,
-					unit->GetUnit()->ExecuteCustomCommand(CMD_PRIORITY, {ClampPriority()});
+					unit->CmdPriority(ClampPriority());
 				)
 			}
 		}
@@ -109,7 +109,7 @@ void CRecruitTask::Update()
 			state = State::DISENGAGE;  // Wait
 			for (CCircuitUnit* unit : units) {
 				TRY_UNIT(circuit, unit,
-					unit->GetUnit()->ExecuteCustomCommand(CMD_PRIORITY, {0});
+					unit->CmdPriority(0);
 				)
 			}
 		}
@@ -124,7 +124,7 @@ void CRecruitTask::Finish()
 	const int buildDelay = circuit->GetEconomyManager()->GetBuildDelay();
 	if (buildDelay > 0) {
 		IUnitTask* task = circuit->GetFactoryManager()->EnqueueWait(false, buildDelay);
-		decltype(units) tmpUnits = units;
+		std::vector<CCircuitUnit*> tmpUnits(units.begin(), units.end());
 		for (CCircuitUnit* unit : tmpUnits) {
 			manager->AssignTask(unit, task);
 		}
@@ -147,7 +147,7 @@ void CRecruitTask::Cancel()
 			delete cmd;
 		}
 		TRY_UNIT(circuit, unit,
-			unit->GetUnit()->ExecuteCustomCommand(CMD_REMOVE, params, UNIT_COMMAND_OPTION_ALT_KEY | UNIT_COMMAND_OPTION_CONTROL_KEY);
+			unit->CmdCustom(CMD_REMOVE, params, UNIT_COMMAND_OPTION_ALT_KEY | UNIT_COMMAND_OPTION_CONTROL_KEY);
 		)
 	}
 }
@@ -10,12 +10,12 @@
 #include "module/BuilderManager.h"
 #include "module/EconomyManager.h"
 #include "module/FactoryManager.h"
+#include "resource/FeatureData.h"
 #include "CircuitAI.h"
 #include "util/utils.h"
 
 #include "OOAICallback.h"
 #include "AISCommands.h"
-#include "Feature.h"
 
 namespace circuit {
 
@@ -43,31 +43,29 @@ void CSRepairTask::Update()
 			manager->AbortTask(this);
 			return;
 		}
+		const int frame = circuit->GetLastFrame();
 		IBuilderTask* task = nullptr;
-		if (repTarget->GetUnit()->IsBeingBuilt()) {
+		if (repTarget->IsBeingBuilt(frame)) {
 			CFactoryManager* factoryManager = circuit->GetFactoryManager();
 			if (economyManager->IsMetalEmpty() && !factoryManager->IsHighPriority(repTarget)) {
 				// Check for damaged units
 				CBuilderManager* builderManager = circuit->GetBuilderManager();
-				circuit->UpdateFriendlyUnits();
 				float radius = (*units.begin())->GetCircuitDef()->GetBuildDistance();
-				auto us = std::move(circuit->GetCallback()->GetFriendlyUnitsIn(position, radius * 0.9f));
-				for (Unit* u : us) {
-					CAllyUnit* candUnit = circuit->GetFriendlyUnit(u);
-					if ((candUnit == nullptr) || builderManager->IsReclaimed(candUnit)) {
+				static std::vector<CAllyUnit*> us;  // NOTE: micro-opt
+				us.clear();
+				circuit->GetFriendlyUnitsIn(position, radius * 0.9f, us);
+				for (CAllyUnit* candUnit : us) {
+					if (builderManager->IsReclaimed(candUnit)) {
 						continue;
 					}
-					if (!u->IsBeingBuilt() && (u->GetHealth() < u->GetMaxHealth())) {
+					if (!candUnit->IsBeingBuilt(frame) && (candUnit->GetHealth(frame) < candUnit->GetMaxHealth(frame))) {
 						task = factoryManager->EnqueueRepair(IBuilderTask::Priority::NORMAL, candUnit);
 						break;
 					}
 				}
-				utils::free_clear(us);
 				if (task == nullptr) {
 					// Reclaim task
-					auto features = std::move(circuit->GetCallback()->GetFeaturesIn(position, radius));
-					if (!features.empty()) {
-						utils::free_clear(features);
+					if (circuit->GetAllyTeam()->GetFeatureData()->HasFeaturesIn(position, radius)) {
 						task = factoryManager->EnqueueReclaim(IBuilderTask::Priority::NORMAL, position, radius);
 					}
 				}
@@ -77,25 +75,24 @@ void CSRepairTask::Update()
 			CFactoryManager* factoryManager = circuit->GetFactoryManager();
 			CBuilderManager* builderManager = circuit->GetBuilderManager();
 			float maxCost = MAX_BUILD_SEC * economyManager->GetAvgMetalIncome() * economyManager->GetEcoFactor();
-			circuit->UpdateFriendlyUnits();
 			float radius = (*units.begin())->GetCircuitDef()->GetBuildDistance();
-			auto us = std::move(circuit->GetCallback()->GetFriendlyUnitsIn(position, radius * 0.9f));
-			for (Unit* u : us) {
-				CAllyUnit* candUnit = circuit->GetFriendlyUnit(u);
-				if ((candUnit == nullptr) || builderManager->IsReclaimed(candUnit)) {
+			static std::vector<CAllyUnit*> us;  // NOTE: micro-opt
+			us.clear();
+			circuit->GetFriendlyUnitsIn(position, radius * 0.9f, us);
+			for (CAllyUnit* candUnit : us) {
+				if (builderManager->IsReclaimed(candUnit)) {
 					continue;
 				}
 				bool isHighPrio = factoryManager->IsHighPriority(candUnit);
-				if (u->IsBeingBuilt() && ((candUnit->GetCircuitDef()->GetBuildTime() < maxCost) || isHighPrio)) {
+				if (candUnit->IsBeingBuilt(frame) && ((candUnit->GetCircuitDef()->GetBuildTime() < maxCost) || isHighPrio)) {
 					IBuilderTask::Priority priority = isHighPrio ? IBuilderTask::Priority::HIGH : IBuilderTask::Priority::NORMAL;
 					task = factoryManager->EnqueueRepair(priority, candUnit);
 					break;
 				}
 			}
-			utils::free_clear(us);
 		}
 		if (task != nullptr) {
-			decltype(units) tmpUnits = units;
+			std::vector<CCircuitUnit*> tmpUnits(units.begin(), units.end());
 			for (CCircuitUnit* unit : tmpUnits) {
 				manager->AssignTask(unit, task);
 			}
@@ -108,10 +105,9 @@ void CSRepairTask::Finish()
 {
 	CCircuitAI* circuit = manager->GetCircuit();
 	for (CCircuitUnit* unit : units) {
-		Unit* u = unit->GetUnit();
 		TRY_UNIT(circuit, unit,
-			u->ExecuteCustomCommand(CMD_PRIORITY, {0});
-			u->PatrolTo(position, UNIT_COMMAND_OPTION_SHIFT_KEY);
+			unit->CmdPriority(0);
+			unit->CmdPatrolTo(position, UNIT_COMMAND_OPTION_SHIFT_KEY, INT_MAX);
 		)
 	}
 
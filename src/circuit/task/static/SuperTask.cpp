@@ -64,7 +64,7 @@ void CSuperTask::Update()
 		if (targetFrame + (cdef->GetReloadTime() + TARGET_DELAY) > frame) {
 			if ((State::ENGAGE == state) && (targetFrame + TARGET_DELAY <= frame)) {
 				TRY_UNIT(circuit, unit,
-					unit->GetUnit()->Stop();
+					unit->CmdStop();
 				)
 				state = State::ROAM;
 			}
@@ -129,7 +129,7 @@ void CSuperTask::Update()
 	const float maxCost = cdef->IsAttrStock() ? cdef->GetStockCost() : cdef->GetCost() * 0.01f;
 	if ((groupIdx < 0) || (cost < maxCost)) {
 		TRY_UNIT(circuit, unit,
-			unit->GetUnit()->Stop();
+			unit->CmdStop();
 		)
 		SetTarget(nullptr);
 		targetFrame = frame;
@@ -174,10 +174,10 @@ void CSuperTask::Update()
 
 		TRY_UNIT(circuit, unit,
 			if (target->IsInRadarOrLOS() && !circuit->IsCheating()) {
-				unit->GetUnit()->Attack(target->GetUnit(), UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
+				unit->CmdAttack(target, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
 			} else {
-				unit->GetUnit()->ExecuteCustomCommand(CMD_ATTACK_GROUND, {targetPos.x, targetPos.y, targetPos.z},
-													  UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
+				unit->CmdCustom(CMD_ATTACK_GROUND, {targetPos.x, targetPos.y, targetPos.z},
+								UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
 			}
 		)
 		targetFrame = frame;
@@ -104,4 +104,44 @@ const int2& IBlockMask::GetStructOffset(int facing)
 	}
 }
 
+const SBlockingMap::SMaskBits& IBlockMask::GetMaskBits(int facing)
+{
+	if ((facing < 0) || (facing > 3)) {
+		facing = UNIT_FACING_SOUTH;
+	}
+	SBlockingMap::SMaskBits& bits = maskBits[facing];
+	if (!bits.blocked.empty()) {
+		return bits;
+	}
+
+	const bool isRotated = (facing == UNIT_FACING_EAST) || (facing == UNIT_FACING_WEST);
+	const int xmsize = isRotated ? zsize : xsize;
+	const int zmsize = isRotated ? xsize : zsize;
+	bits.words = (xmsize + SBlockingMap::BITS_WIDTH - 1) / SBlockingMap::BITS_WIDTH;
+	bits.blocked.assign(zmsize * bits.words, 0);
+	bits.structs.assign(zmsize * bits.words, 0);
+
+	for (int zm = 0; zm < zmsize; ++zm) {
+		for (int xm = 0; xm < xmsize; ++xm) {
+			BlockType type;
+			switch (facing) {
+				default:
+				case UNIT_FACING_SOUTH: { type = GetTypeSouth(xm, zm); } break;
+				case UNIT_FACING_EAST:  { type = GetTypeEast(xm, zm);  } break;
+				case UNIT_FACING_NORTH: { type = GetTypeNorth(xm, zm); } break;
+				case UNIT_FACING_WEST:  { type = GetTypeWest(xm, zm);  } break;
+			}
+			const int index = zm * bits.words + xm / SBlockingMap::BITS_WIDTH;
+			const SBlockingMap::Bits bit = SBlockingMap::Bits(1) << (xm % SBlockingMap::BITS_WIDTH);
+			if (type == BlockType::BLOCKED) {
+				bits.blocked[index] |= bit;
+			} else if (type == BlockType::STRUCT) {
+				bits.structs[index] |= bit;
+			}
+		}
+	}
+
+	return bits;
+}
+
 } // namespace circuit
@@ -25,6 +25,7 @@ public:
 	int GetXSize();
 	int GetZSize();
 	const int2& GetStructOffset(int facing);
+	const SBlockingMap::SMaskBits& GetMaskBits(int facing);
 
 	inline BlockType GetTypeSouth(int x, int z);
 	inline BlockType GetTypeEast(int x, int z);
@@ -50,6 +51,7 @@ protected:
 	int2 offsetEast;
 	int2 offsetNorth;
 	int2 offsetWest;
+	SBlockingMap::SMaskBits maskBits[4];  // South, East, North, West; lazy
 	SBlockingMap::StructType structType;
 	int ignoreMask;
 };
@@ -41,4 +41,14 @@ SBlockingMap::StructMasks SBlockingMap::structMasks = {
 	{"all",       SBlockingMap::StructMask::ALL},
 };
 
+void SBlockingMap::InitPlanes()
+{
+	wordsPerRow = (columns + BITS_WIDTH - 1) / BITS_WIDTH;
+	planeSize = wordsPerRow * rows;
+	const int planesNum = static_cast<ST>(StructType::_SIZE_);
+	blockerPlanes.assign(planesNum * planeSize, 0);
+	notIgnorePlanes.assign(planesNum * planeSize, 0);
+	structPlane.assign(planeSize, 0);
+}
+
 } // namespace circuit
@@ -13,6 +13,8 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <cstdint>
+#include <algorithm>
 
 #define GRID_RATIO_LOW		8
 #define STRUCT_BIT(bits)	static_cast<SBlockingMap::SM>(SBlockingMap::StructMask::bits)
@@ -33,6 +35,14 @@ struct SBlockingMap {
 	using SM = std::underlying_type<StructMask>::type;
 	using StructTypes = std::map<std::string, StructType>;
 	using StructMasks = std::map<std::string, StructMask>;
+	using Bits = uint64_t;  // bit per cell
+	static constexpr int BITS_WIDTH = 64;
+
+	struct SMaskBits {  // bit rows of IBlockMask for single facing
+		std::vector<Bits> blocked;
+		std::vector<Bits> structs;
+		int words;
+	};
 
 	static inline StructTypes& GetStructTypes() { return structTypes; }
 	static inline StructMasks& GetStructMasks() { return structMasks; }
@@ -40,6 +50,10 @@ struct SBlockingMap {
 	inline bool IsStruct(int x, int z, StructMask structMask) const;
 	inline bool IsBlocked(int x, int z, SM notIgnoreMask) const;
 	inline bool IsBlockedLow(int xLow, int zLow, SM notIgnoreMask) const;
+	inline bool IsEmptyLow(const int2& r1, const int2& r2) const;
+	inline bool IsBlockedArea(const int2& r1, const int2& r2, SM notIgnoreMask) const;
+	inline bool IsOpenMask(const int2& m1, const int2& m2, const int2& om, const SMaskBits& maskBits,
+						   SM notIgnoreMask, StructMask structMask) const;
 	inline void MarkBlocker(int x, int z, StructType structType, SM notIgnoreMask);
 	inline void AddBlocker(int x, int z, StructType structType);
 	inline void DelBlocker(int x, int z, StructType structType);
@@ -51,6 +65,12 @@ struct SBlockingMap {
 	inline void Bound(int2& r1, int2& r2);
 
 	static inline StructMask GetStructMask(StructType structType);
+	static inline Bits GetRowBits(const Bits* row, int x, int count);
+
+	void InitPlanes();
+	inline Bits GetBlockedBits(int x, int z, int count, SM notIgnoreMask) const;
+	inline Bits GetStructBits(int x, int z, int count, SM structMask) const;
+	inline void UpdateBits(int x, int z);
 
 	static StructTypes structTypes;
 	static StructMasks structMasks;
@@ -65,8 +85,19 @@ struct SBlockingMap {
 	int columns;
 	int rows;
 
+	/*
+	 * Bit planes mirror grid for word-wide area tests, kept in sync by UpdateBits.
+	 * Layout: [type][row][word]
+	 */
+	std::vector<Bits> blockerPlanes;  // SBlockCell::blockerMask
+	std::vector<Bits> notIgnorePlanes;  // SBlockCell::notIgnoreMask
+	std::vector<Bits> structPlane;  // SBlockCell::structMask != NONE
+	int wordsPerRow;
+	int planeSize;
+
 	struct SBlockCellLow {
 		SM blockerMask;
+		unsigned short occupied;  // number of cells blocked by anything
 		unsigned short blockerCounts[static_cast<ST>(StructType::_SIZE_)];
 	};
 	// TODO: Replace with QuadTree
@@ -32,6 +32,58 @@ inline bool SBlockingMap::IsBlockedLow(int xLow, int zLow, SM notIgnoreMask) con
 	return (gridLow[zLow * columnsLow + xLow].blockerMask & notIgnoreMask);
 }
 
+inline bool SBlockingMap::IsEmptyLow(const int2& r1, const int2& r2) const
+{
+	// [r1, r2)
+	for (int zLow = r1.y / GRID_RATIO_LOW; zLow <= (r2.y - 1) / GRID_RATIO_LOW; ++zLow) {
+		for (int xLow = r1.x / GRID_RATIO_LOW; xLow <= (r2.x - 1) / GRID_RATIO_LOW; ++xLow) {
+			if (gridLow[zLow * columnsLow + xLow].occupied != 0) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+inline bool SBlockingMap::IsBlockedArea(const int2& r1, const int2& r2, SM notIgnoreMask) const
+{
+	// [r1, r2)
+	if (IsEmptyLow(r1, r2)) {
+		return false;
+	}
+	for (int z = r1.y; z < r2.y; ++z) {
+		for (int x = r1.x; x < r2.x; x += BITS_WIDTH) {
+			if (GetBlockedBits(x, z, std::min(r2.x - x, BITS_WIDTH), notIgnoreMask) != 0) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+inline bool SBlockingMap::IsOpenMask(const int2& m1, const int2& m2, const int2& om, const SMaskBits& maskBits,
+									 SM notIgnoreMask, StructMask structMask) const
+{
+	// [m1, m2), om - offset within mask
+	if (IsEmptyLow(m1, m2)) {
+		return true;
+	}
+	const SM structBits = static_cast<SM>(structMask);
+	for (int z = m1.y, zm = om.y; z < m2.y; z++, zm++) {
+		const Bits* blockedRow = &maskBits.blocked[zm * maskBits.words];
+		const Bits* structRow = &maskBits.structs[zm * maskBits.words];
+		for (int x = m1.x, xm = om.x; x < m2.x; x += BITS_WIDTH, xm += BITS_WIDTH) {
+			const int count = std::min(m2.x - x, BITS_WIDTH);
+			if ((GetStructBits(x, z, count, structBits) & GetRowBits(blockedRow, xm, count))
+				|| (GetBlockedBits(x, z, count, notIgnoreMask) & GetRowBits(structRow, xm, count)))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
 inline void SBlockingMap::MarkBlocker(int x, int z, StructType structType, SM notIgnoreMask)
 {
 	SBlockCell& cell = grid[z * columns + x];
@@ -45,6 +97,7 @@ inline void SBlockingMap::MarkBlocker(int x, int z, StructType structType, SM no
 	if (cellLow.blockerCounts[static_cast<ST>(structType)]++ == BLOCK_THRESHOLD) {
 		cellLow.blockerMask |= structMask;
 	}
+	UpdateBits(x, z);
 }
 
 inline void SBlockingMap::AddBlocker(int x, int z, StructType structType)
@@ -58,6 +111,7 @@ inline void SBlockingMap::AddBlocker(int x, int z, StructType structType)
 		if (++cellLow.blockerCounts[static_cast<ST>(structType)] == BLOCK_THRESHOLD) {
 			cellLow.blockerMask |= structMask;
 		}
+		UpdateBits(x, z);
 	}
 }
 
@@ -72,6 +126,7 @@ inline void SBlockingMap::DelBlocker(int x, int z, StructType structType)
 		if (cellLow.blockerCounts[static_cast<ST>(structType)]-- == BLOCK_THRESHOLD) {
 			cellLow.blockerMask &= notStructMask;
 		}
+		UpdateBits(x, z);
 	}
 }
 
@@ -86,6 +141,7 @@ inline void SBlockingMap::AddStruct(int x, int z, StructType structType, SM notI
 	}
 	cell.notIgnoreMask = notIgnoreMask;
 	cell.structMask = GetStructMask(structType);
+	UpdateBits(x, z);
 }
 
 inline void SBlockingMap::DelStruct(int x, int z, StructType structType, SM notIgnoreMask)
@@ -99,6 +155,7 @@ inline void SBlockingMap::DelStruct(int x, int z, StructType structType, SM notI
 			cellLow.blockerMask &= ~static_cast<SM>(GetStructMask(structType));
 		}
 	}
+	UpdateBits(x, z);
 }
 
 inline bool SBlockingMap::IsInBounds(const int2& r1, const int2& r2) const
@@ -122,4 +179,68 @@ inline SBlockingMap::StructMask SBlockingMap::GetStructMask(StructType structTyp
 	return static_cast<StructMask>(1 << static_cast<ST>(structType));
 }
 
+inline SBlockingMap::Bits SBlockingMap::GetRowBits(const Bits* row, int x, int count)
+{
+	// count <= BITS_WIDTH, row must hold x + count bits
+	const int word = x / BITS_WIDTH;
+	const int shift = x % BITS_WIDTH;
+	Bits bits = row[word] >> shift;
+	if ((shift != 0) && (shift + count > BITS_WIDTH)) {
+		bits |= row[word + 1] << (BITS_WIDTH - shift);
+	}
+	return (count < BITS_WIDTH) ? (bits & ((Bits(1) << count) - 1)) : bits;
+}
+
+inline SBlockingMap::Bits SBlockingMap::GetBlockedBits(int x, int z, int count, SM notIgnoreMask) const
+{
+	// @see IsBlocked
+	const int rowOffset = z * wordsPerRow;
+	Bits bits = GetRowBits(&structPlane[rowOffset], x, count);
+	for (ST type = 0; type < static_cast<ST>(StructType::_SIZE_); ++type) {
+		if (notIgnoreMask & (1 << type)) {
+			bits |= GetRowBits(&blockerPlanes[type * planeSize + rowOffset], x, count);
+		}
+	}
+	return bits;
+}
+
+inline SBlockingMap::Bits SBlockingMap::GetStructBits(int x, int z, int count, SM structMask) const
+{
+	// @see IsStruct
+	const int rowOffset = z * wordsPerRow;
+	Bits bits = 0;
+	for (ST type = 0; type < static_cast<ST>(StructType::_SIZE_); ++type) {
+		if (structMask & (1 << type)) {
+			bits |= GetRowBits(&notIgnorePlanes[type * planeSize + rowOffset], x, count);
+		}
+	}
+	return bits;
+}
+
+inline void SBlockingMap::UpdateBits(int x, int z)
+{
+	const SBlockCell& cell = grid[z * columns + x];
+	const int index = z * wordsPerRow + x / BITS_WIDTH;
+	const Bits bit = Bits(1) << (x % BITS_WIDTH);
+	auto setBit = [bit](Bits& word, bool value) {
+		word = value ? (word | bit) : (word & ~bit);
+	};
+
+	bool wasOccupied = structPlane[index] & bit;
+	for (ST type = 0; type < static_cast<ST>(StructType::_SIZE_); ++type) {
+		Bits& blockerWord = blockerPlanes[type * planeSize + index];
+		wasOccupied |= (blockerWord & bit) != 0;
+		setBit(blockerWord, cell.blockerMask & (1 << type));
+		setBit(notIgnorePlanes[type * planeSize + index], cell.notIgnoreMask & (1 << type));
+	}
+	const bool isOccupied = (cell.structMask != StructMask::NONE)
+			|| (cell.blockerMask & ((1 << static_cast<ST>(StructType::_SIZE_)) - 1));
+	setBit(structPlane[index], cell.structMask != StructMask::NONE);
+
+	if (wasOccupied != isOccupied) {
+		SBlockCellLow& cellLow = gridLow[z / GRID_RATIO_LOW * columnsLow + x / GRID_RATIO_LOW];
+		cellLow.occupied += isOccupied ? 1 : -1;
+	}
+}
+
 } // namespace circuit
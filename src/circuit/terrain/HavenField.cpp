@@ -0,0 +1,197 @@
+/*
+ * HavenField.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#include "terrain/HavenField.h"
+#include "terrain/TerrainManager.h"
+#include "util/utils.h"
+
+namespace circuit {
+
+using namespace springai;
+
+static const int dx[] = {-1, 0, 1, -1, 1, -1, 0, 1};
+static const int dz[] = {-1, -1, -1, 0, 0, 1, 1, 1};
+
+void CHavenField::SeedSector(const STerrainMapMobileType* mobileType, SField& field, int iS, int havenIdx, SQueue& queue)
+{
+	if ((mobileType->sector[iS].area == nullptr) || (field.dist[iS] <= .0f)) {
+		return;
+	}
+	field.dist[iS] = .0f;
+	field.source[iS] = havenIdx;
+	queue.push(std::make_pair(.0f, iS));
+}
+
+void CHavenField::Propagate(const STerrainMapMobileType* mobileType, SField& field, SQueue& queue,
+		int sizeX, int sizeZ, float step)
+{
+	static const float dc[] = {1.4142f, 1.f, 1.4142f, 1.f, 1.f, 1.4142f, 1.f, 1.4142f};
+	std::vector<float>& dist = field.dist;
+	std::vector<int>& source = field.source;
+
+	while (!queue.empty()) {
+		const float d = queue.top().first;
+		const int i = queue.top().second;
+		queue.pop();
+		if (d > dist[i]) {
+			continue;
+		}
+		const int x = i % sizeX;
+		const int z = i / sizeX;
+		for (int k = 0; k < 8; ++k) {
+			const int nx = x + dx[k];
+			const int nz = z + dz[k];
+			if ((nx < 0) || (nx >= sizeX) || (nz < 0) || (nz >= sizeZ)) {
+				continue;
+			}
+			const int ni = nz * sizeX + nx;
+			if (mobileType->sector[ni].area == nullptr) {
+				continue;
+			}
+			const float nd = d + dc[k] * step;
+			if (nd < dist[ni]) {
+				dist[ni] = nd;
+				source[ni] = source[i];
+				queue.push(std::make_pair(nd, ni));
+			}
+		}
+	}
+}
+
+int CHavenField::Descend(const SField& field, int iS, int sizeX, int sizeZ)
+{
+	const int x = iS % sizeX;
+	const int z = iS / sizeX;
+	int next = iS;
+	for (int k = 0; k < 8; ++k) {
+		const int nx = x + dx[k];
+		const int nz = z + dz[k];
+		if ((nx < 0) || (nx >= sizeX) || (nz < 0) || (nz >= sizeZ)) {
+			continue;
+		}
+		const int ni = nz * sizeX + nx;
+		if (field.dist[ni] < field.dist[next]) {
+			next = ni;
+		}
+	}
+	return next;
+}
+
+CHavenField::CHavenField(CTerrainManager* terrainManager, const F3Vec& havens)
+		: terrainManager(terrainManager)
+		, havens(havens)
+		, areaData(nullptr)
+{
+}
+
+CHavenField::~CHavenField()
+{
+	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
+}
+
+void CHavenField::AddHaven()
+{
+	if (areaData != terrainManager->GetAreaData()) {
+		return;
+	}
+	const std::vector<STerrainMapMobileType>& mobileTypes = terrainManager->GetMobileTypes();
+	for (unsigned i = 0; i < fields.size(); ++i) {
+		if (fields[i].isValid) {
+			Relax(const_cast<STerrainMapMobileType*>(&mobileTypes[i]), fields[i], havens.size() - 1);
+		}
+	}
+}
+
+void CHavenField::DelHaven()
+{
+	for (SField& field : fields) {
+		field.isValid = false;
+	}
+}
+
+int CHavenField::GetClosest(STerrainMapArea* area, const AIFloat3& position)
+{
+	if ((area == nullptr) || havens.empty()) {
+		return -1;
+	}
+	SField* field = GetField(area->mobileType);
+	const int iS = terrainManager->GetSectorIndex(position);
+	return (field->dist[iS] < std::numeric_limits<float>::max()) ? field->source[iS] : -1;
+}
+
+bool CHavenField::GetPath(STerrainMapArea* area, const AIFloat3& position, float range, F3Vec& path)
+{
+	if ((area == nullptr) || havens.empty()) {
+		return false;
+	}
+	STerrainMapMobileType* mobileType = area->mobileType;
+	SField* field = GetField(mobileType);
+	int iS = terrainManager->GetSectorIndex(position);
+	if (field->dist[iS] == std::numeric_limits<float>::max()) {
+		return false;
+	}
+
+	const int sizeX = terrainManager->GetSectorXSize();
+	const int sizeZ = terrainManager->GetSectorZSize();
+	const int havenIdx = field->source[iS];
+	while (field->dist[iS] > range) {
+		const int next = Descend(*field, iS, sizeX, sizeZ);
+		if (next == iS) {  // reached source
+			break;
+		}
+		iS = next;
+		path.push_back(mobileType->sector[iS].S->position);
+	}
+	if (path.empty()) {
+		path.push_back(havens[havenIdx]);
+	}
+	return true;
+}
+
+CHavenField::SField* CHavenField::GetField(STerrainMapMobileType* mobileType)
+{
+	if (areaData != terrainManager->GetAreaData()) {
+		areaData = terrainManager->GetAreaData();
+		fields.clear();
+		fields.resize(terrainManager->GetMobileTypes().size());
+	}
+	SField& field = fields[mobileType - &terrainManager->GetMobileTypes().front()];
+	if (!field.isValid) {
+		Build(mobileType, field);
+	}
+	return &field;
+}
+
+void CHavenField::Build(STerrainMapMobileType* mobileType, SField& field)
+{
+	const int size = terrainManager->GetSectorXSize() * terrainManager->GetSectorZSize();
+	field.dist.assign(size, std::numeric_limits<float>::max());
+	field.source.assign(size, -1);
+	field.isValid = true;
+
+	SQueue queue;
+	for (unsigned i = 0; i < havens.size(); ++i) {
+		Seed(mobileType, field, i, queue);
+	}
+	Propagate(mobileType, field, queue,
+			terrainManager->GetSectorXSize(), terrainManager->GetSectorZSize(), terrainManager->GetConvertStoP());
+}
+
+void CHavenField::Relax(STerrainMapMobileType* mobileType, SField& field, int havenIdx)
+{
+	SQueue queue;
+	Seed(mobileType, field, havenIdx, queue);
+	Propagate(mobileType, field, queue,
+			terrainManager->GetSectorXSize(), terrainManager->GetSectorZSize(), terrainManager->GetConvertStoP());
+}
+
+void CHavenField::Seed(STerrainMapMobileType* mobileType, SField& field, int havenIdx, SQueue& queue)
+{
+	SeedSector(mobileType, field, terrainManager->GetSectorIndex(havens[havenIdx]), havenIdx, queue);
+}
+
+} // namespace circuit
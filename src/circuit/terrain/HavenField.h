@@ -0,0 +1,66 @@
+/*
+ * HavenField.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#ifndef SRC_CIRCUIT_TERRAIN_HAVENFIELD_H_
+#define SRC_CIRCUIT_TERRAIN_HAVENFIELD_H_
+
+#include "util/Defines.h"
+
+#include <queue>
+#include <vector>
+
+namespace circuit {
+
+class CTerrainManager;
+struct STerrainMapArea;
+struct STerrainMapMobileType;
+struct SAreaData;
+
+/*
+ * Per mobile type distance field over sector grid with all havens as sources (multi-source Dijkstra).
+ * New haven relaxes built fields in place, removed haven or area update rebuilds field on next query.
+ */
+class CHavenField {
+public:
+	using SQueue = std::priority_queue<std::pair<float, int>, std::vector<std::pair<float, int>>, std::greater<std::pair<float, int>>>;
+
+	CHavenField(CTerrainManager* terrainManager, const F3Vec& havens);
+	virtual ~CHavenField();
+
+	void AddHaven();  // last of havens
+	void DelHaven();
+
+	int GetClosest(STerrainMapArea* area, const springai::AIFloat3& position);  // index of haven or -1
+	bool GetPath(STerrainMapArea* area, const springai::AIFloat3& position, float range, F3Vec& path);
+
+	struct SField {
+		SField() : isValid(false) {}
+		std::vector<float> dist;
+		std::vector<int> source;  // index of haven
+		bool isValid;
+	};
+	// Sector grid of mobile type, independent of CTerrainManager
+	static void SeedSector(const STerrainMapMobileType* mobileType, SField& field, int iS, int havenIdx, SQueue& queue);
+	static void Propagate(const STerrainMapMobileType* mobileType, SField& field, SQueue& queue,
+			int sizeX, int sizeZ, float step);
+	static int Descend(const SField& field, int iS, int sizeX, int sizeZ);  // closer neighbour, iS at source
+
+private:
+	SField* GetField(STerrainMapMobileType* mobileType);
+	void Build(STerrainMapMobileType* mobileType, SField& field);
+	void Relax(STerrainMapMobileType* mobileType, SField& field, int havenIdx);
+	void Seed(STerrainMapMobileType* mobileType, SField& field, int havenIdx, SQueue& queue);
+
+	CTerrainManager* terrainManager;
+	const F3Vec& havens;
+	SAreaData* areaData;  // fields were built for
+	std::vector<SField> fields;  // index: STerrainMapMobileType::Id
+};
+
+} // namespace circuit
+
+#endif // SRC_CIRCUIT_TERRAIN_HAVENFIELD_H_
@@ -7,6 +7,7 @@
  */
 
 #include "terrain/PathFinder.h"
+#include "terrain/TargetField.h"
 #include "terrain/TerrainData.h"
 #include "terrain/TerrainManager.h"
 #include "terrain/ThreatMap.h"
@@ -21,6 +22,8 @@
 #include "Figure.h"
 #endif
 
+#include <algorithm>
+
 namespace circuit {
 
 using namespace springai;
@@ -32,6 +35,9 @@ CPathFinder::CPathFinder(CTerrainData* terrainData)
 		: terrainData(terrainData)
 		, airMoveArray(nullptr)
 		, isUpdated(true)
+		, curMoveArray(nullptr)
+		, curCostArray(nullptr)
+		, threatEpoch(-1)
 #ifdef DEBUG_VIS
 		, isVis(false)
 		, toggleFrame(-1)
@@ -45,6 +51,7 @@ CPathFinder::CPathFinder(CTerrainData* terrainData)
 	pathMapXSize = terrainData->sectorXSize + 2;  // +2 for passable edges
 	pathMapYSize = terrainData->sectorZSize + 2;  // +2 for passable edges
 	micropather  = new CMicroPather(this, pathMapXSize, pathMapYSize);
+	targetField  = new CTargetField(pathMapXSize, pathMapYSize);
 
 	const std::vector<STerrainMapMobileType>& moveTypes = terrainData->pAreaData.load()->mobileType;
 	moveArrays.reserve(moveTypes.size());
@@ -109,6 +116,7 @@ CPathFinder::~CPathFinder()
 	}
 	delete[] airMoveArray;
 	delete micropather;
+	delete targetField;
 }
 
 void CPathFinder::UpdateAreaUsers(CTerrainManager* terrainManager)
@@ -160,26 +168,27 @@ void CPathFinder::UpdateAreaUsers(CTerrainManager* terrainManager)
 		}
 	}
 	micropather->Reset();
+	targetField->Invalidate();
 }
 
 void CPathFinder::SetMapData(CCircuitUnit* unit, CThreatMap* threatMap, int frame)
 {
 	CCircuitDef* cdef = unit->GetCircuitDef();
 	STerrainMapMobileType::Id mobileTypeId = cdef->GetMobileId();
-	bool* moveArray = (mobileTypeId < 0) ? airMoveArray : moveArrays[mobileTypeId];
-	float* costArray;
+	curMoveArray = (mobileTypeId < 0) ? airMoveArray : moveArrays[mobileTypeId];
 	if ((unit->GetPos(frame).y < .0f) && !cdef->IsSonarStealth()) {
-		costArray = threatMap->GetAmphThreatArray();  // cloak doesn't work under water
+		curCostArray = threatMap->GetAmphThreatArray();  // cloak doesn't work under water
 	} else if (unit->GetUnit()->IsCloaked()) {
-		costArray = threatMap->GetCloakThreatArray();
+		curCostArray = threatMap->GetCloakThreatArray();
 	} else if (cdef->IsAbleToFly()) {
-		costArray = threatMap->GetAirThreatArray();
+		curCostArray = threatMap->GetAirThreatArray();
 	} else if (cdef->IsAmphibious()) {
-		costArray = threatMap->GetAmphThreatArray();
+		curCostArray = threatMap->GetAmphThreatArray();
 	} else {
-		costArray = threatMap->GetSurfThreatArray();
+		curCostArray = threatMap->GetSurfThreatArray();
 	}
-	micropather->SetMapData(moveArray, costArray);
+	threatEpoch = threatMap->GetEpoch();
+	micropather->SetMapData(curMoveArray, curCostArray);
 }
 
 void* CPathFinder::XY2Node(int x, int y)
@@ -349,6 +358,106 @@ float CPathFinder::FindBestPath(F3Vec& posPath, AIFloat3& startPos, float maxRan
 
 	path.clear();
 
+	static std::vector<void*> endNodes;  // NOTE: micro-opt
+	static std::vector<void*> nodeTargets;  // NOTE: micro-opt
+	FillEndNodes(maxRange, possibleTargets, endNodes, nodeTargets);
+
+	CTerrainData::CorrectPosition(startPos);
+
+	int result = safe ? micropather->FindBestPathToAnyGivenPointSafe(Pos2Node(startPos), endNodes, nodeTargets, &path, &pathCost) :
+						micropather->FindBestPathToAnyGivenPoint(Pos2Node(startPos), endNodes, nodeTargets, &path, &pathCost);
+	if (result == CMicroPather::SOLVED) {
+		posPath.reserve(path.size());
+
+		Map* map = terrainData->GetMap();
+		for (void* node : path) {
+			float3 mypos = Node2Pos(node);
+			mypos.y = map->GetElevationAt(mypos.x, mypos.z);
+			posPath.push_back(mypos);
+		}
+	}
+
+#ifdef DEBUG_VIS
+	UpdateVis(posPath);
+#endif
+
+	endNodes.clear();
+	nodeTargets.clear();
+	return pathCost;
+}
+
+float CPathFinder::FindBestPathToRadius(F3Vec& posPath, AIFloat3& startPos, float radiusAroundTarget, const AIFloat3& target)
+{
+	F3Vec posTargets;
+	posTargets.push_back(target);
+	return FindBestPath(posPath, startPos, radiusAroundTarget, posTargets);
+}
+
+float CPathFinder::FindBestPathByField(F3Vec& posPath, AIFloat3& startPos, float maxRange, F3Vec& possibleTargets, bool safe)
+{
+	float pathCost = 0.0f;
+
+	if (maxRange < float(squareSize)) {
+		return pathCost;
+	}
+
+	static std::vector<void*> endNodes;  // NOTE: micro-opt
+	static std::vector<void*> nodeTargets;  // NOTE: micro-opt
+	FillEndNodes(maxRange, possibleTargets, endNodes, nodeTargets);
+
+	// Field key: end nodes moved off the edges as CMicroPather::FixNode does
+	static std::vector<int> sources;  // NOTE: micro-opt
+	sources.reserve(endNodes.size());
+	for (void* node : endNodes) {
+		int x, y;
+		Node2XY(node, &x, &y);
+		sources.push_back(utils::clamp(y, 1, pathMapYSize - 2) * pathMapXSize + utils::clamp(x, 1, pathMapXSize - 2));
+	}
+	std::sort(sources.begin(), sources.end());
+	sources.erase(std::unique(sources.begin(), sources.end()), sources.end());
+
+	CTerrainData::CorrectPosition(startPos);
+	int sx, sy;
+	Pos2XY(startPos, &sx, &sy);
+	const int startNode = utils::clamp(sy, 1, pathMapYSize - 2) * pathMapXSize + utils::clamp(sx, 1, pathMapXSize - 2);
+
+	static std::vector<int> nodePath;  // NOTE: micro-opt
+	const float cost = targetField->FindPath(curMoveArray, curCostArray, threatEpoch, safe, sources, startNode, nodePath);
+	if (cost >= 0.0f) {
+		pathCost = cost;
+		posPath.reserve(nodePath.size());
+
+		Map* map = terrainData->GetMap();
+		for (int node : nodePath) {
+			float3 mypos = Node2Pos(XY2Node(node % pathMapXSize, node / pathMapXSize));
+			mypos.y = map->GetElevationAt(mypos.x, mypos.z);
+			posPath.push_back(mypos);
+		}
+	}
+
+#ifdef DEBUG_VIS
+	UpdateVis(posPath);
+#endif
+
+	endNodes.clear();
+	nodeTargets.clear();
+	sources.clear();
+	nodePath.clear();
+	return pathCost;
+}
+
+unsigned CPathFinder::GetFieldHitNum() const
+{
+	return targetField->GetHitNum();
+}
+
+unsigned CPathFinder::GetFieldMissNum() const
+{
+	return targetField->GetMissNum();
+}
+
+void CPathFinder::FillEndNodes(float maxRange, F3Vec& possibleTargets, std::vector<void*>& endNodes, std::vector<void*>& nodeTargets)
+{
 	const unsigned int radius = maxRange / squareSize;
 	unsigned int offsetSize = 0;
 
@@ -356,7 +465,6 @@ float CPathFinder::FindBestPath(F3Vec& posPath, AIFloat3& startPos, float maxRan
 	std::vector<int> xend;
 
 	// make a list with the points that will count as end nodes
-	static std::vector<void*> endNodes;  // NOTE: micro-opt
 //	endNodes.reserve(possibleTargets.size() * radius * 10);
 
 	{
@@ -422,7 +530,6 @@ float CPathFinder::FindBestPath(F3Vec& posPath, AIFloat3& startPos, float maxRan
 		offsetSize = index;
 	}
 
-	static std::vector<void*> nodeTargets;  // NOTE: micro-opt
 //	nodeTargets.reserve(possibleTargets.size());
 	for (unsigned int i = 0; i < possibleTargets.size(); i++) {
 		AIFloat3& f = possibleTargets[i];
@@ -451,36 +558,6 @@ float CPathFinder::FindBestPath(F3Vec& posPath, AIFloat3& startPos, float maxRan
 	for (void* node : nodeTargets) {
 		micropather->GetNode((size_t)node)->isTarget = 0;
 	}
-
-	CTerrainData::CorrectPosition(startPos);
-
-	int result = safe ? micropather->FindBestPathToAnyGivenPointSafe(Pos2Node(startPos), endNodes, nodeTargets, &path, &pathCost) :
-						micropather->FindBestPathToAnyGivenPoint(Pos2Node(startPos), endNodes, nodeTargets, &path, &pathCost);
-	if (result == CMicroPather::SOLVED) {
-		posPath.reserve(path.size());
-
-		Map* map = terrainData->GetMap();
-		for (void* node : path) {
-			float3 mypos = Node2Pos(node);
-			mypos.y = map->GetElevationAt(mypos.x, mypos.z);
-			posPath.push_back(mypos);
-		}
-	}
-
-#ifdef DEBUG_VIS
-	UpdateVis(posPath);
-#endif
-
-	endNodes.clear();
-	nodeTargets.clear();
-	return pathCost;
-}
-
-float CPathFinder::FindBestPathToRadius(F3Vec& posPath, AIFloat3& startPos, float radiusAroundTarget, const AIFloat3& target)
-{
-	F3Vec posTargets;
-	posTargets.push_back(target);
-	return FindBestPath(posPath, startPos, radiusAroundTarget, posTargets);
 }
 
 #ifdef DEBUG_VIS
@@ -490,9 +567,11 @@ void CPathFinder::SetMapData(CThreatMap* threatMap)
 		return;
 	}
 	STerrainMapMobileType::Id mobileTypeId = dbgDef->GetMobileId();
-	bool* moveArray = (mobileTypeId < 0) ? airMoveArray : moveArrays[mobileTypeId];
-	float* costArray[] = {threatMap->GetAirThreatArray(), threatMap->GetSurfThreatArray(), threatMap->GetAmphThreatArray(), threatMap->GetCloakThreatArray()};
-	micropather->SetMapData(moveArray, costArray[dbgType]);
+	curMoveArray = (mobileTypeId < 0) ? airMoveArray : moveArrays[mobileTypeId];
+	float* costArrays[] = {threatMap->GetAirThreatArray(), threatMap->GetSurfThreatArray(), threatMap->GetAmphThreatArray(), threatMap->GetCloakThreatArray()};
+	curCostArray = costArrays[dbgType];
+	threatEpoch = threatMap->GetEpoch();
+	micropather->SetMapData(curMoveArray, curCostArray);
 }
 
 void CPathFinder::UpdateVis(const F3Vec& path)
@@ -16,6 +16,7 @@ namespace circuit {
 
 class CTerrainData;
 class CTerrainManager;
+class CTargetField;
 class CCircuitUnit;
 class CThreatMap;
 #ifdef DEBUG_VIS
@@ -47,10 +48,17 @@ public:
 	float PathCostDirect(const springai::AIFloat3& startPos, springai::AIFloat3& endPos, int radius);
 	float FindBestPath(F3Vec& posPath, springai::AIFloat3& startPos, float myMaxRange, F3Vec& possibleTargets, bool safe = true);
 	float FindBestPathToRadius(F3Vec& posPath, springai::AIFloat3& startPos, float radiusAroundTarget, const springai::AIFloat3& target);
+	// Same as FindBestPath, but reads path from field shared by queries with the same targets and map data until threat update.
+	// For target sets shared by many units, area of unit is implied by move array; unit-specific sets go to FindBestPath
+	float FindBestPathByField(F3Vec& posPath, springai::AIFloat3& startPos, float myMaxRange, F3Vec& possibleTargets, bool safe = true);
+	unsigned GetFieldHitNum() const;
+	unsigned GetFieldMissNum() const;
 
 	int GetSquareSize() const { return squareSize; }
 
 private:
+	void FillEndNodes(float maxRange, F3Vec& possibleTargets, std::vector<void*>& endNodes, std::vector<void*>& nodeTargets);
+
 	CTerrainData* terrainData;
 
 	NSMicroPather::CMicroPather* micropather;
@@ -59,6 +67,11 @@ private:
 	static std::vector<int> blockArray;
 	bool isUpdated;
 
+	CTargetField* targetField;
+	bool* curMoveArray;  // of last SetMapData
+	float* curCostArray;
+	int threatEpoch;
+
 	int squareSize;
 	int pathMapXSize;
 	int pathMapYSize;
@@ -0,0 +1,190 @@
+/*
+ * TargetField.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#include "terrain/TargetField.h"
+#include "util/utils.h"
+
+#include <limits>
+
+namespace circuit {
+
+#define MAX_FIELDS	8
+
+CTargetField::CTargetField(int sizeX, int sizeY)
+		: sizeX(sizeX)
+		, sizeY(sizeY)
+		, offsets{-1, 1, -sizeX, sizeX, -sizeX - 1, -sizeX + 1, sizeX - 1, sizeX + 1}  // diagonals last
+		, useNum(0)
+		, hitNum(0)
+		, missNum(0)
+{
+}
+
+CTargetField::~CTargetField()
+{
+	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
+}
+
+float CTargetField::FindPath(const bool* moveArray, const float* costArray, int epoch, bool isSafe,
+		const std::vector<int>& endNodes, int startNode, std::vector<int>& path)
+{
+	if (endNodes.empty()) {
+		return -1.f;
+	}
+	SField& field = GetField(moveArray, costArray, epoch, isSafe, endNodes);
+
+	// Settled: every open state costs more than the best start
+	int best;
+	float bestCost = GetStartCost(field, startNode, best);
+	while (!field.queue.empty() && (field.queue.top().first < bestCost)) {
+		Expand(field);
+		bestCost = GetStartCost(field, startNode, best);
+	}
+	if (best < 0) {
+		return -1.f;
+	}
+
+	path.push_back(startNode);
+	for (int si = (best / 2 == startNode) ? field.next[best] : best; si >= 0; si = field.next[si]) {
+		path.push_back(si / 2);
+	}
+	if (path.size() < 2) {
+		path.push_back(startNode);
+	}
+	return bestCost;
+}
+
+CTargetField::SField& CTargetField::GetField(const bool* moveArray, const float* costArray, int epoch, bool isSafe,
+		const std::vector<int>& endNodes)
+{
+	++useNum;
+	SField* victim = nullptr;
+	for (SField& field : fields) {
+		if ((field.epoch == epoch) && (field.moveArray == moveArray) && (field.costArray == costArray)
+			&& (field.isSafe == isSafe) && (field.sources == endNodes))
+		{
+			field.useNum = useNum;
+			++hitNum;
+			return field;
+		}
+		// NOTE: fields of previous epochs were used before any of current epoch
+		if ((victim == nullptr) || (victim->useNum > field.useNum)) {
+			victim = &field;
+		}
+	}
+	if ((victim == nullptr) || ((victim->epoch == epoch) && (fields.size() < MAX_FIELDS))) {
+		fields.emplace_back();
+		victim = &fields.back();
+	}
+
+	victim->moveArray = moveArray;
+	victim->costArray = costArray;
+	victim->epoch = epoch;
+	victim->isSafe = isSafe;
+	victim->sources = endNodes;
+	victim->useNum = useNum;
+	++missNum;
+	Build(*victim);
+	return *victim;
+}
+
+void CTargetField::Build(SField& field)
+{
+	const int size = sizeX * sizeY * 2;
+	field.dist.assign(size, std::numeric_limits<float>::max());
+	field.next.assign(size, -1);
+
+	field.queue = SQueue();
+	for (int node : field.sources) {
+		if (field.moveArray[node]) {
+			field.dist[node * 2] = .0f;
+			field.queue.push(std::make_pair(.0f, node * 2));
+		}
+	}
+}
+
+void CTargetField::Expand(SField& field)
+{
+	const float d = field.queue.top().first;
+	const int si = field.queue.top().second;
+	field.queue.pop();
+	if (d > field.dist[si]) {
+		return;
+	}
+	// NOTE: Edges of path map are not passable, passable node always has 8 neighbours
+	const int node = si / 2;
+	const float cost = field.costArray[node];
+	for (int k = 0; k < 8; ++k) {
+		const int prev = node + offsets[k];
+		int state;
+		if (!field.moveArray[prev] || !IsAllowed(field, prev, node, si % 2, state)) {
+			continue;
+		}
+		const float nd = d + ((k > 3) ? cost * SQRT_2 : cost);
+		const int pi = prev * 2 + state;
+		if (nd < field.dist[pi]) {
+			field.dist[pi] = nd;
+			field.next[pi] = si;
+			field.queue.push(std::make_pair(nd, pi));
+		}
+	}
+}
+
+float CTargetField::GetStartCost(const SField& field, int startNode, int& outBest) const
+{
+	outBest = -1;
+	float bestCost = std::numeric_limits<float>::max();
+	for (int s = 0; s < 2; ++s) {
+		const int si = startNode * 2 + s;
+		if (field.dist[si] < bestCost) {
+			bestCost = field.dist[si];
+			outBest = si;
+		}
+	}
+	if (field.moveArray[startNode]) {
+		return bestCost;
+	}
+	// Blocked start: step into passable neighbour, as CMicroPather does
+	for (int k = 0; k < 8; ++k) {
+		const int node = startNode + offsets[k];
+		if (!field.moveArray[node]) {
+			continue;
+		}
+		const float step = (k > 3) ? field.costArray[node] * SQRT_2 : field.costArray[node];
+		for (int s = 0; s < 2; ++s) {
+			int state;
+			const int si = node * 2 + s;
+			if ((field.dist[si] + step < bestCost) && IsAllowed(field, startNode, node, s, state)) {
+				bestCost = field.dist[si] + step;
+				outBest = si;
+			}
+		}
+	}
+	return bestCost;
+}
+
+/*
+ * Step from -> to, state of path from "to": 0 - threat never decreases, 1 - it decreases somewhere.
+ * Safe path can't increase threat before it decreases.
+ */
+bool CTargetField::IsAllowed(const SField& field, int from, int to, int state, int& outState) const
+{
+	outState = state;
+	if (!field.isSafe) {
+		return true;
+	}
+	const float diff = field.costArray[to] - field.costArray[from];
+	if (diff > .0f) {
+		return state == 0;
+	}
+	if (diff < .0f) {
+		outState = 1;
+	}
+	return true;
+}
+
+} // namespace circuit
@@ -0,0 +1,69 @@
+/*
+ * TargetField.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#ifndef SRC_CIRCUIT_TERRAIN_TARGETFIELD_H_
+#define SRC_CIRCUIT_TERRAIN_TARGETFIELD_H_
+
+#include <queue>
+#include <vector>
+
+namespace circuit {
+
+/*
+ * Cost-to-go fields over path map with end nodes of target set as sources (reverse multi-source Dijkstra).
+ * Field is keyed by move array, cost array, threat epoch and end nodes, it pays off only for target sets
+ * shared by many units (per-unit filters like area come from move array), unit-specific sets go to A*.
+ * Dijkstra is lazy: it stops once start node is settled and resumes on next query of the same field.
+ * Edge cost matches CMicroPather: cost of entered node.
+ * Safe field tracks 2 states per node to forbid leaving threat after entering it (as FindBestPathToAnyGivenPointSafe).
+ */
+class CTargetField {
+public:
+	using SQueue = std::priority_queue<std::pair<float, int>, std::vector<std::pair<float, int>>, std::greater<std::pair<float, int>>>;
+
+	CTargetField(int sizeX, int sizeY);
+	virtual ~CTargetField();
+
+	void Invalidate() { fields.clear(); }
+	unsigned GetHitNum() const { return hitNum; }
+	unsigned GetMissNum() const { return missNum; }
+
+	// endNodes must be sorted and unique; path starts with startNode; returns cost or -1 if no path
+	float FindPath(const bool* moveArray, const float* costArray, int epoch, bool isSafe,
+			const std::vector<int>& endNodes, int startNode, std::vector<int>& path);
+
+private:
+	struct SField {
+		const bool* moveArray;
+		const float* costArray;
+		int epoch;
+		bool isSafe;
+		std::vector<int> sources;  // end nodes
+		std::vector<float> dist;  // index: node * 2 + state
+		std::vector<int> next;  // index of state towards source, -1 at source
+		SQueue queue;  // open states of lazy Dijkstra
+		int useNum;
+	};
+	SField& GetField(const bool* moveArray, const float* costArray, int epoch, bool isSafe,
+			const std::vector<int>& endNodes);
+	void Build(SField& field);
+	void Expand(SField& field);
+	float GetStartCost(const SField& field, int startNode, int& outBest) const;
+	bool IsAllowed(const SField& field, int from, int to, int state, int& outState) const;
+
+	int sizeX;
+	int sizeY;
+	int offsets[8];
+	std::vector<SField> fields;  // least recently used is replaced
+	int useNum;
+	unsigned hitNum;
+	unsigned missNum;
+};
+
+} // namespace circuit
+
+#endif // SRC_CIRCUIT_TERRAIN_TARGETFIELD_H_
@@ -25,6 +25,7 @@
 #include <functional>
 #include <algorithm>
 #include <deque>
+#include <queue>
 #include <set>
 #include <sstream>
 
@@ -55,6 +56,7 @@ CTerrainData::CTerrainData()
 		, aiToUpdate(0)
 //		, isClusterizing(false)
 		, isInitialized(false)
+		, isClosestPending(false)
 #ifdef DEBUG_VIS
 		, toggleFrame(-1)
 #endif
@@ -244,6 +246,7 @@ void CTerrainData::Init(CCircuitAI* circuit)
 				IT->minElevation = -maxWaterDepth;
 				IT->canHover = canHover;
 				IT->canFloat = canFloat;
+				IT->sector.resize(sectorXSize * sectorZSize, false);
 			}
 			IT->udCount++;
 			udImmobileType[def->GetUnitDefId()] = itIdx;
@@ -320,7 +323,7 @@ void CTerrainData::Init(CCircuitAI* circuit)
 					(it.canFloat && (it.maxElevation >= sector[i].maxElevation) && !waterIsHarmful) ||
 					((it.minElevation <= sector[i].minElevation) && (it.maxElevation >= sector[i].maxElevation) && (!waterIsHarmful || (sector[i].minElevation >=0))))
 				{
-					it.sector[i] = &sector[i];
+					it.sector[i] = true;
 				}
 			}
 		}
@@ -329,7 +332,8 @@ void CTerrainData::Init(CCircuitAI* circuit)
 	percentLand *= 100.0 / (sectorXSize * convertStoHM * sectorZSize * convertStoHM);
 
 	for (auto& it : immobileType) {
-		it.typeUsable = (((100.0 * it.sector.size()) / float(sectorXSize * sectorZSize) >= 20.0) || ((double)convertStoP * convertStoP * it.sector.size() >= 1.8e7));
+		const int sectorCount = std::count(it.sector.begin(), it.sector.end(), true);
+		it.typeUsable = (((100.0 * sectorCount) / float(sectorXSize * sectorZSize) >= 20.0) || ((double)convertStoP * convertStoP * sectorCount >= 1.8e7));
 	}
 
 	circuit->LOG("  Map Land Percent: %.2f%%", percentLand);
@@ -354,7 +358,7 @@ void CTerrainData::Init(CCircuitAI* circuit)
 		} else {
 			itText += "any";
 		}
-		float percentMap = (100.0 * it.sector.size()) / (sectorXSize * sectorZSize);
+		float percentMap = (100.0 * std::count(it.sector.begin(), it.sector.end(), true)) / (sectorXSize * sectorZSize);
 		itText += ")  \tIs buildable across " + utils::float_to_string(percentMap/*, "%-.4G"*/) + "%% of the map. (used by %d unit-defs)";
 		circuit->LOG(itText.c_str(), it.udCount);
 	}
@@ -387,40 +391,46 @@ void CTerrainData::Init(CCircuitAI* circuit)
 		mtText << ")  \tMove-Data used:'" << mt.moveData->GetName() << "'";
 
 		std::deque<int> sectorSearch;
-		std::set<int> sectorsRemaining;
+		std::vector<bool> sectorsRemaining(sectorZSize * sectorXSize, false);
+		int remainCount = 0, remainIdx = 0;
 		for (int iS = 0; iS < sectorZSize * sectorXSize; iS++) {
 			if ((mt.canHover && (mt.maxElevation >= sector[iS].maxElevation) && !waterIsAVoid && ((sector[iS].maxElevation <= 0) || (mt.maxSlope >= sector[iS].maxSlope))) ||
 				(mt.canFloat && (mt.maxElevation >= sector[iS].maxElevation) && !waterIsHarmful && ((sector[iS].maxElevation <= 0) || (mt.maxSlope >= sector[iS].maxSlope))) ||
 				((mt.maxSlope >= sector[iS].maxSlope) && (mt.minElevation <= sector[iS].minElevation) && (mt.maxElevation >= sector[iS].maxElevation) && (!waterIsHarmful || (sector[iS].minElevation >= 0))))
 			{
-				sectorsRemaining.insert(iS);
+				sectorsRemaining[iS] = true;
+				++remainCount;
 			}
 		}
 
 		// Group sectors into areas
 		int i, iX, iZ, areaSize = 0;  // Temp Var.
-		while (!sectorsRemaining.empty() || !sectorSearch.empty()) {
+		while ((remainCount > 0) || !sectorSearch.empty()) {
 
 			if (!sectorSearch.empty()) {
 				i = sectorSearch.front();
-				mt.area.back().sector[i] = &mt.sector[i];
+				mt.area.back().sector.push_back(i);
 				iX = i % sectorXSize;
 				iZ = i / sectorXSize;
-				if ((sectorsRemaining.find(i - 1) != sectorsRemaining.end()) && (iX > 0)) {  // Search left
+				if ((iX > 0) && sectorsRemaining[i - 1]) {  // Search left
 					sectorSearch.push_back(i - 1);
-					sectorsRemaining.erase(i - 1);
+					sectorsRemaining[i - 1] = false;
+					--remainCount;
 				}
-				if ((sectorsRemaining.find(i + 1) != sectorsRemaining.end()) && (iX < sectorXSize - 1)) {  // Search right
+				if ((iX < sectorXSize - 1) && sectorsRemaining[i + 1]) {  // Search right
 					sectorSearch.push_back(i + 1);
-					sectorsRemaining.erase(i + 1);
+					sectorsRemaining[i + 1] = false;
+					--remainCount;
 				}
-				if ((sectorsRemaining.find(i - sectorXSize) != sectorsRemaining.end()) && (iZ > 0)) {  // Search up
+				if ((iZ > 0) && sectorsRemaining[i - sectorXSize]) {  // Search up
 					sectorSearch.push_back(i - sectorXSize);
-					sectorsRemaining.erase(i - sectorXSize);
+					sectorsRemaining[i - sectorXSize] = false;
+					--remainCount;
 				}
-				if ((sectorsRemaining.find(i + sectorXSize) != sectorsRemaining.end()) && (iZ < sectorZSize - 1)) {  // Search down
+				if ((iZ < sectorZSize - 1) && sectorsRemaining[i + sectorXSize]) {  // Search down
 					sectorSearch.push_back(i + sectorXSize);
-					sectorsRemaining.erase(i + sectorXSize);
+					sectorsRemaining[i + sectorXSize] = false;
+					--remainCount;
 				}
 				sectorSearch.pop_front();
 
@@ -444,9 +454,13 @@ void CTerrainData::Init(CCircuitAI* circuit)
 					areaSize--;
 				}
 
-				i = *sectorsRemaining.begin();
+				while (!sectorsRemaining[remainIdx]) {
+					++remainIdx;
+				}
+				i = remainIdx;
 				sectorSearch.push_back(i);
-				sectorsRemaining.erase(i);
+				sectorsRemaining[i] = false;
+				--remainCount;
 				mt.area.emplace_back(&mt);
 				areaSize++;
 			}
@@ -461,8 +475,8 @@ void CTerrainData::Init(CCircuitAI* circuit)
 		// Calculations
 		float percentOfMap = 0.0;
 		for (auto& area : mt.area) {
-			for (auto& iS : area.sector) {
-				iS.second->area = &area;
+			for (int iS : area.sector) {
+				mt.sector[iS].area = &area;
 			}
 			area.percentOfMap = (100.0 * area.sector.size()) / (sectorXSize * sectorZSize);
 			if (area.percentOfMap >= 20.0 ) {  // A map area occupying 20% of the map
@@ -481,6 +495,11 @@ void CTerrainData::Init(CCircuitAI* circuit)
 		circuit->LOG(mtText.str().c_str());
 	}
 
+	isClosestPending = circuit->IsLoadSave();
+	if (!isClosestPending) {
+		UpdateClosestSectors(areaData);
+	}
+
 	/*
 	 *  Duplicate areaData
 	 */
@@ -490,9 +509,8 @@ void CTerrainData::Init(CCircuitAI* circuit)
 		mt.areaLargest = nullptr;
 		for (auto& area : mt.area) {
 			area.mobileType = &mt;
-			for (auto& kv : area.sector) {
-				kv.second = &mt.sector[kv.first];
-				kv.second->area = &area;
+			for (int iS : area.sector) {
+				mt.sector[iS].area = &area;
 			}
 			if ((mt.areaLargest == nullptr) || (mt.areaLargest->percentOfMap < area.percentOfMap)) {
 				mt.areaLargest = &area;
@@ -509,14 +527,6 @@ void CTerrainData::Init(CCircuitAI* circuit)
 			for (auto& mt : nextAreaData.mobileType) {
 				mt.sector[i].S = &nextAreaData.sector[i];
 			}
-			for (auto& it : nextAreaData.immobileType) {
-				if ((it.canHover && (it.maxElevation >= nextAreaData.sector[i].maxElevation) && !waterIsAVoid) ||
-					(it.canFloat && (it.maxElevation >= nextAreaData.sector[i].maxElevation) && !waterIsHarmful) ||
-					((it.minElevation <= nextAreaData.sector[i].minElevation) && (it.maxElevation >= nextAreaData.sector[i].maxElevation) && (!waterIsHarmful || (nextAreaData.sector[i].minElevation >=0))))
-				{
-					it.sector[i] = &nextAreaData.sector[i];
-				}
-			}
 		}
 	}
 
@@ -656,23 +666,19 @@ void CTerrainData::UpdateAreas()
 		itmt->areaLargest = nullptr;
 		for (auto& as : itmt->sector) {
 			as.area = nullptr;
-			// TODO: Use previous sectorAlternativeM/I and update it?
-			as.sectorAlternativeM.clear();
-			as.sectorAlternativeI.clear();
 		}
 		itmt->area.clear();
+		// TODO: Use previous sectorAlternative and update it?
+		itmt->sectorAlternative.Clear();
 		++itmt;
 	}
 	decltype(areaData.immobileType)::iterator itit = immobileType.begin();
 	for (auto& it : prevAreaData.immobileType) {
-		itit->sector.clear();
-		for (auto& kv : it.sector) {
-			itit->sector[kv.first] = &sector[kv.first];
-		}
-		// TODO: Use previous sectorClosest and update it (replace STerrainMapSector* by index)?
+		itit->sector = it.sector;
 		itit->sectorClosest.clear();
 		++itit;
 	}
+	areaData.sectorAirAlternative.Clear();
 	minElevation = prevAreaData.minElevation;
 	percentLand = prevAreaData.percentLand;
 
@@ -758,9 +764,9 @@ void CTerrainData::UpdateAreas()
 					(it.canFloat && (it.maxElevation >= sector[i].maxElevation) && !waterIsHarmful) ||
 					((it.minElevation <= sector[i].minElevation) && (it.maxElevation >= sector[i].maxElevation) && (!waterIsHarmful || (sector[i].minElevation >= 0))))
 				{
-					it.sector[i] = &sector[i];
+					it.sector[i] = true;
 				} else {
-					it.sector.erase(i);
+					it.sector[i] = false;
 				}
 			}
 		}
@@ -769,7 +775,8 @@ void CTerrainData::UpdateAreas()
 	percentLand = tmpPercentLand * 100.0 / (sectorXSize * convertStoHM * sectorZSize * convertStoHM);
 
 	for (auto& it : immobileType) {
-		it.typeUsable = (((100.0 * it.sector.size()) / float(sectorXSize * sectorZSize) >= 20.0) || ((double)convertStoP * convertStoP * it.sector.size() >= 1.8e7));
+		const int sectorCount = std::count(it.sector.begin(), it.sector.end(), true);
+		it.typeUsable = (((100.0 * sectorCount) / float(sectorXSize * sectorZSize) >= 20.0) || ((double)convertStoP * convertStoP * sectorCount >= 1.8e7));
 	}
 
 	/*
@@ -799,40 +806,46 @@ void CTerrainData::UpdateAreas()
 		if (shouldRebuild(*itmt)) {
 
 			std::deque<int> sectorSearch;
-			std::set<int> sectorsRemaining;
+			std::vector<bool> sectorsRemaining(sectorZSize * sectorXSize, false);
+			int remainCount = 0, remainIdx = 0;
 			for (int iS = 0; iS < sectorZSize * sectorXSize; iS++) {
 				if ((mt.canHover && (mt.maxElevation >= sector[iS].maxElevation) && !waterIsAVoid && ((sector[iS].maxElevation <= 0) || (mt.maxSlope >= sector[iS].maxSlope))) ||
 					(mt.canFloat && (mt.maxElevation >= sector[iS].maxElevation) && !waterIsHarmful && ((sector[iS].maxElevation <= 0) || (mt.maxSlope >= sector[iS].maxSlope))) ||
 					((mt.maxSlope >= sector[iS].maxSlope) && (mt.minElevation <= sector[iS].minElevation) && (mt.maxElevation >= sector[iS].maxElevation) && (!waterIsHarmful || (sector[iS].minElevation >= 0))))
 				{
-					sectorsRemaining.insert(iS);
+					sectorsRemaining[iS] = true;
+					++remainCount;
 				}
 			}
 
 			// Group sectors into areas
 			int i, iX, iZ, areaSize = 0;  // Temp Var.
-			while (!sectorsRemaining.empty() || !sectorSearch.empty()) {
+			while ((remainCount > 0) || !sectorSearch.empty()) {
 
 				if (!sectorSearch.empty()) {
 					i = sectorSearch.front();
-					mt.area.back().sector[i] = &mt.sector[i];
+					mt.area.back().sector.push_back(i);
 					iX = i % sectorXSize;
 					iZ = i / sectorXSize;
-					if ((sectorsRemaining.find(i - 1) != sectorsRemaining.end()) && (iX > 0)) {  // Search left
+					if ((iX > 0) && sectorsRemaining[i - 1]) {  // Search left
 						sectorSearch.push_back(i - 1);
-						sectorsRemaining.erase(i - 1);
+						sectorsRemaining[i - 1] = false;
+						--remainCount;
 					}
-					if ((sectorsRemaining.find(i + 1) != sectorsRemaining.end()) && (iX < sectorXSize - 1)) {  // Search right
+					if ((iX < sectorXSize - 1) && sectorsRemaining[i + 1]) {  // Search right
 						sectorSearch.push_back(i + 1);
-						sectorsRemaining.erase(i + 1);
+						sectorsRemaining[i + 1] = false;
+						--remainCount;
 					}
-					if ((sectorsRemaining.find(i - sectorXSize) != sectorsRemaining.end()) && (iZ > 0)) {  // Search up
+					if ((iZ > 0) && sectorsRemaining[i - sectorXSize]) {  // Search up
 						sectorSearch.push_back(i - sectorXSize);
-						sectorsRemaining.erase(i - sectorXSize);
+						sectorsRemaining[i - sectorXSize] = false;
+						--remainCount;
 					}
-					if ((sectorsRemaining.find(i + sectorXSize) != sectorsRemaining.end()) && (iZ < sectorZSize - 1)) {  // Search down
+					if ((iZ < sectorZSize - 1) && sectorsRemaining[i + sectorXSize]) {  // Search down
 						sectorSearch.push_back(i + sectorXSize);
-						sectorsRemaining.erase(i + sectorXSize);
+						sectorsRemaining[i + sectorXSize] = false;
+						--remainCount;
 					}
 					sectorSearch.pop_front();
 
@@ -852,9 +865,13 @@ void CTerrainData::UpdateAreas()
 						areaSize--;
 					}
 
-					i = *sectorsRemaining.begin();
+					while (!sectorsRemaining[remainIdx]) {
+						++remainIdx;
+					}
+					i = remainIdx;
 					sectorSearch.push_back(i);
-					sectorsRemaining.erase(i);
+					sectorsRemaining[i] = false;
+					--remainCount;
 					mt.area.emplace_back(&mt);
 					areaSize++;
 				}
@@ -870,17 +887,15 @@ void CTerrainData::UpdateAreas()
 			// Copy mt.area from previous areaData
 			for (auto& area : itmt->area) {
 				mt.area.emplace_back(&mt);
-				std::map<int, STerrainMapAreaSector*>& sector = mt.area.back().sector;
-				for (auto& kv : area.sector) {
-					sector[kv.first] = &mt.sector[kv.first];
-				}
+				mt.area.back().sector = area.sector;
+				mt.area.back().sectorClosest = area.sectorClosest;
 			}
 		}
 
 		// Calculations
 		for (auto& area : mt.area) {
-			for (auto& iS : area.sector) {
-				iS.second->area = &area;
+			for (int iS : area.sector) {
+				mt.sector[iS].area = &area;
 			}
 			area.percentOfMap = (100.0 * area.sector.size()) / (sectorXSize * sectorZSize);
 			if (area.percentOfMap >= 20.0 ) {  // A map area occupying 20% of the map
@@ -896,6 +911,195 @@ void CTerrainData::UpdateAreas()
 
 		++itmt;
 	}
+
+	UpdateClosestSectors(areaData);
+}
+
+void CTerrainData::UpdateClosestSectors(SAreaData& areaData)
+{
+	std::vector<int> sources;
+	for (auto& mt : areaData.mobileType) {
+		for (auto& area : mt.area) {
+			if (!area.sectorClosest.empty()) {  // area was not rebuilt
+				continue;
+			}
+			FillClosestSectors(area.sector, area.sectorClosest);
+		}
+	}
+	for (auto& it : areaData.immobileType) {
+		sources.clear();
+		for (unsigned iS = 0; iS < it.sector.size(); ++iS) {
+			if (it.sector[iS]) {
+				sources.push_back(iS);
+			}
+		}
+		FillClosestSectors(sources, it.sectorClosest);
+	}
+}
+
+/*
+ * Voronoi partition of sector grid: propagates closest source from all sources at once
+ */
+void CTerrainData::FillClosestSectors(const std::vector<int>& sources, std::vector<int>& closest) const
+{
+	static const int dx[] = {-1, 0, 1, -1, 1, -1, 0, 1};
+	static const int dz[] = {-1, -1, -1, 0, 0, 1, 1, 1};
+	const int size = sectorXSize * sectorZSize;
+	closest.assign(size, -1);
+	std::vector<int> sqDist(size, std::numeric_limits<int>::max());
+	std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<std::pair<int, int>>> queue;
+	for (int iS : sources) {
+		sqDist[iS] = 0;
+		closest[iS] = iS;
+		queue.push(std::make_pair(0, iS));
+	}
+
+	while (!queue.empty()) {
+		const int d = queue.top().first;
+		const int iS = queue.top().second;
+		queue.pop();
+		if (d > sqDist[iS]) {
+			continue;
+		}
+		const int src = closest[iS];
+		const int sx = src % sectorXSize;
+		const int sz = src / sectorXSize;
+		const int x = iS % sectorXSize;
+		const int z = iS / sectorXSize;
+		for (int k = 0; k < 8; ++k) {
+			const int nx = x + dx[k];
+			const int nz = z + dz[k];
+			if ((nx < 0) || (nx >= sectorXSize) || (nz < 0) || (nz >= sectorZSize)) {
+				continue;
+			}
+			const int ni = nz * sectorXSize + nx;
+			const int nd = SQUARE(nx - sx) + SQUARE(nz - sz);
+			if (nd < sqDist[ni]) {
+				sqDist[ni] = nd;
+				closest[ni] = src;
+				queue.push(std::make_pair(nd, ni));
+			}
+		}
+	}
+}
+
+void CTerrainData::CopyClosestSectors(const SAreaData& src, SAreaData& dst) const
+{
+	for (unsigned i = 0; i < src.mobileType.size(); ++i) {
+		const std::vector<STerrainMapArea>& srcArea = src.mobileType[i].area;
+		std::vector<STerrainMapArea>& dstArea = dst.mobileType[i].area;
+		for (unsigned j = 0; j < srcArea.size(); ++j) {
+			dstArea[j].sectorClosest = srcArea[j].sectorClosest;
+		}
+	}
+	for (unsigned i = 0; i < src.immobileType.size(); ++i) {
+		dst.immobileType[i].sectorClosest = src.immobileType[i].sectorClosest;
+	}
+}
+
+void CTerrainData::InitClosestSectors()
+{
+	if (!isClosestPending) {
+		return;
+	}
+	isClosestPending = false;
+
+	SAreaData& areaData = *pAreaData.load();
+	UpdateClosestSectors(areaData);
+	CopyClosestSectors(areaData, *GetNextAreaData());
+}
+
+void CTerrainData::SaveAreas(std::ostream& os) const
+{
+	const SAreaData& areaData = *pAreaData.load();
+	const uint32_t sectorCount = areaData.sector.size();
+	const uint32_t mtCount = areaData.mobileType.size();
+	const uint32_t itCount = areaData.immobileType.size();
+	utils::binary_write(os, sectorCount);
+	utils::binary_write(os, mtCount);
+	for (const STerrainMapMobileType& mt : areaData.mobileType) {
+		const uint32_t areaCount = mt.area.size();
+		utils::binary_write(os, areaCount);
+		for (const STerrainMapArea& area : mt.area) {
+			utils::binary_write(os, area.sector);
+			utils::binary_write(os, area.sectorClosest);
+		}
+	}
+	utils::binary_write(os, itCount);
+	for (const STerrainMapImmobileType& it : areaData.immobileType) {
+		utils::binary_write(os, it.sectorClosest);
+	}
+}
+
+bool CTerrainData::LoadAreas(std::istream& is)
+{
+	if (!isClosestPending) {
+		return false;
+	}
+
+	// Areas are rebuilt on init (cheap), snapshot must match them exactly
+	SAreaData& areaData = *pAreaData.load();
+	const int sectorCount = areaData.sector.size();
+	auto isValid = [sectorCount](const std::vector<int>& closest) {
+		if (closest.size() != (unsigned)sectorCount) {
+			return false;
+		}
+		for (int iS : closest) {
+			if ((iS < -1) || (iS >= sectorCount)) {
+				return false;
+			}
+		}
+		return true;
+	};
+	uint32_t size = 0;
+	utils::binary_read(is, size);
+	if (size != (unsigned)sectorCount) {
+		return false;
+	}
+	std::vector<std::vector<int>> closests;
+	std::vector<int> sectors;
+	utils::binary_read(is, size);
+	if (size != areaData.mobileType.size()) {
+		return false;
+	}
+	for (const STerrainMapMobileType& mt : areaData.mobileType) {
+		utils::binary_read(is, size);
+		if (size != mt.area.size()) {
+			return false;
+		}
+		for (const STerrainMapArea& area : mt.area) {
+			closests.emplace_back();
+			utils::binary_read(is, sectors);
+			utils::binary_read(is, closests.back());
+			if (!is || (sectors != area.sector) || !isValid(closests.back())) {
+				return false;
+			}
+		}
+	}
+	utils::binary_read(is, size);
+	if (size != areaData.immobileType.size()) {
+		return false;
+	}
+	for (unsigned i = 0; i < areaData.immobileType.size(); ++i) {
+		closests.emplace_back();
+		utils::binary_read(is, closests.back());
+		if (!is || !isValid(closests.back())) {
+			return false;
+		}
+	}
+
+	std::vector<std::vector<int>>::iterator itc = closests.begin();
+	for (STerrainMapMobileType& mt : areaData.mobileType) {
+		for (STerrainMapArea& area : mt.area) {
+			area.sectorClosest = std::move(*itc++);
+		}
+	}
+	for (STerrainMapImmobileType& it : areaData.immobileType) {
+		it.sectorClosest = std::move(*itc++);
+	}
+	CopyClosestSectors(areaData, *GetNextAreaData());
+	isClosestPending = false;
+	return true;
 }
 
 void CTerrainData::ScheduleUsersUpdate()
@@ -1106,7 +1310,7 @@ void CTerrainData::UpdateVis()
 	for (const STerrainMapImmobileType& mt : areaData.immobileType) {
 		std::pair<Uint32, float*> win = sdlWindows[winNum++];
 		for (int i = 0; i < sectorXSize * sectorZSize; ++i) {
-			if (mt.sector.find(i) != mt.sector.end()) LAND(win.second, i)
+			if (mt.sector[i]) LAND(win.second, i)
 			else if (sector[i].maxElevation < 0.0) WATER(win.second, i)
 			else if (sector[i].maxSlope > 0.5) HILL(win.second, i)
 			else BLOCK(win.second, i)
@@ -1145,7 +1349,7 @@ void CTerrainData::ToggleVis(int frame)
 			std::pair<Uint32, float*> win;
 			win.second = new float [sectorXSize * sectorZSize * 3];
 			std::ostringstream label;
-			label << "Circuit AI :: Terrain :: Immobile [" << itId++ << "] h=" << mt.canHover << " f=" << mt.canFloat << " mb=" << mt.sector.size();
+			label << "Circuit AI :: Terrain :: Immobile [" << itId++ << "] h=" << mt.canHover << " f=" << mt.canFloat << " mb=" << std::count(mt.sector.begin(), mt.sector.end(), true);
 			win.first = debugDrawer->AddSDLWindow(sectorXSize, sectorZSize, label.str().c_str());
 			sdlWindows.push_back(win);
 		}
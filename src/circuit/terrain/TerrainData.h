@@ -24,6 +24,7 @@
 #include <map>
 #include <vector>
 #include <atomic>
+#include <iosfwd>
 #include <memory>
 
 namespace springai {
@@ -52,12 +53,16 @@ struct STerrainMapAreaSector {
 		area(nullptr)
 	{};
 
-	// NOTE: some of these values are loaded as they become needed, use GlobalTerrainMap functions
 	STerrainMapSector* S;  // always valid
-	STerrainMapArea* area;  // The TerrainMapArea this sector belongs to, otherwise = 0 until
-	// Use this to find the closest sector useable by a unit with a different MoveType, the 0 pointer may be valid as a key index
-	std::map<STerrainMapMobileType*, STerrainMapAreaSector*> sectorAlternativeM;  // uninitialized
-	std::map<STerrainMapImmobileType*, STerrainMapSector*> sectorAlternativeI;  // uninitialized
+	STerrainMapArea* area;  // The TerrainMapArea this sector belongs to, otherwise = 0
+};
+
+// Use this to find the closest sector useable by a unit with a different MoveType.
+// Filled as needed by TerrainManager::GetAlternativeSector, value = sector index, -1 = none, -2 = not determined
+struct SAlternativeSectors {
+	std::vector<std::vector<int>> mobile;    // index = destination mobile type id, then source sector index
+	std::vector<std::vector<int>> immobile;  // index = destination immobile type id, then source sector index
+	void Clear() { mobile.clear(); immobile.clear(); }
 };
 
 struct STerrainMapArea {
@@ -66,12 +71,13 @@ struct STerrainMapArea {
 		mobileType(TMMobileType),
 		percentOfMap(.0f)
 	{};
+	inline bool HasSector(int sIndex) const;
 
 	bool areaUsable;  // Should units of this type be used in this area
 	STerrainMapMobileType* mobileType;
-	std::map<int, STerrainMapAreaSector*> sector;         // key = sector index, a list of all sectors belonging to it
-	std::map<int, STerrainMapAreaSector*> sectorClosest;  // key = sector indexes not in "sector", indicates the sector belonging to this map-area with the closest distance
-	// NOTE: use TerrainData::GetClosestSector: these values are not initialized but are instead loaded as they become needed
+	std::vector<int> sector;  // indices of all sectors belonging to it
+	std::vector<int> sectorClosest;  // index = sector index, value = index of the closest sector belonging to this map-area
+	// NOTE: use TerrainData::GetClosestSector: filled on area analysis
 	float percentOfMap;  // 0-100
 };
 
@@ -96,6 +102,7 @@ struct STerrainMapMobileType {
 	std::vector<STerrainMapAreaSector> sector;  // Each MoveType has it's own sector list, GlobalTerrainMap->GetSectorIndex() gives an index
 	std::vector<STerrainMapArea> area;  // Each MoveType has it's own MapArea list
 	STerrainMapArea* areaLargest;  // Largest area usable by this type, otherwise = 0
+	SAlternativeSectors sectorAlternative;  // from sectors of this type
 
 	float maxSlope;      // = MoveData*->maxSlope
 	float maxElevation;  // = -ud->minWaterDepth
@@ -106,6 +113,11 @@ struct STerrainMapMobileType {
 	int udCount;
 };
 
+inline bool STerrainMapArea::HasSector(int sIndex) const
+{
+	return mobileType->sector[sIndex].area == this;
+}
+
 struct STerrainMapSector {
 	STerrainMapSector() :
 		isWater(false),
@@ -138,8 +150,8 @@ struct STerrainMapImmobileType {
 	{};
 
 	bool typeUsable;  // Should units of this type be used on this map
-	std::map<int, STerrainMapSector*> sector;         // a list of sectors useable by these units
-	std::map<int, STerrainMapSector*> sectorClosest;  // key = sector indexes not in "sector", indicates the closest sector in "sector"
+	std::vector<bool> sector;  // index = sector index, true if useable by these units
+	std::vector<int> sectorClosest;  // index = sector index, value = index of the closest sector in "sector"
 	float minElevation;
 	float maxElevation;
 	bool canHover;
@@ -156,6 +168,7 @@ struct SAreaData {
 	std::vector<STerrainMapMobileType> mobileType;      // Used for mobile units, not all movedatas are used
 	std::vector<STerrainMapImmobileType> immobileType;  // Used for immobile units
 	std::vector<STerrainMapAreaSector> sectorAirType;   // used for flying units, GetSectorIndex gives an index
+	SAlternativeSectors sectorAirAlternative;           // from sectors of flying units
 	std::vector<STerrainMapSector> sector;  // global sector data, GetSectorIndex gives an index
 
 	float minElevation;   // 0 or less (used by cRAIUnitDefHandler, builder start selecter)
@@ -206,6 +219,18 @@ private:
 // ---- RAI's GlobalTerrainMap ---- END
 
 	void DelegateAuthority(CCircuitAI* curOwner);
+	void UpdateClosestSectors(SAreaData& areaData);
+	void FillClosestSectors(const std::vector<int>& sources, std::vector<int>& closest) const;
+	void CopyClosestSectors(const SAreaData& src, SAreaData& dst) const;
+
+public:
+	/*
+	 * Saved game postpones closest sectors until snapshot is loaded,
+	 * InitClosestSectors computes them if snapshot had none.
+	 */
+	void InitClosestSectors();
+	void SaveAreas(std::ostream& os) const;
+	bool LoadAreas(std::istream& is);
 
 // ---- Threaded areas updater ---- BEGIN
 private:
@@ -240,6 +265,7 @@ public:
 
 private:
 	bool isInitialized;
+	bool isClosestPending;
 
 #ifdef DEBUG_VIS
 private:
@@ -30,9 +30,17 @@ namespace circuit {
 
 using namespace springai;
 
+#define BUILD_CACHE_TTL		FRAMES_PER_SEC
+#define BUILD_CACHE_MAX		4096
+#define BUILD_CACHE_CELL	(SQUARE_SIZE * 32)
+
 CTerrainManager::CTerrainManager(CCircuitAI* circuit, CTerrainData* terrainData)
 		: circuit(circuit)
 		, terrainData(terrainData)
+		, areaUpdateNum(0)
+		, buildCacheStamp(0)
+		, buildCacheHits(0)
+		, buildCacheMisses(0)
 #ifdef DEBUG_VIS
 		, dbgTextureId(-1)
 		, sdlWindowId(-1)
@@ -57,6 +65,11 @@ CTerrainManager::CTerrainManager(CCircuitAI* circuit, CTerrainData* terrainData)
 	blockingMap.rowsLow = mapHeight / (GRID_RATIO_LOW * 2);
 	SBlockingMap::SBlockCellLow cellLow = {0};
 	blockingMap.gridLow.resize(blockingMap.columnsLow * blockingMap.rowsLow, cellLow);
+	blockingMap.InitPlanes();
+
+	buildCacheWidth = (mapWidth * SQUARE_SIZE + BUILD_CACHE_CELL - 1) / BUILD_CACHE_CELL;
+	buildCacheHeight = (mapHeight * SQUARE_SIZE + BUILD_CACHE_CELL - 1) / BUILD_CACHE_CELL;
+	buildCacheCells.resize(buildCacheWidth * buildCacheHeight, 0);
 
 	ReadConfig();
 }
@@ -376,14 +389,7 @@ AIFloat3 CTerrainManager::FindBuildSite(CCircuitDef* cdef, const AIFloat3& pos,
 
 	auto isOpenSite = [this](const int2& s1, const int2& s2) {
 		const SBlockingMap::SM notIgnore = static_cast<SBlockingMap::SM>(SBlockingMap::StructMask::ALL);
-		for (int x = s1.x; x < s2.x; x++) {
-			for (int z = s1.y; z < s2.y; z++) {
-				if (blockingMap.IsBlocked(x, z, notIgnore)) {
-					return false;
-				}
-			}
-		}
-		return true;
+		return !blockingMap.IsBlockedArea(s1, s2, notIgnore);
 	};
 
 	const int endr = (int)(searchRadius / (SQUARE_SIZE * 2));
@@ -404,7 +410,7 @@ AIFloat3 CTerrainManager::FindBuildSite(CCircuitDef* cdef, const AIFloat3& pos,
 
 		probePos.x = (s1.x + s2.x) * SQUARE_SIZE;
 		probePos.z = (s1.y + s2.y) * SQUARE_SIZE;
-		if (CanBeBuiltAtSafe(cdef, probePos) && map->IsPossibleToBuildAt(unitDef, probePos, facing)) {
+		if (CanBeBuiltAtSafe(cdef, probePos) && IsPossibleToBuildAt(cdef, probePos, facing)) {
 			probePos.y = map->GetElevationAt(probePos.x, probePos.z);
 			if (predicate(probePos)) {
 				return probePos;
@@ -593,14 +599,7 @@ AIFloat3 CTerrainManager::FindBuildSiteLow(CCircuitDef* cdef, const AIFloat3& po
 
 	auto isOpenSite = [this](const int2& s1, const int2& s2) {
 		const SBlockingMap::SM notIgnore = static_cast<SBlockingMap::SM>(SBlockingMap::StructMask::ALL);
-		for (int x = s1.x; x < s2.x; x++) {
-			for (int z = s1.y; z < s2.y; z++) {
-				if (blockingMap.IsBlocked(x, z, notIgnore)) {
-					return false;
-				}
-			}
-		}
-		return true;
+		return !blockingMap.IsBlockedArea(s1, s2, notIgnore);
 	};
 
 	const int endr = (int)(searchRadius / (SQUARE_SIZE * 2));
@@ -635,7 +634,7 @@ AIFloat3 CTerrainManager::FindBuildSiteLow(CCircuitDef* cdef, const AIFloat3& po
 
 			probePos.x = (s1.x + s2.x) * SQUARE_SIZE;
 			probePos.z = (s1.y + s2.y) * SQUARE_SIZE;
-			if (CanBeBuiltAtSafe(cdef, probePos) && map->IsPossibleToBuildAt(unitDef, probePos, facing)) {
+			if (CanBeBuiltAtSafe(cdef, probePos) && IsPossibleToBuildAt(cdef, probePos, facing)) {
 				probePos.y = map->GetElevationAt(probePos.x, probePos.z);
 				if (predicate(probePos)) {
 					return probePos;
@@ -675,30 +674,6 @@ AIFloat3 CTerrainManager::FindBuildSiteByMask(CCircuitDef* cdef, const AIFloat3&
 		}
 	}
 
-#define DECLARE_TEST(testName, facingType)																	\
-	auto testName = [this, mask, notIgnore, structMask](const int2& m1, const int2& m2, const int2& om) {	\
-		for (int x = m1.x, xm = om.x; x < m2.x; x++, xm++) {												\
-			for (int z = m1.y, zm = om.y; z < m2.y; z++, zm++) {											\
-				switch (mask->facingType(xm, zm)) {															\
-					case IBlockMask::BlockType::BLOCKED: {													\
-						if (blockingMap.IsStruct(x, z, structMask)) {										\
-							return false;																	\
-						}																					\
-						break;																				\
-					}																						\
-					case IBlockMask::BlockType::STRUCT: {													\
-						if (blockingMap.IsBlocked(x, z, notIgnore)) {										\
-							return false;																	\
-						}																					\
-						break;																				\
-					}																						\
-					case IBlockMask::BlockType::OPEN: { break; }											\
-				}																							\
-			}																								\
-		}																									\
-		return true;																						\
-	};
-
 	const int endr = (int)(searchRadius / (SQUARE_SIZE * 2));
 	const SearchOffsets& ofs = GetSearchOffsetTable(endr);
 
@@ -715,54 +690,31 @@ AIFloat3 CTerrainManager::FindBuildSiteByMask(CCircuitDef* cdef, const AIFloat3&
 	AIFloat3 probePos(ZeroVector);
 	Map* map = circuit->GetMap();
 
-#define DO_TEST(testName)																				\
-	for (int so = 0; so < endr * endr * 4; so++) {														\
-		int2 s1(structCorner.x + ofs[so].dx, structCorner.y + ofs[so].dy);								\
-		int2 s2(          s1.x + xssize,               s1.y + zssize);									\
-		if (!blockingMap.IsInBounds(s1, s2)) {															\
-			continue;																					\
-		}																								\
-																										\
-		int2 m1(maskCorner.x + ofs[so].dx, maskCorner.y + ofs[so].dy);									\
-		int2 m2(        m1.x + xmsize,             m1.y + zmsize);										\
-		int2 om = m1;																					\
-		blockingMap.Bound(m1, m2);																		\
-		om = m1 - om;																					\
-		if (!testName(m1, m2, om)) {																	\
-			continue;																					\
-		}																								\
-																										\
-		probePos.x = (s1.x + s2.x) * SQUARE_SIZE;														\
-		probePos.z = (s1.y + s2.y) * SQUARE_SIZE;														\
-		if (CanBeBuiltAtSafe(cdef, probePos) && map->IsPossibleToBuildAt(unitDef, probePos, facing)) {	\
-			probePos.y = map->GetElevationAt(probePos.x, probePos.z);									\
-			if (predicate(probePos)) {																	\
-				return probePos;																		\
-			}																							\
-		}																								\
-	}
+	const SBlockingMap::SMaskBits& maskBits = mask->GetMaskBits(facing);
 
-	switch (facing) {
-		default:
-		case UNIT_FACING_SOUTH: {
-			DECLARE_TEST(isOpenSouth, GetTypeSouth);
-			DO_TEST(isOpenSouth);
-			break;
-		}
-		case UNIT_FACING_EAST: {
-			DECLARE_TEST(isOpenEast, GetTypeEast);
-			DO_TEST(isOpenEast);
-			break;
+	for (int so = 0; so < endr * endr * 4; so++) {
+		int2 s1(structCorner.x + ofs[so].dx, structCorner.y + ofs[so].dy);
+		int2 s2(          s1.x + xssize,               s1.y + zssize);
+		if (!blockingMap.IsInBounds(s1, s2)) {
+			continue;
 		}
-		case UNIT_FACING_NORTH: {
-			DECLARE_TEST(isOpenNorth, GetTypeNorth);
-			DO_TEST(isOpenNorth);
-			break;
+
+		int2 m1(maskCorner.x + ofs[so].dx, maskCorner.y + ofs[so].dy);
+		int2 m2(        m1.x + xmsize,             m1.y + zmsize);
+		int2 om = m1;
+		blockingMap.Bound(m1, m2);
+		om = m1 - om;
+		if (!blockingMap.IsOpenMask(m1, m2, om, maskBits, notIgnore, structMask)) {
+			continue;
 		}
-		case UNIT_FACING_WEST: {
-			DECLARE_TEST(isOpenWest, GetTypeWest);
-			DO_TEST(isOpenWest);
-			break;
+
+		probePos.x = (s1.x + s2.x) * SQUARE_SIZE;
+		probePos.z = (s1.y + s2.y) * SQUARE_SIZE;
+		if (CanBeBuiltAtSafe(cdef, probePos) && IsPossibleToBuildAt(cdef, probePos, facing)) {
+			probePos.y = map->GetElevationAt(probePos.x, probePos.z);
+			if (predicate(probePos)) {
+				return probePos;
+			}
 		}
 	}
 
@@ -793,30 +745,6 @@ AIFloat3 CTerrainManager::FindBuildSiteByMaskLow(CCircuitDef* cdef, const AIFloa
 		}
 	}
 
-#define DECLARE_TEST_LOW(testName, facingType)																\
-	auto testName = [this, mask, notIgnore, structMask](const int2& m1, const int2& m2, const int2& om) {	\
-		for (int x = m1.x, xm = om.x; x < m2.x; x++, xm++) {												\
-			for (int z = m1.y, zm = om.y; z < m2.y; z++, zm++) {											\
-				switch (mask->facingType(xm, zm)) {															\
-					case IBlockMask::BlockType::BLOCKED: {													\
-						if (blockingMap.IsStruct(x, z, structMask)) {										\
-							return false;																	\
-						}																					\
-						break;																				\
-					}																						\
-					case IBlockMask::BlockType::STRUCT: {													\
-						if (blockingMap.IsBlocked(x, z, notIgnore)) {										\
-							return false;																	\
-						}																					\
-						break;																				\
-					}																						\
-					case IBlockMask::BlockType::OPEN: { break; }											\
-				}																							\
-			}																								\
-		}																									\
-		return true;																						\
-	};
-
 	const int endr = (int)(searchRadius / (SQUARE_SIZE * 2));
 	const SearchOffsetsLow& ofsLow = GetSearchOffsetTableLow(endr);
 	const int endrLow = endr / GRID_RATIO_LOW;
@@ -838,66 +766,96 @@ AIFloat3 CTerrainManager::FindBuildSiteByMaskLow(CCircuitDef* cdef, const AIFloa
 	AIFloat3 probePos(ZeroVector);
 	Map* map = circuit->GetMap();
 
-#define DO_TEST_LOW(testName)																					\
-	for (int soLow = 0; soLow < endrLow * endrLow * 4; soLow++) {												\
-		int2 low(structCenter.x + ofsLow[soLow].dx, structCenter.y + ofsLow[soLow].dy);							\
-		if (!blockingMap.IsInBoundsLow(low.x, low.y) || blockingMap.IsBlockedLow(low.x, low.y, notIgnore)) {	\
-			continue;																							\
-		}																										\
-																												\
-		const SearchOffsets& ofs = ofsLow[soLow].ofs;															\
-		for (int so = 0; so < GRID_RATIO_LOW * GRID_RATIO_LOW; so++) {											\
-			int2 s1(structCorner.x + ofs[so].dx, structCorner.y + ofs[so].dy);									\
-			int2 s2(          s1.x + xssize,               s1.y + zssize);										\
-			if (!blockingMap.IsInBounds(s1, s2)) {																\
-				continue;																						\
-			}																									\
-																												\
-			int2 m1(maskCorner.x + ofs[so].dx, maskCorner.y + ofs[so].dy);										\
-			int2 m2(        m1.x + xmsize,             m1.y + zmsize);											\
-			int2 om = m1;																						\
-			blockingMap.Bound(m1, m2);																			\
-			om = m1 - om;																						\
-			if (!testName(m1, m2, om)) {																		\
-				continue;																						\
-			}																									\
-																												\
-			probePos.x = (s1.x + s2.x) * SQUARE_SIZE;															\
-			probePos.z = (s1.y + s2.y) * SQUARE_SIZE;															\
-			if (CanBeBuiltAtSafe(cdef, probePos) && map->IsPossibleToBuildAt(unitDef, probePos, facing)) {		\
-				probePos.y = map->GetElevationAt(probePos.x, probePos.z);										\
-				if (predicate(probePos)) {																		\
-					return probePos;																			\
-				}																								\
-			}																									\
-		}																										\
-	}
+	const SBlockingMap::SMaskBits& maskBits = mask->GetMaskBits(facing);
 
-	switch (facing) {
-		default:
-		case UNIT_FACING_SOUTH: {
-			DECLARE_TEST_LOW(isOpenSouth, GetTypeSouth);
-			DO_TEST_LOW(isOpenSouth);
-			break;
+	for (int soLow = 0; soLow < endrLow * endrLow * 4; soLow++) {
+		int2 low(structCenter.x + ofsLow[soLow].dx, structCenter.y + ofsLow[soLow].dy);
+		if (!blockingMap.IsInBoundsLow(low.x, low.y) || blockingMap.IsBlockedLow(low.x, low.y, notIgnore)) {
+			continue;
 		}
-		case UNIT_FACING_EAST: {
-			DECLARE_TEST_LOW(isOpenEast, GetTypeEast);
-			DO_TEST_LOW(isOpenEast);
-			break;
+
+		const SearchOffsets& ofs = ofsLow[soLow].ofs;
+		for (int so = 0; so < GRID_RATIO_LOW * GRID_RATIO_LOW; so++) {
+			int2 s1(structCorner.x + ofs[so].dx, structCorner.y + ofs[so].dy);
+			int2 s2(          s1.x + xssize,               s1.y + zssize);
+			if (!blockingMap.IsInBounds(s1, s2)) {
+				continue;
+			}
+
+			int2 m1(maskCorner.x + ofs[so].dx, maskCorner.y + ofs[so].dy);
+			int2 m2(        m1.x + xmsize,             m1.y + zmsize);
+			int2 om = m1;
+			blockingMap.Bound(m1, m2);
+			om = m1 - om;
+			if (!blockingMap.IsOpenMask(m1, m2, om, maskBits, notIgnore, structMask)) {
+				continue;
+			}
+
+			probePos.x = (s1.x + s2.x) * SQUARE_SIZE;
+			probePos.z = (s1.y + s2.y) * SQUARE_SIZE;
+			if (CanBeBuiltAtSafe(cdef, probePos) && IsPossibleToBuildAt(cdef, probePos, facing)) {
+				probePos.y = map->GetElevationAt(probePos.x, probePos.z);
+				if (predicate(probePos)) {
+					return probePos;
+				}
+			}
 		}
-		case UNIT_FACING_NORTH: {
-			DECLARE_TEST_LOW(isOpenNorth, GetTypeNorth);
-			DO_TEST_LOW(isOpenNorth);
-			break;
+	}
+
+	return -RgtVector;
+}
+
+bool CTerrainManager::IsPossibleToBuildAt(CCircuitDef* cdef, const AIFloat3& probePos, int facing)
+{
+	const int frame = circuit->GetLastFrame();
+	const uint64_t key = ((uint64_t)cdef->GetId() << 32)
+			| ((uint64_t)(facing & 0x3) << 30)
+			| ((uint64_t)((int)probePos.x / (SQUARE_SIZE * 2) & 0x7FFF) << 15)
+			| (uint64_t)((int)probePos.z / (SQUARE_SIZE * 2) & 0x7FFF);
+
+	UnitDef* unitDef = cdef->GetUnitDef();
+	auto it = buildCache.find(key);
+	if ((it != buildCache.end()) && (it->second.frame + BUILD_CACHE_TTL > frame)) {
+		// Probe is stale if any cell under footprint changed
+		const int xsize = (((facing & 1) == 0) ? unitDef->GetXSize() : unitDef->GetZSize()) * SQUARE_SIZE / 2;
+		const int zsize = (((facing & 1) == 1) ? unitDef->GetXSize() : unitDef->GetZSize()) * SQUARE_SIZE / 2;
+		const int x1 = utils::clamp(int(probePos.x) - xsize, 0, buildCacheWidth * BUILD_CACHE_CELL - 1) / BUILD_CACHE_CELL;
+		const int x2 = utils::clamp(int(probePos.x) + xsize, 0, buildCacheWidth * BUILD_CACHE_CELL - 1) / BUILD_CACHE_CELL;
+		const int z1 = utils::clamp(int(probePos.z) - zsize, 0, buildCacheHeight * BUILD_CACHE_CELL - 1) / BUILD_CACHE_CELL;
+		const int z2 = utils::clamp(int(probePos.z) + zsize, 0, buildCacheHeight * BUILD_CACHE_CELL - 1) / BUILD_CACHE_CELL;
+		unsigned cellStamp = 0;
+		for (int z = z1; z <= z2; ++z) {
+			for (int x = x1; x <= x2; ++x) {
+				cellStamp = std::max(cellStamp, buildCacheCells[z * buildCacheWidth + x]);
+			}
 		}
-		case UNIT_FACING_WEST: {
-			DECLARE_TEST_LOW(isOpenWest, GetTypeWest);
-			DO_TEST_LOW(isOpenWest);
-			break;
+		if (it->second.stamp >= cellStamp) {
+			++buildCacheHits;
+			return it->second.isPossible;
 		}
 	}
+	++buildCacheMisses;
 
-	return -RgtVector;
+	if (buildCache.size() > BUILD_CACHE_MAX) {
+		buildCache.clear();
+	}
+	const bool isPossible = circuit->GetMap()->IsPossibleToBuildAt(unitDef, probePos, facing);
+	buildCache[key] = {buildCacheStamp, frame, isPossible};
+	return isPossible;
+}
+
+void CTerrainManager::InvalidateBuildCache(const AIFloat3& pos, float radius)
+{
+	const int x1 = utils::clamp(int(pos.x - radius) / BUILD_CACHE_CELL, 0, buildCacheWidth - 1);
+	const int x2 = utils::clamp(int(pos.x + radius) / BUILD_CACHE_CELL, 0, buildCacheWidth - 1);
+	const int z1 = utils::clamp(int(pos.z - radius) / BUILD_CACHE_CELL, 0, buildCacheHeight - 1);
+	const int z2 = utils::clamp(int(pos.z + radius) / BUILD_CACHE_CELL, 0, buildCacheHeight - 1);
+	++buildCacheStamp;
+	for (int z = z1; z <= z2; ++z) {
+		for (int x = x1; x <= x2; ++x) {
+			buildCacheCells[z * buildCacheWidth + x] = buildCacheStamp;
+		}
+	}
 }
 
 void CTerrainManager::MarkBlockerByMask(const SStructure& building, bool block, IBlockMask* mask)
@@ -990,7 +948,10 @@ void CTerrainManager::MarkBlocker(const SStructure& building, bool block)
 	CCircuitDef* cdef = building.cdef;
 	auto search = blockInfos.find(cdef->GetId());
 	if (search != blockInfos.end()) {
-		MarkBlockerByMask(building, block, search->second);
+		IBlockMask* mask = search->second;
+		// NOTE: mask can be shifted off the structure by struct offset
+		InvalidateBuildCache(building.pos, std::max(mask->GetXSize(), mask->GetZSize()) * SQUARE_SIZE * 2);
+		MarkBlockerByMask(building, block, mask);
 		return;
 	}
 
@@ -1001,6 +962,7 @@ void CTerrainManager::MarkBlocker(const SStructure& building, bool block)
 	const AIFloat3& pos = building.pos;
 
 	UnitDef* unitDef = cdef->GetUnitDef();
+	InvalidateBuildCache(pos, std::max(unitDef->GetXSize(), unitDef->GetZSize()) * SQUARE_SIZE / 2);
 	const int xsize = (((facing & 1) == 0) ? unitDef->GetXSize() : unitDef->GetZSize()) / 2;
 	const int zsize = (((facing & 1) == 1) ? unitDef->GetXSize() : unitDef->GetZSize()) / 2;
 
@@ -1112,70 +1074,48 @@ std::vector<STerrainMapAreaSector>& CTerrainManager::GetSectorList(STerrainMapAr
 
 STerrainMapAreaSector* CTerrainManager::GetClosestSector(STerrainMapArea* sourceArea, const int destinationSIndex)
 {
-	auto iAS = sourceArea->sectorClosest.find(destinationSIndex);
-	if (iAS != sourceArea->sectorClosest.end()) {  // It's already been determined
-		return iAS->second;
-	}
-
-	std::vector<STerrainMapAreaSector>& TMSectors = GetSectorList(sourceArea);
-	if (sourceArea == TMSectors[destinationSIndex].area) {
-		sourceArea->sectorClosest[destinationSIndex] = &TMSectors[destinationSIndex];
-		return &TMSectors[destinationSIndex];
-	}
-
-	AIFloat3* destination = &TMSectors[destinationSIndex].S->position;
-	STerrainMapAreaSector* SClosest = nullptr;
-	float sqDisClosest = std::numeric_limits<float>::max();
-	for (auto& iS : sourceArea->sector) {
-		float sqDist = iS.second->S->position.SqDistance2D(*destination);  // TODO: Consider SqDistance() instead of 2D
-		if (sqDist < sqDisClosest) {
-			SClosest = iS.second;
-			sqDisClosest = sqDist;
-		}
-	}
-	sourceArea->sectorClosest[destinationSIndex] = SClosest;
-	return SClosest;
+	const int iS = sourceArea->sectorClosest[destinationSIndex];
+	return (iS < 0) ? nullptr : &GetSectorList(sourceArea)[iS];
 }
 
 STerrainMapSector* CTerrainManager::GetClosestSector(STerrainMapImmobileType* sourceIT, const int destinationSIndex)
 {
-	auto iS = sourceIT->sectorClosest.find(destinationSIndex);
-	if (iS != sourceIT->sectorClosest.end()) {  // It's already been determined
-		return iS->second;
-	}
+	const int iS = sourceIT->sectorClosest[destinationSIndex];
+	return (iS < 0) ? nullptr : &areaData->sector[iS];
+}
 
-	if (sourceIT->sector.find(destinationSIndex) != sourceIT->sector.end()) {
-		STerrainMapSector* SClosest = &areaData->sector[destinationSIndex];
-		sourceIT->sectorClosest[destinationSIndex] = SClosest;
-		return SClosest;
+SAlternativeSectors& CTerrainManager::GetAlternativeSectors(STerrainMapArea* sourceArea)
+{
+	if ((sourceArea == nullptr) || (sourceArea->mobileType == nullptr)) {  // It flies or it's immobile
+		return areaData->sectorAirAlternative;
 	}
+	return sourceArea->mobileType->sectorAlternative;
+}
 
-	const AIFloat3* destination = &areaData->sector[destinationSIndex].position;
-	STerrainMapSector* SClosest = nullptr;
-	float sqDisClosest = std::numeric_limits<float>::max();
-	for (auto& iS : sourceIT->sector) {
-		float sqDist = iS.second->position.SqDistance2D(*destination);  // TODO: Consider SqDistance() instead of 2D
-		if (sqDist < sqDisClosest) {
-			SClosest = iS.second;
-			sqDisClosest = sqDist;
-		}
+std::vector<int>& CTerrainManager::GetAlternativeTable(std::vector<std::vector<int>>& tables, unsigned typeId)
+{
+	if (tables.size() <= typeId) {
+		tables.resize(typeId + 1);
+	}
+	std::vector<int>& table = tables[typeId];
+	if (table.empty()) {
+		table.assign(areaData->sector.size(), -2);
 	}
-	sourceIT->sectorClosest[destinationSIndex] = SClosest;
-	return SClosest;
+	return table;
 }
 
 STerrainMapAreaSector* CTerrainManager::GetAlternativeSector(STerrainMapArea* sourceArea, const int sourceSIndex, STerrainMapMobileType* destinationMT)
 {
 	std::vector<STerrainMapAreaSector>& TMSectors = GetSectorList(sourceArea);
-	auto iMS = TMSectors[sourceSIndex].sectorAlternativeM.find(destinationMT);
-	if (iMS != TMSectors[sourceSIndex].sectorAlternativeM.end()) {  // It's already been determined
-		return iMS->second;
-	}
-
 	if (destinationMT == nullptr) {  // flying unit movetype
 		return &TMSectors[sourceSIndex];
 	}
 
+	std::vector<int>& alternative = GetAlternativeTable(GetAlternativeSectors(sourceArea).mobile, destinationMT - &areaData->mobileType.front());
+	if (alternative[sourceSIndex] != -2) {  // It's already been determined
+		return (alternative[sourceSIndex] < 0) ? nullptr : &destinationMT->sector[alternative[sourceSIndex]];
+	}
+
 	if ((sourceArea != nullptr) && (sourceArea != TMSectors[sourceSIndex].area)) {
 		return GetAlternativeSector(sourceArea, GetSectorIndex(GetClosestSector(sourceArea, sourceSIndex)->S->position), destinationMT);
 	}
@@ -1210,16 +1150,16 @@ STerrainMapAreaSector* CTerrainManager::GetAlternativeSector(STerrainMapArea* so
 		}
 	}
 
-	TMSectors[sourceSIndex].sectorAlternativeM[destinationMT] = bestAS;
+	alternative[sourceSIndex] = (bestAS == nullptr) ? -1 : (bestAS - &destinationMT->sector.front());
 	return bestAS;
 }
 
 STerrainMapSector* CTerrainManager::GetAlternativeSector(STerrainMapArea* destinationArea, const int sourceSIndex, STerrainMapImmobileType* destinationIT)
 {
 	std::vector<STerrainMapAreaSector>& TMSectors = GetSectorList(destinationArea);
-	auto iMS = TMSectors[sourceSIndex].sectorAlternativeI.find(destinationIT);
-	if (iMS != TMSectors[sourceSIndex].sectorAlternativeI.end()) {  // It's already been determined
-		return iMS->second;
+	std::vector<int>& alternative = GetAlternativeTable(GetAlternativeSectors(destinationArea).immobile, destinationIT - &areaData->immobileType.front());
+	if (alternative[sourceSIndex] != -2) {  // It's already been determined
+		return (alternative[sourceSIndex] < 0) ? nullptr : &areaData->sector[alternative[sourceSIndex]];
 	}
 
 	STerrainMapSector* closestS = nullptr;
@@ -1227,19 +1167,11 @@ STerrainMapSector* CTerrainManager::GetAlternativeSector(STerrainMapArea* destin
 		if (destinationArea != TMSectors[sourceSIndex].area) {
 			closestS = GetAlternativeSector(destinationArea, GetSectorIndex(GetClosestSector(destinationArea, sourceSIndex)->S->position), destinationIT);
 		} else {
-			const AIFloat3& position = areaData->sector[sourceSIndex].position;
-			float closestDistance = std::numeric_limits<float>::max();
-			for (auto& iS : destinationArea->sector) {
-				float sqDist = iS.second->S->position.SqDistance2D(position);  // TODO: Consider SqDistance() instead of 2D
-				if (sqDist < closestDistance) {
-					closestS = iS.second->S;
-					closestDistance = sqDist;
-				}
-			}
+			closestS = GetClosestSector(destinationArea, sourceSIndex)->S;
 		}
 	}
 
-	TMSectors[sourceSIndex].sectorAlternativeI[destinationIT] = closestS;
+	alternative[sourceSIndex] = (closestS == nullptr) ? -1 : (closestS - &areaData->sector.front());
 	return closestS;
 }
 
@@ -1295,7 +1227,7 @@ bool CTerrainManager::CanBuildAt(CCircuitUnit* unit, const AIFloat3& destination
 		return true;
 	}
 	int iS = GetSectorIndex(destination);
-	if (area->sector.find(iS) != area->sector.end()) {
+	if (area->HasSector(iS)) {
 		return true;
 	}
 	return GetClosestSector(area, iS)->S->position.distance2D(destination) < unit->GetCircuitDef()->GetBuildDistance();
@@ -1315,7 +1247,7 @@ bool CTerrainManager::CanMobileBuildAt(STerrainMapArea* area, CCircuitDef* build
 		return true;
 	}
 	int iS = GetSectorIndex(destination);
-	if (area->sector.find(iS) != area->sector.end()) {
+	if (area->HasSector(iS)) {
 		return true;
 	}
 	return GetClosestSector(area, iS)->S->position.distance2D(destination) < builderDef->GetBuildDistance();
@@ -1331,7 +1263,9 @@ bool CTerrainManager::CanMobileBuildAtSafe(STerrainMapArea* area, CCircuitDef* b
 
 void CTerrainManager::UpdateAreaUsers(int interval)
 {
+	InvalidateBuildCache();  // height map changed
 	areaData = terrainData->GetNextAreaData();
+	++areaUpdateNum;
 	const int frame = circuit->GetLastFrame();
 	for (auto& kv : circuit->GetTeamUnits()) {
 		CCircuitUnit* unit = kv.second;
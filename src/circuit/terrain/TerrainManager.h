@@ -63,6 +63,10 @@ public:
 									 TerrainPredicate& predicate);
 
 	const SBlockingMap& GetBlockingMap();
+	void InvalidateBuildCache() { buildCache.clear(); }
+	void InvalidateBuildCache(const springai::AIFloat3& pos, float radius);
+	unsigned GetBuildCacheHits() const { return buildCacheHits; }
+	unsigned GetBuildCacheMisses() const { return buildCacheMisses; }
 
 	bool ResignAllyBuilding(CCircuitUnit* unit);
 
@@ -111,6 +115,26 @@ private:
 
 	SBlockingMap blockingMap;
 	std::unordered_map<CCircuitDef::Id, IBlockMask*> blockInfos;  // owner
+
+	/*
+	 * Engine buildability probes by UnitDef, facing and snapped build position.
+	 * Blockers and unit deaths stamp cells they touch, probe is valid while no cell under its footprint
+	 * is stamped later; height map updates invalidate all.
+	 */
+	struct SBuildProbe {
+		unsigned stamp;
+		int frame;
+		bool isPossible;
+	};
+	std::unordered_map<uint64_t, SBuildProbe> buildCache;
+	std::vector<unsigned> buildCacheCells;  // stamp of last change in cell
+	int buildCacheWidth;
+	int buildCacheHeight;
+	unsigned buildCacheStamp;
+	unsigned buildCacheHits;
+	unsigned buildCacheMisses;
+	bool IsPossibleToBuildAt(CCircuitDef* cdef, const springai::AIFloat3& probePos, int facing);
+
 	void MarkBlockerByMask(const SStructure& building, bool block, IBlockMask* mask);
 	void MarkBlocker(const SStructure& building, bool block);
 
@@ -128,6 +152,8 @@ private:
 	std::vector<STerrainMapAreaSector>& GetSectorList(STerrainMapArea* sourceArea = nullptr);
 	STerrainMapAreaSector* GetClosestSector(STerrainMapArea* sourceArea, const int destinationSIndex);
 	STerrainMapSector* GetClosestSector(STerrainMapImmobileType* sourceIT, const int destinationSIndex);
+	SAlternativeSectors& GetAlternativeSectors(STerrainMapArea* sourceArea);
+	std::vector<int>& GetAlternativeTable(std::vector<std::vector<int>>& tables, unsigned typeId);
 	// TODO: Refine brute-force algorithms
 	STerrainMapAreaSector* GetAlternativeSector(STerrainMapArea* sourceArea, const int sourceSIndex, STerrainMapMobileType* destinationMT);
 	STerrainMapSector* GetAlternativeSector(STerrainMapArea* destinationArea, const int sourceSIndex, STerrainMapImmobileType* destinationIT); // can return 0
@@ -173,11 +199,13 @@ public:
 	}
 
 	SAreaData* GetAreaData() const { return areaData; }
+	unsigned GetAreaUpdateNum() const { return areaUpdateNum; }  // areaData is double-buffered, pointer repeats
 	void UpdateAreaUsers(int interval);
 	void DidUpdateAreaUsers() { terrainData->DidUpdateAreaUsers(); }
 private:
 	SAreaData* areaData;
 	CTerrainData* terrainData;
+	unsigned areaUpdateNum;
 
 #ifdef DEBUG_VIS
 private:
@@ -0,0 +1,169 @@
+/*
+ * ThreatData.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#include "terrain/ThreatData.h"
+#include "terrain/TerrainData.h"
+#include "CircuitAI.h"
+#include "util/GameAttribute.h"
+#include "util/utils.h"
+
+#include "OOAICallback.h"
+#include "SSkirmishAICallback.h"
+#include "Mod.h"
+#include "Map.h"
+
+namespace circuit {
+
+using namespace springai;
+
+#define THREAT_DECAY	0.05f
+
+CThreatData::CThreatData(CCircuitAI* circuit)
+		: circuit(circuit)
+		, epoch(0)
+		, sonarFrame(-1)
+		, losFrame(-1)
+{
+	const CTerrainData& terrainData = circuit->GetGameAttribute()->GetTerrainData();
+	squareSize = terrainData.convertStoP;
+	width = terrainData.sectorXSize + 2;  // +2 for pathfinder edges
+	height = terrainData.sectorZSize + 2;  // +2 for pathfinder edges
+	mapSize = width * height;
+
+	airThreat.resize(mapSize, THREAT_BASE);
+	surfThreat.resize(mapSize, THREAT_BASE);
+	amphThreat.resize(mapSize, THREAT_BASE);
+	cloakThreat.resize(mapSize, THREAT_BASE);
+	shield.resize(mapSize, 0.f);
+
+	airMips.Init(&airThreat, width, height);
+	surfMips.Init(&surfThreat, width, height);
+	amphMips.Init(&amphThreat, width, height);
+	cloakMips.Init(&cloakThreat, width, height);
+
+	Map* map = circuit->GetMap();
+	int mapWidth = map->GetWidth();
+	int mapHeight = map->GetHeight();
+	Mod* mod = circuit->GetCallback()->GetMod();
+	int losMipLevel = mod->GetLosMipLevel();
+	int radarMipLevel = mod->GetRadarMipLevel();
+	delete mod;
+
+	radarWidth = mapWidth >> radarMipLevel;
+	radarResConv = SQUARE_SIZE << radarMipLevel;
+	sonarMap.resize(radarWidth * (mapHeight >> radarMipLevel), 0);
+	losWidth = mapWidth >> losMipLevel;
+	losResConv = SQUARE_SIZE << losMipLevel;
+	losMap.resize(losWidth * (mapHeight >> losMipLevel), 0);
+}
+
+CThreatData::~CThreatData()
+{
+	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
+}
+
+void CThreatData::Clear()
+{
+	++epoch;
+	std::fill(airThreat.begin(), airThreat.end(), THREAT_BASE);
+	std::fill(surfThreat.begin(), surfThreat.end(), THREAT_BASE);
+	std::fill(amphThreat.begin(), amphThreat.end(), THREAT_BASE);
+	std::fill(cloakThreat.begin(), cloakThreat.end(), THREAT_BASE);
+	std::fill(shield.begin(), shield.end(), 0.f);
+
+	for (CThreatPyramid* mips : {&airMips, &surfMips, &amphMips, &cloakMips}) {
+		mips->MarkAll();
+		mips->SetHotRect(0, 0, 0, 0);
+	}
+}
+
+void CThreatData::Decay()
+{
+	++epoch;
+	// decay stamped cells to compensate for precision errors
+	DecayLayer(airThreat, airMips);
+	DecayLayer(surfThreat, surfMips);
+	DecayLayer(amphThreat, amphMips);
+	// except for cloakThreat
+}
+
+/*
+ * Only cells above THREAT_BASE change, they are within hot rect of stamps.
+ * Levels are dirtied over changed cells, hot rect shrinks to cells left above base.
+ */
+void CThreatData::DecayLayer(Threats& threats, CThreatPyramid& mips)
+{
+	int x0, z0, x1, z1;
+	mips.GetHotRect(x0, z0, x1, z1);
+	int cx0 = width, cz0 = height, cx1 = 0, cz1 = 0;  // changed
+	int hx0 = width, hz0 = height, hx1 = 0, hz1 = 0;  // still hot
+	for (int z = z0; z < z1; ++z) {
+		for (int x = x0; x < x1; ++x) {
+			float& threat = threats[z * width + x];
+			if (threat <= THREAT_BASE) {
+				continue;
+			}
+			cx0 = std::min(cx0, x);
+			cz0 = std::min(cz0, z);
+			cx1 = std::max(cx1, x + 1);
+			cz1 = std::max(cz1, z + 1);
+			threat = std::max<float>(threat - THREAT_DECAY, THREAT_BASE);
+			if (threat > THREAT_BASE) {
+				hx0 = std::min(hx0, x);
+				hz0 = std::min(hz0, z);
+				hx1 = std::max(hx1, x + 1);
+				hz1 = std::max(hz1, z + 1);
+			}
+		}
+	}
+	mips.MarkDirty(cx0, cz0, cx1, cz1);
+	mips.SetHotRect(hx0, hz0, std::max(hx1, hx0), std::max(hz1, hz0));
+}
+
+void CThreatData::UpdateLOS()
+{
+	if (losFrame >= circuit->GetLastFrame()) {
+		return;
+	}
+	losFrame = circuit->GetLastFrame();
+	// NOTE: Map::GetLosMap allocates new vector on each call, C API fills existing buffer
+	circuit->GetSkirmishAICallback()->Map_getLosMap(circuit->GetSkirmishAIId(), losMap.data(), losMap.size());
+}
+
+void CThreatData::UpdateSonar()
+{
+	if (sonarFrame >= circuit->GetLastFrame()) {
+		return;
+	}
+	sonarFrame = circuit->GetLastFrame();
+	circuit->GetSkirmishAICallback()->Map_getSonarMap(circuit->GetSkirmishAIId(), sonarMap.data(), sonarMap.size());
+}
+
+bool CThreatData::IsInLOS(const AIFloat3& pos)
+{
+	// res = 1 << Mod->GetLosMipLevel();
+	// the value for the full resolution position (x, z) is at index ((z * width + x) / res)
+	// the last value, bottom right, is at index (width/res * height/res - 1)
+
+	// FIXME: @see rts/Sim/Objects/SolidObject.cpp CSolidObject::UpdatePhysicalState
+	//        for proper "underwater" implementation
+	if (pos.y < -SQUARE_SIZE * 5) {  // Mod->GetRequireSonarUnderWater() = true
+		UpdateSonar();
+		const int x = (int)pos.x / radarResConv;
+		const int z = (int)pos.z / radarResConv;
+		if (sonarMap[z * radarWidth + x] <= 0) {
+			return false;
+		}
+	}
+	UpdateLOS();
+	// convert from world coordinates to losmap coordinates
+	const int x = (int)pos.x / losResConv;
+	const int z = (int)pos.z / losResConv;
+	return losMap[z * losWidth + x] > 0;
+}
+
+} // namespace circuit
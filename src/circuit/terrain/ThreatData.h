@@ -0,0 +1,99 @@
+/*
+ * ThreatData.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#ifndef SRC_CIRCUIT_TERRAIN_THREATDATA_H_
+#define SRC_CIRCUIT_TERRAIN_THREATDATA_H_
+
+#include "terrain/ThreatPyramid.h"
+
+#include "AIFloat3.h"
+
+#include <vector>
+
+namespace circuit {
+
+class CCircuitAI;
+
+/*
+ * Threat layers shared by all AIs of the same ally team.
+ * Only authority stamps enemies and decays layers, others read.
+ */
+class CThreatData {
+public:
+	using Threats = std::vector<float>;
+
+	CThreatData(CCircuitAI* circuit);
+	virtual ~CThreatData();
+
+	void SetAuthority(CCircuitAI* authority) { circuit = authority; }
+	bool IsAuthority(const CCircuitAI* ai) const { return circuit == ai; }
+
+	void Clear();
+	void Decay();
+	void Touch() { ++epoch; }  // on stamp of enemy
+	int GetEpoch() const { return epoch; }  // changes on each stamp, clear and decay
+	bool IsInLOS(const springai::AIFloat3& pos);
+
+	int GetSquareSize() const { return squareSize; }
+	int GetWidth() const { return width; }
+	int GetHeight() const { return height; }
+	int GetMapSize() const { return mapSize; }
+
+	Threats& GetAirThreat() { return airThreat; }
+	Threats& GetSurfThreat() { return surfThreat; }
+	Threats& GetAmphThreat() { return amphThreat; }
+	Threats& GetCloakThreat() { return cloakThreat; }
+	Threats& GetShield() { return shield; }
+
+	CThreatPyramid& GetAirMips() { return airMips; }
+	CThreatPyramid& GetSurfMips() { return surfMips; }
+	CThreatPyramid& GetAmphMips() { return amphMips; }
+	CThreatPyramid& GetCloakMips() { return cloakMips; }
+
+private:
+	CCircuitAI* circuit;
+	int epoch;
+
+	int squareSize;
+	int width;
+	int height;
+	int mapSize;
+
+	Threats airThreat;  // air layer
+	Threats surfThreat;  // surface (water and land)
+	Threats amphThreat;  // under water and surface on land
+	Threats cloakThreat;
+	Threats shield;
+
+	CThreatPyramid airMips;
+	CThreatPyramid surfMips;
+	CThreatPyramid amphMips;
+	CThreatPyramid cloakMips;
+
+	void DecayLayer(Threats& threats, CThreatPyramid& mips);
+
+	/*
+	 * LOS and sonar are fetched on demand into persistent buffers,
+	 * at most once per frame for the whole ally team.
+	 */
+	void UpdateLOS();
+	void UpdateSonar();
+
+//	std::vector<int> radarMap;
+	std::vector<int> sonarMap;
+	std::vector<int> losMap;
+	int sonarFrame;  // frame of last fetch
+	int losFrame;
+	int radarWidth;
+	int radarResConv;
+	int losWidth;
+	int losResConv;
+};
+
+} // namespace circuit
+
+#endif // SRC_CIRCUIT_TERRAIN_THREATDATA_H_
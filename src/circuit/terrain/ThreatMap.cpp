@@ -15,8 +15,6 @@
 #include "json/json.h"
 
 #include "OOAICallback.h"
-#include "Mod.h"
-#include "Map.h"
 
 //#undef NDEBUG
 #include <cassert>
@@ -25,44 +23,33 @@ namespace circuit {
 
 using namespace springai;
 
-#define THREAT_DECAY	0.05f
-
 CThreatMap::CThreatMap(CCircuitAI* circuit, float decloakRadius)
 		: circuit(circuit)
+		, threatData(circuit->GetAllyTeam()->GetThreatData().get())
 //		, currMaxThreat(.0f)  // maximum threat (normalizer)
 //		, currSumThreat(.0f)  // threat summed over all cells
 //		, currAvgThreat(.0f)  // average threat over all cells
+		, airThreat(threatData->GetAirThreat())
+		, surfThreat(threatData->GetSurfThreat())
+		, amphThreat(threatData->GetAmphThreat())
+		, cloakThreat(threatData->GetCloakThreat())
+		, shield(threatData->GetShield())
+		, airMips(threatData->GetAirMips())
+		, surfMips(threatData->GetSurfMips())
+		, amphMips(threatData->GetAmphMips())
+		, cloakMips(threatData->GetCloakMips())
 {
 	areaData = circuit->GetTerrainManager()->GetAreaData();
-	squareSize = circuit->GetTerrainManager()->GetConvertStoP();
-	width = circuit->GetTerrainManager()->GetSectorXSize() + 2;  // +2 for pathfinder edges
-	height = circuit->GetTerrainManager()->GetSectorZSize() + 2;  // +2 for pathfinder edges
-	mapSize = width * height;
+	squareSize = threatData->GetSquareSize();
+	width = threatData->GetWidth();
+	height = threatData->GetHeight();
+	mapSize = threatData->GetMapSize();
 
 	rangeDefault = (DEFAULT_SLACK * 4) / squareSize;
 	distCloak = (decloakRadius + DEFAULT_SLACK) / squareSize;
 
-	airThreat.resize(mapSize, THREAT_BASE);
-	surfThreat.resize(mapSize, THREAT_BASE);
-	amphThreat.resize(mapSize, THREAT_BASE);
-	cloakThreat.resize(mapSize, THREAT_BASE);
 	threatArray = &surfThreat[0];
-	shield.resize(mapSize, 0.f);
-
-	Map* map = circuit->GetMap();
-	int mapWidth = map->GetWidth();
-	Mod* mod = circuit->GetCallback()->GetMod();
-	int losMipLevel = mod->GetLosMipLevel();
-	int radarMipLevel = mod->GetRadarMipLevel();
-	delete mod;
-
-//	radarMap = std::move(map->GetRadarMap());
-	radarWidth = mapWidth >> radarMipLevel;
-	sonarMap = std::move(map->GetSonarMap());
-	radarResConv = SQUARE_SIZE << radarMipLevel;
-	losMap = std::move(map->GetLosMap());
-	losWidth = mapWidth >> losMipLevel;
-	losResConv = SQUARE_SIZE << losMipLevel;
+	threatMips = &surfMips;
 
 	const Json::Value& root = circuit->GetSetupManager()->GetConfig();
 	const float slackMod = root["quota"].get("slack_mod", 2.f).asFloat() / FRAMES_PER_SEC;
@@ -111,9 +98,6 @@ CThreatMap::~CThreatMap()
 
 void CThreatMap::Update()
 {
-//	radarMap = std::move(circuit->GetMap()->GetRadarMap());
-	sonarMap = std::move(circuit->GetMap()->GetSonarMap());
-	losMap = std::move(circuit->GetMap()->GetLosMap());
 //	currMaxThreat = .0f;
 
 	// account for moving units
@@ -172,12 +156,8 @@ void CThreatMap::Update()
 		}
 	}
 
-	// decay whole threatMap to compensate for precision errors
-	for (int index = 0; index < mapSize; ++index) {
-		airThreat[index]  = std::max<float>(airThreat[index]  - THREAT_DECAY, THREAT_BASE);
-		surfThreat[index] = std::max<float>(surfThreat[index] - THREAT_DECAY, THREAT_BASE);
-		amphThreat[index] = std::max<float>(amphThreat[index] - THREAT_DECAY, THREAT_BASE);
-		// except for cloakThreat
+	if (IsAuthority()) {
+		threatData->Decay();
 	}
 //	airMetal    = std::max(airMetal    - THREAT_DECAY, .0f);
 //	staticMetal = std::max(staticMetal - THREAT_DECAY, .0f);
@@ -189,6 +169,26 @@ void CThreatMap::Update()
 #endif
 }
 
+void CThreatMap::Restamp()
+{
+	// NOTE: New authority: layers hold stamps of previous owner's enemies
+	threatData->Clear();
+	areaData = circuit->GetTerrainManager()->GetAreaData();
+
+	for (auto& kv : hostileUnits) {
+		CEnemyUnit* e = kv.second;
+		if (!e->IsHidden()) {
+			AddEnemyUnit(e);
+		}
+	}
+	for (auto& kv : peaceUnits) {
+		CEnemyUnit* e = kv.second;
+		if (!e->IsHidden()) {
+			AddDecloaker(e);
+		}
+	}
+}
+
 bool CThreatMap::EnemyEnterLOS(CEnemyUnit* enemy)
 {
 	// Possible cases:
@@ -358,11 +358,14 @@ void CThreatMap::SetThreatType(CCircuitUnit* unit)
 	assert(unit != nullptr);
 	if (unit->GetCircuitDef()->IsAbleToFly()) {
 		threatArray = &airThreat[0];
+		threatMips = &airMips;
 //	} else if (unit->GetPos(circuit->GetLastFrame()).y < -SQUARE_SIZE * 5) {
 	} else if (unit->GetCircuitDef()->IsAmphibious()) {
 		threatArray = &amphThreat[0];
+		threatMips = &amphMips;
 	} else {
 		threatArray = &surfThreat[0];
+		threatMips = &surfMips;
 	}
 }
 
@@ -392,9 +395,29 @@ float CThreatMap::GetThreatAt(CCircuitUnit* unit, const AIFloat3& position) cons
 	return surfThreat[z * width + x] - THREAT_BASE;
 }
 
+float CThreatMap::GetMaxThreatIn(const AIFloat3& position, float radius) const
+{
+	int x, z;
+	PosToXZ(position, x, z);
+	return std::max(threatMips->GetMaxInCircle(x, z, radius / squareSize) - THREAT_BASE, 0.f);
+}
+
+AIFloat3 CThreatMap::GetSafestPos(const AIFloat3& position, float radius) const
+{
+	int x, z;
+	PosToXZ(position, x, z);
+	threatMips->GetSafest(x, z, radius / squareSize, x, z);
+	// skip pathfinder edges
+	x = utils::clamp(x, 1, width - 2);
+	z = utils::clamp(z, 1, height - 2);
+	AIFloat3 pos((x - 1) * squareSize + squareSize / 2, position.y, (z - 1) * squareSize + squareSize / 2);
+	CTerrainManager::CorrectPosition(pos);
+	return pos;
+}
+
 float CThreatMap::GetUnitThreat(CCircuitUnit* unit) const
 {
-	float health = unit->GetUnit()->GetHealth() + unit->GetShieldPower() * 2.0f;
+	float health = unit->GetHealth(circuit->GetLastFrame()) + unit->GetShieldPower() * 2.0f;
 	return unit->GetDamage() * sqrtf(std::max(health, 0.f));  // / unit->GetUnit()->GetMaxHealth();
 }
 
@@ -406,6 +429,11 @@ inline void CThreatMap::PosToXZ(const AIFloat3& pos, int& x, int& z) const
 
 void CThreatMap::AddEnemyUnit(const CEnemyUnit* e)
 {
+	if (!IsAuthority()) {
+		return;
+	}
+	threatData->Touch();
+
 	CCircuitDef* cdef = e->GetCircuitDef();
 	if (cdef == nullptr) {
 		AddEnemyUnitAll(e);
@@ -427,6 +455,11 @@ void CThreatMap::AddEnemyUnit(const CEnemyUnit* e)
 
 void CThreatMap::DelEnemyUnit(const CEnemyUnit* e)
 {
+	if (!IsAuthority()) {
+		return;
+	}
+	threatData->Touch();
+
 	CCircuitDef* cdef = e->GetCircuitDef();
 	if (cdef == nullptr) {
 		DelEnemyUnitAll(e);
@@ -448,6 +481,10 @@ void CThreatMap::DelEnemyUnit(const CEnemyUnit* e)
 
 void CThreatMap::AddEnemyUnitAll(const CEnemyUnit* e)
 {
+	if (!IsAuthority()) {
+		return;
+	}
+	threatData->Touch();
 	AddEnemyAir(e);
 	AddEnemyAmph(e);
 	AddDecloaker(e);
@@ -455,6 +492,10 @@ void CThreatMap::AddEnemyUnitAll(const CEnemyUnit* e)
 
 void CThreatMap::DelEnemyUnitAll(const CEnemyUnit* e)
 {
+	if (!IsAuthority()) {
+		return;
+	}
+	threatData->Touch();
 	DelEnemyAir(e);
 	DelEnemyAmph(e);
 	DelDecloaker(e);
@@ -492,6 +533,7 @@ void CThreatMap::AddEnemyAir(const CEnemyUnit* e)
 	}
 
 //	currAvgThreat = currSumThreat / landThreat.size();
+	airMips.MarkDirty(beginX, beginZ, endX, endZ);
 }
 
 void CThreatMap::DelEnemyAir(const CEnemyUnit* e)
@@ -531,6 +573,7 @@ void CThreatMap::DelEnemyAir(const CEnemyUnit* e)
 	}
 
 //	currAvgThreat = currSumThreat / landThreat.size();
+	airMips.MarkDirty(beginX, beginZ, endX, endZ);
 }
 
 void CThreatMap::AddEnemyAmph(const CEnemyUnit* e)
@@ -571,6 +614,8 @@ void CThreatMap::AddEnemyAmph(const CEnemyUnit* e)
 			}
 		}
 	}
+	amphMips.MarkDirty(beginX, beginZ, endX, endZ);
+	surfMips.MarkDirty(beginX, beginZ, endX, endZ);
 }
 
 void CThreatMap::DelEnemyAmph(const CEnemyUnit* e)
@@ -611,10 +656,17 @@ void CThreatMap::DelEnemyAmph(const CEnemyUnit* e)
 			}
 		}
 	}
+	amphMips.MarkDirty(beginX, beginZ, endX, endZ);
+	surfMips.MarkDirty(beginX, beginZ, endX, endZ);
 }
 
 void CThreatMap::AddDecloaker(const CEnemyUnit* e)
 {
+	if (!IsAuthority()) {
+		return;
+	}
+	threatData->Touch();
+
 	int posx, posz;
 	PosToXZ(e->GetPos(), posx, posz);
 
@@ -642,10 +694,16 @@ void CThreatMap::AddDecloaker(const CEnemyUnit* e)
 			cloakThreat[index] += heat;
 		}
 	}
+	cloakMips.MarkDirty(beginX, beginZ, endX, endZ);
 }
 
 void CThreatMap::DelDecloaker(const CEnemyUnit* e)
 {
+	if (!IsAuthority()) {
+		return;
+	}
+	threatData->Touch();
+
 	int posx, posz;
 	PosToXZ(e->GetPos(), posx, posz);
 
@@ -673,6 +731,7 @@ void CThreatMap::DelDecloaker(const CEnemyUnit* e)
 			cloakThreat[index] = std::max<float>(cloakThreat[index] - heat, THREAT_BASE);
 		}
 	}
+	cloakMips.MarkDirty(beginX, beginZ, endX, endZ);
 }
 
 void CThreatMap::AddShield(const CEnemyUnit* e)
@@ -775,27 +834,6 @@ float CThreatMap::GetEnemyUnitThreat(CEnemyUnit* enemy) const
 	return enemy->GetDamage() * sqrtf(health + shield[z * width + x] * 2.0f);  // / unit->GetUnit()->GetMaxHealth();
 }
 
-bool CThreatMap::IsInLOS(const AIFloat3& pos) const
-{
-	// res = 1 << Mod->GetLosMipLevel();
-	// the value for the full resolution position (x, z) is at index ((z * width + x) / res)
-	// the last value, bottom right, is at index (width/res * height/res - 1)
-
-	// FIXME: @see rts/Sim/Objects/SolidObject.cpp CSolidObject::UpdatePhysicalState
-	//        for proper "underwater" implementation
-	if (pos.y < -SQUARE_SIZE * 5) {  // Mod->GetRequireSonarUnderWater() = true
-		const int x = (int)pos.x / radarResConv;
-		const int z = (int)pos.z / radarResConv;
-		if (sonarMap[z * radarWidth + x] <= 0) {
-			return false;
-		}
-	}
-	// convert from world coordinates to losmap coordinates
-	const int x = (int)pos.x / losResConv;
-	const int z = (int)pos.z / losResConv;
-	return losMap[z * losWidth + x] > 0;
-}
-
 //bool CThreatMap::IsInRadar(const AIFloat3& pos) const
 //{
 //	// the value for the full resolution position (x, z) is at index ((z * width + x) / res)
@@ -9,6 +9,7 @@
 #ifndef SRC_CIRCUIT_TERRAIN_THREATMAP_H_
 #define SRC_CIRCUIT_TERRAIN_THREATMAP_H_
 
+#include "terrain/ThreatData.h"
 #include "CircuitAI.h"
 
 #include <map>
@@ -28,6 +29,7 @@ public:
 	const CCircuitAI::EnemyUnits& GetPeaceUnits() const { return peaceUnits; }
 
 	void Update();
+	void Restamp();
 
 	bool EnemyEnterLOS(CEnemyUnit* enemy);
 	void EnemyLeaveLOS(CEnemyUnit* enemy);
@@ -42,6 +44,9 @@ public:
 	void SetThreatType(CCircuitUnit* unit);
 	float GetThreatAt(const springai::AIFloat3& position) const;
 	float GetThreatAt(CCircuitUnit* unit, const springai::AIFloat3& position) const;
+	// Region queries over current threat type
+	float GetMaxThreatIn(const springai::AIFloat3& position, float radius) const;
+	springai::AIFloat3 GetSafestPos(const springai::AIFloat3& position, float radius) const;
 
 	float* GetAirThreatArray() { return &airThreat[0]; }
 	float* GetSurfThreatArray() { return &surfThreat[0]; }
@@ -49,6 +54,7 @@ public:
 	float* GetCloakThreatArray() { return &cloakThreat[0]; }
 	int GetThreatMapWidth() const { return width; }
 	int GetThreatMapHeight() const { return height; }
+	int GetEpoch() const { return threatData->GetEpoch(); }
 
 	float GetUnitThreat(CCircuitUnit* unit) const;
 	int GetSquareSize() const { return squareSize; }
@@ -59,10 +65,13 @@ private:
 	 * http://stackoverflow.com/questions/872544/precision-of-floating-point
 	 * Single precision: for accuracy of +/-0.5 (or 2^-1) the maximum size that the number can be is 2^23.
 	 */
-	using Threats = std::vector<float>;
+	using Threats = CThreatData::Threats;
 	CCircuitAI* circuit;
+	CThreatData* threatData;  // ally-team shared
 	SAreaData* areaData;
 
+	bool IsAuthority() const { return threatData->IsAuthority(circuit); }
+
 	inline void PosToXZ(const springai::AIFloat3& pos, int& x, int& z) const;
 
 	void AddEnemyUnit(const CEnemyUnit* e);
@@ -83,7 +92,7 @@ private:
 	int GetShieldRange(const CCircuitDef* edef) const;
 	float GetEnemyUnitThreat(CEnemyUnit* enemy) const;
 
-	bool IsInLOS(const springai::AIFloat3& pos) const;
+	bool IsInLOS(const springai::AIFloat3& pos) const { return threatData->IsInLOS(pos); }
 //	bool IsInRadar(const springai::AIFloat3& pos) const;
 
 //	float currAvgThreat;
@@ -100,22 +109,19 @@ private:
 
 	CCircuitAI::EnemyUnits hostileUnits;
 	CCircuitAI::EnemyUnits peaceUnits;
-	Threats airThreat;  // air layer
-	Threats surfThreat;  // surface (water and land)
-	Threats amphThreat;  // under water and surface on land
-	Threats cloakThreat;
-	Threats shield;
+	Threats& airThreat;  // air layer
+	Threats& surfThreat;  // surface (water and land)
+	Threats& amphThreat;  // under water and surface on land
+	Threats& cloakThreat;
+	Threats& shield;
 	float* threatArray;
+	CThreatPyramid& airMips;
+	CThreatPyramid& surfMips;
+	CThreatPyramid& amphMips;
+	CThreatPyramid& cloakMips;
+	CThreatPyramid* threatMips;  // of threatArray
 	// TODO: shield-map - units under shield should get threat boost
 
-//	std::vector<int> radarMap;
-	std::vector<int> sonarMap;
-	std::vector<int> losMap;
-	int radarWidth;
-	int radarResConv;
-	int losWidth;
-	int losResConv;
-
 #ifdef DEBUG_VIS
 private:
 	std::vector<std::pair<uint32_t, float*>> sdlWindows;
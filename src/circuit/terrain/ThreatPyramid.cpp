@@ -0,0 +1,269 @@
+/*
+ * ThreatPyramid.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#include "terrain/ThreatPyramid.h"
+#include "util/utils.h"
+
+#include <limits>
+
+namespace circuit {
+
+struct CThreatPyramid::SRect {
+	int x0, z0, x1, z1;
+	bool IsDisjoint(int bx0, int bz0, int bx1, int bz1) const {
+		return (bx1 < x0) || (bx0 > x1) || (bz1 < z0) || (bz0 > z1);
+	}
+	bool IsInside(int bx0, int bz0, int bx1, int bz1) const {
+		return (bx0 >= x0) && (bx1 <= x1) && (bz0 >= z0) && (bz1 <= z1);
+	}
+};
+
+struct CThreatPyramid::SCircle {
+	int x, z, rangeSq;
+	bool IsDisjoint(int bx0, int bz0, int bx1, int bz1) const {
+		const int dx = (x < bx0) ? (bx0 - x) : (x > bx1) ? (x - bx1) : 0;
+		const int dz = (z < bz0) ? (bz0 - z) : (z > bz1) ? (z - bz1) : 0;
+		return SQUARE(dx) + SQUARE(dz) > rangeSq;
+	}
+	bool IsInside(int bx0, int bz0, int bx1, int bz1) const {
+		const int dx = std::max(std::abs(bx0 - x), std::abs(bx1 - x));
+		const int dz = std::max(std::abs(bz0 - z), std::abs(bz1 - z));
+		return SQUARE(dx) + SQUARE(dz) <= rangeSq;
+	}
+};
+
+CThreatPyramid::CThreatPyramid()
+		: layer(nullptr)
+		, width(0)
+		, height(0)
+		, dirtyX0(0), dirtyZ0(0), dirtyX1(0), dirtyZ1(0)
+		, hotX0(0), hotZ0(0), hotX1(0), hotZ1(0)
+{
+}
+
+CThreatPyramid::~CThreatPyramid()
+{
+	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
+}
+
+void CThreatPyramid::Init(const Threats* layer, int width, int height)
+{
+	this->layer = layer;
+	this->width = width;
+	this->height = height;
+
+	levels.clear();
+	int w = width, h = height;
+	while ((w > 1) || (h > 1)) {
+		w = (w + 1) / 2;
+		h = (h + 1) / 2;
+		levels.emplace_back();
+		SLevel& level = levels.back();
+		level.width = w;
+		level.height = h;
+		level.max.resize(w * h, 0.f);
+		level.sum.resize(w * h, 0.f);
+	}
+	MarkAll();
+}
+
+void CThreatPyramid::MarkDirty(int x0, int z0, int x1, int z1)
+{
+	x0 = std::max(x0, 0);
+	z0 = std::max(z0, 0);
+	x1 = std::min(x1, width);
+	z1 = std::min(z1, height);
+	if ((x0 >= x1) || (z0 >= z1)) {
+		return;
+	}
+	Extend(dirtyX0, dirtyZ0, dirtyX1, dirtyZ1, x0, z0, x1, z1);
+	Extend(hotX0, hotZ0, hotX1, hotZ1, x0, z0, x1, z1);
+}
+
+void CThreatPyramid::SetHotRect(int x0, int z0, int x1, int z1)
+{
+	hotX0 = x0;
+	hotZ0 = z0;
+	hotX1 = x1;
+	hotZ1 = z1;
+}
+
+float CThreatPyramid::GetMaxInRect(int x0, int z0, int x1, int z1)
+{
+	Refresh();
+	const SRect rect = {std::max(x0, 0), std::max(z0, 0), std::min(x1, width - 1), std::min(z1, height - 1)};
+	float best = -1.f;
+	if ((rect.x0 > rect.x1) || (rect.z0 > rect.z1)) {
+		return best;
+	}
+	const int top = levels.size();
+	const int topWidth = levels.empty() ? width : levels.back().width;
+	const int topHeight = levels.empty() ? height : levels.back().height;
+	for (int z = 0; z < topHeight; ++z) {
+		for (int x = 0; x < topWidth; ++x) {
+			MaxIn(rect, top, x, z, best);
+		}
+	}
+	return best;
+}
+
+float CThreatPyramid::GetMaxInCircle(int x, int z, int radius)
+{
+	Refresh();
+	const SCircle circle = {x, z, SQUARE(std::max(radius, 0))};
+	float best = -1.f;
+	const int top = levels.size();
+	const int topWidth = levels.empty() ? width : levels.back().width;
+	const int topHeight = levels.empty() ? height : levels.back().height;
+	for (int tz = 0; tz < topHeight; ++tz) {
+		for (int tx = 0; tx < topWidth; ++tx) {
+			MaxIn(circle, top, tx, tz, best);
+		}
+	}
+	return best;
+}
+
+void CThreatPyramid::GetSafest(int x, int z, int radius, int& outX, int& outZ)
+{
+	Refresh();
+	x = utils::clamp(x, 0, width - 1);
+	z = utils::clamp(z, 0, height - 1);
+	outX = x;
+	outZ = z;
+	radius = std::max(radius, 0);
+
+	// Block is at most half of radius: few blocks cover the circle
+	int level = 0;
+	while ((level < (int)levels.size()) && ((2 << level) <= radius)) {
+		++level;
+	}
+	const int levelWidth = (level == 0) ? width : levels[level - 1].width;
+	const int levelHeight = (level == 0) ? height : levels[level - 1].height;
+	const int rangeSq = SQUARE(radius);
+
+	const int beginX = std::max(x - radius, 0) >> level;
+	const int endX = std::min((std::min(x + radius, width - 1) >> level) + 1, levelWidth);
+	const int beginZ = std::max(z - radius, 0) >> level;
+	const int endZ = std::min((std::min(z + radius, height - 1) >> level) + 1, levelHeight);
+
+	float bestAvg = std::numeric_limits<float>::max();
+	int bestDistSq = std::numeric_limits<int>::max();
+	for (int bz = beginZ; bz < endZ; ++bz) {
+		const int bz0 = bz << level;
+		const int bz1 = std::min((bz + 1) << level, height) - 1;
+		const int cz = (bz0 + bz1) / 2;
+		for (int bx = beginX; bx < endX; ++bx) {
+			const int bx0 = bx << level;
+			const int bx1 = std::min((bx + 1) << level, width) - 1;
+			const int cx = (bx0 + bx1) / 2;
+			const int distSq = SQUARE(cx - x) + SQUARE(cz - z);
+			if (distSq > rangeSq) {
+				continue;
+			}
+			const float avg = GetSum(level, bx, bz) / ((bx1 - bx0 + 1) * (bz1 - bz0 + 1));
+			if ((avg < bestAvg) || ((avg == bestAvg) && (distSq < bestDistSq))) {
+				bestAvg = avg;
+				bestDistSq = distSq;
+				outX = cx;
+				outZ = cz;
+			}
+		}
+	}
+}
+
+void CThreatPyramid::Extend(int& rx0, int& rz0, int& rx1, int& rz1, int x0, int z0, int x1, int z1)
+{
+	if (rx0 >= rx1) {
+		rx0 = x0;
+		rz0 = z0;
+		rx1 = x1;
+		rz1 = z1;
+	} else {
+		rx0 = std::min(rx0, x0);
+		rz0 = std::min(rz0, z0);
+		rx1 = std::max(rx1, x1);
+		rz1 = std::max(rz1, z1);
+	}
+}
+
+void CThreatPyramid::Refresh()
+{
+	if ((dirtyX0 >= dirtyX1) || (dirtyZ0 >= dirtyZ1)) {
+		return;
+	}
+
+	int x0 = dirtyX0, z0 = dirtyZ0, x1 = dirtyX1, z1 = dirtyZ1;
+	for (unsigned l = 1; l <= levels.size(); ++l) {
+		x0 >>= 1;
+		z0 >>= 1;
+		x1 = (x1 + 1) >> 1;
+		z1 = (z1 + 1) >> 1;
+		const int childWidth = (l == 1) ? width : levels[l - 2].width;
+		const int childHeight = (l == 1) ? height : levels[l - 2].height;
+		SLevel& level = levels[l - 1];
+		for (int z = z0; z < z1; ++z) {
+			const int endZ = std::min(2 * z + 2, childHeight);
+			for (int x = x0; x < x1; ++x) {
+				const int endX = std::min(2 * x + 2, childWidth);
+				float max = -std::numeric_limits<float>::max();
+				float sum = 0.f;
+				for (int cz = 2 * z; cz < endZ; ++cz) {
+					for (int cx = 2 * x; cx < endX; ++cx) {
+						max = std::max(max, GetMax(l - 1, cx, cz));
+						sum += GetSum(l - 1, cx, cz);
+					}
+				}
+				const int index = z * level.width + x;
+				level.max[index] = max;
+				level.sum[index] = sum;
+			}
+		}
+	}
+
+	dirtyX0 = dirtyZ0 = dirtyX1 = dirtyZ1 = 0;
+}
+
+template<typename S>
+void CThreatPyramid::MaxIn(const S& shape, int level, int x, int z, float& best) const
+{
+	const int bx0 = x << level;
+	const int bz0 = z << level;
+	const int bx1 = std::min((x + 1) << level, width) - 1;
+	const int bz1 = std::min((z + 1) << level, height) - 1;
+	if (shape.IsDisjoint(bx0, bz0, bx1, bz1)) {
+		return;
+	}
+	const float max = GetMax(level, x, z);
+	if (max <= best) {
+		return;
+	}
+	if ((level == 0) || shape.IsInside(bx0, bz0, bx1, bz1)) {
+		best = max;
+		return;
+	}
+	const int childWidth = (level == 1) ? width : levels[level - 2].width;
+	const int childHeight = (level == 1) ? height : levels[level - 2].height;
+	const int endX = std::min(2 * x + 2, childWidth);
+	const int endZ = std::min(2 * z + 2, childHeight);
+	for (int cz = 2 * z; cz < endZ; ++cz) {
+		for (int cx = 2 * x; cx < endX; ++cx) {
+			MaxIn(shape, level - 1, cx, cz, best);
+		}
+	}
+}
+
+float CThreatPyramid::GetMax(int level, int x, int z) const
+{
+	return (level == 0) ? (*layer)[z * width + x] : levels[level - 1].max[z * levels[level - 1].width + x];
+}
+
+float CThreatPyramid::GetSum(int level, int x, int z) const
+{
+	return (level == 0) ? (*layer)[z * width + x] : levels[level - 1].sum[z * levels[level - 1].width + x];
+}
+
+} // namespace circuit
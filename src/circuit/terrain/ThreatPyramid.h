@@ -0,0 +1,66 @@
+/*
+ * ThreatPyramid.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#ifndef SRC_CIRCUIT_TERRAIN_THREATPYRAMID_H_
+#define SRC_CIRCUIT_TERRAIN_THREATPYRAMID_H_
+
+#include <vector>
+
+namespace circuit {
+
+/*
+ * Max and sum mip levels over threat layer, cell of level L covers (2^L)x(2^L) cells of layer.
+ * Stamps mark dirty rectangle, only dirty cells of levels are refreshed on next query.
+ * Hot rectangle bounds cells stamped since they were last at base, decay walks only it.
+ */
+class CThreatPyramid {
+public:
+	using Threats = std::vector<float>;
+
+	CThreatPyramid();
+	virtual ~CThreatPyramid();
+
+	void Init(const Threats* layer, int width, int height);
+	void MarkDirty(int x0, int z0, int x1, int z1);  // [x0, x1) x [z0, z1) of layer
+	void MarkAll() { MarkDirty(0, 0, width, height); }
+	void GetHotRect(int& x0, int& z0, int& x1, int& z1) const { x0 = hotX0; z0 = hotZ0; x1 = hotX1; z1 = hotZ1; }
+	void SetHotRect(int x0, int z0, int x1, int z1);  // [x0, x1) x [z0, z1) of layer
+
+	// Raw values of layer (with THREAT_BASE), -1 if region has no cells
+	float GetMaxInRect(int x0, int z0, int x1, int z1);  // [x0, x1] x [z0, z1]
+	float GetMaxInCircle(int x, int z, int radius);
+	// Cell of the block with the lowest average threat, block centre must be within radius
+	void GetSafest(int x, int z, int radius, int& outX, int& outZ);
+
+private:
+	struct SLevel {
+		int width;
+		int height;
+		Threats max;
+		Threats sum;
+	};
+	struct SRect;
+	struct SCircle;
+
+	static void Extend(int& rx0, int& rz0, int& rx1, int& rz1, int x0, int z0, int x1, int z1);
+	void Refresh();
+	template<typename S> void MaxIn(const S& shape, int level, int x, int z, float& best) const;
+	float GetMax(int level, int x, int z) const;
+	float GetSum(int level, int x, int z) const;
+
+	const Threats* layer;
+	int width;
+	int height;
+	std::vector<SLevel> levels;  // index: level - 1
+
+	int dirtyX0, dirtyZ0, dirtyX1, dirtyZ1;  // empty if dirtyX0 >= dirtyX1
+	int hotX0, hotZ0, hotX1, hotZ1;
+};
+
+} // namespace circuit
+
+#endif // SRC_CIRCUIT_TERRAIN_THREATPYRAMID_H_
@@ -9,10 +9,13 @@
 #include "unit/FactoryData.h"
 #include "resource/MetalManager.h"
 #include "resource/EnergyGrid.h"
+#include "resource/FeatureData.h"
 #include "setup/DefenceMatrix.h"
 #include "setup/SetupManager.h"
 #include "terrain/PathFinder.h"
 #include "terrain/TerrainData.h"
+#include "terrain/ThreatData.h"
+#include "terrain/ThreatMap.h"
 #include "CircuitAI.h"
 #include "util/GameAttribute.h"
 #include "util/Scheduler.h"
@@ -26,6 +29,8 @@ namespace circuit {
 
 using namespace springai;
 
+#define ALLY_CELL_SIZE	512
+
 bool CAllyTeam::SBox::ContainsPoint(const AIFloat3& point) const
 {
 	return (point.x >= left) && (point.x <= right) &&
@@ -38,6 +43,10 @@ CAllyTeam::CAllyTeam(const TeamIds& tids, const SBox& sb)
 		, initCount(0)
 		, resignSize(0)
 		, lastUpdate(-1)
+		, cellSize(ALLY_CELL_SIZE)
+		, maxUnitRadius(.0f)
+		, cellXSize(0)
+		, cellZSize(0)
 {
 }
 
@@ -61,13 +70,20 @@ void CAllyTeam::Init(CCircuitAI* circuit)
 		startBox = circuit->GetGameAttribute()->GetSetupData().GetStartBox(boxId);
 	}
 
+	cellXSize = (CTerrainData::terrainWidth + cellSize - 1) / cellSize;
+	cellZSize = (CTerrainData::terrainHeight + cellSize - 1) / cellSize;
+	cells.resize(cellXSize * cellZSize);
+
 	metalManager = std::make_shared<CMetalManager>(circuit, &circuit->GetGameAttribute()->GetMetalData());
-	if (metalManager->HasMetalSpots() && !metalManager->HasMetalClusters() && !metalManager->IsClusterizing()) {
+	// NOTE: Saved game restores clusters from snapshot, @see CCircuitAI::FinishInit
+	if (metalManager->HasMetalSpots() && !metalManager->HasMetalClusters() && !metalManager->IsClusterizing() && !circuit->IsLoadSave()) {
 		metalManager->ClusterizeMetal(circuit->GetSetupManager()->GetCommChoice());
 	}
 
 	energyGrid = std::make_shared<CEnergyGrid>(circuit);
+	featureData = std::make_shared<CFeatureData>(circuit);
 	defence = std::make_shared<CDefenceMatrix>(circuit);
+	threatData = std::make_shared<CThreatData>(circuit);
 	pathfinder = std::make_shared<CPathFinder>(&circuit->GetGameAttribute()->GetTerrainData());
 	factoryData = std::make_shared<CFactoryData>(circuit);
 
@@ -85,10 +101,13 @@ void CAllyTeam::Release()
 		delete kv.second;
 	}
 	friendlyUnits.clear();
+	cells.clear();
 
 	metalManager = nullptr;
 	energyGrid = nullptr;
+	featureData = nullptr;
 	defence = nullptr;
+	threatData = nullptr;
 	pathfinder = nullptr;
 	factoryData = nullptr;
 }
@@ -103,6 +122,11 @@ void CAllyTeam::UpdateFriendlyUnits(CCircuitAI* circuit)
 		delete kv.second;
 	}
 	friendlyUnits.clear();
+	for (std::vector<CAllyUnit*>& cell : cells) {
+		cell.clear();
+	}
+	maxUnitRadius = .0f;
+	const int frame = circuit->GetLastFrame();
 	const std::vector<Unit*>& units = circuit->GetCallback()->GetFriendlyUnits();
 	for (Unit* u : units) {
 		// FIXME: Why engine returns vector with some nullptrs?
@@ -115,8 +139,33 @@ void CAllyTeam::UpdateFriendlyUnits(CCircuitAI* circuit)
 		CAllyUnit* unit = new CAllyUnit(unitId, u, circuit->GetCircuitDef(unitDef->GetUnitDefId()));
 		delete unitDef;
 		friendlyUnits[unitId] = unit;
+		maxUnitRadius = std::max(maxUnitRadius, unit->GetCircuitDef()->GetRadius());
+
+		const AIFloat3& pos = unit->GetPos(frame);
+		const int x = utils::clamp(int(pos.x) / cellSize, 0, cellXSize - 1);
+		const int z = utils::clamp(int(pos.z) / cellSize, 0, cellZSize - 1);
+		cells[z * cellXSize + x].push_back(unit);
+	}
+	lastUpdate = frame;
+}
+
+void CAllyTeam::GetFriendlyUnitsIn(const AIFloat3& pos, float radius, std::vector<CAllyUnit*>& outUnits) const
+{
+	// Same as engine: unit is inside if its footprint circle touches the query circle
+	const float range = radius + maxUnitRadius;
+	const int x0 = utils::clamp(int(pos.x - range) / cellSize, 0, cellXSize - 1);
+	const int x1 = utils::clamp(int(pos.x + range) / cellSize, 0, cellXSize - 1);
+	const int z0 = utils::clamp(int(pos.z - range) / cellSize, 0, cellZSize - 1);
+	const int z1 = utils::clamp(int(pos.z + range) / cellSize, 0, cellZSize - 1);
+	for (int z = z0; z <= z1; ++z) {
+		for (int x = x0; x <= x1; ++x) {
+			for (CAllyUnit* unit : cells[z * cellXSize + x]) {
+				if (pos.SqDistance2D(unit->GetPos(lastUpdate)) <= SQUARE(radius + unit->GetCircuitDef()->GetRadius())) {
+					outUnits.push_back(unit);
+				}
+			}
+		}
 	}
-	lastUpdate = circuit->GetLastFrame();
 }
 
 CAllyUnit* CAllyTeam::GetFriendlyUnit(ICoreUnit::Id unitId) const
@@ -150,6 +199,10 @@ void CAllyTeam::DelegateAuthority(CCircuitAI* curOwner)
 		if (circuit->IsInitialized() && (circuit != curOwner) && (circuit->GetAllyTeamId() == curOwner->GetAllyTeamId())) {
 			metalManager->SetAuthority(circuit);
 			energyGrid->SetAuthority(circuit);
+			featureData->SetAuthority(circuit);
+			threatData->SetAuthority(circuit);
+			defence->SetAuthority(circuit);
+			circuit->GetThreatMap()->Restamp();
 			circuit->GetScheduler()->RunOnRelease(std::make_shared<CGameTask>(&CAllyTeam::DelegateAuthority, this, circuit));
 			break;
 		}
@@ -13,6 +13,7 @@
 #include <memory>
 #include <map>
 #include <unordered_set>
+#include <vector>
 
 namespace springai {
 	class AIFloat3;
@@ -23,7 +24,9 @@ namespace circuit {
 class CCircuitAI;
 class CMetalManager;
 class CEnergyGrid;
+class CFeatureData;
 class CDefenceMatrix;
+class CThreatData;
 class CPathFinder;
 class CFactoryData;
 
@@ -66,10 +69,14 @@ public:
 	void UpdateFriendlyUnits(CCircuitAI* circuit);
 	CAllyUnit* GetFriendlyUnit(ICoreUnit::Id unitId) const;
 	const Units& GetFriendlyUnits() const { return friendlyUnits; }
+	// Units of last UpdateFriendlyUnits that touch the circle, appended to outUnits
+	void GetFriendlyUnitsIn(const springai::AIFloat3& pos, float radius, std::vector<CAllyUnit*>& outUnits) const;
 
 	std::shared_ptr<CMetalManager>& GetMetalManager() { return metalManager; }
 	std::shared_ptr<CEnergyGrid>& GetEnergyGrid() { return energyGrid; }
+	std::shared_ptr<CFeatureData>& GetFeatureData() { return featureData; }
 	std::shared_ptr<CDefenceMatrix>& GetDefenceMatrix() { return defence; }
+	std::shared_ptr<CThreatData>& GetThreatData() { return threatData; }
 	std::shared_ptr<CPathFinder>& GetPathfinder() { return pathfinder; }
 	std::shared_ptr<CFactoryData>& GetFactoryData() { return factoryData; }
 
@@ -86,12 +93,19 @@ private:
 	int resignSize;
 	int lastUpdate;
 	Units friendlyUnits;  // owner
+	int cellSize;
+	int cellXSize;
+	int cellZSize;
+	std::vector<std::vector<CAllyUnit*>> cells;  // spatial hash of friendlyUnits
+	float maxUnitRadius;  // of friendlyUnits, extends cell range of query
 
 	std::map<int, SClusterTeam> occupants;  // Cluster owner on start. clusterId: SClusterTeam
 
 	std::shared_ptr<CMetalManager> metalManager;
 	std::shared_ptr<CEnergyGrid> energyGrid;
+	std::shared_ptr<CFeatureData> featureData;
 	std::shared_ptr<CDefenceMatrix> defence;
+	std::shared_ptr<CThreatData> threatData;
 	std::shared_ptr<CPathFinder> pathfinder;
 	std::shared_ptr<CFactoryData> factoryData;
 };
@@ -13,11 +13,16 @@ namespace circuit {
 
 using namespace springai;
 
+unsigned CAllyUnit::propsStamp = 0;
+
 CAllyUnit::CAllyUnit(Id unitId, springai::Unit* unit, CCircuitDef* cdef)
 		: ICoreUnit(unitId, unit, cdef)
 		, task(nullptr)
 		, posFrame(-1)
 {
+	props.frame = -1;
+	props.stamp = 0;
+	props.mask = 0;
 }
 
 CAllyUnit::~CAllyUnit()
@@ -35,4 +40,48 @@ const AIFloat3& CAllyUnit::GetPos(int frame)
 	return position;
 }
 
+float CAllyUnit::GetHealth(int frame)
+{
+	if (!IsPropValid(frame, PropMask::HEALTH)) {
+		props.health = unit->GetHealth();
+	}
+	return props.health;
+}
+
+float CAllyUnit::GetMaxHealth(int frame)
+{
+	if (!IsPropValid(frame, PropMask::MAX_HEALTH)) {
+		props.maxHealth = unit->GetMaxHealth();
+	}
+	return props.maxHealth;
+}
+
+const AIFloat3& CAllyUnit::GetVel(int frame)
+{
+	if (!IsPropValid(frame, PropMask::VEL)) {
+		props.vel = unit->GetVel();
+	}
+	return props.vel;
+}
+
+bool CAllyUnit::IsBeingBuilt(int frame)
+{
+	if (!IsPropValid(frame, PropMask::BUILT)) {
+		props.isBeingBuilt = unit->IsBeingBuilt();
+	}
+	return props.isBeingBuilt;
+}
+
+bool CAllyUnit::IsPropValid(int frame, PropMask prop)
+{
+	if ((props.frame != frame) || (props.stamp != propsStamp)) {
+		props.frame = frame;
+		props.stamp = propsStamp;
+		props.mask = 0;
+	}
+	const bool isValid = (props.mask & prop) != 0;
+	props.mask |= prop;
+	return isValid;
+}
+
 } // namespace circuit
@@ -24,11 +24,34 @@ public:
 	IUnitTask* GetTask() const { return task; }
 	const springai::AIFloat3& GetPos(int frame);
 
+	// Properties are read from engine once per frame and event
+	float GetHealth(int frame);
+	float GetMaxHealth(int frame);
+	const springai::AIFloat3& GetVel(int frame);
+	bool IsBeingBuilt(int frame);
+	// Repair, Lua and other units change engine state between events of the same frame
+	static void ClearAllProps() { ++propsStamp; }
+
 protected:
 	IUnitTask* task;  // nullptr - ally or no handler (unable to control).
 
 	int posFrame;
 	springai::AIFloat3 position;
+
+private:
+	enum PropMask: unsigned char {HEALTH = 0x01, MAX_HEALTH = 0x02, VEL = 0x04, BUILT = 0x08};
+	struct SProps {
+		int frame;
+		unsigned stamp;
+		unsigned char mask;  // valid properties of the frame and stamp
+		bool isBeingBuilt;
+		float health;
+		float maxHealth;
+		springai::AIFloat3 vel;
+	} props;
+	bool IsPropValid(int frame, PropMask prop);
+
+	static unsigned propsStamp;
 };
 
 } // namespace circuit
@@ -101,6 +101,7 @@ CCircuitDef::CCircuitDef(CCircuitAI* circuit, UnitDef* def, std::unordered_set<I
 		, retreat(-1.f)
 		, height(-1.f)
 		, topOffset(-1.f)
+		, radius(-1.f)
 {
 	id = def->GetUnitDefId();
 
@@ -496,4 +497,12 @@ bool CCircuitDef::IsYTargetable(float elevation, float posY) {
 	return (elevation > -height || posY > -topOffset);
 }
 
+float CCircuitDef::GetRadius()
+{
+	if (radius < 0.f) {
+		radius = def->GetRadius();  // Forces loading of the unit model
+	}
+	return radius;
+}
+
 } // namespace circuit
@@ -85,10 +85,12 @@ public:
 	void SetMainRole(RoleType type) { mainRole = type; }
 	RoleT GetMainRole() const { return static_cast<RoleT>(mainRole); }
 	void AddEnemyRole(RoleType type) { enemyRole |= GetMask(static_cast<RoleT>(type)); }
+	void AddEnemyRoles(RoleM mask) { enemyRole |= mask; }
 	bool IsEnemyRoleAny(RoleM value) const { return (enemyRole & value) != 0; }
 
 	void AddAttribute(AttrType type) { role |= GetMask(static_cast<RoleT>(type)); }
 	void AddRole(RoleType type) { role |= GetMask(static_cast<RoleT>(type)); }
+	void AddRoles(RoleM mask) { role |= mask; }
 	bool IsRoleAny(RoleM value)     const { return (role & value) != 0; }
 	bool IsRoleEqual(RoleM value)   const { return role == value; }
 	bool IsRoleContain(RoleM value) const { return (role & value) == value; }
@@ -215,6 +217,7 @@ public:
 	float GetRetreat()   const { return retreat; }
 
 	bool IsYTargetable(float elevation, float posY);
+	float GetRadius();
 	const springai::AIFloat3& GetMidPosOffset() const { return midPosOffset; }
 
 private:
@@ -288,6 +291,7 @@ private:
 
 	float height;
 	float topOffset;  // top point offset in water
+	float radius;
 	springai::AIFloat3 midPosOffset;
 };
 
@@ -10,6 +10,7 @@
 #include "unit/EnemyUnit.h"
 #include "setup/SetupManager.h"
 #include "CircuitAI.h"
+#include "util/EventRecorder.h"
 #include "util/utils.h"
 
 #include "Lua/LuaConfig.h"
@@ -17,6 +18,8 @@
 #include "Weapon.h"
 #include "WrappWeaponMount.h"
 
+#include <assert.h>
+
 namespace circuit {
 
 using namespace springai;
@@ -36,6 +39,12 @@ CCircuitUnit::CCircuitUnit(Id unitId, Unit* unit, CCircuitDef* cdef)
 		, isWeaponReady(true)
 		, ammoFrame(-1)
 		, isMorphing(false)
+		, cmdTimeout(-1)
+		, wantedSpeed(NAN)
+		, priority(NAN)
+		, miscPriority(NAN)
+		, fireState(NAN)
+		, moveState(NAN)
 {
 	WeaponMount* wpMnt;
 	if (cdef->IsRoleComm()) {
@@ -76,10 +85,28 @@ CCircuitUnit::~CCircuitUnit()
 	delete shield;
 }
 
+void* CCircuitUnit::operator new(std::size_t size)
+{
+	assert(size == sizeof(CCircuitUnit));
+	return GetPool().Alloc();
+}
+
+void CCircuitUnit::operator delete(void* ptr)
+{
+	GetPool().Free(ptr);
+}
+
+CObjectPool<CCircuitUnit>& CCircuitUnit::GetPool()
+{
+	static CObjectPool<CCircuitUnit> pool("CCircuitUnit");
+	return pool;
+}
+
 void CCircuitUnit::SetTask(IUnitTask* task)
 {
 	this->task = task;
 	SetTaskFrame(manager->GetCircuit()->GetLastFrame());
+	CmdClear();
 }
 
 bool CCircuitUnit::IsMoveFailed(int frame)
@@ -189,7 +216,8 @@ float CCircuitUnit::GetDGunRange()
 
 float CCircuitUnit::GetHealthPercent()
 {
-	return unit->GetHealth() / unit->GetMaxHealth() - unit->GetCaptureProgress() * 16.f;
+	const int frame = manager->GetCircuit()->GetLastFrame();
+	return GetHealth(frame) / GetMaxHealth(frame) - unit->GetCaptureProgress() * 16.f;
 }
 
 void CCircuitUnit::Attack(CEnemyUnit* target, int timeout)
@@ -208,7 +236,8 @@ void CCircuitUnit::Attack(CEnemyUnit* target, int timeout)
 			unit->Attack(target->GetUnit(), UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, timeout);
 		}
 		unit->Fight(pos, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY | UNIT_COMMAND_OPTION_SHIFT_KEY, timeout);  // los-cheat related
-		unit->ExecuteCustomCommand(CMD_WANTED_SPEED, {NO_SPEED_LIMIT});
+		CmdClear();
+		CmdWantedSpeed(NO_SPEED_LIMIT);
 //		unit->ExecuteCustomCommand(CMD_UNIT_SET_TARGET, {(float)target->GetId()});
 	)
 }
@@ -227,7 +256,8 @@ void CCircuitUnit::Attack(const AIFloat3& position, int timeout)
 		} else {
 			unit->Fight(pos, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, timeout);
 		}
-		unit->ExecuteCustomCommand(CMD_WANTED_SPEED, {NO_SPEED_LIMIT});
+		CmdClear();
+		CmdWantedSpeed(NO_SPEED_LIMIT);
 	)
 }
 
@@ -247,7 +277,8 @@ void CCircuitUnit::Attack(const AIFloat3& position, CEnemyUnit* target, int time
 		}
 		unit->Attack(target->GetUnit(), UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY | UNIT_COMMAND_OPTION_SHIFT_KEY, timeout);
 		unit->Fight(position, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY | UNIT_COMMAND_OPTION_SHIFT_KEY, timeout);  // los-cheat related
-		unit->ExecuteCustomCommand(CMD_WANTED_SPEED, {NO_SPEED_LIMIT});
+		CmdClear();
+		CmdWantedSpeed(NO_SPEED_LIMIT);
 //		unit->ExecuteCustomCommand(CMD_UNIT_SET_TARGET, {(float)target->GetId()});
 	)
 }
@@ -256,6 +287,7 @@ void CCircuitUnit::Guard(CCircuitUnit* target, int timeout)
 {
 	TRY_UNIT(manager->GetCircuit(), this,
 		unit->ExecuteCustomCommand(CMD_ORBIT, {(float)target->GetId(), 300.0f}, UNIT_COMMAND_OPTION_INTERNAL_ORDER, timeout);
+		CmdClear();
 //		unit->Guard(target->GetUnit(), UNIT_COMMAND_OPTION_INTERNAL_ORDER, timeout);
 //		unit->ExecuteCustomCommand(CMD_WANTED_SPEED, {NO_SPEED_LIMIT});
 	)
@@ -265,9 +297,9 @@ void CCircuitUnit::Gather(const AIFloat3& groupPos, int timeout)
 {
 	const AIFloat3& pos = utils::get_radial_pos(groupPos, SQUARE_SIZE * 8);
 	TRY_UNIT(manager->GetCircuit(), this,
-		unit->MoveTo(groupPos, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, timeout);
-		unit->ExecuteCustomCommand(CMD_WANTED_SPEED, {NO_SPEED_LIMIT});
-		unit->PatrolTo(pos, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY | UNIT_COMMAND_OPTION_SHIFT_KEY, timeout);
+		CmdMoveTo(groupPos, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, timeout);
+		CmdWantedSpeed(NO_SPEED_LIMIT);
+		CmdPatrolTo(pos, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY | UNIT_COMMAND_OPTION_SHIFT_KEY, timeout);
 	)
 }
 
@@ -276,7 +308,8 @@ void CCircuitUnit::Morph()
 	isMorphing = true;
 	TRY_UNIT(manager->GetCircuit(), this,
 		unit->ExecuteCustomCommand(CMD_MORPH, {});
-		unit->ExecuteCustomCommand(CMD_MISC_PRIORITY, {1.0f});
+		CmdClear();
+		CmdMiscPriority(1.0f);
 	)
 }
 
@@ -285,7 +318,8 @@ void CCircuitUnit::StopMorph()
 	isMorphing = false;
 	TRY_UNIT(manager->GetCircuit(), this,
 		unit->ExecuteCustomCommand(CMD_MORPH_STOP, {});
-		unit->ExecuteCustomCommand(CMD_MISC_PRIORITY, {1.0f});
+		CmdClear();
+		CmdMiscPriority(1.0f);
 	)
 }
 
@@ -339,7 +373,8 @@ void CCircuitUnit::Upgrade()
 
 	TRY_UNIT(manager->GetCircuit(), this,
 		unit->ExecuteCustomCommand(CMD_MORPH_UPGRADE_INTERNAL, upgrade);
-		unit->ExecuteCustomCommand(CMD_MISC_PRIORITY, {1.0f});
+		CmdClear();
+		CmdMiscPriority(1.0f);
 	)
 }
 
@@ -348,8 +383,207 @@ void CCircuitUnit::StopUpgrade()
 	isMorphing = false;
 	TRY_UNIT(manager->GetCircuit(), this,
 		unit->ExecuteCustomCommand(CMD_UPGRADE_STOP, {});
-		unit->ExecuteCustomCommand(CMD_MISC_PRIORITY, {1.0f});
+		CmdClear();
+		CmdMiscPriority(1.0f);
 	)
 }
 
+void CCircuitUnit::CmdMoveTo(const AIFloat3& pos, short options, int timeout)
+{
+	CmdQueue(CmdType::MOVE, &pos, 1, options, timeout, 0);
+}
+
+void CCircuitUnit::CmdFightTo(const AIFloat3& pos, short options, int timeout)
+{
+	CmdQueue(CmdType::FIGHT, &pos, 1, options, timeout, 0);
+}
+
+void CCircuitUnit::CmdPatrolTo(const AIFloat3& pos, short options, int timeout)
+{
+	CmdQueue(CmdType::PATROL, &pos, 1, options, timeout, 0);
+}
+
+void CCircuitUnit::CmdMovePath(const F3Vec& waypoints, short options, int timeout)
+{
+	CmdQueue(CmdType::RAW_MOVE, waypoints.data(), waypoints.size(), options, timeout, 0);
+}
+
+void CCircuitUnit::CmdFightPath(const F3Vec& waypoints, short options, int timeout, int timeoutInc)
+{
+	CmdQueue(CmdType::FIGHT, waypoints.data(), waypoints.size(), options, timeout, timeoutInc);
+}
+
+void CCircuitUnit::CmdWantedSpeed(float speed)
+{
+	if (!IsCmdStateSet(wantedSpeed, speed)) {
+		unit->ExecuteCustomCommand(CMD_WANTED_SPEED, {speed});
+	}
+}
+
+void CCircuitUnit::CmdPriority(float value)
+{
+	if (!IsCmdStateSet(priority, value)) {
+		unit->ExecuteCustomCommand(CMD_PRIORITY, {value});
+	}
+}
+
+void CCircuitUnit::CmdMiscPriority(float value)
+{
+	if (!IsCmdStateSet(miscPriority, value)) {
+		unit->ExecuteCustomCommand(CMD_MISC_PRIORITY, {value});
+	}
+}
+
+void CCircuitUnit::CmdFireState(int state)
+{
+	if (!IsCmdStateSet(fireState, state)) {
+		unit->SetFireState(state);
+	}
+}
+
+void CCircuitUnit::CmdMoveState(int state)
+{
+	if (!IsCmdStateSet(moveState, state)) {
+		unit->SetMoveState(state);
+	}
+}
+
+void CCircuitUnit::CmdClear()
+{
+	cmdShadow.clear();
+	cmdTimeout = -1;  // shadow misses orders of direct queue
+	wantedSpeed = NAN;  // new queue may reset speed limit
+}
+
+void CCircuitUnit::CmdStop()
+{
+	unit->Stop();
+	CmdClear();
+}
+
+void CCircuitUnit::CmdBuild(CCircuitDef* buildDef, const AIFloat3& pos, int facing, short options, int timeout)
+{
+	unit->Build(buildDef->GetUnitDef(), pos, facing, options, timeout);
+	CmdClear();
+}
+
+void CCircuitUnit::CmdRepair(CAllyUnit* target, short options, int timeout)
+{
+	unit->Repair(target->GetUnit(), options, timeout);
+	CmdClear();
+}
+
+void CCircuitUnit::CmdReclaimUnit(Unit* target, short options, int timeout)
+{
+	unit->ReclaimUnit(target, options, timeout);
+	CmdClear();
+}
+
+void CCircuitUnit::CmdReclaimInArea(const AIFloat3& pos, float radius, short options, int timeout)
+{
+	unit->ReclaimInArea(pos, radius, options, timeout);
+	CmdClear();
+}
+
+void CCircuitUnit::CmdGuard(CAllyUnit* target, short options, int timeout)
+{
+	unit->Guard(target->GetUnit(), options, timeout);
+	CmdClear();
+}
+
+void CCircuitUnit::CmdAttack(CEnemyUnit* target, short options, int timeout)
+{
+	unit->Attack(target->GetUnit(), options, timeout);
+	CmdClear();
+}
+
+void CCircuitUnit::CmdCustom(int cmdId, const std::vector<float>& params, short options, int timeout)
+{
+	unit->ExecuteCustomCommand(cmdId, params, options, timeout);
+	CmdClear();
+}
+
+void CCircuitUnit::CmdQueue(CmdType type, const AIFloat3* points, unsigned count, short options, int timeout, int timeoutInc)
+{
+	if (count == 0) {
+		return;
+	}
+	CCircuitAI* circuit = manager->GetCircuit();
+	const int frame = circuit->GetLastFrame();
+
+	// Merge collinear waypoints
+	static std::vector<SCommand> cmds;  // NOTE: micro-opt
+	cmds.clear();
+	unsigned merged = 0;
+	cmds.push_back({type, points[0], options});
+	options |= UNIT_COMMAND_OPTION_SHIFT_KEY;
+	for (unsigned i = 1; i < count; ++i) {
+		if (i + 1 < count) {
+			const AIFloat3 v0 = points[i] - cmds.back().pos;
+			const AIFloat3 v1 = points[i + 1] - points[i];
+			const float cross = v0.x * v1.z - v0.z * v1.x;
+			const float dot = v0.x * v1.x + v0.z * v1.z;
+			if ((dot > 0.f) && (SQUARE(cross) <= SQUARE(0.02f) * v0.SqLength2D() * v1.SqLength2D())) {
+				++merged;
+				continue;
+			}
+		}
+		cmds.push_back({type, points[i], options});
+	}
+
+	// Drop orders that replace shadow by the same queue
+	const bool isAppend = (cmds.front().options & UNIT_COMMAND_OPTION_SHIFT_KEY) != 0;
+	if (!isAppend && (frame < cmdTimeout) && (cmds.size() == cmdShadow.size())
+		&& std::equal(cmds.begin(), cmds.end(), cmdShadow.begin(), [](const SCommand& a, const SCommand& b) {
+			return (a.type == b.type) && (a.options == b.options) && (a.pos == b.pos);
+		}))
+	{
+		circuit->CountCommands(0, cmds.size() + merged, 0);
+		return;
+	}
+
+	if (!isAppend) {
+		CmdClear();
+		cmdTimeout = frame + CMD_SHADOW_FRAMES;
+	}
+	for (unsigned i = 0; i < cmds.size(); ++i) {
+		const int cmdTimeout = timeout + timeoutInc * i;
+		CmdSend(cmds[i], cmdTimeout);
+		cmdShadow.push_back(cmds[i]);
+		this->cmdTimeout = std::min(this->cmdTimeout, cmdTimeout);
+	}
+	circuit->CountCommands(cmds.size(), 0, merged);
+}
+
+void CCircuitUnit::CmdSend(const SCommand& cmd, int timeout)
+{
+	const AIFloat3& pos = cmd.pos;
+	switch (cmd.type) {
+		case CmdType::MOVE: {
+			unit->MoveTo(pos, cmd.options, timeout);
+		} break;
+		case CmdType::RAW_MOVE: {
+			unit->ExecuteCustomCommand(CMD_RAW_MOVE, {pos.x, pos.y, pos.z}, cmd.options, timeout);
+		} break;
+		case CmdType::FIGHT: {
+			unit->Fight(pos, cmd.options, timeout);
+		} break;
+		case CmdType::PATROL: {
+			unit->PatrolTo(pos, cmd.options, timeout);
+		} break;
+	}
+}
+
+bool CCircuitUnit::IsCmdStateSet(float& state, float value)
+{
+	CCircuitAI* circuit = manager->GetCircuit();
+	if (state == value) {
+		circuit->CountCommands(0, 1, 0);
+		return true;
+	}
+	state = value;
+	circuit->CountCommands(1, 0, 0);
+	return false;
+}
+
 } // namespace circuit
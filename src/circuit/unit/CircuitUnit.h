@@ -10,6 +10,11 @@
 
 #include "unit/AllyUnit.h"
 #include "util/ActionList.h"
+#include "util/Defines.h"
+#include "util/ObjectPool.h"
+#include "util/SlotSet.h"
+
+#include <climits>
 
 namespace springai {
 	class Weapon;
@@ -20,6 +25,7 @@ namespace circuit {
 #define TRY_UNIT(c, u, x)	try { x } catch (const std::exception& e) { c->Garbage(u, e.what()); }
 
 #define UNIT_CMD_OPTION				0
+#define CMD_SHADOW_FRAMES			(FRAMES_PER_SEC * 10)
 
 #define CMD_ATTACK_GROUND			20
 #define CMD_RETREAT_ZONE			10001
@@ -51,13 +57,18 @@ class CEnemyUnit;
 class IUnitManager;
 struct STerrainMapArea;
 
-class CCircuitUnit: public CAllyUnit, public CActionList {
+class CCircuitUnit: public CAllyUnit, public CActionList, public ISlotItem {
 public:
 	CCircuitUnit(const CCircuitUnit& that) = delete;
 	CCircuitUnit& operator=(const CCircuitUnit&) = delete;
 	CCircuitUnit(Id unitId, springai::Unit* unit, CCircuitDef* cdef);
 	virtual ~CCircuitUnit();
 
+	static void* operator new(std::size_t size);
+	static void operator delete(void* ptr);
+	static CObjectPool<CCircuitUnit>& GetPool();
+	CMemPool::SHandle GetHandle() const { return GetPool().GetHandle(this); }
+
 	void SetTask(IUnitTask* task);
 	void SetTaskFrame(int frame) { taskFrame = frame; }
 	int GetTaskFrame() const { return taskFrame; }
@@ -108,7 +119,46 @@ public:
 	void StopUpgrade();
 	bool IsMorphing() const { return isMorphing; }
 
+	/*
+	 * Orders through shadow of last issued command queue and unit states: identical orders are dropped,
+	 * collinear waypoints of path are merged. Shadow is cleared on task change, idle, move fail
+	 * and by direct orders below, it expires in CMD_SHADOW_FRAMES regardless of order timeout.
+	 */
+	void CmdMoveTo(const springai::AIFloat3& pos, short options, int timeout);
+	void CmdFightTo(const springai::AIFloat3& pos, short options, int timeout);
+	void CmdPatrolTo(const springai::AIFloat3& pos, short options, int timeout);
+	void CmdMovePath(const F3Vec& waypoints, short options, int timeout);  // CMD_RAW_MOVE
+	void CmdFightPath(const F3Vec& waypoints, short options, int timeout, int timeoutInc);
+	void CmdWantedSpeed(float speed);
+	void CmdPriority(float value);
+	void CmdMiscPriority(float value);
+	void CmdFireState(int state);
+	void CmdMoveState(int state);
+	void CmdClear();
+
+	/*
+	 * Direct orders, clear shadow. Orders must not go through GetUnit(), util/CheckOrders.awk lints it.
+	 */
+	void CmdStop();
+	void CmdBuild(CCircuitDef* buildDef, const springai::AIFloat3& pos, int facing, short options, int timeout);
+	void CmdRepair(CAllyUnit* target, short options, int timeout);
+	void CmdReclaimUnit(springai::Unit* target, short options, int timeout);
+	void CmdReclaimInArea(const springai::AIFloat3& pos, float radius, short options, int timeout);
+	void CmdGuard(CAllyUnit* target, short options = UNIT_CMD_OPTION, int timeout = INT_MAX);
+	void CmdAttack(CEnemyUnit* target, short options, int timeout);
+	void CmdCustom(int cmdId, const std::vector<float>& params, short options = UNIT_CMD_OPTION, int timeout = INT_MAX);
+
 private:
+	enum class CmdType: char {MOVE, RAW_MOVE, FIGHT, PATROL};
+	struct SCommand {
+		CmdType type;
+		springai::AIFloat3 pos;
+		short options;
+	};
+	void CmdQueue(CmdType type, const springai::AIFloat3* points, unsigned count, short options, int timeout, int timeoutInc);
+	void CmdSend(const SCommand& cmd, int timeout);
+	bool IsCmdStateSet(float& state, float value);
+
 	// NOTE: taskFrame assigned on task change and OnUnitIdle to workaround idle spam.
 	//       Proper fix: do not issue any commands OnUnitIdle, delay them until next frame?
 	int taskFrame;
@@ -132,6 +182,14 @@ private:
 	int ammoFrame;
 
 	bool isMorphing;
+
+	std::vector<SCommand> cmdShadow;  // last issued command queue
+	int cmdTimeout;  // frame when shadow expires
+	float wantedSpeed;  // NaN - unknown
+	float priority;
+	float miscPriority;
+	float fireState;
+	float moveState;
 };
 
 } // namespace circuit
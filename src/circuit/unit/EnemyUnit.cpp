@@ -9,6 +9,8 @@
 #include "task/fighter/FighterTask.h"
 #include "util/utils.h"
 
+#include <assert.h>
+
 namespace circuit {
 
 using namespace springai;
@@ -32,6 +34,33 @@ CEnemyUnit::~CEnemyUnit()
 	}
 }
 
+void* CEnemyUnit::operator new(std::size_t size)
+{
+	assert(size == sizeof(CEnemyUnit));
+	return GetPool().Alloc();
+}
+
+void CEnemyUnit::operator delete(void* ptr)
+{
+	GetPool().Free(ptr);
+}
+
+CObjectPool<CEnemyUnit>& CEnemyUnit::GetPool()
+{
+	static CObjectPool<CEnemyUnit> pool("CEnemyUnit");
+	return pool;
+}
+
+void CEnemyUnit::BindTask(IFighterTask* task)
+{
+	tasks.insert(task);
+}
+
+void CEnemyUnit::UnbindTask(IFighterTask* task)
+{
+	tasks.erase(task);
+}
+
 void CEnemyUnit::SetCircuitDef(CCircuitDef* cdef)
 {
 	circuitDef = cdef;
@@ -10,8 +10,8 @@
 
 #include "unit/CoreUnit.h"
 #include "unit/CircuitDef.h"
-
-#include <set>
+#include "util/ObjectPool.h"
+#include "util/SlotSet.h"
 
 namespace circuit {
 
@@ -24,11 +24,16 @@ public:
 	CEnemyUnit(Id unitId, springai::Unit* unit, CCircuitDef* cdef);
 	virtual ~CEnemyUnit();
 
+	static void* operator new(std::size_t size);
+	static void operator delete(void* ptr);
+	static CObjectPool<CEnemyUnit>& GetPool();
+	CMemPool::SHandle GetHandle() const { return GetPool().GetHandle(this); }
+
 	void SetCircuitDef(CCircuitDef* cdef);
 
-	void BindTask(IFighterTask* task) { tasks.insert(task); }
-	void UnbindTask(IFighterTask* task) { tasks.erase(task); }
-	const std::set<IFighterTask*>& GetTasks() const { return tasks; }
+	void BindTask(IFighterTask* task);
+	void UnbindTask(IFighterTask* task);
+	const CSlotSet<IFighterTask>& GetTasks() const { return tasks; }
 
 	void SetLastSeen(int frame) { lastSeen = frame; }
 	int GetLastSeen() const { return lastSeen; }
@@ -54,7 +59,7 @@ public:
 	int GetRange(CCircuitDef::ThreatType t = CCircuitDef::ThreatType::MAX) const { return range[static_cast<CCircuitDef::ThreatT>(t)]; }
 
 private:
-	std::set<IFighterTask*> tasks;
+	CSlotSet<IFighterTask> tasks;
 	int lastSeen;
 
 	float cost;
@@ -43,17 +43,17 @@ void CFightAction::Update(CCircuitAI* circuit)
 	}
 	int step = pathIterator;
 
+	static F3Vec waypoints;  // NOTE: micro-opt
+	waypoints.clear();
+	waypoints.push_back((*pPath)[step]);
+	for (int i = 2; (step < pathMaxIndex) && (i < 4); ++i) {
+		step = std::min(step + increment, pathMaxIndex);
+		waypoints.push_back((*pPath)[step]);
+	}
+
 	TRY_UNIT(circuit, unit,
-		const AIFloat3& pos = (*pPath)[step];
-		unit->GetUnit()->Fight(pos, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
-		unit->GetUnit()->ExecuteCustomCommand(CMD_WANTED_SPEED, {stepSpeed});
-
-		constexpr short options = UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY | UNIT_COMMAND_OPTION_SHIFT_KEY;
-		for (int i = 2; (step < pathMaxIndex) && (i < 4); ++i) {
-			step = std::min(step + increment, pathMaxIndex);
-			const AIFloat3& pos = (*pPath)[step];
-			unit->GetUnit()->Fight(pos, options, frame + FRAMES_PER_SEC * 60 * i);
-		}
+		unit->CmdFightPath(waypoints, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60, FRAMES_PER_SEC * 60);
+		unit->CmdWantedSpeed(stepSpeed);
 	)
 }
 
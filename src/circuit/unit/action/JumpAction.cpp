@@ -47,36 +47,29 @@ void CJumpAction::Update(CCircuitAI* circuit)
 	int step = pathIterator;
 
 	TRY_UNIT(circuit, unit,
+		static F3Vec waypoints;  // NOTE: micro-opt
+		waypoints.clear();
+		short options = UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY;
 		if (unit->IsJumpReady()) {
 			AIFloat3 startPos = unit->GetPos(frame);
 			const float sqRange = SQUARE(unit->GetCircuitDef()->GetJumpRange());
 			for (; (step < pathMaxIndex) && ((*pPath)[step].SqDistance2D(startPos) < sqRange); ++step);
 			const AIFloat3& jumpPos = (*pPath)[std::max(0, step - 1)];
 
-			unit->GetUnit()->ExecuteCustomCommand(CMD_JUMP,
-												  {jumpPos.x, jumpPos.y, jumpPos.z},
-												  UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY,
-												  frame + FRAMES_PER_SEC * 60);
+			unit->CmdCustom(CMD_JUMP,
+							{jumpPos.x, jumpPos.y, jumpPos.z},
+							UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY,
+							frame + FRAMES_PER_SEC * 60);
+			options |= UNIT_COMMAND_OPTION_SHIFT_KEY;
 		} else {
-			const AIFloat3& pos = (*pPath)[step];
-//			unit->GetUnit()->MoveTo(pos, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
-			unit->GetUnit()->ExecuteCustomCommand(CMD_RAW_MOVE,
-												  {pos.x, pos.y, pos.z},
-												  UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY,
-												  frame + FRAMES_PER_SEC * 60);
+			waypoints.push_back((*pPath)[step]);
 		}
-		unit->GetUnit()->ExecuteCustomCommand(CMD_WANTED_SPEED, {stepSpeed});
-
-		constexpr short options = UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY | UNIT_COMMAND_OPTION_SHIFT_KEY;
 		for (int i = 2; (step < pathMaxIndex) && (i < 4); ++i) {
 			step = std::min(step + increment, pathMaxIndex);
-			const AIFloat3& pos = (*pPath)[step];
-//			unit->GetUnit()->MoveTo(pos, options, frame + FRAMES_PER_SEC * 60 * i);
-			unit->GetUnit()->ExecuteCustomCommand(CMD_RAW_MOVE,
-												  {pos.x, pos.y, pos.z},
-												  options,
-												  frame + FRAMES_PER_SEC * 60);
+			waypoints.push_back((*pPath)[step]);
 		}
+		unit->CmdMovePath(waypoints, options, frame + FRAMES_PER_SEC * 60);
+		unit->CmdWantedSpeed(stepSpeed);
 	)
 }
 
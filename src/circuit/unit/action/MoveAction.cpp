@@ -43,25 +43,17 @@ void CMoveAction::Update(CCircuitAI* circuit)
 	}
 	int step = pathIterator;
 
-	TRY_UNIT(circuit, unit,
-		const AIFloat3& pos = (*pPath)[step];
-//		unit->GetUnit()->MoveTo(pos, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
-		unit->GetUnit()->ExecuteCustomCommand(CMD_RAW_MOVE,
-											  {pos.x, pos.y, pos.z},
-											  UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY,
-											  frame + FRAMES_PER_SEC * 60);
-		unit->GetUnit()->ExecuteCustomCommand(CMD_WANTED_SPEED, {stepSpeed});
+	static F3Vec waypoints;  // NOTE: micro-opt
+	waypoints.clear();
+	waypoints.push_back((*pPath)[step]);
+	for (int i = 2; (step < pathMaxIndex) && (i < 4); ++i) {
+		step = std::min(step + increment, pathMaxIndex);
+		waypoints.push_back((*pPath)[step]);
+	}
 
-		constexpr short options = UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY | UNIT_COMMAND_OPTION_SHIFT_KEY;
-		for (int i = 2; (step < pathMaxIndex) && (i < 4); ++i) {
-			step = std::min(step + increment, pathMaxIndex);
-			const AIFloat3& pos = (*pPath)[step];
-//			unit->GetUnit()->MoveTo(pos, options, frame + FRAMES_PER_SEC * 60 * i);
-			unit->GetUnit()->ExecuteCustomCommand(CMD_RAW_MOVE,
-												  {pos.x, pos.y, pos.z},
-												  options,
-												  frame + FRAMES_PER_SEC * 60);
-		}
+	TRY_UNIT(circuit, unit,
+		unit->CmdMovePath(waypoints, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
+		unit->CmdWantedSpeed(stepSpeed);
 	)
 }
 
@@ -45,9 +45,9 @@ void CSupportAction::Update(CCircuitAI* circuit)
 	const AIFloat3& pos = leader->GetPos(frame);
 	TRY_UNIT(circuit, unit,
 		if (unit->GetCircuitDef()->IsAttrMelee()) {
-			unit->GetUnit()->Guard(leader->GetUnit());
+			unit->CmdGuard(leader);
 		} else {
-			unit->GetUnit()->Fight(pos, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
+			unit->CmdFightTo(pos, UNIT_COMMAND_OPTION_RIGHT_MOUSE_KEY, frame + FRAMES_PER_SEC * 60);
 		}
 	)
 }
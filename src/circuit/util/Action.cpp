@@ -22,6 +22,12 @@ IAction::~IAction()
 {
 }
 
+CSizedPool& IAction::GetPool()
+{
+	static CSizedPool pool("IAction");
+	return pool;
+}
+
 void IAction::OnStart()
 {
 }
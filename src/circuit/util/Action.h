@@ -9,6 +9,8 @@
 #ifndef SRC_CIRCUIT_UTIL_ACTION_H_
 #define SRC_CIRCUIT_UTIL_ACTION_H_
 
+#include "util/ObjectPool.h"
+
 namespace circuit {
 
 class CActionList;
@@ -20,6 +22,10 @@ protected:
 public:
 	virtual ~IAction();
 
+	static void* operator new(std::size_t size) { return GetPool().Alloc(size); }
+	static void operator delete(void* ptr, std::size_t size) { GetPool().Free(ptr, size); }
+	static CSizedPool& GetPool();
+
 	virtual void Update(CCircuitAI* circuit) = 0;
 	virtual void OnStart();
 	virtual void OnEnd();
@@ -0,0 +1,415 @@
+/*
+ * CallbackProxy.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#include "util/CallbackProxy.h"
+#include "util/EventRecorder.h"
+#include "util/utils.h"
+
+#include "AISCommands.h"
+
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace circuit {
+
+#define MAX_PROXIES	256  // engine allows less skirmish AIs
+#define MAX_STRINGS	256
+
+CCallbackProxy* CCallbackProxy::proxies[MAX_PROXIES] = {nullptr};
+
+namespace {
+
+using Expand = int[];
+
+template<typename T> struct SValue {
+	static void Write(std::string& data, const T& value) {
+		data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+	static T Read(CCallbackProxy* proxy, const std::string& data, std::size_t& pos) {
+		T value = T();
+		if (pos + sizeof(T) <= data.size()) {
+			memcpy(&value, data.data() + pos, sizeof(T));
+		}
+		pos += sizeof(T);
+		return value;
+	}
+};
+
+constexpr uint32_t NULL_SIZE = -1;  // size of nullptr string
+
+template<> struct SValue<const char*> {
+	static void Write(std::string& data, const char* value) {
+		if (value == nullptr) {
+			SValue<uint32_t>::Write(data, NULL_SIZE);
+			return;
+		}
+		const uint32_t size = strlen(value);
+		SValue<uint32_t>::Write(data, size);
+		data.append(value, size);
+	}
+	static const char* Read(CCallbackProxy* proxy, const std::string& data, std::size_t& pos) {
+		const uint32_t size = SValue<uint32_t>::Read(proxy, data, pos);
+		if (size == NULL_SIZE) {
+			return nullptr;
+		}
+		if (pos + size > data.size()) {
+			pos = data.size() + 1;
+			return nullptr;
+		}
+		pos += size;
+		return proxy->KeepString(data.substr(pos - size, size));
+	}
+};
+
+/*
+ * Elements of out buffer, Count is the number of elements filled by engine
+ */
+template<typename T> struct SRawElements {
+	static void Write(std::string& data, const T* values, int count) {
+		data.append(reinterpret_cast<const char*>(values), sizeof(T) * count);
+	}
+	static bool Read(CCallbackProxy* proxy, const std::string& data, std::size_t& pos, T* values, int count) {
+		if (pos + sizeof(T) * count > data.size()) {
+			return false;
+		}
+		memcpy(values, data.data() + pos, sizeof(T) * count);
+		pos += sizeof(T) * count;
+		return true;
+	}
+};
+
+template<typename T> struct SElements: public SRawElements<T> {
+	static int Count(const T* values, int size, int sizeMax) { return std::min(size, sizeMax); }
+};
+
+template<> struct SElements<char>: public SRawElements<char> {
+	static int Count(const char* values, int size, int sizeMax) { return std::min<int>(strnlen(values, sizeMax) + 1, sizeMax); }
+};
+
+template<> struct SElements<const char*> {
+	static int Count(const char* const* values, int size, int sizeMax) { return std::min(size, sizeMax); }
+	static void Write(std::string& data, const char* const* values, int count) {
+		for (int i = 0; i < count; ++i) {
+			SValue<const char*>::Write(data, values[i]);
+		}
+	}
+	static bool Read(CCallbackProxy* proxy, const std::string& data, std::size_t& pos, const char** values, int count) {
+		for (int i = 0; i < count; ++i) {
+			values[i] = SValue<const char*>::Read(proxy, data, pos);
+		}
+		return pos <= data.size();
+	}
+};
+
+// Input buffer
+template<typename T> struct SElements<const T> {
+	static int Count(const T* values, int size, int sizeMax) { return 0; }
+	static void Write(std::string& data, const T* values, int count) {}
+	static bool Read(CCallbackProxy* proxy, const std::string& data, std::size_t& pos, const T* values, int count) { return true; }
+};
+
+template<typename T> void WriteElements(std::string& data, const T* values, int count)
+{
+	SValue<int>::Write(data, count);
+	if (count > 0) {
+		SElements<T>::Write(data, values, count);
+	}
+}
+
+template<typename T> void ReadElements(CCallbackProxy* proxy, const std::string& data, std::size_t& pos, T* values, int countMax)
+{
+	const int count = SValue<int>::Read(proxy, data, pos);
+	if ((count == 0) && (pos <= data.size())) {
+		return;
+	}
+	if ((count < 0) || (count > countMax) || (values == nullptr)
+		|| !SElements<T>::Read(proxy, data, pos, values, count))
+	{
+		// NOTE: Diverged replay, drop the rest
+		proxy->CountMiss();
+		pos = data.size() + 1;
+	}
+}
+
+/*
+ * Result of hooked function, Count limits filled elements of out array
+ */
+template<typename R> struct SResult {
+	using IsCount = std::integral_constant<bool, std::is_integral<R>::value && !std::is_same<R, bool>::value>;
+	R value = R();
+	template<typename F, typename... Args> void Call(F func, Args... args) { value = func(args...); }
+	void Write(std::string& data) const { SValue<R>::Write(data, value); }
+	void Read(CCallbackProxy* proxy, const std::string& data, std::size_t& pos) { value = SValue<R>::Read(proxy, data, pos); }
+	int Count(int sizeMax) const { return Count(sizeMax, IsCount()); }
+	int Count(int sizeMax, std::true_type) const { return std::max<int>(std::min<int>(value, sizeMax), 0); }
+	int Count(int sizeMax, std::false_type) const { return sizeMax; }
+	R Get() const { return value; }
+};
+
+template<> struct SResult<void> {
+	template<typename F, typename... Args> void Call(F func, Args... args) { func(args...); }
+	void Write(std::string& data) const {}
+	void Read(CCallbackProxy* proxy, const std::string& data, std::size_t& pos) {}
+	int Count(int sizeMax) const { return sizeMax; }
+	void Get() const {}
+};
+
+/*
+ * Out params, A and S are indices of arguments after skirmishAIId
+ */
+template<std::size_t A, std::size_t S, int Stride> struct SOutArray {
+	template<typename R, typename Tuple> static void Write(std::string& data, const SResult<R>& result, const Tuple& args) {
+		using T = typename std::remove_pointer<typename std::tuple_element<A, Tuple>::type>::type;
+		const T* values = std::get<A>(args);
+		const int sizeMax = std::get<S>(args);
+		const int count = (values != nullptr) ? SElements<T>::Count(values, result.Count(sizeMax), sizeMax) : 0;
+		WriteElements<T>(data, values, count * Stride);
+	}
+	template<typename R, typename Tuple> static void Read(CCallbackProxy* proxy, const std::string& data, std::size_t& pos, const SResult<R>& result, const Tuple& args) {
+		ReadElements(proxy, data, pos, std::get<A>(args), std::get<S>(args) * Stride);
+	}
+};
+
+template<std::size_t A, int N> struct SOutFixed {
+	template<typename R, typename Tuple> static void Write(std::string& data, const SResult<R>& result, const Tuple& args) {
+		using T = typename std::remove_pointer<typename std::tuple_element<A, Tuple>::type>::type;
+		const T* values = std::get<A>(args);
+		WriteElements<T>(data, values, (values != nullptr) ? N : 0);
+	}
+	template<typename R, typename Tuple> static void Read(CCallbackProxy* proxy, const std::string& data, std::size_t& pos, const SResult<R>& result, const Tuple& args) {
+		ReadElements(proxy, data, pos, std::get<A>(args), N);
+	}
+};
+
+/*
+ * Hooks are instantiated per callback field, Hook is the id in record file
+ */
+template<typename F, F SSkirmishAICallback::* Field, int Hook, typename... Outs> struct SHook;
+template<typename R, typename... Args, R (*SSkirmishAICallback::* Field)(int, Args...), int Hook, typename... Outs>
+struct SHook<R (*)(int, Args...), Field, Hook, Outs...> {
+	static constexpr bool IS_RECORDED = !std::is_void<R>::value || (sizeof...(Outs) > 0);
+
+	static R Record(int skirmishAIId, Args... args) {
+		CCallbackProxy* proxy = CCallbackProxy::Get(skirmishAIId);
+		SResult<R> result;
+		result.Call(proxy->GetInner()->*Field, skirmishAIId, args...);
+		if (IS_RECORDED) {
+			std::string& data = proxy->BeginQuery();
+			result.Write(data);
+			const std::tuple<Args...> tuple(args...);
+			(void)tuple;
+			(void)Expand{0, (Outs::Write(data, result, tuple), 0)...};
+			proxy->EndQuery(Hook);
+		}
+		return result.Get();
+	}
+	static R Replay(int skirmishAIId, Args... args) {
+		SResult<R> result;
+		if (IS_RECORDED) {
+			CCallbackProxy* proxy = CCallbackProxy::Get(skirmishAIId);
+			const std::string* data = proxy->PopQuery(Hook);
+			if (data != nullptr) {
+				std::size_t pos = 0;
+				result.Read(proxy, *data, pos);
+				const std::tuple<Args...> tuple(args...);
+				(void)tuple;
+				(void)Expand{0, (Outs::Read(proxy, *data, pos, result, tuple), 0)...};
+			}
+		}
+		return result.Get();
+	}
+};
+
+/*
+ * Out fields of command struct: strings, caller buffers of N elements or values
+ */
+template<typename T, int N> struct SField {
+	static void Write(std::string& data, const T& value) { SValue<T>::Write(data, value); }
+	static void Read(CCallbackProxy* proxy, const std::string& data, std::size_t& pos, T& value) { value = SValue<T>::Read(proxy, data, pos); }
+};
+
+template<typename T, int N> struct SField<T*, N> {
+	static void Write(std::string& data, const T* values) { WriteElements<T>(data, values, (values != nullptr) ? N : 0); }
+	static void Read(CCallbackProxy* proxy, const std::string& data, std::size_t& pos, T* values) { ReadElements(proxy, data, pos, values, N); }
+};
+
+template<int N> struct SField<const char*, N> {
+	static void Write(std::string& data, const char* value) { SValue<const char*>::Write(data, value); }
+	static void Read(CCallbackProxy* proxy, const std::string& data, std::size_t& pos, const char*& value) { value = SValue<const char*>::Read(proxy, data, pos); }
+};
+
+template<int N> struct SField<char*, N> {
+	static void Write(std::string& data, const char* value) { SValue<const char*>::Write(data, value); }
+	static void Read(CCallbackProxy* proxy, const std::string& data, std::size_t& pos, char*& value) { value = const_cast<char*>(SValue<const char*>::Read(proxy, data, pos)); }
+};
+
+template<typename S, typename T, T S::* Member, int N> struct SCmdOut {
+	static void Write(std::string& data, const S* cmd) { SField<T, N>::Write(data, cmd->*Member); }
+	static void Read(CCallbackProxy* proxy, const std::string& data, std::size_t& pos, S* cmd) { SField<T, N>::Read(proxy, data, pos, cmd->*Member); }
+};
+
+template<typename S, typename... Outs> struct SCommand {
+	static void Write(std::string& data, const void* commandData) {
+		(void)Expand{0, (Outs::Write(data, static_cast<const S*>(commandData)), 0)...};
+	}
+	static void Read(CCallbackProxy* proxy, const std::string& data, std::size_t& pos, void* commandData) {
+		(void)Expand{0, (Outs::Read(proxy, data, pos, static_cast<S*>(commandData)), 0)...};
+	}
+};
+
+#define CMD_OUT(S, member, count)	SCmdOut<S, decltype(S::member), &S::member, count>
+
+/*
+ * Engine_handleCommand: result and out fields of command
+ */
+static_assert(std::is_same<decltype(SSkirmishAICallback::Engine_handleCommand), int (*)(int, int, int, int, void*)>::value,
+		"Engine_handleCommand signature changed");
+
+struct SCommandHook {
+	static int Record(int skirmishAIId, int toId, int commandId, int commandTopic, void* commandData) {
+		CCallbackProxy* proxy = CCallbackProxy::Get(skirmishAIId);
+		const int result = proxy->GetInner()->Engine_handleCommand(skirmishAIId, toId, commandId, commandTopic, commandData);
+		std::string& data = proxy->BeginQuery();
+		SValue<int>::Write(data, result);
+		switch (commandTopic) {
+#define HOOK(name, ...)
+#define COMMAND(topic, S, ...) case topic: SCommand<S, __VA_ARGS__>::Write(data, commandData); break;
+#include "CallbackHooks.inl"
+#undef HOOK
+#undef COMMAND
+			default: break;
+		}
+		proxy->EndQuery(CCallbackProxy::HOOK_Engine_handleCommand);
+		return result;
+	}
+	static int Replay(int skirmishAIId, int toId, int commandId, int commandTopic, void* commandData) {
+		CCallbackProxy* proxy = CCallbackProxy::Get(skirmishAIId);
+		const std::string* data = proxy->PopQuery(CCallbackProxy::HOOK_Engine_handleCommand);
+		if (data == nullptr) {
+			return 0;
+		}
+		std::size_t pos = 0;
+		const int result = SValue<int>::Read(proxy, *data, pos);
+		switch (commandTopic) {
+#define HOOK(name, ...)
+#define COMMAND(topic, S, ...) case topic: SCommand<S, __VA_ARGS__>::Read(proxy, *data, pos, commandData); break;
+#include "CallbackHooks.inl"
+#undef HOOK
+#undef COMMAND
+			default: break;
+		}
+		return result;
+	}
+};
+
+} // namespace
+
+static_assert(CCallbackProxy::HOOK_COUNT * sizeof(void (*)()) == sizeof(SSkirmishAICallback),
+		"Not every slot of SSkirmishAICallback is hooked, regenerate CallbackHooks.inl");
+
+#define HOOK_FIELD(name)	decltype(SSkirmishAICallback::name), &SSkirmishAICallback::name
+#define OUT_ARRAY(arg, size, stride)	SOutArray<arg, size, stride>
+#define OUT_FIXED(arg, count)	SOutFixed<arg, count>
+#define COMMAND(topic, ...)
+
+CCallbackProxy::CCallbackProxy(int skirmishAIId, const struct SSkirmishAICallback* inner, CEventRecorder* recorder)
+		: skirmishAIId(skirmishAIId)
+		, callback(*inner)
+		, inner(inner)
+		, recorder(recorder)
+		, missCount(0)
+{
+#define HOOK(name, ...) callback.name = &SHook<HOOK_FIELD(name), HOOK_##name, ##__VA_ARGS__>::Record;
+#include "CallbackHooks.inl"
+#undef HOOK
+	callback.Engine_handleCommand = &SCommandHook::Record;
+
+	proxies[skirmishAIId] = this;
+}
+
+CCallbackProxy::CCallbackProxy(int skirmishAIId)
+		: skirmishAIId(skirmishAIId)
+		, inner(nullptr)
+		, recorder(nullptr)
+		, missCount(0)
+{
+#define HOOK(name, ...) callback.name = &SHook<HOOK_FIELD(name), HOOK_##name, ##__VA_ARGS__>::Replay;
+#include "CallbackHooks.inl"
+#undef HOOK
+	callback.Engine_handleCommand = &SCommandHook::Replay;
+
+	proxies[skirmishAIId] = this;
+}
+
+#undef COMMAND
+
+CCallbackProxy::~CCallbackProxy()
+{
+	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
+	if (proxies[skirmishAIId] == this) {
+		proxies[skirmishAIId] = nullptr;
+	}
+}
+
+uint32_t CCallbackProxy::GetSignature()
+{
+	static const char* const layout[] = {
+#define HOOK(name, ...) #name "(" #__VA_ARGS__ ")",
+#define COMMAND(topic, ...) #topic "(" #__VA_ARGS__ ")",
+#include "CallbackHooks.inl"
+#undef HOOK
+#undef COMMAND
+	};
+	uint32_t hash = 2166136261u;  // FNV-1a
+	for (const char* str : layout) {
+		for (; *str != '\0'; ++str) {
+			hash = (hash ^ uint8_t(*str)) * 16777619u;
+		}
+	}
+	return hash;
+}
+
+void CCallbackProxy::EndQuery(int hook)
+{
+	recorder->RecordQuery(hook, query);
+}
+
+void CCallbackProxy::PushQuery(int hook, std::string&& data)
+{
+	queries.push_back({hook, std::move(data)});
+}
+
+const std::string* CCallbackProxy::PopQuery(int hook)
+{
+	// NOTE: Diverged replay drops queries until hook matches
+	while (!queries.empty()) {
+		SQuery& q = queries.front();
+		if (q.hook == hook) {
+			popped = std::move(q.data);
+			queries.pop_front();
+			return &popped;
+		}
+		queries.pop_front();
+		++missCount;
+	}
+	++missCount;
+	return nullptr;
+}
+
+const char* CCallbackProxy::KeepString(std::string&& str)
+{
+	if (strings.size() >= MAX_STRINGS) {
+		strings.pop_front();
+	}
+	strings.push_back(std::move(str));
+	return strings.back().c_str();
+}
+
+} // namespace circuit
@@ -0,0 +1,79 @@
+/*
+ * CallbackProxy.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#ifndef SRC_CIRCUIT_UTIL_CALLBACKPROXY_H_
+#define SRC_CIRCUIT_UTIL_CALLBACKPROXY_H_
+
+#include "SSkirmishAICallback.h"
+
+#include <deque>
+#include <string>
+#include <cstdint>
+
+namespace circuit {
+
+class CEventRecorder;
+
+/*
+ * Copy of engine's C callback with every slot hooked.
+ * Hooks are generated from engine headers by util/CallbackHooks.awk.
+ * Record: hooks forward to engine and write results and out params into event record.
+ * Replay: hooks return recorded results, functions without results do nothing.
+ */
+class CCallbackProxy {
+public:
+	enum HookId: int {
+#define HOOK(name, ...) HOOK_##name,
+#define COMMAND(topic, ...)
+#include "CallbackHooks.inl"
+#undef HOOK
+#undef COMMAND
+		HOOK_COUNT
+	};
+
+	CCallbackProxy(int skirmishAIId, const struct SSkirmishAICallback* inner, CEventRecorder* recorder);  // record
+	CCallbackProxy(int skirmishAIId);  // replay
+	virtual ~CCallbackProxy();
+
+	static CCallbackProxy* Get(int skirmishAIId) { return proxies[skirmishAIId]; }
+	static uint32_t GetSignature();  // of hooks layout, record and replay must match
+	const struct SSkirmishAICallback* GetCallback() const { return &callback; }
+	const struct SSkirmishAICallback* GetInner() const { return inner; }
+
+	// Record
+	std::string& BeginQuery() { query.clear(); return query; }
+	void EndQuery(int hook);
+
+	// Replay
+	void PushQuery(int hook, std::string&& data);
+	const std::string* PopQuery(int hook);
+	const char* KeepString(std::string&& str);
+	void CountMiss() { ++missCount; }
+	unsigned GetMissCount() const { return missCount; }  // hook or size mismatch, no recorded result
+	unsigned GetPendingCount() const { return queries.size(); }
+
+private:
+	static CCallbackProxy* proxies[];
+	int skirmishAIId;
+	struct SSkirmishAICallback callback;
+	const struct SSkirmishAICallback* inner;
+	CEventRecorder* recorder;
+	std::string query;
+
+	struct SQuery {
+		int hook;
+		std::string data;
+	};
+	std::deque<SQuery> queries;
+	std::string popped;  // data of last popped query
+	std::deque<std::string> strings;  // results of string queries, engine keeps them alive too
+	unsigned missCount;
+};
+
+} // namespace circuit
+
+#endif // SRC_CIRCUIT_UTIL_CALLBACKPROXY_H_
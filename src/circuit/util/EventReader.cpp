@@ -0,0 +1,223 @@
+/*
+ * EventReader.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#include "util/EventReader.h"
+#include "util/EventRecorder.h"
+#include "util/CallbackProxy.h"
+#include "util/utils.h"
+
+#include <sstream>
+#include <cstring>
+
+namespace circuit {
+
+using utils::binary_read;
+
+static void ReadString(std::istream& is, std::string& str)
+{
+	uint32_t size = 0;
+	binary_read(is, size);
+	str.resize(size);
+	is.read(&str[0], size);
+}
+
+CEventReader::CEventReader(const std::string& filename)
+		: isValid(false)
+		, skirmishAIId(-1)
+		, pos{.0f, .0f, .0f}
+{
+	memset(&event, 0, sizeof(event));
+	file.open(filename, std::ios::binary);
+	if (!file.is_open()) {
+		return;
+	}
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	uint32_t hookCount = 0;
+	uint32_t signature = 0;
+	int32_t id = -1;
+	binary_read(file, magic);
+	binary_read(file, version);
+	binary_read(file, hookCount);
+	binary_read(file, signature);
+	binary_read(file, id);
+	// NOTE: Hook ids follow engine headers, record and replay must be built against the same engine
+	isValid = file.good() && (magic == RECORD_MAGIC) && (version == RECORD_VERSION)
+			&& (hookCount == CCallbackProxy::HOOK_COUNT) && (signature == CCallbackProxy::GetSignature());
+	skirmishAIId = id;
+}
+
+CEventReader::~CEventReader()
+{
+	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
+}
+
+bool CEventReader::Next(SRecord& record)
+{
+	if (!isValid) {
+		return false;
+	}
+	int32_t frame, topic;
+	float elapsed;
+	uint32_t size;
+	binary_read(file, frame);
+	binary_read(file, topic);
+	binary_read(file, elapsed);
+	binary_read(file, size);
+	if (!file.good()) {
+		return false;
+	}
+	record.frame = frame;
+	record.topic = topic;
+	record.elapsed = elapsed;
+	record.payload.resize(size);
+	file.read(&record.payload[0], size);
+	return file.good();
+}
+
+int CEventReader::GetQueryHook(const SRecord& record, std::string& outData)
+{
+	int32_t hook = -1;
+	if (record.payload.size() < sizeof(hook)) {
+		outData.clear();
+		return hook;
+	}
+	memcpy(&hook, record.payload.data(), sizeof(hook));
+	outData.assign(record.payload, sizeof(hook), std::string::npos);
+	return hook;
+}
+
+/*
+ * Mirror of CEventRecorder::WritePayload
+ */
+const void* CEventReader::MakeEvent(const SRecord& record, const struct SSkirmishAICallback* callback)
+{
+	std::istringstream is(record.payload);
+
+	switch (record.topic) {
+		case EVENT_INIT: {
+			binary_read(is, event.init.skirmishAIId);
+			binary_read(is, event.init.savedGame);
+			event.init.callback = callback;
+		} break;
+		case EVENT_RELEASE: {
+			binary_read(is, event.release.reason);
+		} break;
+		case EVENT_UPDATE: {
+			binary_read(is, event.update.frame);
+		} break;
+		case EVENT_MESSAGE: {
+			binary_read(is, event.message.player);
+			ReadString(is, str);
+			event.message.message = str.c_str();
+		} break;
+		case EVENT_UNIT_CREATED: {
+			binary_read(is, event.unitCreated.unit);
+			binary_read(is, event.unitCreated.builder);
+		} break;
+		case EVENT_UNIT_FINISHED: {
+			binary_read(is, event.unitFinished.unit);
+		} break;
+		case EVENT_UNIT_IDLE: {
+			binary_read(is, event.unitIdle.unit);
+		} break;
+		case EVENT_UNIT_MOVE_FAILED: {
+			binary_read(is, event.unitMoveFailed.unit);
+		} break;
+		case EVENT_UNIT_DAMAGED: {
+			binary_read(is, event.unitDamaged.unit);
+			binary_read(is, event.unitDamaged.attacker);
+			binary_read(is, event.unitDamaged.damage);
+			binary_read(is, pos);
+			event.unitDamaged.dir_posF3 = pos;
+			binary_read(is, event.unitDamaged.weaponDefId);
+			binary_read(is, event.unitDamaged.paralyzer);
+		} break;
+		case EVENT_UNIT_DESTROYED: {
+			binary_read(is, event.unitDestroyed.unit);
+			binary_read(is, event.unitDestroyed.attacker);
+		} break;
+		case EVENT_UNIT_GIVEN: {
+			binary_read(is, event.unitGiven.unitId);
+			binary_read(is, event.unitGiven.oldTeamId);
+			binary_read(is, event.unitGiven.newTeamId);
+		} break;
+		case EVENT_UNIT_CAPTURED: {
+			binary_read(is, event.unitCaptured.unitId);
+			binary_read(is, event.unitCaptured.oldTeamId);
+			binary_read(is, event.unitCaptured.newTeamId);
+		} break;
+		case EVENT_ENEMY_ENTER_LOS: {
+			binary_read(is, event.enemyEnterLos.enemy);
+		} break;
+		case EVENT_ENEMY_LEAVE_LOS: {
+			binary_read(is, event.enemyLeaveLos.enemy);
+		} break;
+		case EVENT_ENEMY_ENTER_RADAR: {
+			binary_read(is, event.enemyEnterRadar.enemy);
+		} break;
+		case EVENT_ENEMY_LEAVE_RADAR: {
+			binary_read(is, event.enemyLeaveRadar.enemy);
+		} break;
+		case EVENT_ENEMY_DAMAGED: {
+			binary_read(is, event.enemyDamaged.enemy);
+			binary_read(is, event.enemyDamaged.attacker);
+			binary_read(is, event.enemyDamaged.damage);
+			binary_read(is, pos);
+			event.enemyDamaged.dir_posF3 = pos;
+			binary_read(is, event.enemyDamaged.weaponDefId);
+			binary_read(is, event.enemyDamaged.paralyzer);
+		} break;
+		case EVENT_ENEMY_DESTROYED: {
+			binary_read(is, event.enemyDestroyed.enemy);
+			binary_read(is, event.enemyDestroyed.attacker);
+		} break;
+		case EVENT_WEAPON_FIRED: {
+			binary_read(is, event.weaponFired.unitId);
+			binary_read(is, event.weaponFired.weaponDefId);
+		} break;
+		case EVENT_PLAYER_COMMAND: {
+			binary_read(is, ids);
+			event.playerCommand.unitIds = ids.data();
+			event.playerCommand.unitIds_size = ids.size();
+			binary_read(is, event.playerCommand.commandTopicId);
+			binary_read(is, event.playerCommand.playerId);
+		} break;
+		case EVENT_SEISMIC_PING: {
+			binary_read(is, pos);
+			event.seismicPing.pos_posF3 = pos;
+			binary_read(is, event.seismicPing.strength);
+		} break;
+		case EVENT_COMMAND_FINISHED: {
+			binary_read(is, event.commandFinished.unitId);
+			binary_read(is, event.commandFinished.commandId);
+			binary_read(is, event.commandFinished.commandTopicId);
+		} break;
+		case EVENT_LOAD: {
+			ReadString(is, str);
+			event.load.file = str.c_str();
+		} break;
+		case EVENT_SAVE: {
+			ReadString(is, str);
+			event.save.file = str.c_str();
+		} break;
+		case EVENT_ENEMY_CREATED: {
+			binary_read(is, event.enemyCreated.enemy);
+		} break;
+		case EVENT_ENEMY_FINISHED: {
+			binary_read(is, event.enemyFinished.enemy);
+		} break;
+		case EVENT_LUA_MESSAGE: {
+			ReadString(is, str);
+			event.luaMessage.inData = str.c_str();
+		} break;
+		default: break;
+	}
+	return &event;
+}
+
+} // namespace circuit
@@ -0,0 +1,84 @@
+/*
+ * EventReader.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#ifndef SRC_CIRCUIT_UTIL_EVENTREADER_H_
+#define SRC_CIRCUIT_UTIL_EVENTREADER_H_
+
+#include "AISEvents.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+struct SSkirmishAICallback;
+
+namespace circuit {
+
+/*
+ * Reads stream of CEventRecorder and rebuilds engine events for replay.
+ */
+class CEventReader {
+public:
+	struct SRecord {
+		int frame;
+		int topic;  // RECORD_QUERY or EVENT_*
+		float elapsed;  // microseconds
+		std::string payload;
+	};
+
+	CEventReader(const std::string& filename);
+	virtual ~CEventReader();
+
+	bool IsValid() const { return isValid; }
+	int GetSkirmishAIId() const { return skirmishAIId; }
+	bool Next(SRecord& record);
+
+	static int GetQueryHook(const SRecord& record, std::string& outData);
+	const void* MakeEvent(const SRecord& record, const struct SSkirmishAICallback* callback);  // valid until next call
+
+private:
+	std::ifstream file;
+	bool isValid;
+	int skirmishAIId;
+
+	union {
+		SInitEvent init;
+		SReleaseEvent release;
+		SUpdateEvent update;
+		SMessageEvent message;
+		SUnitCreatedEvent unitCreated;
+		SUnitFinishedEvent unitFinished;
+		SUnitIdleEvent unitIdle;
+		SUnitMoveFailedEvent unitMoveFailed;
+		SUnitDamagedEvent unitDamaged;
+		SUnitDestroyedEvent unitDestroyed;
+		SUnitGivenEvent unitGiven;
+		SUnitCapturedEvent unitCaptured;
+		SEnemyEnterLOSEvent enemyEnterLos;
+		SEnemyLeaveLOSEvent enemyLeaveLos;
+		SEnemyEnterRadarEvent enemyEnterRadar;
+		SEnemyLeaveRadarEvent enemyLeaveRadar;
+		SEnemyDamagedEvent enemyDamaged;
+		SEnemyDestroyedEvent enemyDestroyed;
+		SWeaponFiredEvent weaponFired;
+		SPlayerCommandEvent playerCommand;
+		SSeismicPingEvent seismicPing;
+		SCommandFinishedEvent commandFinished;
+		SLoadEvent load;
+		SSaveEvent save;
+		SEnemyCreatedEvent enemyCreated;
+		SEnemyFinishedEvent enemyFinished;
+		SLuaMessageEvent luaMessage;
+	} event;
+	std::string str;
+	std::vector<int> ids;
+	float pos[3];
+};
+
+} // namespace circuit
+
+#endif // SRC_CIRCUIT_UTIL_EVENTREADER_H_
@@ -0,0 +1,283 @@
+/*
+ * EventRecorder.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#include "util/EventRecorder.h"
+#include "util/CallbackProxy.h"
+#include "CircuitAI.h"
+#include "util/utils.h"
+
+#include "AISEvents.h"
+#include "SSkirmishAICallback.h"
+
+#include <sstream>
+#include <cstring>
+
+namespace circuit {
+
+CEventRecorder* CEventRecorder::Create(int skirmishAIId, const struct SSkirmishAICallback* callback)
+{
+	const char* value = callback->SkirmishAI_OptionValues_getValueByKey(skirmishAIId, "record");
+	if ((value == nullptr) || (strlen(value) == 0)) {
+		return nullptr;
+	}
+
+	std::string filename = std::string(value) + "-" + utils::int_to_string(skirmishAIId) + ".rec";
+	static const size_t absPath_sizeMax = 2048;
+	char absPath[absPath_sizeMax];
+	if (callback->DataDirs_locatePath(skirmishAIId, absPath, absPath_sizeMax, filename.c_str(), true /*writable*/, true /*create*/, false /*dir*/, false /*common*/)) {
+		filename = absPath;
+	}
+	CEventRecorder* recorder = new CEventRecorder(filename, skirmishAIId, callback);
+	if (!recorder->IsOpen()) {
+		std::string msg = "Can't open event record! (" + filename + ")";
+		callback->Log_log(skirmishAIId, msg.c_str());
+	}
+	return recorder;
+}
+
+CEventRecorder::CEventRecorder(const std::string& filename, int skirmishAIId, const struct SSkirmishAICallback* callback)
+		: frames({0, .0f, .0f})
+		, lastFrame(-1)
+		, frameTime(.0f)
+		, cmdTotal({0, 0, 0})
+		, cmdFrame({0, 0, 0})
+		, cmdMaxSent(0)
+		, cmdFrames(0)
+		, cmdLastFrame(-1)
+{
+	file.open(filename, std::ios::binary | std::ios::trunc);
+	if (file.is_open()) {
+		utils::binary_write(file, (uint32_t)RECORD_MAGIC);
+		utils::binary_write(file, (uint32_t)RECORD_VERSION);
+		utils::binary_write(file, (uint32_t)CCallbackProxy::HOOK_COUNT);
+		utils::binary_write(file, CCallbackProxy::GetSignature());
+		utils::binary_write(file, (int32_t)skirmishAIId);
+	}
+	proxy.reset(new CCallbackProxy(skirmishAIId, callback, this));
+}
+
+CEventRecorder::~CEventRecorder()
+{
+	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
+}
+
+const struct SSkirmishAICallback* CEventRecorder::GetCallback() const
+{
+	return proxy->GetCallback();
+}
+
+void CEventRecorder::Record(int frame, int topic, const void* data, float elapsed)
+{
+	STiming& timing = topics[topic];
+	++timing.count;
+	timing.total += elapsed;
+	timing.max = std::max(timing.max, elapsed);
+
+	if (lastFrame != frame) {
+		if (lastFrame >= 0) {
+			++frames.count;
+			frames.total += frameTime;
+			frames.max = std::max(frames.max, frameTime);
+		}
+		lastFrame = frame;
+		frameTime = .0f;
+	}
+	frameTime += elapsed;
+
+	if (!file.is_open()) {
+		return;
+	}
+	std::ostringstream payload;
+	WritePayload(payload, topic, data);
+	const std::string& str = payload.str();
+	utils::binary_write(file, (int32_t)frame);
+	utils::binary_write(file, (int32_t)topic);
+	utils::binary_write(file, elapsed);
+	utils::binary_write(file, (uint32_t)str.size());
+	file.write(str.data(), str.size());
+}
+
+void CEventRecorder::RecordQuery(int hook, const std::string& data)
+{
+	if (!file.is_open()) {
+		return;
+	}
+	utils::binary_write(file, (int32_t)lastFrame);
+	utils::binary_write(file, (int32_t)RECORD_QUERY);
+	utils::binary_write(file, .0f);
+	utils::binary_write(file, (uint32_t)(sizeof(int32_t) + data.size()));
+	utils::binary_write(file, (int32_t)hook);
+	file.write(data.data(), data.size());
+}
+
+void CEventRecorder::CountCommands(int frame, unsigned sent, unsigned dropped, unsigned merged)
+{
+	if (cmdLastFrame != frame) {
+		cmdMaxSent = std::max(cmdMaxSent, cmdFrame.sent);
+		cmdFrame = {0, 0, 0};
+		cmdLastFrame = frame;
+		++cmdFrames;
+	}
+	cmdFrame.sent += sent;
+	cmdFrame.dropped += dropped;
+	cmdFrame.merged += merged;
+	cmdTotal.sent += sent;
+	cmdTotal.dropped += dropped;
+	cmdTotal.merged += merged;
+}
+
+void CEventRecorder::Report(CCircuitAI* circuit) const
+{
+	const float frameAvg = (frames.count > 0) ? frames.total / frames.count : .0f;
+	circuit->LOG("Events: frames=%u avg=%.1fus max=%.1fus", frames.count, frameAvg, frames.max);
+	for (auto& kv : topics) {
+		const STiming& timing = kv.second;
+		circuit->LOG("\ttopic %i: count=%u avg=%.1fus max=%.1fus",
+				kv.first, timing.count, timing.total / timing.count, timing.max);
+	}
+	const float cmdAvg = (cmdFrames > 0) ? float(cmdTotal.sent) / cmdFrames : .0f;
+	circuit->LOG("Commands: sent=%u dropped=%u merged=%u frames=%u avg=%.1f max=%u",
+			cmdTotal.sent, cmdTotal.dropped, cmdTotal.merged, cmdFrames, cmdAvg, std::max(cmdMaxSent, cmdFrame.sent));
+}
+
+void CEventRecorder::WritePayload(std::ostream& os, int topic, const void* data)
+{
+	using utils::binary_write;
+
+	switch (topic) {
+		case EVENT_INIT: {
+			const SInitEvent* evt = (const SInitEvent*)data;
+			binary_write(os, evt->skirmishAIId);
+			binary_write(os, evt->savedGame);
+		} break;
+		case EVENT_RELEASE: {
+			binary_write(os, ((const SReleaseEvent*)data)->reason);
+		} break;
+		case EVENT_UPDATE: {
+			binary_write(os, ((const SUpdateEvent*)data)->frame);
+		} break;
+		case EVENT_MESSAGE: {
+			const SMessageEvent* evt = (const SMessageEvent*)data;
+			binary_write(os, evt->player);
+			WriteString(os, evt->message);
+		} break;
+		case EVENT_UNIT_CREATED: {
+			const SUnitCreatedEvent* evt = (const SUnitCreatedEvent*)data;
+			binary_write(os, evt->unit);
+			binary_write(os, evt->builder);
+		} break;
+		case EVENT_UNIT_FINISHED: {
+			binary_write(os, ((const SUnitFinishedEvent*)data)->unit);
+		} break;
+		case EVENT_UNIT_IDLE: {
+			binary_write(os, ((const SUnitIdleEvent*)data)->unit);
+		} break;
+		case EVENT_UNIT_MOVE_FAILED: {
+			binary_write(os, ((const SUnitMoveFailedEvent*)data)->unit);
+		} break;
+		case EVENT_UNIT_DAMAGED: {
+			const SUnitDamagedEvent* evt = (const SUnitDamagedEvent*)data;
+			binary_write(os, evt->unit);
+			binary_write(os, evt->attacker);
+			binary_write(os, evt->damage);
+			os.write(reinterpret_cast<const char*>(evt->dir_posF3), sizeof(float) * 3);
+			binary_write(os, evt->weaponDefId);
+			binary_write(os, evt->paralyzer);
+		} break;
+		case EVENT_UNIT_DESTROYED: {
+			const SUnitDestroyedEvent* evt = (const SUnitDestroyedEvent*)data;
+			binary_write(os, evt->unit);
+			binary_write(os, evt->attacker);
+		} break;
+		case EVENT_UNIT_GIVEN: {
+			const SUnitGivenEvent* evt = (const SUnitGivenEvent*)data;
+			binary_write(os, evt->unitId);
+			binary_write(os, evt->oldTeamId);
+			binary_write(os, evt->newTeamId);
+		} break;
+		case EVENT_UNIT_CAPTURED: {
+			const SUnitCapturedEvent* evt = (const SUnitCapturedEvent*)data;
+			binary_write(os, evt->unitId);
+			binary_write(os, evt->oldTeamId);
+			binary_write(os, evt->newTeamId);
+		} break;
+		case EVENT_ENEMY_ENTER_LOS: {
+			binary_write(os, ((const SEnemyEnterLOSEvent*)data)->enemy);
+		} break;
+		case EVENT_ENEMY_LEAVE_LOS: {
+			binary_write(os, ((const SEnemyLeaveLOSEvent*)data)->enemy);
+		} break;
+		case EVENT_ENEMY_ENTER_RADAR: {
+			binary_write(os, ((const SEnemyEnterRadarEvent*)data)->enemy);
+		} break;
+		case EVENT_ENEMY_LEAVE_RADAR: {
+			binary_write(os, ((const SEnemyLeaveRadarEvent*)data)->enemy);
+		} break;
+		case EVENT_ENEMY_DAMAGED: {
+			const SEnemyDamagedEvent* evt = (const SEnemyDamagedEvent*)data;
+			binary_write(os, evt->enemy);
+			binary_write(os, evt->attacker);
+			binary_write(os, evt->damage);
+			os.write(reinterpret_cast<const char*>(evt->dir_posF3), sizeof(float) * 3);
+			binary_write(os, evt->weaponDefId);
+			binary_write(os, evt->paralyzer);
+		} break;
+		case EVENT_ENEMY_DESTROYED: {
+			const SEnemyDestroyedEvent* evt = (const SEnemyDestroyedEvent*)data;
+			binary_write(os, evt->enemy);
+			binary_write(os, evt->attacker);
+		} break;
+		case EVENT_WEAPON_FIRED: {
+			const SWeaponFiredEvent* evt = (const SWeaponFiredEvent*)data;
+			binary_write(os, evt->unitId);
+			binary_write(os, evt->weaponDefId);
+		} break;
+		case EVENT_PLAYER_COMMAND: {
+			const SPlayerCommandEvent* evt = (const SPlayerCommandEvent*)data;
+			binary_write(os, (uint32_t)evt->unitIds_size);
+			os.write(reinterpret_cast<const char*>(evt->unitIds), sizeof(int) * evt->unitIds_size);
+			binary_write(os, evt->commandTopicId);
+			binary_write(os, evt->playerId);
+		} break;
+		case EVENT_SEISMIC_PING: {
+			const SSeismicPingEvent* evt = (const SSeismicPingEvent*)data;
+			os.write(reinterpret_cast<const char*>(evt->pos_posF3), sizeof(float) * 3);
+			binary_write(os, evt->strength);
+		} break;
+		case EVENT_COMMAND_FINISHED: {
+			const SCommandFinishedEvent* evt = (const SCommandFinishedEvent*)data;
+			binary_write(os, evt->unitId);
+			binary_write(os, evt->commandId);
+			binary_write(os, evt->commandTopicId);
+		} break;
+		case EVENT_LOAD: {
+			WriteString(os, ((const SLoadEvent*)data)->file);
+		} break;
+		case EVENT_SAVE: {
+			WriteString(os, ((const SSaveEvent*)data)->file);
+		} break;
+		case EVENT_ENEMY_CREATED: {
+			binary_write(os, ((const SEnemyCreatedEvent*)data)->enemy);
+		} break;
+		case EVENT_ENEMY_FINISHED: {
+			binary_write(os, ((const SEnemyFinishedEvent*)data)->enemy);
+		} break;
+		case EVENT_LUA_MESSAGE: {
+			WriteString(os, ((const SLuaMessageEvent*)data)->inData);
+		} break;
+		default: break;
+	}
+}
+
+void CEventRecorder::WriteString(std::ostream& os, const char* str)
+{
+	const uint32_t size = (str != nullptr) ? strlen(str) : 0;
+	utils::binary_write(os, size);
+	os.write(str, size);
+}
+
+} // namespace circuit
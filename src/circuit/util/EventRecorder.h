@@ -0,0 +1,78 @@
+/*
+ * EventRecorder.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#ifndef SRC_CIRCUIT_UTIL_EVENTRECORDER_H_
+#define SRC_CIRCUIT_UTIL_EVENTRECORDER_H_
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+
+struct SSkirmishAICallback;
+
+namespace circuit {
+
+#define RECORD_MAGIC	0x43455243  // "CREC"
+#define RECORD_VERSION	3
+#define RECORD_QUERY	-1  // topic of callback query result
+
+class CCircuitAI;
+class CCallbackProxy;
+
+/*
+ * Writes engine events with handling time into binary stream.
+ * Header: {uint32 magic, uint32 version, uint32 hook count, uint32 hooks signature, int32 skirmishAIId}.
+ * Record: {int32 frame, int32 topic, float microseconds, uint32 size, payload}.
+ * Payload is topic specific: ids and numbers as is, strings and arrays with uint32 size prefix.
+ * RECORD_QUERY payload: {int32 hook, result}, written before record of event that made the query.
+ */
+class CEventRecorder {
+public:
+	static CEventRecorder* Create(int skirmishAIId, const struct SSkirmishAICallback* callback);  // nullptr if not enabled
+	CEventRecorder(const std::string& filename, int skirmishAIId, const struct SSkirmishAICallback* callback);
+	virtual ~CEventRecorder();
+
+	bool IsOpen() const { return file.is_open(); }
+	const struct SSkirmishAICallback* GetCallback() const;
+	void Record(int frame, int topic, const void* data, float elapsed);
+	void RecordQuery(int hook, const std::string& data);
+	void CountCommands(int frame, unsigned sent, unsigned dropped, unsigned merged);
+	void Report(CCircuitAI* circuit) const;
+
+private:
+	static void WritePayload(std::ostream& os, int topic, const void* data);
+	static void WriteString(std::ostream& os, const char* str);
+
+	struct STiming {
+		unsigned count;
+		float total;
+		float max;
+	};
+
+	std::ofstream file;
+	std::unique_ptr<CCallbackProxy> proxy;
+	std::map<int, STiming> topics;  // key: topic
+	STiming frames;
+	int lastFrame;
+	float frameTime;
+
+	struct SCommands {
+		unsigned sent;
+		unsigned dropped;
+		unsigned merged;
+	};
+	SCommands cmdTotal;
+	SCommands cmdFrame;  // of cmdLastFrame
+	unsigned cmdMaxSent;  // per frame
+	unsigned cmdFrames;  // with orders
+	int cmdLastFrame;
+};
+
+} // namespace circuit
+
+#endif // SRC_CIRCUIT_UTIL_EVENTRECORDER_H_
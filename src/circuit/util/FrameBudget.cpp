@@ -0,0 +1,112 @@
+/*
+ * FrameBudget.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#include "util/FrameBudget.h"
+#include "util/utils.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace circuit {
+
+using clock = std::chrono::steady_clock;
+using microseconds = std::chrono::duration<float, std::micro>;
+
+#define COST_INIT	50.f
+#define COST_ALPHA	0.1f
+
+CFrameBudget::CFrameBudget(int budget)
+		: budget(budget)
+		, frames(0)
+		, overruns(0)
+{
+}
+
+CFrameBudget::~CFrameBudget()
+{
+	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
+	PRINT_DEBUG("Frame budget: %ius frames=%u overruns=%u\n", budget, frames, overruns);
+	for (const SQueue& q : queues) {
+		PRINT_DEBUG("\t%s: items=%u cost=%.1fus\n", q.name, q.items, q.cost);
+	}
+}
+
+void CFrameBudget::AddQueue(const char* name, int priority, int minFrames, int maxFrames,
+							CountFunc count, RunFunc run)
+{
+	SQueue queue = {name, std::max(priority, 1), std::max(minFrames, 1), std::max(maxFrames, minFrames),
+					count, run, .0f, .0f, COST_INIT, 0};
+	auto it = std::upper_bound(queues.begin(), queues.end(), queue, [](const SQueue& a, const SQueue& b) {
+		return a.priority > b.priority;
+	});
+	queues.insert(it, queue);
+}
+
+void CFrameBudget::Process()
+{
+	const clock::time_point t0 = clock::now();
+	++frames;
+
+	// Guaranteed share
+	int weight = 0;
+	for (SQueue& q : queues) {
+		const unsigned count = q.count();
+		if (count == 0) {
+			q.credit = q.debt = .0f;
+			continue;
+		}
+		q.credit = std::min<float>(q.credit + (float)count / q.minFrames, count);
+		q.debt = std::min(q.debt + (float)count / q.maxFrames, q.credit);
+		const unsigned n = q.debt;
+		if (n > 0) {
+			Run(q, n);
+		}
+		if (q.credit >= 1.f) {
+			weight += q.priority;
+		}
+	}
+
+	float spare = budget - microseconds(clock::now() - t0).count();
+	if (spare <= .0f) {
+		++overruns;
+		return;
+	}
+
+	// Spare time by priority and cost
+	for (SQueue& q : queues) {
+		if ((weight <= 0) || (spare <= .0f)) {
+			break;
+		}
+		if (q.credit < 1.f) {
+			continue;
+		}
+		const float share = spare * q.priority / weight;
+		weight -= q.priority;
+		const unsigned n = std::min<float>(q.credit, share / q.cost);
+		if (n > 0) {
+			Run(q, n);
+			spare = budget - microseconds(clock::now() - t0).count();
+		}
+	}
+}
+
+void CFrameBudget::Run(SQueue& queue, unsigned n)
+{
+	const clock::time_point t0 = clock::now();
+	const unsigned done = queue.run(n);
+	const float elapsed = microseconds(clock::now() - t0).count();
+
+	// Short run (cursor wrapped, items removed) keeps the rest for the next call
+	queue.credit = std::max(queue.credit - done, .0f);
+	queue.debt = std::max(queue.debt - done, .0f);
+	if (done > 0) {
+		queue.cost += (elapsed / done - queue.cost) * COST_ALPHA;
+		queue.items += done;
+	}
+}
+
+} // namespace circuit
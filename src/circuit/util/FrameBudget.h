@@ -0,0 +1,60 @@
+/*
+ * FrameBudget.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#ifndef SRC_CIRCUIT_UTIL_FRAMEBUDGET_H_
+#define SRC_CIRCUIT_UTIL_FRAMEBUDGET_H_
+
+#include <functional>
+#include <vector>
+
+namespace circuit {
+
+/*
+ * Divides per-frame time budget among staggered updates.
+ * Each queue keeps own resumable cursor and processes n items per call.
+ * Item is visited at least once per maxFrames regardless of budget (starvation guarantee),
+ * spare time is divided by priority and measured cost, but not more often than once per minFrames.
+ */
+class CFrameBudget {
+public:
+	using CountFunc = std::function<unsigned ()>;
+	using RunFunc = std::function<unsigned (unsigned n)>;  // returns number of processed items
+
+	CFrameBudget(int budget);
+	virtual ~CFrameBudget();
+
+	void SetBudget(int value) { budget = value; }
+	int GetBudget() const { return budget; }  // microseconds
+
+	void AddQueue(const char* name, int priority, int minFrames, int maxFrames, CountFunc count, RunFunc run);
+	void Process();
+
+private:
+	struct SQueue {
+		const char* name;
+		int priority;
+		int minFrames;
+		int maxFrames;
+		CountFunc count;
+		RunFunc run;
+
+		float credit;  // items allowed by minFrames rate
+		float debt;  // items required by maxFrames rate
+		float cost;  // average microseconds per item
+		unsigned items;  // processed total
+	};
+	void Run(SQueue& queue, unsigned n);
+
+	std::vector<SQueue> queues;  // sorted by priority
+	int budget;
+	unsigned frames;
+	unsigned overruns;  // frames where guaranteed share exceeded budget
+};
+
+} // namespace circuit
+
+#endif // SRC_CIRCUIT_UTIL_FRAMEBUDGET_H_
@@ -6,6 +6,7 @@
  */
 
 #include "util/GameAttribute.h"
+#include "setup/ConfigData.h"
 #include "util/utils.h"
 #include "CircuitAI.h"
 
@@ -12,11 +12,14 @@
 #include "resource/MetalData.h"
 #include "terrain/TerrainData.h"
 
+#include <map>
+#include <memory>
 #include <unordered_set>
 
 namespace circuit {
 
 class CCircuitAI;
+class CConfigData;
 
 class CGameAttribute {
 public:
@@ -35,12 +38,16 @@ public:
 	CMetalData& GetMetalData() { return metalData; }
 	CTerrainData& GetTerrainData() { return terrainData; }
 
+	using Configs = std::map<std::string, std::shared_ptr<CConfigData>>;
+	Configs& GetConfigs() { return configs; }
+
 private:
 	bool isGameEnd;
 	Circuits circuits;
 	CSetupData setupData;
 	CMetalData metalData;
 	CTerrainData terrainData;
+	Configs configs;  // key: config source; nullptr if source is missing or malformed
 };
 
 } // namespace circuit
@@ -0,0 +1,143 @@
+/*
+ * ObjectPool.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#include "util/ObjectPool.h"
+#include "util/utils.h"
+
+#include <new>
+
+namespace circuit {
+
+CMemPool::CMemPool(const char* name, std::size_t blockSize, unsigned chunkSize)
+		: name(name)
+		, blockSize(blockSize)
+		, chunkSize(chunkSize)
+		, freeList(nullptr)
+		, used(0)
+		, highWater(0)
+{
+	const std::size_t align = alignof(std::max_align_t);
+	slotSize = HEADER_SIZE + (blockSize + align - 1) / align * align;
+}
+
+CMemPool::~CMemPool()
+{
+	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
+	PRINT_DEBUG("%s pool: block=%u used=%u highWater=%u capacity=%u\n",
+				name, (unsigned)blockSize, used, highWater, GetCapacity());
+}
+
+void* CMemPool::Alloc()
+{
+	if (freeList == nullptr) {
+		Grow();
+	}
+	SHeader* header = freeList;
+	freeList = header->next;
+	header->next = nullptr;
+	++header->generation;  // odd: alive
+
+	if (++used > highWater) {
+		highWater = used;
+	}
+	return reinterpret_cast<char*>(header) + HEADER_SIZE;
+}
+
+void CMemPool::Free(void* ptr)
+{
+	if (ptr == nullptr) {
+		return;
+	}
+	SHeader* header = HeaderOf(ptr);
+	++header->generation;  // even: free, invalidates handles
+	header->next = freeList;
+	freeList = header;
+	--used;
+}
+
+CMemPool::SHandle CMemPool::GetHandle(const void* ptr) const
+{
+	if (ptr == nullptr) {
+		return SHandle();
+	}
+	const SHeader* header = HeaderOf(ptr);
+	return SHandle(header->index, header->generation);
+}
+
+void* CMemPool::Get(const SHandle& handle) const
+{
+	if (handle.index >= GetCapacity()) {
+		return nullptr;
+	}
+	SHeader* header = HeaderAt(handle.index);
+	return (header->generation == handle.generation) ? reinterpret_cast<char*>(header) + HEADER_SIZE : nullptr;
+}
+
+void CMemPool::Grow()
+{
+	const unsigned base = GetCapacity();
+	chunks.emplace_back(new char[chunkSize * slotSize]);
+	// Link in reverse so that lower indices are used first
+	for (unsigned i = chunkSize; i-- > 0;) {
+		SHeader* header = new (chunks.back().get() + i * slotSize) SHeader;
+		header->index = base + i;
+		header->generation = 0;
+		header->next = freeList;
+		freeList = header;
+	}
+}
+
+CSizedPool::CSizedPool(const char* name)
+		: name(name)
+		, heapUsed(0)
+		, used(0)
+		, highWater(0)
+{
+	pools.resize(MAX_SIZE / GRANULE);
+}
+
+CSizedPool::~CSizedPool()
+{
+	PRINT_DEBUG("Execute: %s\n", __PRETTY_FUNCTION__);
+	PRINT_DEBUG("%s pool: used=%u highWater=%u heap=%u\n", name, used, highWater, heapUsed);
+}
+
+void* CSizedPool::Alloc(std::size_t size)
+{
+	void* ptr;
+	if (size > MAX_SIZE) {
+		++heapUsed;
+		ptr = ::operator new(size);
+	} else {
+		std::unique_ptr<CMemPool>& pool = pools[(size - 1) / GRANULE];
+		if (pool == nullptr) {
+			pool.reset(new CMemPool(name, ((size - 1) / GRANULE + 1) * GRANULE, 64));
+		}
+		ptr = pool->Alloc();
+	}
+
+	if (++used > highWater) {
+		highWater = used;
+	}
+	return ptr;
+}
+
+void CSizedPool::Free(void* ptr, std::size_t size)
+{
+	if (ptr == nullptr) {
+		return;
+	}
+	if (size > MAX_SIZE) {
+		--heapUsed;
+		::operator delete(ptr);
+	} else {
+		pools[(size - 1) / GRANULE]->Free(ptr);
+	}
+	--used;
+}
+
+} // namespace circuit
@@ -0,0 +1,120 @@
+/*
+ * ObjectPool.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#ifndef SRC_CIRCUIT_UTIL_OBJECTPOOL_H_
+#define SRC_CIRCUIT_UTIL_OBJECTPOOL_H_
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+
+namespace circuit {
+
+/*
+ * Fixed-size blocks allocated in chunks, memory is reused and never returned to heap until pool dies.
+ * Each slot carries generation incremented on Alloc and Free, odd generation means alive,
+ * so handle to freed (or reused) slot resolves into nullptr.
+ * NOTE: Not thread-safe, use from main thread only.
+ */
+class CMemPool {
+public:
+	struct SHandle {
+		SHandle() : index(-1), generation(0) {}
+		SHandle(unsigned i, unsigned g) : index(i), generation(g) {}
+		bool operator==(const SHandle& o) const { return (index == o.index) && (generation == o.generation); }
+		unsigned index;
+		unsigned generation;
+	};
+
+	CMemPool(const char* name, std::size_t blockSize, unsigned chunkSize = 256);
+	CMemPool(const CMemPool&) = delete;
+	CMemPool& operator=(const CMemPool&) = delete;
+	virtual ~CMemPool();
+
+	void* Alloc();
+	void Free(void* ptr);
+
+	SHandle GetHandle(const void* ptr) const;
+	void* Get(const SHandle& handle) const;
+
+	const char* GetName() const { return name; }
+	std::size_t GetBlockSize() const { return blockSize; }
+	unsigned GetUsed() const { return used; }
+	unsigned GetHighWater() const { return highWater; }
+	unsigned GetCapacity() const { return chunks.size() * chunkSize; }
+
+private:
+	struct SHeader {
+		unsigned index;
+		unsigned generation;
+		SHeader* next;  // free list
+	};
+	static constexpr std::size_t HEADER_SIZE = (sizeof(SHeader) + alignof(std::max_align_t) - 1)
+			/ alignof(std::max_align_t) * alignof(std::max_align_t);
+
+	SHeader* HeaderOf(const void* ptr) const {
+		return reinterpret_cast<SHeader*>(const_cast<char*>(static_cast<const char*>(ptr)) - HEADER_SIZE);
+	}
+	SHeader* HeaderAt(unsigned index) const {
+		return reinterpret_cast<SHeader*>(chunks[index / chunkSize].get() + (index % chunkSize) * slotSize);
+	}
+	void Grow();
+
+	const char* name;
+	std::size_t blockSize;
+	std::size_t slotSize;
+	unsigned chunkSize;
+	std::vector<std::unique_ptr<char[]>> chunks;
+	SHeader* freeList;
+
+	unsigned used;
+	unsigned highWater;
+};
+
+/*
+ * Pool for exactly one type, T must declare class-level operator new/delete that use it
+ */
+template <typename T>
+class CObjectPool: public CMemPool {
+public:
+	CObjectPool(const char* name, unsigned chunkSize = 256) : CMemPool(name, sizeof(T), chunkSize) {}
+
+	T* Get(const SHandle& handle) const { return static_cast<T*>(CMemPool::Get(handle)); }
+};
+
+/*
+ * Size-class pools for polymorphic families (tasks, actions) with class-level operator new/delete.
+ * Blocks larger than MAX_SIZE fall back to global heap.
+ */
+class CSizedPool {
+public:
+	CSizedPool(const char* name);
+	CSizedPool(const CSizedPool&) = delete;
+	CSizedPool& operator=(const CSizedPool&) = delete;
+	virtual ~CSizedPool();
+
+	void* Alloc(std::size_t size);
+	void Free(void* ptr, std::size_t size);
+
+	const char* GetName() const { return name; }
+	unsigned GetUsed() const { return used; }
+	unsigned GetHighWater() const { return highWater; }
+
+private:
+	static constexpr std::size_t GRANULE = 32;
+	static constexpr std::size_t MAX_SIZE = 1024;
+
+	const char* name;
+	std::vector<std::unique_ptr<CMemPool>> pools;  // index: (size - 1) / GRANULE
+	unsigned heapUsed;  // blocks above MAX_SIZE
+	unsigned used;
+	unsigned highWater;
+};
+
+} // namespace circuit
+
+#endif // SRC_CIRCUIT_UTIL_OBJECTPOOL_H_
@@ -0,0 +1,97 @@
+/*
+ * SlotSet.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#ifndef SRC_CIRCUIT_UTIL_SLOTSET_H_
+#define SRC_CIRCUIT_UTIL_SLOTSET_H_
+
+#include <vector>
+
+namespace circuit {
+
+template <typename T> class CSlotSet;
+
+/*
+ * Element of CSlotSet keeps own index within the set.
+ * NOTE: Element can be a member of only one CSlotSet at a time,
+ *       inserting into another set makes it unreachable from the previous one.
+ */
+class ISlotItem {
+	template <typename T> friend class CSlotSet;
+protected:
+	ISlotItem() : slotIndex(-1) {}
+	~ISlotItem() = default;
+private:
+	unsigned slotIndex;
+};
+
+/*
+ * Unordered set of pointers with O(1) insert, erase, contains and contiguous iteration.
+ * Erase swaps with the last element: iterators at and past erased position are invalidated.
+ */
+template <typename T>
+class CSlotSet {
+public:
+	using const_iterator = typename std::vector<T*>::const_iterator;
+	using iterator = const_iterator;
+
+	CSlotSet() = default;
+	CSlotSet(const CSlotSet&) = delete;  // disable copying
+	CSlotSet& operator=(const CSlotSet&) = delete;  // disable assignment
+	CSlotSet(CSlotSet&&) = default;
+	CSlotSet& operator=(CSlotSet&&) = default;
+
+	bool insert(T* item) {
+		if (contains(item)) {
+			return false;
+		}
+		Slot(item) = items.size();
+		items.push_back(item);
+		return true;
+	}
+	template <typename It>
+	void insert(It first, It last) {
+		for (; first != last; ++first) {
+			insert(*first);
+		}
+	}
+	bool erase(T* item) {
+		if (!contains(item)) {
+			return false;
+		}
+		const unsigned index = Slot(item);
+		T* back = items.back();
+		items[index] = back;
+		Slot(back) = index;
+		items.pop_back();
+		return true;
+	}
+	bool contains(const T* item) const {
+		const unsigned index = Slot(item);
+		return (index < items.size()) && (items[index] == item);
+	}
+	const_iterator find(const T* item) const {
+		return contains(item) ? items.begin() + Slot(item) : items.end();
+	}
+	// NOTE: Doesn't touch elements, they may be already deleted
+	void clear() { items.clear(); }
+
+	const_iterator begin() const { return items.begin(); }
+	const_iterator end() const { return items.end(); }
+	T* operator[](unsigned index) const { return items[index]; }
+	unsigned size() const { return items.size(); }
+	bool empty() const { return items.empty(); }
+
+private:
+	static unsigned& Slot(T* item) { return static_cast<ISlotItem*>(item)->slotIndex; }
+	static unsigned Slot(const T* item) { return static_cast<const ISlotItem*>(item)->slotIndex; }
+
+	std::vector<T*> items;
+};
+
+} // namespace circuit
+
+#endif // SRC_CIRCUIT_UTIL_SLOTSET_H_
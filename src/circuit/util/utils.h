@@ -16,7 +16,10 @@
 
 #include <string.h>
 #include <stdarg.h>  // for va_start, etc
+#include <istream>
+#include <ostream>
 #include <memory>    // for std::unique_ptr
+#include <vector>
 //#include <random>
 //#include <iterator>
 
@@ -269,6 +272,43 @@ template<typename T> static inline std::istream& binary_read(std::istream& strea
     return stream.read(reinterpret_cast<char*>(&value), sizeof(T));
 }
 
+// NOTE: T must be trivially copyable
+template<typename T> static inline std::ostream& binary_write(std::ostream& stream, const std::vector<T>& values)
+{
+	const uint32_t size = values.size();
+	binary_write(stream, size);
+	return stream.write(reinterpret_cast<const char*>(values.data()), sizeof(T) * size);
+}
+
+// Bytes left in seekable stream, -1 if unknown
+static inline std::streamoff stream_left(std::istream& stream)
+{
+	const std::streampos pos = stream.tellg();
+	if (pos == std::streampos(-1)) {
+		return -1;
+	}
+	stream.seekg(0, std::ios::end);
+	const std::streamoff left = stream.tellg() - pos;
+	stream.seekg(pos);
+	return left;
+}
+
+template<typename T> static inline std::istream& binary_read(std::istream& stream, std::vector<T>& values)
+{
+	uint32_t size = 0;
+	if (!binary_read(stream, size)) {
+		return stream;
+	}
+	// NOTE: Corrupted size must not allocate beyond the data
+	const std::streamoff left = stream_left(stream);
+	if ((left < 0) || (sizeof(T) * size > (uint64_t)left)) {
+		stream.setstate(std::ios::failbit);
+		return stream;
+	}
+	values.resize(size);
+	return stream.read(reinterpret_cast<char*>(values.data()), sizeof(T) * size);
+}
+
 #ifdef DEBUG_LOG
 	class CScopedTime {
 	public:
@@ -0,0 +1,38 @@
+/*
+ * Check.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#ifndef TEST_CHECK_H_
+#define TEST_CHECK_H_
+
+#include <cmath>
+#include <cstdio>
+
+/*
+ * Minimal assertions for ctest: failures are printed and counted, CHECK_RESULT is the exit code of main.
+ */
+static int checkFailures = 0;
+
+#define CHECK(cond)															\
+	do {																	\
+		if (!(cond)) {														\
+			printf("%s:%i: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);	\
+			++checkFailures;												\
+		}																	\
+	} while (0)
+
+#define CHECK_NEAR(a, b, eps)												\
+	do {																	\
+		if (!(std::fabs((a) - (b)) <= (eps))) {								\
+			printf("%s:%i: CHECK_NEAR(%s, %s) failed: %f != %f\n",			\
+					__FILE__, __LINE__, #a, #b, (double)(a), (double)(b));	\
+			++checkFailures;												\
+		}																	\
+	} while (0)
+
+#define CHECK_RESULT()	((checkFailures == 0) ? 0 : 1)
+
+#endif // TEST_CHECK_H_
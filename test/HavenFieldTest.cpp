@@ -0,0 +1,124 @@
+/*
+ * HavenFieldTest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#include "Check.h"
+#include "Oracle.h"
+#include "terrain/HavenField.h"
+#include "terrain/TerrainData.h"
+
+#include <limits>
+
+using namespace circuit;
+
+static const int SIZE_X = 17;
+static const int SIZE_Z = 12;
+static const float STEP = 64.f;  // convertStoP
+
+static CTestRandom Random(31337);
+
+// NOTE: TerrainData.cpp is not linked, HavenField reads sector size from CTerrainManager
+int CTerrainData::convertStoP(STEP);
+
+// Dijkstra from single sector, the same 8-neighbour metric
+static std::vector<float> NaiveDist(const STerrainMapMobileType& mobileType, int iS)
+{
+	return NaiveDijkstra(SIZE_X, SIZE_Z, iS, [&mobileType](int from, int to, bool isDiagonal) {
+		return (mobileType.sector[to].area != nullptr) ? (isDiagonal ? 1.4142f : 1.f) * STEP : -1.f;
+	});
+}
+
+static void Build(const STerrainMapMobileType& mobileType, const std::vector<int>& havens, CHavenField::SField& field)
+{
+	field.dist.assign(SIZE_X * SIZE_Z, std::numeric_limits<float>::max());
+	field.source.assign(SIZE_X * SIZE_Z, -1);
+	CHavenField::SQueue queue;
+	for (unsigned i = 0; i < havens.size(); ++i) {
+		CHavenField::SeedSector(&mobileType, field, havens[i], i, queue);
+	}
+	CHavenField::Propagate(&mobileType, field, queue, SIZE_X, SIZE_Z, STEP);
+}
+
+static void CheckField(const STerrainMapMobileType& mobileType, const std::vector<int>& havens,
+		const CHavenField::SField& field)
+{
+	std::vector<std::vector<float>> naive;
+	for (int iS : havens) {
+		naive.push_back((mobileType.sector[iS].area != nullptr) ? NaiveDist(mobileType, iS)
+				: std::vector<float>(SIZE_X * SIZE_Z, std::numeric_limits<float>::max()));
+	}
+	for (int iS = 0; iS < SIZE_X * SIZE_Z; ++iS) {
+		if (mobileType.sector[iS].area == nullptr) {
+			continue;
+		}
+		float best = std::numeric_limits<float>::max();
+		for (const std::vector<float>& dist : naive) {
+			best = std::min(best, dist[iS]);
+		}
+		CHECK_NEAR(field.dist[iS], best, 1e-2f);
+		if (best == std::numeric_limits<float>::max()) {
+			CHECK(field.source[iS] == -1);
+			continue;
+		}
+		// Source is one of the closest havens
+		CHECK((field.source[iS] >= 0) && (naive[field.source[iS]][iS] <= best + 1e-2f));
+
+		// Descent strictly decreases and ends at haven sector
+		int steps = 0;
+		for (int i = iS, next; (next = CHavenField::Descend(field, i, SIZE_X, SIZE_Z)) != i; i = next) {
+			CHECK(field.dist[next] < field.dist[i]);
+			CHECK(mobileType.sector[next].area != nullptr);
+			++steps;
+			if (field.dist[next] == .0f) {
+				break;
+			}
+		}
+		CHECK(steps <= SIZE_X + SIZE_Z);
+	}
+}
+
+int main()
+{
+	STerrainMapMobileType mobileType;
+	STerrainMapArea area(&mobileType);
+	mobileType.sector.resize(SIZE_X * SIZE_Z);
+	for (STerrainMapAreaSector& sector : mobileType.sector) {
+		sector.area = (Random(5) != 0) ? &area : nullptr;
+	}
+	// Wall with single gap splits the map: detour distances
+	for (int z = 0; z < SIZE_Z; ++z) {
+		mobileType.sector[z * SIZE_X + 8].area = (z == 2) ? &area : nullptr;
+	}
+
+	std::vector<int> havens = {3 * SIZE_X + 2, 9 * SIZE_X + 14};
+	CHavenField::SField field;
+	Build(mobileType, havens, field);
+	CheckField(mobileType, havens, field);
+
+	// New haven relaxes built field in place, result equals rebuild
+	havens.push_back(10 * SIZE_X + 3);
+	CHavenField::SQueue queue;
+	CHavenField::SeedSector(&mobileType, field, havens.back(), havens.size() - 1, queue);
+	CHavenField::Propagate(&mobileType, field, queue, SIZE_X, SIZE_Z, STEP);
+	CheckField(mobileType, havens, field);
+	CHavenField::SField rebuilt;
+	Build(mobileType, havens, rebuilt);
+	for (int iS = 0; iS < SIZE_X * SIZE_Z; ++iS) {
+		CHECK_NEAR(field.dist[iS], rebuilt.dist[iS], 1e-2f);
+	}
+
+	// Straight and diagonal steps on open map
+	for (STerrainMapAreaSector& sector : mobileType.sector) {
+		sector.area = &area;
+	}
+	havens = {0};
+	Build(mobileType, havens, field);
+	CHECK_NEAR(field.dist[5], 5 * STEP, 1e-2f);
+	CHECK_NEAR(field.dist[3 * SIZE_X + 3], 3 * 1.4142f * STEP, 1e-2f);
+	CHECK_NEAR(field.dist[2 * SIZE_X + 5], (2 * 1.4142f + 3) * STEP, 1e-2f);
+
+	return CHECK_RESULT();
+}
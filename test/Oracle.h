@@ -0,0 +1,75 @@
+/*
+ * Oracle.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#ifndef TEST_ORACLE_H_
+#define TEST_ORACLE_H_
+
+#include <functional>
+#include <limits>
+#include <queue>
+#include <vector>
+
+/*
+ * Reference implementations shared by tests: reproducible random numbers and naive grid Dijkstra.
+ */
+
+// LCG of C standard, the same sequence on every platform
+class CTestRandom {
+public:
+	CTestRandom(unsigned seed) : seed(seed) {}
+	int operator()(int range) {
+		seed = seed * 1103515245 + 12345;
+		return ((seed >> 16) & 0x7fff) % range;
+	}
+private:
+	unsigned seed;
+};
+
+/*
+ * Distances from source over 8-connected sizeX * sizeZ grid.
+ * stepCost(from, to, isDiagonal) returns cost of the step, negative if the step is blocked.
+ */
+using StepCostFunc = std::function<float (int from, int to, bool isDiagonal)>;
+
+static inline std::vector<float> NaiveDijkstra(int sizeX, int sizeZ, int source, StepCostFunc stepCost)
+{
+	static const int dx[] = {-1, 1, 0, 0, -1, 1, -1, 1};  // straight steps first
+	static const int dz[] = {0, 0, -1, 1, -1, -1, 1, 1};
+	using Node = std::pair<float, int>;
+	std::vector<float> dist(sizeX * sizeZ, std::numeric_limits<float>::max());
+	std::priority_queue<Node, std::vector<Node>, std::greater<Node>> queue;
+	dist[source] = .0f;
+	queue.push(std::make_pair(.0f, source));
+	while (!queue.empty()) {
+		const float d = queue.top().first;
+		const int i = queue.top().second;
+		queue.pop();
+		if (d > dist[i]) {
+			continue;
+		}
+		for (int k = 0; k < 8; ++k) {
+			const int nx = i % sizeX + dx[k];
+			const int nz = i / sizeX + dz[k];
+			if ((nx < 0) || (nx >= sizeX) || (nz < 0) || (nz >= sizeZ)) {
+				continue;
+			}
+			const int ni = nz * sizeX + nx;
+			const float cost = stepCost(i, ni, k > 3);
+			if (cost < .0f) {
+				continue;
+			}
+			const float nd = d + cost;
+			if (nd < dist[ni]) {
+				dist[ni] = nd;
+				queue.push(std::make_pair(nd, ni));
+			}
+		}
+	}
+	return dist;
+}
+
+#endif // TEST_ORACLE_H_
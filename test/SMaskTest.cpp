@@ -0,0 +1,110 @@
+/*
+ * SMaskTest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#include "Check.h"
+#include "Oracle.h"
+#include "resource/MetalData.h"
+
+using namespace circuit;
+using SMask = CMetalData::SMask;
+
+static int NaiveNext(const std::vector<bool>& bits, int index)
+{
+	for (int i = index; i < (int)bits.size(); ++i) {
+		if (bits[i]) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+static SMask MakeMask(const std::vector<bool>& bits)
+{
+	SMask mask;
+	mask.Resize(bits.size(), false);
+	for (unsigned i = 0; i < bits.size(); ++i) {
+		mask.Set(i, bits[i]);
+	}
+	return mask;
+}
+
+int main()
+{
+	const int size = 130;  // 3 words, partial tail
+
+	SMask full;
+	full.Resize(size, true);
+	CHECK(full.Any());
+	CHECK(full.FindNext(0) == 0);
+	CHECK(full.FindNext(64) == 64);
+	CHECK(full.FindNext(size - 1) == size - 1);
+	CHECK(full.FindNext(size) == -1);  // tail bits past size are clear
+	CHECK(full.FindNext(1000) == -1);
+
+	SMask empty;
+	empty.Resize(size, false);
+	CHECK(!empty.Any());
+	CHECK(empty.FindNext(0) == -1);
+
+	// FindNext crosses word boundaries
+	SMask mask;
+	mask.Resize(size, false);
+	mask.Set(5, true);
+	mask.Set(70, true);
+	mask.Set(129, true);
+	CHECK(mask.FindNext(0) == 5);
+	CHECK(mask.FindNext(5) == 5);
+	CHECK(mask.FindNext(6) == 70);
+	CHECK(mask.FindNext(71) == 129);
+	mask.Set(70, false);
+	CHECK(!mask.Test(70));
+	CHECK(mask.FindNext(6) == 129);
+
+	// Or, AndNot, And
+	SMask other;
+	other.Resize(size, false);
+	other.Set(5, true);
+	other.Set(64, true);
+	mask.Or(other);
+	CHECK(mask.Test(5) && mask.Test(64) && mask.Test(129));
+	CHECK(mask.FindNext(6) == 64);
+	mask.AndNot(other);
+	CHECK(!mask.Test(5) && !mask.Test(64) && mask.Test(129));
+	CHECK(mask.FindNext(0) == 129);
+	mask.And(other);
+	CHECK(!mask.Any());
+
+	// Random masks against std::vector<bool>
+	CTestRandom random(777);
+	for (int n = 0; n < 200; ++n) {
+		std::vector<bool> a(size), b(size);
+		for (int i = 0; i < size; ++i) {
+			a[i] = (random(7) == 0);
+			b[i] = (random(3) == 0);
+		}
+		SMask ma = MakeMask(a), mb = MakeMask(b);
+
+		SMask orMask = ma;
+		orMask.Or(mb);
+		SMask andNotMask = ma;
+		andNotMask.AndNot(mb);
+		std::vector<bool> orBits(size), andNotBits(size);
+		for (int i = 0; i < size; ++i) {
+			orBits[i] = a[i] || b[i];
+			andNotBits[i] = a[i] && !b[i];
+		}
+
+		for (int i = 0; i <= size; ++i) {
+			CHECK(ma.FindNext(i) == NaiveNext(a, i));
+			CHECK(orMask.FindNext(i) == NaiveNext(orBits, i));
+			CHECK(andNotMask.FindNext(i) == NaiveNext(andNotBits, i));
+		}
+		CHECK(andNotMask.Any() == (NaiveNext(andNotBits, 0) >= 0));
+	}
+
+	return CHECK_RESULT();
+}
@@ -0,0 +1,70 @@
+/*
+ * SlotSetBench.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+/*
+ * CSlotSet vs std::set on task membership pattern: join, walk all members, leave.
+ * Not a ctest, run manually: circuit-bench-slotset [members] [rounds]
+ */
+
+#include "util/SlotSet.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+
+using namespace circuit;
+
+struct SUnit: public ISlotItem {
+	int health;
+};
+
+template<typename S, typename I, typename E>
+static float Run(std::vector<SUnit>& units, int rounds, long& checksum, I insert, E erase)
+{
+	const auto t0 = std::chrono::steady_clock::now();
+	S members;
+	unsigned seed = 12345;
+	for (int r = 0; r < rounds; ++r) {
+		// Every unit joins, walks, then a random half leaves as task reassigns them
+		for (SUnit& unit : units) {
+			insert(members, &unit);
+		}
+		for (SUnit* unit : members) {
+			checksum += unit->health;
+		}
+		for (unsigned i = 0; i < units.size() / 2; ++i) {
+			seed = seed * 1103515245 + 12345;
+			erase(members, &units[(seed >> 16) % units.size()]);
+		}
+	}
+	const std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - t0;
+	return elapsed.count();
+}
+
+int main(int argc, char* argv[])
+{
+	const int count = (argc > 1) ? atoi(argv[1]) : 200;
+	const int rounds = (argc > 2) ? atoi(argv[2]) : 20000;
+	std::vector<SUnit> units(count);
+	for (int i = 0; i < count; ++i) {
+		units[i].health = i;
+	}
+
+	long sumSlot = 0, sumSet = 0;
+	const float slotTime = Run<CSlotSet<SUnit>>(units, rounds, sumSlot,
+			[](CSlotSet<SUnit>& s, SUnit* u) { s.insert(u); },
+			[](CSlotSet<SUnit>& s, SUnit* u) { s.erase(u); });
+	const float setTime = Run<std::set<SUnit*>>(units, rounds, sumSet,
+			[](std::set<SUnit*>& s, SUnit* u) { s.insert(u); },
+			[](std::set<SUnit*>& s, SUnit* u) { s.erase(u); });
+
+	printf("members=%i rounds=%i\n", count, rounds);
+	printf("\tCSlotSet: %.1fms\n", slotTime);
+	printf("\tstd::set: %.1fms\n", setTime);
+	return (sumSlot == sumSet) ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+/*
+ * SlotSetTest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#include "Check.h"
+#include "util/SlotSet.h"
+
+#include <algorithm>
+#include <set>
+
+using namespace circuit;
+
+struct SItem: public ISlotItem {
+	SItem(int id) : id(id) {}
+	int id;
+};
+
+static bool IsSame(const CSlotSet<SItem>& slots, const std::set<SItem*>& expected)
+{
+	if (slots.size() != expected.size()) {
+		return false;
+	}
+	for (unsigned i = 0; i < slots.size(); ++i) {
+		if ((expected.find(slots[i]) == expected.end()) || !slots.contains(slots[i])) {
+			return false;
+		}
+	}
+	return std::all_of(expected.begin(), expected.end(), [&slots](SItem* item) {
+		return slots.contains(item) && (*slots.find(item) == item);
+	});
+}
+
+int main()
+{
+	SItem a(0), b(1), c(2), d(3);
+	CSlotSet<SItem> slots;
+	CHECK(slots.empty());
+	CHECK(!slots.contains(&a));  // never inserted: slot index is -1
+	CHECK(slots.find(&a) == slots.end());
+
+	CHECK(slots.insert(&a));
+	CHECK(slots.insert(&b));
+	CHECK(slots.insert(&c));
+	CHECK(!slots.insert(&b));  // duplicate
+	CHECK(slots.size() == 3);
+	CHECK(IsSame(slots, {&a, &b, &c}));
+
+	// Erase swaps last into the hole
+	CHECK(slots.erase(&a));
+	CHECK(!slots.erase(&a));
+	CHECK(slots.size() == 2);
+	CHECK(slots[0] == &c);
+	CHECK(IsSame(slots, {&b, &c}));
+
+	// Erase of the last element
+	CHECK(slots.erase(&b));
+	CHECK(IsSame(slots, {&c}));
+	CHECK(slots.insert(&a));
+	CHECK(slots.insert(&d));
+	CHECK(IsSame(slots, {&a, &c, &d}));
+
+	// Stale slot index of erased element must not alias a live one
+	CHECK(slots.erase(&c));
+	CHECK(!slots.contains(&c));
+	CHECK(IsSame(slots, {&a, &d}));
+
+	// Moving the set keeps slot indices valid
+	CSlotSet<SItem> other(std::move(slots));
+	CHECK(IsSame(other, {&a, &d}));
+
+	other.clear();
+	CHECK(other.empty());
+	CHECK(!other.contains(&a));
+	std::vector<SItem*> items = {&a, &b, &a, &c};
+	other.insert(items.begin(), items.end());
+	CHECK(IsSame(other, {&a, &b, &c}));
+
+	// Random churn against std::set
+	std::vector<SItem> pool;
+	for (int i = 0; i < 64; ++i) {
+		pool.emplace_back(i);
+	}
+	CSlotSet<SItem> churn;
+	std::set<SItem*> expected;
+	unsigned seed = 12345;
+	for (int i = 0; i < 10000; ++i) {
+		seed = seed * 1103515245 + 12345;
+		SItem* item = &pool[(seed >> 16) % pool.size()];
+		if ((seed >> 8) & 1) {
+			CHECK(churn.insert(item) == expected.insert(item).second);
+		} else {
+			CHECK(churn.erase(item) == (expected.erase(item) > 0));
+		}
+	}
+	CHECK(IsSame(churn, expected));
+
+	return CHECK_RESULT();
+}
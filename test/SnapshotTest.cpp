@@ -0,0 +1,132 @@
+/*
+ * SnapshotTest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#include "Check.h"
+#include "resource/MetalData.h"
+#include "util/math/RagMatrix.h"
+
+#include <sstream>
+
+using namespace circuit;
+using namespace springai;
+
+/*
+ * CLUSTERS section of snapshot: loaded clusters replace clusterization of the same spots.
+ */
+
+static CMetalData::Metals MakeSpots(int groups)
+{
+	CMetalData::Metals spots;
+	for (int g = 0; g < groups; ++g) {
+		const float cx = 500.f + (g % 3) * 2000.f;
+		const float cz = 500.f + (g / 3) * 2000.f;
+		for (int i = 0; i < 3 + g % 2; ++i) {
+			spots.push_back({1.5f + i * .5f, AIFloat3(cx + i * 90.f, 10.f * g, cz + (i % 2) * 120.f)});
+		}
+	}
+	return spots;
+}
+
+static void Clusterize(CMetalData& metalData)
+{
+	const CMetalData::Metals& spots = metalData.GetSpots();
+	const int nrows = spots.size();
+	std::shared_ptr<CRagMatrix> distMatrix = std::make_shared<CRagMatrix>(nrows);
+	for (int i = 1; i < nrows; ++i) {
+		for (int j = 0; j < i; ++j) {
+			const float dx = spots[i].position.x - spots[j].position.x;
+			const float dz = spots[i].position.z - spots[j].position.z;
+			(*distMatrix)(i, j) = std::sqrt(dx * dx + dz * dz);
+		}
+	}
+	metalData.Clusterize(800.f, distMatrix);
+}
+
+static bool IsSame(const CMetalData& a, const CMetalData& b)
+{
+	const CMetalData::Clusters& ca = a.GetClusters();
+	const CMetalData::Clusters& cb = b.GetClusters();
+	if (ca.size() != cb.size()) {
+		return false;
+	}
+	for (unsigned i = 0; i < ca.size(); ++i) {
+		if ((ca[i].idxSpots != cb[i].idxSpots) || (ca[i].position != cb[i].position)
+			|| (ca[i].weightCentr != cb[i].weightCentr) || (ca[i].income != cb[i].income))
+		{
+			return false;
+		}
+	}
+	return (lemon::countNodes(a.GetGraph()) == lemon::countNodes(b.GetGraph()))
+		&& (lemon::countEdges(a.GetGraph()) == lemon::countEdges(b.GetGraph()));
+}
+
+int main()
+{
+	const CMetalData::Metals spots = MakeSpots(6);
+
+	CMetalData saved;
+	saved.Init(spots);
+	Clusterize(saved);
+	CHECK(saved.GetClusters().size() == 6);
+	std::ostringstream os;
+	saved.SaveClusters(os);
+	const std::string data = os.str();
+
+	// Round-trip
+	CMetalData loaded;
+	loaded.Init(spots);
+	loaded.SetClusterizing(true);
+	std::istringstream is(data);
+	CHECK(loaded.LoadClusters(is));
+	CHECK(!loaded.IsClusterizing());
+	CHECK(IsSame(saved, loaded));
+	for (const CMetalData::SCluster& cluster : saved.GetClusters()) {
+		CHECK(loaded.FindNearestCluster(cluster.position) == saved.FindNearestCluster(cluster.position));
+	}
+
+	// Different metal config: spot count mismatch, clusters untouched
+	CMetalData other;
+	other.Init(MakeSpots(5));
+	Clusterize(other);
+	const CMetalData::Clusters before = other.GetClusters();
+	std::istringstream mismatch(data);
+	CHECK(!other.LoadClusters(mismatch));
+	CHECK(other.GetClusters().size() == before.size());
+
+	// Truncated stream
+	CMetalData truncated;
+	truncated.Init(spots);
+	std::istringstream cut(data.substr(0, data.size() / 2));
+	CHECK(!truncated.LoadClusters(cut));
+	CHECK(truncated.GetClusters().empty());
+
+	// Spot index out of range: first index of first cluster follows 2 counts and vector size
+	std::string corrupt = data;
+	const int32_t badIndex = spots.size();
+	corrupt.replace(3 * sizeof(uint32_t), sizeof(badIndex), reinterpret_cast<const char*>(&badIndex), sizeof(badIndex));
+	CMetalData invalid;
+	invalid.Init(spots);
+	std::istringstream bad(corrupt);
+	CHECK(!invalid.LoadClusters(bad));
+	CHECK(invalid.GetClusters().empty());
+
+	// Corrupted vector size exceeds the data: no allocation, stream fails
+	std::string huge = data;
+	const uint32_t badSize = 0x7fffffff;
+	huge.replace(2 * sizeof(uint32_t), sizeof(badSize), reinterpret_cast<const char*>(&badSize), sizeof(badSize));
+	CMetalData oversized;
+	oversized.Init(spots);
+	std::istringstream over(huge);
+	CHECK(!oversized.LoadClusters(over));
+	CHECK(oversized.GetClusters().empty());
+
+	// Empty stream
+	std::istringstream empty;
+	CHECK(!invalid.LoadClusters(empty));
+
+	return CHECK_RESULT();
+}
@@ -0,0 +1,161 @@
+/*
+ * TargetFieldTest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#include "Check.h"
+#include "Oracle.h"
+#include "terrain/TargetField.h"
+#include "util/Defines.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace circuit;
+
+static const int SIZE_X = 14;
+static const int SIZE_Y = 11;
+static const int offsets[] = {-1, 1, -SIZE_X, SIZE_X, -SIZE_X - 1, -SIZE_X + 1, SIZE_X - 1, SIZE_X + 1};
+
+static CTestRandom Random(99);
+
+static float StepCost(const float* costArray, int k, int to)
+{
+	return (k > 3) ? costArray[to] * SQRT_2 : costArray[to];
+}
+
+// Cost from start to closest end node, the same edge model: cost of entered node
+static float NaiveCost(const bool* moveArray, const float* costArray, const std::vector<int>& endNodes, int start)
+{
+	const std::vector<float> dist = NaiveDijkstra(SIZE_X, SIZE_Y, start, [moveArray, costArray](int from, int to, bool isDiagonal) {
+		return moveArray[to] ? (isDiagonal ? costArray[to] * SQRT_2 : costArray[to]) : -1.f;
+	});
+	float best = std::numeric_limits<float>::max();
+	for (int node : endNodes) {
+		best = std::min(best, dist[node]);
+	}
+	return (best < std::numeric_limits<float>::max()) ? best : -1.f;
+}
+
+// Path is connected, passable after start, ends at a target and costs what FindPath returned
+static bool IsValidPath(const bool* moveArray, const float* costArray, const std::vector<int>& endNodes,
+		int start, const std::vector<int>& path, float cost, bool isSafe)
+{
+	if ((path.size() < 2) || (path.front() != start)
+		|| !std::binary_search(endNodes.begin(), endNodes.end(), path.back()))
+	{
+		return false;
+	}
+	float sum = .0f;
+	bool isIncreased = false;
+	for (unsigned i = 1; i < path.size(); ++i) {
+		if (path[i] == path[i - 1]) {  // start is the target
+			continue;
+		}
+		const int* k = std::find(std::begin(offsets), std::end(offsets), path[i] - path[i - 1]);
+		if ((k == std::end(offsets)) || !moveArray[path[i]]) {
+			return false;
+		}
+		sum += StepCost(costArray, k - offsets, path[i]);
+		const float diff = costArray[path[i]] - costArray[path[i - 1]];
+		if (isSafe && (diff < .0f) && isIncreased) {
+			return false;  // left threat after entering it
+		}
+		isIncreased |= (diff > .0f);
+	}
+	return std::fabs(sum - cost) <= 1e-3f;
+}
+
+int main()
+{
+	const int size = SIZE_X * SIZE_Y;
+	bool moveArray[size];
+	float costArray[size];
+	for (int y = 0; y < SIZE_Y; ++y) {
+		for (int x = 0; x < SIZE_X; ++x) {
+			const bool isEdge = (x == 0) || (y == 0) || (x == SIZE_X - 1) || (y == SIZE_Y - 1);
+			moveArray[y * SIZE_X + x] = !isEdge && (Random(6) != 0);
+			costArray[y * SIZE_X + x] = 1.f + Random(4);
+		}
+	}
+
+	CTargetField targetField(SIZE_X, SIZE_Y);
+	std::vector<int> path;
+	for (int epoch = 0; epoch < 4; ++epoch) {
+		for (int n = 0; n < 40; ++n) {
+			std::vector<int> endNodes;
+			for (int i = Random(4) + 1; i > 0; --i) {
+				endNodes.push_back(Random(size));
+			}
+			std::sort(endNodes.begin(), endNodes.end());
+			endNodes.erase(std::unique(endNodes.begin(), endNodes.end()), endNodes.end());
+			const int start = Random(size);
+			if (!moveArray[start]) {
+				continue;
+			}
+
+			path.clear();
+			const float cost = targetField.FindPath(moveArray, costArray, epoch, false, endNodes, start, path);
+			const float expected = NaiveCost(moveArray, costArray, endNodes, start);
+			CHECK_NEAR(cost, expected, 1e-3f);
+			if (cost >= .0f) {
+				CHECK(IsValidPath(moveArray, costArray, endNodes, start, path, cost, false));
+			} else {
+				CHECK(path.empty());
+			}
+
+			// Safe path is never cheaper and never leaves threat after entering it
+			path.clear();
+			const float safeCost = targetField.FindPath(moveArray, costArray, epoch, true, endNodes, start, path);
+			if (safeCost >= .0f) {
+				CHECK(safeCost >= cost - 1e-3f);
+				CHECK(IsValidPath(moveArray, costArray, endNodes, start, path, safeCost, true));
+			}
+
+			// Cached field of the same epoch gives the same answer
+			path.clear();
+			CHECK(targetField.FindPath(moveArray, costArray, epoch, false, endNodes, start, path) == cost);
+		}
+		// New epoch: costs changed, stale fields must not be reused
+		for (int i = 0; i < size; ++i) {
+			costArray[i] = 1.f + Random(4);
+		}
+	}
+
+	// Shared target set: one field resumed from every start, the others are hits
+	const std::vector<int> sharedNodes = {2 * SIZE_X + 3, 8 * SIZE_X + 11};
+	const unsigned missNum = targetField.GetMissNum();
+	const unsigned hitNum = targetField.GetHitNum();
+	unsigned queryNum = 0;
+	for (int start = size - 1; start >= 0; --start) {
+		if (!moveArray[start]) {
+			continue;
+		}
+		path.clear();
+		CHECK_NEAR(targetField.FindPath(moveArray, costArray, 10, false, sharedNodes, start, path),
+				NaiveCost(moveArray, costArray, sharedNodes, start), 1e-3f);
+		++queryNum;
+	}
+	CHECK(targetField.GetMissNum() == missNum + 1);
+	CHECK(targetField.GetHitNum() == hitNum + queryNum - 1);
+
+	// Blocked start steps into passable neighbour
+	std::fill(moveArray, moveArray + size, false);
+	std::fill(costArray, costArray + size, 1.f);
+	for (int x = 1; x < SIZE_X - 1; ++x) {
+		moveArray[5 * SIZE_X + x] = true;
+	}
+	const std::vector<int> endNodes = {5 * SIZE_X + 10};
+	path.clear();
+	CHECK_NEAR(targetField.FindPath(moveArray, costArray, 100, false, endNodes, 4 * SIZE_X + 2, path), SQRT_2 + 7.f, 1e-3f);  // diagonal onto (3, 5)
+	CHECK((path.size() == 9) && (path.front() == 4 * SIZE_X + 2) && (path.back() == endNodes.front()));
+
+	// Unreachable target
+	path.clear();
+	CHECK(targetField.FindPath(moveArray, costArray, 100, false, {2 * SIZE_X + 2}, 5 * SIZE_X + 3, path) == -1.f);
+	CHECK(path.empty());
+
+	return CHECK_RESULT();
+}
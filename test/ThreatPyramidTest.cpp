@@ -0,0 +1,115 @@
+/*
+ * ThreatPyramidTest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: rlcevg
+ */
+
+#include "Check.h"
+#include "Oracle.h"
+#include "terrain/ThreatPyramid.h"
+
+#include <algorithm>
+
+using namespace circuit;
+
+static const int WIDTH = 37;  // not power of 2: partial blocks at every level
+static const int HEIGHT = 23;
+
+static CTestRandom Random(4242);
+
+static float NaiveRect(const std::vector<float>& layer, int x0, int z0, int x1, int z1)
+{
+	float best = -1.f;
+	for (int z = std::max(z0, 0); z <= std::min(z1, HEIGHT - 1); ++z) {
+		for (int x = std::max(x0, 0); x <= std::min(x1, WIDTH - 1); ++x) {
+			best = std::max(best, layer[z * WIDTH + x]);
+		}
+	}
+	return best;
+}
+
+static float NaiveCircle(const std::vector<float>& layer, int cx, int cz, int radius)
+{
+	float best = -1.f;
+	for (int z = 0; z < HEIGHT; ++z) {
+		for (int x = 0; x < WIDTH; ++x) {
+			if ((x - cx) * (x - cx) + (z - cz) * (z - cz) <= radius * radius) {
+				best = std::max(best, layer[z * WIDTH + x]);
+			}
+		}
+	}
+	return best;
+}
+
+static void CheckQueries(CThreatPyramid& pyramid, const std::vector<float>& layer)
+{
+	for (int n = 0; n < 300; ++n) {
+		const int x0 = Random(WIDTH + 4) - 2;
+		const int z0 = Random(HEIGHT + 4) - 2;
+		const int x1 = x0 + Random(WIDTH);
+		const int z1 = z0 + Random(HEIGHT);
+		CHECK(pyramid.GetMaxInRect(x0, z0, x1, z1) == NaiveRect(layer, x0, z0, x1, z1));
+
+		const int cx = Random(WIDTH);
+		const int cz = Random(HEIGHT);
+		const int radius = Random(20);
+		CHECK(pyramid.GetMaxInCircle(cx, cz, radius) == NaiveCircle(layer, cx, cz, radius));
+	}
+}
+
+int main()
+{
+	std::vector<float> layer(WIDTH * HEIGHT);
+	for (float& threat : layer) {
+		threat = Random(1000) * 0.1f;
+	}
+
+	CThreatPyramid pyramid;
+	pyramid.Init(&layer, WIDTH, HEIGHT);
+	CheckQueries(pyramid, layer);
+
+	// Empty region
+	CHECK(pyramid.GetMaxInRect(WIDTH, 0, WIDTH + 5, 5) == -1.f);
+	CHECK(pyramid.GetMaxInRect(5, 5, 4, 5) == -1.f);
+	// Single cell
+	CHECK(pyramid.GetMaxInRect(36, 22, 36, 22) == layer[22 * WIDTH + 36]);
+	CHECK(pyramid.GetMaxInCircle(3, 4, 0) == layer[4 * WIDTH + 3]);
+
+	// Only dirty rectangle is refreshed: stamp a peak and a hole, then query again
+	layer[10 * WIDTH + 30] = 500.f;
+	pyramid.MarkDirty(30, 10, 31, 11);
+	CHECK(pyramid.GetMaxInRect(0, 0, WIDTH - 1, HEIGHT - 1) == 500.f);
+	for (int z = 8; z < 14; ++z) {
+		for (int x = 28; x < 34; ++x) {
+			layer[z * WIDTH + x] = 0.f;
+		}
+	}
+	pyramid.MarkDirty(28, 8, 34, 14);
+	CHECK(pyramid.GetMaxInRect(28, 8, 33, 13) == 0.f);
+	CheckQueries(pyramid, layer);
+
+	// Safest block within radius is the cold one, radius 12 searches 8x8 blocks
+	std::fill(layer.begin(), layer.end(), 10.f);
+	for (int z = 8; z < 16; ++z) {
+		for (int x = 8; x < 16; ++x) {
+			layer[z * WIDTH + x] = 1.f;
+		}
+	}
+	pyramid.MarkAll();
+	int outX, outZ;
+	pyramid.GetSafest(20, 18, 12, outX, outZ);
+	CHECK((outX >= 8) && (outX < 16) && (outZ >= 8) && (outZ < 16));
+	pyramid.GetSafest(30, 5, 3, outX, outZ);  // cold block out of radius: every block is equal, closest wins
+	CHECK((outX - 30) * (outX - 30) + (outZ - 5) * (outZ - 5) <= 2);
+
+	// Hot rectangle bounds stamps since it was reset
+	int x0, z0, x1, z1;
+	pyramid.SetHotRect(0, 0, 0, 0);
+	pyramid.MarkDirty(4, 6, 9, 7);
+	pyramid.MarkDirty(2, 3, 5, 4);
+	pyramid.GetHotRect(x0, z0, x1, z1);
+	CHECK((x0 == 2) && (z0 == 3) && (x1 == 9) && (z1 == 7));
+
+	return CHECK_RESULT();
+}
@@ -0,0 +1,167 @@
+#!/usr/bin/awk -f
+#
+# Generates CallbackHooks.inl for src/circuit/util/CallbackProxy.cpp
+# usage: awk -f CallbackHooks.awk SSkirmishAICallback.h AISCommands.h > CallbackHooks.inl
+#
+# Every slot of SSkirmishAICallback becomes
+#   HOOK(name [, OUT_ARRAY(arg, sizeArg, stride)] [, OUT_FIXED(arg, count)] ...)
+# arg indices exclude skirmishAIId. Output params follow engine naming:
+#   "<x>, <x>_sizeMax" - array filled up to min(result, sizeMax),
+#                        stride 3 for "*F3"/"*S3" element arrays
+#   "return_*" or "*_out" - fixed buffer, count from F3/S3 suffix
+# Every command struct with ret_* fields becomes
+#   COMMAND(topic, struct, CMD_OUT(struct, field, count) ...)
+# count > 0 for pointers to caller buffer, 0 for values and strings.
+
+function trim(s) {
+	gsub(/^[ \t]+|[ \t]+$/, "", s)
+	return s
+}
+
+function lastIdent(s,    n, parts) {
+	s = trim(s)
+	n = split(s, parts, /[^A-Za-z0-9_]+/)
+	while ((n > 0) && (parts[n] == "")) {
+		n--
+	}
+	return parts[n]
+}
+
+function fixedCount(name) {
+	if (match(name, /[FS][0-9]+_out$/)) {
+		return substr(name, RSTART + 1, RLENGTH - 5) + 0
+	}
+	return 1
+}
+
+# Removes /* */ and // comments, keeps state across lines in inComment
+function stripComments(line,    out, p, q) {
+	out = ""
+	while (line != "") {
+		if (inComment) {
+			p = index(line, "*/")
+			if (p == 0) {
+				return out
+			}
+			line = substr(line, p + 2)
+			inComment = 0
+			continue
+		}
+		p = index(line, "/*")
+		q = index(line, "//")
+		if ((q > 0) && ((p == 0) || (q < p))) {
+			return out substr(line, 1, q - 1)
+		}
+		if (p == 0) {
+			return out line
+		}
+		out = out substr(line, 1, p - 1)
+		line = substr(line, p + 2)
+		inComment = 1
+	}
+	return out
+}
+
+function emitHook(stmt,    name, params, n, args, i, descr, argName) {
+	if (!match(stmt, /\*[ \t]*[A-Za-z0-9_]+[ \t]*\)[ \t]*\(/)) {
+		return
+	}
+	name = substr(stmt, RSTART + 1, RLENGTH - 1)
+	sub(/[ \t]*\)[ \t]*\($/, "", name)
+	name = trim(name)
+	params = substr(stmt, RSTART + RLENGTH)
+	sub(/\)[ \t]*$/, "", params)
+
+	n = split(params, args, ",")
+	if (lastIdent(args[1]) != "skirmishAIId") {
+		printf("#error \"%s: first parameter is not skirmishAIId\"\n", name)
+		return
+	}
+	descr = ""
+	for (i = 2; i <= n; i++) {
+		argName = lastIdent(args[i])
+		if (argName ~ /_sizeMax$/) {
+			descr = descr sprintf(", OUT_ARRAY(%d, %d, %d)", i - 3, i - 2, (lastIdent(args[i - 1]) ~ /[FS]3$/) ? 3 : 1)
+			continue
+		}
+		if ((index(args[i], "*") == 0) || (args[i] ~ /const/)) {
+			continue
+		}
+		if ((i < n) && (lastIdent(args[i + 1]) ~ /_sizeMax$/)) {
+			continue
+		}
+		if ((argName ~ /^return_/) || (argName ~ /_out$/)) {
+			descr = descr sprintf(", OUT_FIXED(%d, %d)", i - 2, fixedCount(argName))
+		}
+	}
+	printf("HOOK(%s%s)\n", name, descr)
+}
+
+BEGIN {
+	print "// Generated by util/CallbackHooks.awk, do not edit"
+	inComment = 0
+}
+
+FNR == 1 {
+	isCallback = (FILENAME ~ /SSkirmishAICallback\.h$/)
+	inStruct = 0
+	inComment = 0
+	stmt = ""
+}
+
+# SSkirmishAICallback.h: function pointer fields, may span lines
+isCallback {
+	line = stripComments($0)
+	if (!inStruct) {
+		if (line ~ /struct[ \t]+SSkirmishAICallback[ \t]*\{/) {
+			inStruct = 1
+		}
+		next
+	}
+	if (line ~ /^[ \t]*\}/) {
+		inStruct = 0
+		next
+	}
+	stmt = stmt " " line
+	while ((p = index(stmt, ";")) > 0) {
+		emitHook(trim(substr(stmt, 1, p - 1)))
+		stmt = substr(stmt, p + 1)
+	}
+	next
+}
+
+# AISCommands.h: "struct S...Command {" fields "}; //$ COMMAND_TOPIC ..."
+!isCallback {
+	if (!inStruct) {
+		if (match($0, /^struct[ \t]+S[A-Za-z0-9_]+Command[ \t]*\{/)) {
+			cmdName = lastIdent(substr($0, 7, RLENGTH - 7))
+			cmdOuts = ""
+			inStruct = 1
+		}
+		next
+	}
+	if ($0 ~ /^[ \t]*\}/) {
+		inStruct = 0
+		if (cmdOuts == "") {
+			next
+		}
+		if (match($0, /\/\/\$[ \t]+COMMAND_[A-Z0-9_]+/)) {
+			topic = trim(substr($0, RSTART + 3, RLENGTH - 3))
+			printf("COMMAND(%s, %s%s)\n", topic, cmdName, cmdOuts)
+		} else {
+			print "CallbackHooks.awk: no topic for " cmdName ", its output fields are not recorded" > "/dev/stderr"
+		}
+		next
+	}
+	line = stripComments($0)
+	if (line !~ /;/) {
+		next
+	}
+	sub(/;.*$/, "", line)
+	field = lastIdent(line)
+	if (field !~ /^ret_/) {
+		next
+	}
+	count = (index(line, "*") && (line !~ /char[ \t]*\*/)) ? fixedCount(field) : 0
+	cmdOuts = cmdOuts sprintf(", CMD_OUT(%s, %s, %d)", cmdName, field, count)
+}
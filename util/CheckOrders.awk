@@ -0,0 +1,53 @@
+#!/usr/bin/awk -f
+#
+# Lints unit orders that bypass CCircuitUnit::Cmd* and leave command shadow stale
+# usage: awk -f CheckOrders.awk <sources of src/circuit>
+#
+# Reports orders issued on springai::Unit of CCircuitUnit::GetUnit(), directly
+# or through local "Unit* u = unit->GetUnit();". unit/CircuitUnit.cpp owns the shadow.
+
+function trim(s) {
+	gsub(/^[ \t]+|[ \t]+$/, "", s)
+	return s
+}
+
+BEGIN {
+	orders = "(Build|Stop|Wait[A-Za-z]*|Repair|Reclaim[A-Za-z]*|Restore[A-Za-z]*|Resurrect[A-Za-z]*|Capture[A-Za-z]*|Guard|MoveTo|PatrolTo|Fight|Attack[A-Za-z]*|DGun[A-Za-z]*|Load[A-Za-z]*|Unload[A-Za-z]*|ExecuteCustomCommand)"
+	direct = "GetUnit\\(\\)->" orders "\\("
+	failures = 0
+}
+
+FNR == 1 {
+	isSkipped = (FILENAME ~ /unit\/CircuitUnit\.cpp$/)
+	split("", aliases)
+}
+
+isSkipped || /^[ \t]*\/\// {
+	next
+}
+
+match($0, /Unit\*[ \t]+[A-Za-z0-9_]+[ \t]*=[^;]*GetUnit\(\)/) {
+	name = substr($0, RSTART, RLENGTH)
+	sub(/^Unit\*[ \t]+/, "", name)
+	sub(/[ \t]*=.*$/, "", name)
+	aliases[name] = 1
+}
+
+{
+	line = $0
+	sub(/\/\/.*$/, "", line)
+	isOrder = (line ~ direct)
+	for (name in aliases) {
+		if (line ~ ("(^|[^A-Za-z0-9_])" name "->" orders "\\(")) {
+			isOrder = 1
+		}
+	}
+	if (isOrder) {
+		printf("%s:%d: unit order bypasses CCircuitUnit::Cmd*: %s\n", FILENAME, FNR, trim(line)) > "/dev/stderr"
+		failures++
+	}
+}
+
+END {
+	exit (failures > 0) ? 1 : 0
+}